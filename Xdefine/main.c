@@ -29,5 +29,25 @@ int main() {
     Param_Print_By_Index(&myCfg, 0); // Should be 888
     Param_Print_By_Index(&myCfg, 1); // Should be 99.900
 
+    // 4. 按名字查找 (哈希表, 不再逐个 strcmp)
+    printf("\n3. Lookup by name...\n");
+    int idx = Param_Find_By_Name("pid_ki");
+    printf("   pid_ki -> index %d\n", idx);
+    printf("   unknown -> index %d\n", Param_Find_By_Name("unknown"));
+
+    // 5. 序列化 / 反序列化 (可直接写入 ringlog_flash)
+    printf("\n4. Serialize round-trip (schema 0x%08X)...\n", Param_Get_Schema_Hash());
+    uint8_t blob[PARAM_BLOB_MAX_SIZE];
+    int len = Param_Serialize(&myCfg, blob, sizeof(blob));
+    printf("   blob size: %d bytes\n", len);
+
+    Config_t loadCfg = {0};
+    int loaded = Param_Deserialize(&loadCfg, blob, (uint32_t)len);
+    printf("   loaded %d fields\n", loaded);
+    Param_Dump_All(&loadCfg);
+
+    blob[len - 1] ^= 0x01;  // 破坏一个字节, 应被 CRC 拦截
+    printf("   corrupted blob -> %d\n", Param_Deserialize(&loadCfg, blob, (uint32_t)len));
+
     return 0;
 }
\ No newline at end of file
@@ -2,29 +2,115 @@
 #include <stdio.h>
 #include <stddef.h> // 必须包含 offsetof
 #include <string.h>
+#ifdef PARAM_USE_RINGLOG
+#include "ringlog_flash.h"
+#endif
 
 /* ============================================================
  * 1. 私有元数据定义
  * ============================================================ */
+typedef void (*ParamPrintFn)(const char *format, const void *pAddr);
+
 typedef struct {
     const char* name;   // 变量名
     uint32_t    offset; // 偏移量
+    uint8_t     size;   // 字节数
     VarType_e   type;   // 类型标签
     const char* format; // 打印格式
+    ParamPrintFn print; // 按实际类型打印, 由 X-Macro 生成, 省去运行时 switch
 } ParamMeta_t;
 
+// 利用 X-Macro 为每个参数生成一个打印函数
+#define X(tag, type, name, fmt) \
+    static void _print_##name(const char *format, const void *pAddr) { \
+        type v; \
+        memcpy(&v, pAddr, sizeof(v)); \
+        printf(format, v); \
+    }
+SYSTEM_PARAMS
+#undef X
+
 // 利用 X-Macro 自动生成查找表
 // static 关键字限制在当前文件，避免符号污染
 static const ParamMeta_t ParamTable[] = {
     #define X(tag, type, name, fmt) \
-        { #name, offsetof(Config_t, name), tag, fmt },
-        
+        { #name, offsetof(Config_t, name), sizeof(type), tag, fmt, _print_##name },
+
     SYSTEM_PARAMS
     #undef X
 };
 
 #define PARAM_COUNT (sizeof(ParamTable) / sizeof(ParamTable[0]))
 
+/* ============================================================
+ * 1.1 名字哈希表 (开放寻址, 槽位数为 2 的幂且至少为参数数的 2 倍)
+ * 槽中存放 下标+1, 0 表示空; 首次查找时建表
+ * ============================================================ */
+#define PARAM_HASH_SLOTS \
+    (PARAM_IDX_COUNT <= 8 ? 16 : PARAM_IDX_COUNT <= 32 ? 64 : \
+     PARAM_IDX_COUNT <= 128 ? 256 : 1024)
+
+static uint16_t NameHashSlots[PARAM_HASH_SLOTS];
+static uint32_t NameHash[PARAM_IDX_COUNT];
+static uint32_t SchemaHash;
+static int      HashReady;
+
+// FNV-1a
+static uint32_t _fnv1a(uint32_t h, const void *data, uint32_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    while (len--) {
+        h ^= *p++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint32_t _name_hash(const char *name) {
+    return _fnv1a(2166136261u, name, (uint32_t)strlen(name));
+}
+
+static void _build_hash(void) {
+    uint32_t schema = 2166136261u;
+
+    memset(NameHashSlots, 0, sizeof(NameHashSlots));
+    for (int i = 0; i < (int)PARAM_COUNT; i++) {
+        const ParamMeta_t *meta = &ParamTable[i];
+        uint32_t slot;
+        uint8_t  desc[2];
+
+        NameHash[i] = _name_hash(meta->name);
+        slot = NameHash[i] & (PARAM_HASH_SLOTS - 1);
+        while (NameHashSlots[slot] != 0) {
+            slot = (slot + 1) & (PARAM_HASH_SLOTS - 1);
+        }
+        NameHashSlots[slot] = (uint16_t)(i + 1);
+
+        // schema 覆盖字段顺序、名字、类型和大小, 任何一项变化哈希都会不同
+        desc[0] = (uint8_t)meta->type;
+        desc[1] = meta->size;
+        schema = _fnv1a(schema, &NameHash[i], sizeof(NameHash[i]));
+        schema = _fnv1a(schema, desc, sizeof(desc));
+    }
+    SchemaHash = schema;
+    HashReady = 1;
+}
+
+// 按名字哈希查找下标, 名字为 NULL 时只比较哈希 (反序列化时使用)
+static int _find_by_hash(uint32_t hash, const char *name) {
+    uint32_t slot;
+
+    if (!HashReady) _build_hash();
+    slot = hash & (PARAM_HASH_SLOTS - 1);
+    while (NameHashSlots[slot] != 0) {
+        int idx = NameHashSlots[slot] - 1;
+        if (NameHash[idx] == hash && (name == NULL || strcmp(ParamTable[idx].name, name) == 0)) {
+            return idx;
+        }
+        slot = (slot + 1) & (PARAM_HASH_SLOTS - 1);
+    }
+    return -1;
+}
+
 /* ============================================================
  * 2. 接口实现
  * ============================================================ */
@@ -49,12 +135,7 @@ void Param_Print_By_Index(Config_t *pCfg, int index) {
     void *pAddr = _get_param_addr(pCfg, index);
 
     printf("  [%d] %-12s : ", index, meta->name);
-
-    switch (meta->type) {
-        case T_INT:   printf(meta->format, *(int*)pAddr);      break;
-        case T_FLOAT: printf(meta->format, *(float*)pAddr);    break;
-        case T_HEX:   printf(meta->format, *(uint32_t*)pAddr); break;
-    }
+    meta->print(meta->format, pAddr);
     printf("\n");
 }
 
@@ -66,24 +147,9 @@ int Param_Set_By_Index(Config_t *pCfg, int index, void *pValue) {
         return -1; // Error
     }
 
-    const ParamMeta_t *meta = &ParamTable[index];
-    void *pAddr = _get_param_addr(pCfg, index);
+    // 元数据中已有字段大小, 直接按大小拷贝
+    memcpy(_get_param_addr(pCfg, index), pValue, ParamTable[index].size);
 
-    // 根据类型进行不同长度/类型的赋值
-    switch (meta->type) {
-        case T_INT:
-            *(int*)pAddr = *(int*)pValue;
-            break;
-        case T_FLOAT:
-            *(float*)pAddr = *(float*)pValue;
-            break;
-        case T_HEX:
-            *(uint32_t*)pAddr = *(uint32_t*)pValue;
-            break;
-        default:
-            return -1;
-    }
-    
     // 可选：设置成功后打印一条日志
     // printf("  -> Set %s success.\n", meta->name);
     return 0; // OK
@@ -95,4 +161,129 @@ void Param_Dump_All(Config_t *pCfg) {
         Param_Print_By_Index(pCfg, i);
     }
     printf("------------------------------\n");
-}
\ No newline at end of file
+}
+
+int Param_Find_By_Name(const char *name) {
+    if (name == NULL) return -1;
+    return _find_by_hash(_name_hash(name), name);
+}
+
+uint32_t Param_Get_Schema_Hash(void) {
+    if (!HashReady) _build_hash();
+    return SchemaHash;
+}
+
+/* ============================================================
+ * 3. 序列化
+ * ============================================================ */
+
+// CRC16-CCITT (0x1021, 初值 0xFFFF)
+static uint16_t _crc16(const uint8_t *data, uint32_t len) {
+    uint16_t crc = 0xFFFF;
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+#define BLOB_CRC_START  offsetof(ParamBlobHdr_t, version)
+
+int Param_Serialize(const Config_t *pCfg, uint8_t *buf, uint32_t buf_size) {
+    ParamBlobHdr_t hdr;
+    uint32_t pos = sizeof(hdr);
+
+    if (pCfg == NULL || buf == NULL) return -1;
+    if (!HashReady) _build_hash();
+
+    for (int i = 0; i < (int)PARAM_COUNT; i++) {
+        const ParamMeta_t *meta = &ParamTable[i];
+        if (pos + PARAM_FIELD_HDR_SIZE + meta->size > buf_size) return -1;
+        // 多字节值按小端写入, 与目标板字节序一致
+        memcpy(&buf[pos], &NameHash[i], 4);
+        buf[pos + 4] = (uint8_t)meta->type;
+        buf[pos + 5] = meta->size;
+        memcpy(&buf[pos + PARAM_FIELD_HDR_SIZE], (const char*)pCfg + meta->offset, meta->size);
+        pos += PARAM_FIELD_HDR_SIZE + meta->size;
+    }
+
+    hdr.magic       = PARAM_BLOB_MAGIC;
+    hdr.crc         = 0;
+    hdr.version     = PARAM_BLOB_VERSION;
+    hdr.schema_hash = SchemaHash;
+    hdr.field_count = (uint16_t)PARAM_COUNT;
+    hdr.payload_len = (uint16_t)(pos - sizeof(hdr));
+    memcpy(buf, &hdr, sizeof(hdr));
+    hdr.crc = _crc16(&buf[BLOB_CRC_START], pos - BLOB_CRC_START);
+    memcpy(buf, &hdr, sizeof(hdr));
+    return (int)pos;
+}
+
+int Param_Deserialize(Config_t *pCfg, const uint8_t *buf, uint32_t len) {
+    ParamBlobHdr_t hdr;
+    uint32_t pos = sizeof(hdr);
+    uint32_t end;
+    int loaded = 0;
+
+    if (pCfg == NULL || buf == NULL || len < sizeof(hdr)) return -1;
+    memcpy(&hdr, buf, sizeof(hdr));
+    end = sizeof(hdr) + hdr.payload_len;
+    if (hdr.magic != PARAM_BLOB_MAGIC || hdr.version > PARAM_BLOB_VERSION || end > len) {
+        return -1;
+    }
+    if (_crc16(&buf[BLOB_CRC_START], end - BLOB_CRC_START) != hdr.crc) {
+        return -1;
+    }
+
+    // schema 完全相同时字段顺序与本地一致, 直接按下标拷贝
+    if (hdr.schema_hash == Param_Get_Schema_Hash() && hdr.field_count == PARAM_COUNT) {
+        for (int i = 0; i < (int)PARAM_COUNT; i++) {
+            const ParamMeta_t *meta = &ParamTable[i];
+            if (pos + PARAM_FIELD_HDR_SIZE + meta->size > end) return -1;
+            memcpy((char*)pCfg + meta->offset, &buf[pos + PARAM_FIELD_HDR_SIZE], meta->size);
+            pos += PARAM_FIELD_HDR_SIZE + meta->size;
+        }
+        return (int)PARAM_COUNT;
+    }
+
+    // schema 不同 (增删过字段): 按名字哈希逐个匹配, 类型或大小不符的字段保持默认值
+    for (uint16_t n = 0; n < hdr.field_count; n++) {
+        uint32_t hash;
+        uint8_t  tag, size;
+        int idx;
+
+        if (pos + PARAM_FIELD_HDR_SIZE > end) return -1;
+        memcpy(&hash, &buf[pos], 4);
+        tag  = buf[pos + 4];
+        size = buf[pos + 5];
+        if (pos + PARAM_FIELD_HDR_SIZE + size > end) return -1;
+
+        idx = _find_by_hash(hash, NULL);
+        if (idx >= 0 && ParamTable[idx].type == tag && ParamTable[idx].size == size) {
+            memcpy((char*)pCfg + ParamTable[idx].offset, &buf[pos + PARAM_FIELD_HDR_SIZE], size);
+            loaded++;
+        }
+        pos += PARAM_FIELD_HDR_SIZE + size;
+    }
+    return loaded;
+}
+
+#ifdef PARAM_USE_RINGLOG
+int Param_Save(const Config_t *pCfg) {
+    uint8_t buf[PARAM_BLOB_MAX_SIZE];
+    int len = Param_Serialize(pCfg, buf, sizeof(buf));
+
+    if (len < 0) return -1;
+    return ringlog_flash_write(buf, (uint32_t)len);
+}
+
+int Param_Load(Config_t *pCfg) {
+    static uint8_t buf[UNIT_SIZE];     // ringlog 按记录长度拷贝, 缓冲区按单元大小准备
+    uint32_t len = 0;
+
+    if (ringlog_flash_read(buf, sizeof(buf), &len) != 0) return -1;
+    return Param_Deserialize(pCfg, buf, len);
+}
+#endif
@@ -30,6 +30,39 @@ typedef struct {
     #undef X
 } Config_t;
 
+// 利用 X-Macro 自动生成参数下标, PARAM_IDX_COUNT 即参数总数 (编译期常量)
+enum {
+    #define X(tag, type, name, fmt) PARAM_IDX_##name,
+    SYSTEM_PARAMS
+    #undef X
+    PARAM_IDX_COUNT
+};
+
+/* ============================================================
+ * 2.1 序列化格式 (小端, 紧凑排列)
+ * [ParamBlobHdr_t][字段0][字段1]...
+ * 字段 = name_hash(4) + type_tag(1) + size(1) + data(size)
+ * 按名字哈希匹配字段, 新旧版本之间增删字段时其余字段照常加载
+ * crc 为 CRC16-CCITT, 覆盖 crc 字段之后的头部与所有字段
+ * ============================================================ */
+#define PARAM_BLOB_MAGIC    0x4D524150u     // "PARM"
+#define PARAM_BLOB_VERSION  1
+
+#pragma pack(push, 1)
+typedef struct {
+    uint32_t magic;
+    uint16_t crc;
+    uint16_t version;
+    uint32_t schema_hash;   // 所有字段 名字+类型+大小 的哈希, 相同则字段布局完全一致
+    uint16_t field_count;
+    uint16_t payload_len;   // 头部之后的字节数
+} ParamBlobHdr_t;
+#pragma pack(pop)
+
+#define PARAM_FIELD_HDR_SIZE 6
+// 序列化缓冲区所需的最大字节数
+#define PARAM_BLOB_MAX_SIZE  (sizeof(ParamBlobHdr_t) + PARAM_IDX_COUNT * PARAM_FIELD_HDR_SIZE + sizeof(Config_t))
+
 /* ============================================================
  * 3. 接口函数声明
  * ============================================================ */
@@ -47,4 +80,23 @@ int Param_Set_By_Index(Config_t *pCfg, int index, void *pValue);
 // 打印所有参数 (Dump)
 void Param_Dump_All(Config_t *pCfg);
 
+// 按名字查找参数下标 (哈希表, O(1)), 未找到返回 -1
+int Param_Find_By_Name(const char *name);
+
+// 当前参数表的 schema 哈希
+uint32_t Param_Get_Schema_Hash(void);
+
+// 序列化到 buf, 返回写入字节数, 空间不足返回 -1
+int Param_Serialize(const Config_t *pCfg, uint8_t *buf, uint32_t buf_size);
+
+// 从 buf 反序列化, 只覆盖名字/类型/大小都匹配的字段
+// 返回加载的字段数, 格式或 CRC 错误返回 -1
+int Param_Deserialize(Config_t *pCfg, const uint8_t *buf, uint32_t len);
+
+#ifdef PARAM_USE_RINGLOG
+// 通过 ringlog_flash 环形存储保存/加载 (需先调用 ringlog_flash_init)
+int Param_Save(const Config_t *pCfg);
+int Param_Load(Config_t *pCfg);
+#endif
+
 #endif // __SYS_PARAM_H__
\ No newline at end of file
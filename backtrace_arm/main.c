@@ -1,68 +1,136 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
+#include "mtrace_dump.h"
 
-// 内存分配记录结构
-typedef struct malloc_record {
-    void *ptr;              // 分配的内存地址
-    size_t size;            // 分配大小
-    uint32_t caller_stack[8]; // 调用堆栈（保存8层）
+// ==========================================
+// 内存分配跟踪配置
+// 记录、调用栈、调用点全部放在静态池中, 钩子内部不调用 malloc/printf,
+// 插入/删除/计数均为 O(1), 可在正式版本中常开; 报告仅在需要时生成
+// ==========================================
+#ifndef MTRACE_MAX_RECORDS
+#define MTRACE_MAX_RECORDS   4096   // 同时存活的分配数上限
+#endif
+// 调用栈/调用点登记后只读且不回收 (导出和报告因此可以不加锁读取), 是整个运行期间
+// 累计的上限; 满了以后新出现的调用栈/调用点不再记录, 分配本身仍然跟踪,
+// 未记录的次数在报告和导出文件头中给出, 需要时加大上限
+#ifndef MTRACE_MAX_STACKS
+#define MTRACE_MAX_STACKS    1024   // 去重后的调用栈数上限
+#endif
+#ifndef MTRACE_MAX_SITES
+#define MTRACE_MAX_SITES     256    // 调用点(直接调用者)数上限
+#endif
+// 哈希槽数取上限的 2 倍 (上限须为 2 的幂), 负载率不超过 50%
+#define MTRACE_RECORD_SLOTS  (MTRACE_MAX_RECORDS * 2)
+#define MTRACE_STACK_SLOTS   (MTRACE_MAX_STACKS * 2)
+#define MTRACE_SITE_SLOTS    (MTRACE_MAX_SITES * 2)
+#define MTRACE_STACK_DEPTH   8
+#define MTRACE_NONE          0xFFFF
+
+// 临界区: 默认使用 uC/OS-II 关中断宏, 其它环境可在编译时重定义这三个宏
+#ifndef MTRACE_LOCK
+#define MTRACE_LOCK_DECL     OS_CPU_SR cpu_sr = 0
+#define MTRACE_LOCK()        OS_ENTER_CRITICAL()
+#define MTRACE_UNLOCK()      OS_EXIT_CRITICAL()
+#endif
+
+// 内存分配记录, 直接存放在以 ptr 为键的开放寻址哈希表中
+typedef struct {
+    void *ptr;              // 分配的内存地址, NULL 表示空槽
+    uint32_t size;          // 分配大小
     uint32_t timestamp;     // 时间戳
-    struct malloc_record *next;
+    uint16_t stack_id;      // 去重调用栈下标, MTRACE_NONE 表示调用栈表已满
+    uint16_t site_id;       // 调用点下标, MTRACE_NONE 表示调用点表已满
 } malloc_record_t;
 
-// 全局记录链表
-static malloc_record_t *g_malloc_records = NULL;
+// 去重后的调用栈, 相同的 8 层调用栈只存一份并引用计数
+typedef struct {
+    uint32_t frames[MTRACE_STACK_DEPTH];
+    uint32_t hash;
+    uint32_t depth;
+    uint32_t refcount;      // 引用该调用栈的存活分配数
+    uint32_t live_bytes;    // 这些分配的总字节数
+} stack_sig_t;
+
+// 按直接调用者聚合的计数
+typedef struct {
+    uint32_t caller_addr;
+    uint32_t live_count;
+    uint32_t live_bytes;
+    uint32_t peak_bytes;
+    uint32_t total_allocs;
+    uint32_t total_frees;
+} caller_stats_t;
+
+static malloc_record_t g_records[MTRACE_RECORD_SLOTS];
 static int g_record_count = 0;
 
+static stack_sig_t g_stacks[MTRACE_MAX_STACKS];
+static uint16_t g_stack_index[MTRACE_STACK_SLOTS];  // 存 stack_id + 1, 0 表示空槽
+static int g_stack_count = 0;
+
+static caller_stats_t g_sites[MTRACE_MAX_SITES];
+static uint16_t g_site_index[MTRACE_SITE_SLOTS];    // 存 site_id + 1, 0 表示空槽
+static int g_site_count = 0;
+
+static uint32_t g_dropped_records = 0;  // 记录池满未能跟踪的分配
+static uint32_t g_untracked_frees = 0;  // 释放了未被跟踪的指针
+static uint32_t g_stack_overflow = 0;   // 调用栈表满, 未记录调用栈的分配
+static uint32_t g_site_overflow = 0;    // 调用点表满, 未计入调用点统计的分配
+
+// 导出/打印记录时使用的快照, 持锁一次性拷贝存活记录后在锁外遍历
+// 同一时间只允许一个任务导出或打印记录
+static malloc_record_t g_record_snapshot[MTRACE_MAX_RECORDS];
+
 // ARM Cortex-A53 堆栈回溯函数
 static int backtrace_arm(uint32_t *buffer, int max_frames) {
     uint32_t fp;  // Frame Pointer
     uint32_t lr;  // Link Register
     uint32_t pc;  // Program Counter
     int frame_count = 0;
-    
+
     // 获取当前Frame Pointer (R11)
     __asm__ volatile("mov %0, r11" : "=r"(fp));
-    
+
     // 获取当前Link Register (R14)
     __asm__ volatile("mov %0, lr" : "=r"(lr));
-    
+
     // 第一个返回地址就是当前的LR
     if (frame_count < max_frames) {
         buffer[frame_count++] = lr;
     }
-    
+
     // 遍历调用栈
     while (fp != 0 && frame_count < max_frames) {
         // 检查fp是否有效（4字节对齐，在合理范围内）
         if ((fp & 0x3) != 0 || fp < 0x1000 || fp > 0x80000000) {
             break;
         }
-        
+
         // ARM AAPCS调用约定：
         // fp指向的位置存储上一个fp
         // fp+4位置存储返回地址(lr)
         uint32_t *frame = (uint32_t*)fp;
-        
+
         // 读取返回地址
         lr = frame[1];  // fp+4位置
         if (lr == 0) break;
-        
+
         buffer[frame_count++] = lr;
-        
+
         // 获取上一个frame pointer
         fp = frame[0];  // fp位置
     }
-    
+
     return frame_count;
 }
 
 // 符号查找函数（需要根据实际情况实现）
+// 完整的函数名+偏移解析请用 mtrace_dump() 导出后在主机上运行 mtrace_symbolize
 static const char* get_symbol_name(uint32_t addr) {
     // 这里需要根据你的系统实现符号查找
     // 可以使用符号表或者预定义的地址映射
-    
+
     // 示例：简单的地址范围判断
     if (addr >= 0x08000000 && addr <= 0x08100000) {
         return "main_app";
@@ -71,137 +139,303 @@ static const char* get_symbol_name(uint32_t addr) {
     } else if (addr >= 0x08200000 && addr <= 0x08300000) {
         return "protocol_stack";
     }
-    
+
     return "unknown";
 }
 
+// ==========================================
+// 哈希表操作 (调用者持有锁)
+// ==========================================
+static uint32_t mtrace_hash32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352DU;
+    x ^= x >> 15;
+    x *= 0x846CA68BU;
+    x ^= x >> 16;
+    return x;
+}
+
+static uint32_t mtrace_record_home(const void *ptr) {
+    return mtrace_hash32((uint32_t)(uintptr_t)ptr) & (MTRACE_RECORD_SLOTS - 1);
+}
+
+static uint32_t mtrace_hash_stack(const uint32_t *frames, int depth) {
+    uint32_t h = 2166136261U;
+    for (int i = 0; i < depth; i++) {
+        h = (h ^ frames[i]) * 16777619U;
+    }
+    return mtrace_hash32(h ^ (uint32_t)depth);
+}
+
+// 查找或登记调用栈, 返回 stack_id
+static uint16_t mtrace_stack_intern(const uint32_t *frames, int depth, uint32_t hash) {
+    uint32_t slot = hash & (MTRACE_STACK_SLOTS - 1);
+
+    while (g_stack_index[slot] != 0) {
+        stack_sig_t *sig = &g_stacks[g_stack_index[slot] - 1];
+        if (sig->hash == hash && sig->depth == (uint32_t)depth &&
+            memcmp(sig->frames, frames, depth * sizeof(uint32_t)) == 0) {
+            return (uint16_t)(g_stack_index[slot] - 1);
+        }
+        slot = (slot + 1) & (MTRACE_STACK_SLOTS - 1);
+    }
+    if (g_stack_count >= MTRACE_MAX_STACKS) {
+        return MTRACE_NONE;
+    }
+
+    stack_sig_t *sig = &g_stacks[g_stack_count];
+    memset(sig, 0, sizeof(*sig));
+    memcpy(sig->frames, frames, depth * sizeof(uint32_t));
+    sig->hash = hash;
+    sig->depth = (uint32_t)depth;
+    g_stack_index[slot] = (uint16_t)(++g_stack_count);
+    return (uint16_t)(g_stack_count - 1);
+}
+
+// 查找或登记调用点, 返回 site_id
+static uint16_t mtrace_site_intern(uint32_t caller) {
+    uint32_t slot = mtrace_hash32(caller) & (MTRACE_SITE_SLOTS - 1);
+
+    while (g_site_index[slot] != 0) {
+        if (g_sites[g_site_index[slot] - 1].caller_addr == caller) {
+            return (uint16_t)(g_site_index[slot] - 1);
+        }
+        slot = (slot + 1) & (MTRACE_SITE_SLOTS - 1);
+    }
+    if (g_site_count >= MTRACE_MAX_SITES) {
+        return MTRACE_NONE;
+    }
+
+    memset(&g_sites[g_site_count], 0, sizeof(caller_stats_t));
+    g_sites[g_site_count].caller_addr = caller;
+    g_site_index[slot] = (uint16_t)(++g_site_count);
+    return (uint16_t)(g_site_count - 1);
+}
+
+static malloc_record_t *mtrace_record_find(const void *ptr) {
+    uint32_t slot = mtrace_record_home(ptr);
+
+    while (g_records[slot].ptr != NULL) {
+        if (g_records[slot].ptr == ptr) {
+            return &g_records[slot];
+        }
+        slot = (slot + 1) & (MTRACE_RECORD_SLOTS - 1);
+    }
+    return NULL;
+}
+
+// 线性探测删除: 把后续同簇记录前移填补空洞, 不留墓碑, 查找长度不会随运行时间退化
+static void mtrace_record_remove(malloc_record_t *rec) {
+    uint32_t i = (uint32_t)(rec - g_records);
+    uint32_t j = i;
+
+    for (;;) {
+        j = (j + 1) & (MTRACE_RECORD_SLOTS - 1);
+        if (g_records[j].ptr == NULL) {
+            break;
+        }
+        uint32_t k = mtrace_record_home(g_records[j].ptr);
+        // k 在循环区间 (i, j] 内时该记录不能前移
+        if ((i <= j) ? (i < k && k <= j) : (i < k || k <= j)) {
+            continue;
+        }
+        g_records[i] = g_records[j];
+        i = j;
+    }
+    g_records[i].ptr = NULL;
+    g_record_count--;
+}
+
+// ==========================================
+// 钩子
+// ==========================================
+
 // malloc钩子函数
 void malloc_hook(void *ptr, size_t size) {
+    uint32_t frames[MTRACE_STACK_DEPTH];
+    MTRACE_LOCK_DECL;
+
     if (ptr == NULL) return;
-    
-    // 分配记录结构
-    malloc_record_t *record = (malloc_record_t*)malloc(sizeof(malloc_record_t));
-    if (record == NULL) return;
-    
-    record->ptr = ptr;
-    record->size = size;
-    record->timestamp = OSTimeGet(); // ucos时间戳
-    
-    // 获取调用堆栈
-    int stack_depth = backtrace_arm(record->caller_stack, 8);
-    
-    // 清空未使用的堆栈位置
-    for (int i = stack_depth; i < 8; i++) {
-        record->caller_stack[i] = 0;
-    }
-    
-    // 添加到链表
-    record->next = g_malloc_records;
-    g_malloc_records = record;
+
+    // 回溯与哈希在锁外完成, 临界区内只做查表和计数
+    int depth = backtrace_arm(frames, MTRACE_STACK_DEPTH);
+    uint32_t hash = mtrace_hash_stack(frames, depth);
+    uint32_t now = OSTimeGet(); // ucos时间戳
+
+    MTRACE_LOCK();
+    if (g_record_count >= MTRACE_MAX_RECORDS) {
+        g_dropped_records++;
+        MTRACE_UNLOCK();
+        return;
+    }
+
+    uint16_t stack_id = mtrace_stack_intern(frames, depth, hash);
+    uint16_t site_id = mtrace_site_intern(depth > 0 ? frames[0] : 0);
+
+    uint32_t slot = mtrace_record_home(ptr);
+    while (g_records[slot].ptr != NULL) {
+        slot = (slot + 1) & (MTRACE_RECORD_SLOTS - 1);
+    }
+    malloc_record_t *rec = &g_records[slot];
+    rec->ptr = ptr;
+    rec->size = (uint32_t)size;
+    rec->timestamp = now;
+    rec->stack_id = stack_id;
+    rec->site_id = site_id;
     g_record_count++;
-    
-    // 打印分配信息
-    printf("MALLOC: ptr=%p, size=%zu, caller_stack:\n", ptr, size);
-    for (int i = 0; i < stack_depth; i++) {
-        printf("  [%d] 0x%08x (%s)\n", i, 
-               record->caller_stack[i], 
-               get_symbol_name(record->caller_stack[i]));
+
+    if (stack_id != MTRACE_NONE) {
+        g_stacks[stack_id].refcount++;
+        g_stacks[stack_id].live_bytes += rec->size;
+    } else {
+        g_stack_overflow++;
     }
-    printf("\n");
+    if (site_id == MTRACE_NONE) {
+        g_site_overflow++;
+    } else {
+        caller_stats_t *site = &g_sites[site_id];
+        site->live_count++;
+        site->live_bytes += rec->size;
+        site->total_allocs++;
+        if (site->live_bytes > site->peak_bytes) {
+            site->peak_bytes = site->live_bytes;
+        }
+    }
+    MTRACE_UNLOCK();
 }
 
 // free钩子函数
 void free_hook(void *ptr) {
+    MTRACE_LOCK_DECL;
+
     if (ptr == NULL) return;
-    
-    // 从记录中移除
-    malloc_record_t **current = &g_malloc_records;
-    while (*current) {
-        if ((*current)->ptr == ptr) {
-            malloc_record_t *to_remove = *current;
-            *current = (*current)->next;
-            free(to_remove);
-            g_record_count--;
-            break;
+
+    MTRACE_LOCK();
+    malloc_record_t *rec = mtrace_record_find(ptr);
+    if (rec == NULL) {
+        g_untracked_frees++;
+        MTRACE_UNLOCK();
+        return;
+    }
+
+    if (rec->stack_id != MTRACE_NONE) {
+        g_stacks[rec->stack_id].refcount--;
+        g_stacks[rec->stack_id].live_bytes -= rec->size;
+    }
+    if (rec->site_id != MTRACE_NONE) {
+        caller_stats_t *site = &g_sites[rec->site_id];
+        site->live_count--;
+        site->live_bytes -= rec->size;
+        site->total_frees++;
+    }
+    mtrace_record_remove(rec);
+    MTRACE_UNLOCK();
+}
+
+// ==========================================
+// 按需报告 (在任务上下文调用, 打印期间不持锁)
+// ==========================================
+
+// 持锁拷贝全部存活记录到 g_record_snapshot, 返回记录数
+// 逐槽拷贝时删除操作的前移可能让记录被跳过或重复, 所以整表在一次临界区内拷贝
+static int mtrace_snapshot_records(mtrace_dump_header_t *header) {
+    int count = 0;
+    MTRACE_LOCK_DECL;
+
+    MTRACE_LOCK();
+    for (uint32_t slot = 0; slot < MTRACE_RECORD_SLOTS; slot++) {
+        if (g_records[slot].ptr != NULL) {
+            g_record_snapshot[count++] = g_records[slot];
         }
-        current = &(*current)->next;
+    }
+    if (header != NULL) {
+        header->stack_count = (uint32_t)g_stack_count;
+        header->record_count = (uint32_t)count;
+        header->stack_overflow = g_stack_overflow;
+        header->dropped_records = g_dropped_records;
+    }
+    MTRACE_UNLOCK();
+    return count;
+}
+
+static void print_call_stack(uint16_t stack_id, const char *indent) {
+    if (stack_id == MTRACE_NONE) {
+        printf("%s(call stack table full)\n", indent);
+        return;
+    }
+    // 调用栈登记后只读, 不需要加锁
+    const stack_sig_t *sig = &g_stacks[stack_id];
+    for (uint32_t i = 0; i < sig->depth; i++) {
+        printf("%s[%u] 0x%08x (%s)\n", indent, (unsigned)i,
+               sig->frames[i], get_symbol_name(sig->frames[i]));
     }
 }
 
 // 内存使用情况分析
 void analyze_memory_usage(void) {
+    static caller_stats_t snapshot[MTRACE_MAX_SITES];
+    static uint16_t order[MTRACE_MAX_SITES];
+    int stats_count, record_count, stack_count;
+    uint32_t dropped, untracked, stack_overflow, site_overflow;
+    MTRACE_LOCK_DECL;
+
+    MTRACE_LOCK();
+    stats_count = g_site_count;
+    stack_count = g_stack_count;
+    record_count = g_record_count;
+    dropped = g_dropped_records;
+    untracked = g_untracked_frees;
+    stack_overflow = g_stack_overflow;
+    site_overflow = g_site_overflow;
+    memcpy(snapshot, g_sites, stats_count * sizeof(caller_stats_t));
+    MTRACE_UNLOCK();
+
     printf("=== Memory Usage Analysis ===\n");
-    printf("Total malloc records: %d\n\n", g_record_count);
-    
-    // 按调用者统计
-    typedef struct {
-        uint32_t caller_addr;
-        int count;
-        size_t total_size;
-    } caller_stats_t;
-    
-    caller_stats_t stats[100];
-    int stats_count = 0;
-    
-    malloc_record_t *record = g_malloc_records;
-    while (record) {
-        uint32_t caller = record->caller_stack[0]; // 直接调用者
-        
-        // 查找是否已存在
-        int found = -1;
-        for (int i = 0; i < stats_count; i++) {
-            if (stats[i].caller_addr == caller) {
-                found = i;
-                break;
-            }
-        }
-        
-        if (found >= 0) {
-            stats[found].count++;
-            stats[found].total_size += record->size;
-        } else if (stats_count < 100) {
-            stats[stats_count].caller_addr = caller;
-            stats[stats_count].count = 1;
-            stats[stats_count].total_size = record->size;
-            stats_count++;
+    printf("Total malloc records: %d (dropped %u, untracked frees %u)\n",
+           record_count, (unsigned)dropped, (unsigned)untracked);
+    printf("Unique call stacks: %d/%d, call sites: %d/%d\n",
+           stack_count, MTRACE_MAX_STACKS, stats_count, MTRACE_MAX_SITES);
+    if (stack_overflow != 0 || site_overflow != 0) {
+        printf("Table full: %u allocs without call stack, %u allocs without call site\n",
+               (unsigned)stack_overflow, (unsigned)site_overflow);
+    }
+    printf("\n");
+
+    // 按存活字节数降序 (插入排序, 调用点数量很少)
+    for (int i = 0; i < stats_count; i++) {
+        int j = i;
+        while (j > 0 && snapshot[order[j - 1]].live_bytes < snapshot[i].live_bytes) {
+            order[j] = order[j - 1];
+            j--;
         }
-        
-        record = record->next;
+        order[j] = (uint16_t)i;
     }
-    
-    // 按内存使用量排序并显示
+
     printf("Top memory consumers:\n");
     for (int i = 0; i < stats_count; i++) {
-        printf("Caller: 0x%08x (%s) - Count: %d, Total: %zu bytes\n",
-               stats[i].caller_addr,
-               get_symbol_name(stats[i].caller_addr),
-               stats[i].count,
-               stats[i].total_size);
+        const caller_stats_t *s = &snapshot[order[i]];
+        printf("Caller: 0x%08x (%s) - Live: %u, %u bytes, Peak: %u bytes, Allocs: %u, Frees: %u\n",
+               s->caller_addr, get_symbol_name(s->caller_addr),
+               (unsigned)s->live_count, (unsigned)s->live_bytes, (unsigned)s->peak_bytes,
+               (unsigned)s->total_allocs, (unsigned)s->total_frees);
     }
 }
 
 // 显示详细的内存分配记录
 void dump_all_malloc_records(void) {
+    int count = mtrace_snapshot_records(NULL);
+
     printf("=== All Malloc Records ===\n");
-    
-    malloc_record_t *record = g_malloc_records;
-    int index = 0;
-    
-    while (record) {
-        printf("Record %d:\n", index++);
-        printf("  Address: %p\n", record->ptr);
-        printf("  Size: %zu bytes\n", record->size);
-        printf("  Timestamp: %u\n", record->timestamp);
+    for (int i = 0; i < count; i++) {
+        const malloc_record_t *rec = &g_record_snapshot[i];
+
+        printf("Record %d:\n", i);
+        printf("  Address: %p\n", rec->ptr);
+        printf("  Size: %u bytes\n", (unsigned)rec->size);
+        printf("  Timestamp: %u\n", (unsigned)rec->timestamp);
         printf("  Call stack:\n");
-        
-        for (int i = 0; i < 8 && record->caller_stack[i] != 0; i++) {
-            printf("    [%d] 0x%08x (%s)\n", i, 
-                   record->caller_stack[i],
-                   get_symbol_name(record->caller_stack[i]));
-        }
+        print_call_stack(rec->stack_id, "    ");
         printf("\n");
-        
-        record = record->next;
     }
 }
 
@@ -209,31 +443,73 @@ void dump_all_malloc_records(void) {
 void setup_malloc_hooks(void) {
     // 注册malloc和free钩子
     // 具体实现取决于你的malloc实现
-    
+
     // 如果使用标准库malloc，可能需要：
     // __malloc_hook = malloc_hook;
     // __free_hook = free_hook;
-    
+
     // 如果使用自定义内存管理，直接在分配/释放函数中调用钩子
     printf("Malloc hooks registered\n");
 }
 
-// 查找内存泄漏
+// 查找内存泄漏: 按调用栈聚合仍存活的分配
 void find_memory_leaks(void) {
+    int stack_count;
+    MTRACE_LOCK_DECL;
+
+    MTRACE_LOCK();
+    stack_count = g_stack_count;
+    MTRACE_UNLOCK();
+
     printf("=== Potential Memory Leaks ===\n");
-    
-    malloc_record_t *record = g_malloc_records;
-    while (record) {
-        printf("Leaked memory: %p, size: %zu, allocated at:\n", 
-               record->ptr, record->size);
-        
-        for (int i = 0; i < 8 && record->caller_stack[i] != 0; i++) {
-            printf("  [%d] 0x%08x (%s)\n", i, 
-                   record->caller_stack[i],
-                   get_symbol_name(record->caller_stack[i]));
+    for (int id = 0; id < stack_count; id++) {
+        uint32_t refcount, live_bytes;
+
+        MTRACE_LOCK();
+        refcount = g_stacks[id].refcount;
+        live_bytes = g_stacks[id].live_bytes;
+        MTRACE_UNLOCK();
+        if (refcount == 0) {
+            continue;
         }
+
+        printf("Leaked: %u blocks, %u bytes, allocated at:\n",
+               (unsigned)refcount, (unsigned)live_bytes);
+        print_call_stack((uint16_t)id, "  ");
         printf("\n");
-        
-        record = record->next;
     }
-}
\ No newline at end of file
+}
+
+// 导出跟踪状态 (格式见 mtrace_dump.h), 供主机工具 mtrace_symbolize 解析符号并汇总泄漏
+// 存活记录在一次临界区内拷贝成快照, write 回调在锁外调用, 可直接写串口或 flash
+void mtrace_dump(mtrace_write_fn write, void *arg) {
+    mtrace_dump_header_t header;
+    mtrace_dump_stack_t stack;
+    mtrace_dump_record_t out;
+
+    memset(&header, 0, sizeof(header));
+    header.magic = MTRACE_DUMP_MAGIC;
+    header.version = MTRACE_DUMP_VERSION;
+    header.stack_depth = MTRACE_DUMP_DEPTH;
+    header.max_stacks = MTRACE_MAX_STACKS;
+    mtrace_snapshot_records(&header);
+    write(&header, sizeof(header), arg);
+
+    // 调用栈登记后只读, 导出时不需要加锁
+    for (uint32_t id = 0; id < header.stack_count; id++) {
+        memset(&stack, 0, sizeof(stack));
+        stack.depth = g_stacks[id].depth;
+        memcpy(stack.frames, g_stacks[id].frames, stack.depth * sizeof(uint32_t));
+        write(&stack, sizeof(stack), arg);
+    }
+
+    for (uint32_t i = 0; i < header.record_count; i++) {
+        const malloc_record_t *rec = &g_record_snapshot[i];
+
+        out.ptr = (uint32_t)(uintptr_t)rec->ptr;
+        out.size = rec->size;
+        out.timestamp = rec->timestamp;
+        out.stack_id = (rec->stack_id == MTRACE_NONE) ? MTRACE_DUMP_NO_STACK : rec->stack_id;
+        write(&out, sizeof(out), arg);
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef __MTRACE_DUMP_H__
+#define __MTRACE_DUMP_H__
+
+#include <stdint.h>
+
+// ==========================================
+// 分配跟踪状态的二进制导出格式 (目标板导出, 主机 mtrace_symbolize 解析)
+// 全部字段小端, 依次为:
+//   mtrace_dump_header_t
+//   mtrace_dump_stack_t  x stack_count   (下标即 stack_id)
+//   mtrace_dump_record_t x record_count  (导出开始时一次性拍下的存活记录)
+// ==========================================
+#define MTRACE_DUMP_MAGIC     0x4452544DU   // "MTRD"
+#define MTRACE_DUMP_VERSION   2
+#define MTRACE_DUMP_DEPTH     8
+#define MTRACE_DUMP_NO_STACK  0xFFFFFFFFU
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t stack_depth;       // 每个调用栈的帧数上限, 固定 MTRACE_DUMP_DEPTH
+    uint32_t stack_count;
+    uint32_t record_count;
+    uint32_t max_stacks;        // 调用栈表上限, stack_count 达到该值后新调用栈不再记录
+    uint32_t stack_overflow;    // 因调用栈表满而未记录调用栈的分配次数 (累计)
+    uint32_t dropped_records;   // 因记录池满而未跟踪的分配次数 (累计)
+} mtrace_dump_header_t;
+
+typedef struct {
+    uint32_t depth;
+    uint32_t frames[MTRACE_DUMP_DEPTH];    // 返回地址, frames[0] 为直接调用者
+} mtrace_dump_stack_t;
+
+typedef struct {
+    uint32_t ptr;
+    uint32_t size;
+    uint32_t timestamp;
+    uint32_t stack_id;          // MTRACE_DUMP_NO_STACK 表示调用栈表已满未记录
+} mtrace_dump_record_t;
+
+// 导出数据写出回调 (写串口/缓冲区/文件)
+typedef void (*mtrace_write_fn)(const void *data, uint32_t len, void *arg);
+
+#endif
@@ -0,0 +1,315 @@
+// 主机工具: 解析目标板 mtrace_dump() 导出的跟踪状态, 用 ELF 符号表把调用栈地址
+// 解析为 函数名+偏移, 并按调用栈汇总泄漏
+// 用法: mtrace_symbolize <固件ELF> <导出文件> [-n 显示条数]
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "mtrace_dump.h"
+
+typedef struct {
+    uint64_t addr;
+    uint64_t size;
+    const char *name;
+} symbol_t;
+
+typedef struct {
+    uint8_t *image;             // 整个 ELF 文件, 符号名直接指向其中的字符串表
+    symbol_t *syms;
+    size_t count;
+} symtab_t;
+
+typedef struct {
+    uint32_t stack_id;
+    uint64_t blocks;
+    uint64_t bytes;
+} leak_t;
+
+static uint8_t *read_file(const char *path, size_t *len) {
+    FILE *fp = fopen(path, "rb");
+    uint8_t *buf;
+    long size;
+
+    if (fp == NULL) {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    buf = (uint8_t *)malloc(size > 0 ? (size_t)size : 1);
+    if (buf == NULL || fread(buf, 1, (size_t)size, fp) != (size_t)size) {
+        free(buf);
+        fclose(fp);
+        return NULL;
+    }
+    fclose(fp);
+    *len = (size_t)size;
+    return buf;
+}
+
+// 小端读取
+static uint16_t rd16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t rd32(const uint8_t *p) { return (uint32_t)rd16(p) | ((uint32_t)rd16(p + 2) << 16); }
+static uint64_t rd64(const uint8_t *p) { return (uint64_t)rd32(p) | ((uint64_t)rd32(p + 4) << 32); }
+
+static int symbol_cmp(const void *a, const void *b) {
+    const symbol_t *sa = (const symbol_t *)a, *sb = (const symbol_t *)b;
+    if (sa->addr != sb->addr) {
+        return (sa->addr < sb->addr) ? -1 : 1;
+    }
+    return (sa->size > sb->size) ? -1 : (sa->size < sb->size);   // 同地址时有长度的排前面
+}
+
+#define SHT_SYMTAB  2
+#define SHT_DYNSYM  11
+#define STT_FUNC    2
+#define EM_ARM      40
+
+// 读取 ELF32/ELF64 小端文件中的函数符号, 排序去重后供二分查找
+static int symtab_load(symtab_t *st, const char *path) {
+    size_t len;
+    uint8_t *img = read_file(path, &len);
+
+    memset(st, 0, sizeof(*st));
+    if (img == NULL) {
+        return -1;
+    }
+    if (len < 0x40 || memcmp(img, "\x7F" "ELF", 4) != 0 || img[5] != 1) {
+        fprintf(stderr, "%s: 不是小端 ELF 文件\n", path);
+        free(img);
+        return -1;
+    }
+
+    int is64 = (img[4] == 2);
+    uint16_t machine = rd16(img + 0x12);
+    uint64_t shoff = is64 ? rd64(img + 0x28) : rd32(img + 0x20);
+    uint16_t shentsize = rd16(img + (is64 ? 0x3A : 0x2E));
+    uint16_t shnum = rd16(img + (is64 ? 0x3C : 0x30));
+    const uint8_t *symtab_sh = NULL;
+
+    if (shoff + (uint64_t)shnum * shentsize > len) {
+        free(img);
+        return -1;
+    }
+    // 优先使用完整符号表, 没有时退回动态符号表
+    for (uint16_t i = 0; i < shnum; i++) {
+        const uint8_t *sh = img + shoff + (uint64_t)i * shentsize;
+        uint32_t type = rd32(sh + 4);
+        if (type == SHT_SYMTAB || (type == SHT_DYNSYM && symtab_sh == NULL)) {
+            symtab_sh = sh;
+        }
+    }
+    if (symtab_sh == NULL) {
+        fprintf(stderr, "%s: 没有符号表\n", path);
+        free(img);
+        return -1;
+    }
+
+    uint64_t sym_off = is64 ? rd64(symtab_sh + 24) : rd32(symtab_sh + 16);
+    uint64_t sym_size = is64 ? rd64(symtab_sh + 32) : rd32(symtab_sh + 20);
+    uint32_t str_index = rd32(symtab_sh + (is64 ? 40 : 24));
+    if (str_index >= shnum) {
+        fprintf(stderr, "%s: 符号表的字符串表下标 %u 无效\n", path, (unsigned)str_index);
+        free(img);
+        return -1;
+    }
+    const uint8_t *str_sh = img + shoff + (uint64_t)str_index * shentsize;
+    uint64_t str_off = is64 ? rd64(str_sh + 24) : rd32(str_sh + 16);
+    uint64_t str_size = is64 ? rd64(str_sh + 32) : rd32(str_sh + 20);
+    size_t entsize = is64 ? 24 : 16;
+
+    if (sym_off + sym_size > len || str_off + str_size > len) {
+        free(img);
+        return -1;
+    }
+
+    st->syms = (symbol_t *)malloc((size_t)(sym_size / entsize + 1) * sizeof(symbol_t));
+    if (st->syms == NULL) {
+        free(img);
+        return -1;
+    }
+    for (uint64_t off = 0; off + entsize <= sym_size; off += entsize) {
+        const uint8_t *s = img + sym_off + off;
+        uint32_t name = rd32(s);
+        uint8_t info = is64 ? s[4] : s[12];
+        uint16_t shndx = is64 ? rd16(s + 6) : rd16(s + 14);
+        uint64_t value = is64 ? rd64(s + 8) : rd32(s + 4);
+        uint64_t size = is64 ? rd64(s + 16) : rd32(s + 8);
+
+        if ((info & 0xF) != STT_FUNC || shndx == 0 || name >= str_size) {
+            continue;
+        }
+        if (machine == EM_ARM) {
+            value &= ~(uint64_t)1;      // Thumb 函数地址最低位为 1
+        }
+        st->syms[st->count].addr = value;
+        st->syms[st->count].size = size;
+        st->syms[st->count].name = (const char *)(img + str_off + name);
+        st->count++;
+    }
+
+    // 只排序一次, 之后每次查找 O(log n)
+    qsort(st->syms, st->count, sizeof(symbol_t), symbol_cmp);
+    size_t out = 0;
+    for (size_t i = 0; i < st->count; i++) {
+        if (out > 0 && st->syms[out - 1].addr == st->syms[i].addr) {
+            continue;       // 别名只保留一个
+        }
+        st->syms[out++] = st->syms[i];
+    }
+    st->count = out;
+    st->image = img;
+    return 0;
+}
+
+static const symbol_t *symtab_lookup(const symtab_t *st, uint64_t addr) {
+    size_t lo = 0, hi = st->count;
+
+    // 找最后一个 addr <= 目标地址的符号
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (st->syms[mid].addr <= addr) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) {
+        return NULL;
+    }
+    const symbol_t *sym = &st->syms[lo - 1];
+    if (sym->size != 0 && addr >= sym->addr + sym->size) {
+        return NULL;
+    }
+    return sym;
+}
+
+static void symtab_free(symtab_t *st) {
+    free(st->syms);
+    free(st->image);
+}
+
+static int leak_cmp(const void *a, const void *b) {
+    const leak_t *la = (const leak_t *)a, *lb = (const leak_t *)b;
+    if (la->bytes != lb->bytes) {
+        return (la->bytes > lb->bytes) ? -1 : 1;
+    }
+    return (la->blocks > lb->blocks) ? -1 : (la->blocks < lb->blocks);
+}
+
+static void print_frame(const symtab_t *st, int index, uint32_t addr) {
+    // 调用栈中是返回地址, 用 addr - 1 查找, 避免调用指令位于函数末尾时落到下一个函数
+    const symbol_t *sym = symtab_lookup(st, (addr & ~1U) - 1);
+    if (sym != NULL) {
+        printf("    [%d] 0x%08x %s+0x%llx\n", index, addr, sym->name,
+               (unsigned long long)((addr & ~1U) - sym->addr));
+    } else {
+        printf("    [%d] 0x%08x ??\n", index, addr);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    symtab_t st;
+    size_t dump_len;
+    uint8_t *dump;
+    size_t top = (size_t)-1;
+
+    if (argc != 3 && !(argc == 5 && strcmp(argv[3], "-n") == 0)) {
+        printf("用法: %s <固件ELF> <导出文件> [-n 显示条数]\n", argv[0]);
+        return 1;
+    }
+    if (argc == 5) {
+        top = (size_t)strtoul(argv[4], NULL, 0);
+    }
+
+    if (symtab_load(&st, argv[1]) != 0) {
+        fprintf(stderr, "读取符号表失败: %s\n", argv[1]);
+        return 1;
+    }
+    dump = read_file(argv[2], &dump_len);
+    if (dump == NULL || dump_len < sizeof(mtrace_dump_header_t)) {
+        fprintf(stderr, "读取导出文件失败: %s\n", argv[2]);
+        symtab_free(&st);
+        return 1;
+    }
+
+    mtrace_dump_header_t header;
+    memcpy(&header, dump, sizeof(header));
+    size_t stacks_off = sizeof(header);
+    size_t records_off = stacks_off + (size_t)header.stack_count * sizeof(mtrace_dump_stack_t);
+    if (header.magic != MTRACE_DUMP_MAGIC || header.version != MTRACE_DUMP_VERSION ||
+        header.stack_depth != MTRACE_DUMP_DEPTH || records_off > dump_len) {
+        fprintf(stderr, "导出文件格式错误\n");
+        free(dump);
+        symtab_free(&st);
+        return 1;
+    }
+    const uint8_t *stacks = dump + stacks_off;
+    size_t record_count = (dump_len - records_off) / sizeof(mtrace_dump_record_t);
+    if (record_count < header.record_count) {
+        fprintf(stderr, "导出文件不完整: 应有 %u 条记录, 实际 %llu 条\n",
+                (unsigned)header.record_count, (unsigned long long)record_count);
+    } else {
+        record_count = header.record_count;
+    }
+
+    // 按 stack_id 直接索引汇总, 最后一个桶存放没有调用栈的记录
+    leak_t *leaks = (leak_t *)calloc((size_t)header.stack_count + 1, sizeof(leak_t));
+    if (leaks == NULL) {
+        free(dump);
+        symtab_free(&st);
+        return 1;
+    }
+    for (uint32_t i = 0; i <= header.stack_count; i++) {
+        leaks[i].stack_id = (i < header.stack_count) ? i : MTRACE_DUMP_NO_STACK;
+    }
+
+    uint64_t total_bytes = 0;
+    const uint8_t *rec = dump + records_off;
+    for (size_t i = 0; i < record_count; i++, rec += sizeof(mtrace_dump_record_t)) {
+        uint32_t size = rd32(rec + 4);
+        uint32_t stack_id = rd32(rec + 12);
+        leak_t *bucket = &leaks[(stack_id < header.stack_count) ? stack_id : header.stack_count];
+        bucket->blocks++;
+        bucket->bytes += size;
+        total_bytes += size;
+    }
+
+    qsort(leaks, (size_t)header.stack_count + 1, sizeof(leak_t), leak_cmp);
+
+    printf("=== Potential Memory Leaks ===\n");
+    printf("%llu live blocks, %llu bytes, %u unique call stacks, %llu symbols\n\n",
+           (unsigned long long)record_count, (unsigned long long)total_bytes,
+           (unsigned)header.stack_count, (unsigned long long)st.count);
+    if (header.stack_overflow != 0 || header.dropped_records != 0) {
+        printf("Tracker full: %u allocs without call stack (table %u/%u), %u allocs not tracked\n\n",
+               (unsigned)header.stack_overflow, (unsigned)header.stack_count,
+               (unsigned)header.max_stacks, (unsigned)header.dropped_records);
+    }
+
+    size_t shown = 0;
+    for (uint32_t i = 0; i <= header.stack_count && shown < top; i++) {
+        const leak_t *lk = &leaks[i];
+        if (lk->blocks == 0) {
+            continue;
+        }
+        printf("Leaked: %llu blocks, %llu bytes, allocated at:\n",
+               (unsigned long long)lk->blocks, (unsigned long long)lk->bytes);
+        if (lk->stack_id == MTRACE_DUMP_NO_STACK) {
+            printf("    (call stack not recorded)\n");
+        } else {
+            const uint8_t *sig = stacks + (size_t)lk->stack_id * sizeof(mtrace_dump_stack_t);
+            uint32_t depth = rd32(sig);
+            for (uint32_t f = 0; f < depth && f < MTRACE_DUMP_DEPTH; f++) {
+                print_frame(&st, (int)f, rd32(sig + 4 + f * 4));
+            }
+        }
+        printf("\n");
+        shown++;
+    }
+
+    free(leaks);
+    free(dump);
+    symtab_free(&st);
+    return 0;
+}
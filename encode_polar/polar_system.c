@@ -12,6 +12,7 @@
 // 预定义最大支持的配置，替代动态分配
 #define MAX_N 1024
 #define MAX_STAGES 10  // log2(MAX_N)
+#define MAX_WORDS (MAX_N / 64)  // 打包版: 每个 uint64_t 存 64 个比特
 
 // ==========================================
 // 1. 核心上下文结构体 (多维数组版)
@@ -20,8 +21,13 @@ typedef struct {
     int N;             
     int K;             
     int n_stages;      
-    int frozen_flag[MAX_N];  
-    
+    int frozen_flag[MAX_N];
+    // 信息位连续段 (升序): 打包编码器按段整块搬运消息比特, 不逐位散布
+    int n_info_runs;
+    int run_dst[MAX_N];      // 段起点在码字 u 中的下标
+    int run_src[MAX_N];      // 段起点在消息中的下标
+    int run_len[MAX_N];
+
     // SCL 多路径状态
     int active_paths;
     double path_metric[LIST_SIZE];
@@ -68,7 +74,22 @@ void init_polar_system(PolarContext *ctx, int N, int K) {
                 max_idx = i;
             }
         }
-        ctx->frozen_flag[max_idx] = 0; 
+        ctx->frozen_flag[max_idx] = 0;
+    }
+
+    int idx = 0;
+    ctx->n_info_runs = 0;
+    for (int i = 0; i < N; i++) {
+        if (ctx->frozen_flag[i] != 0) continue;
+        if (i > 0 && ctx->frozen_flag[i - 1] == 0) {
+            ctx->run_len[ctx->n_info_runs - 1]++;
+        } else {
+            ctx->run_dst[ctx->n_info_runs] = i;
+            ctx->run_src[ctx->n_info_runs] = idx;
+            ctx->run_len[ctx->n_info_runs] = 1;
+            ctx->n_info_runs++;
+        }
+        idx++;
     }
 }
 
@@ -124,6 +145,142 @@ void polar_encode(PolarContext *ctx, const int *message, int *x) {
     }
 }
 
+// ==========================================
+// 2.1 打包版 CRC 与 发射机编码 (发射热路径)
+//     比特布局: 第 i 比特存放在 w[i >> 6] 的第 (i & 63) 位
+//     输出与 int 版逐位一致, 译码端 check_crc 无需改动
+// ==========================================
+static uint16_t crc_byte_tab[256];   // 标准逐字节表: 一次查表 = 8 次移位
+static uint16_t crc_zero8_hi[256];   // 状态高字节经过 8 个零字节后的贡献
+static uint16_t crc_zero8_lo[256];   // 状态低字节经过 8 个零字节后的贡献
+static uint16_t crc_bits8_tab[256];  // 8 个比特(每比特当作一个字节 0/1)从零状态的贡献
+static int crc_tab_ready = 0;
+
+static uint16_t crc_step_byte(uint16_t crc, uint8_t byte) {
+    return (uint16_t)((crc << 8) ^ crc_byte_tab[(crc >> 8) ^ byte]);
+}
+
+static void crc_packed_init(void) {
+    if (crc_tab_ready) return;
+
+    for (int b = 0; b < 256; b++) {
+        uint16_t crc = (uint16_t)(b << 8);
+        for (int j = 0; j < 8; j++) {
+            if (crc & 0x8000) crc = (crc << 1) ^ CRC_POLY;
+            else crc <<= 1;
+        }
+        crc_byte_tab[b] = crc;
+    }
+
+    // CRC 对 (状态, 输入) 在 GF(2) 上线性, 8 个比特可拆成"状态推进"与"输入贡献"两部分查表
+    for (int v = 0; v < 256; v++) {
+        uint16_t hi = (uint16_t)(v << 8), lo = (uint16_t)v, in = 0;
+        for (int k = 0; k < 8; k++) {
+            hi = crc_step_byte(hi, 0);
+            lo = crc_step_byte(lo, 0);
+            in = crc_step_byte(in, (uint8_t)((v >> k) & 1));
+        }
+        crc_zero8_hi[v] = hi;
+        crc_zero8_lo[v] = lo;
+        crc_bits8_tab[v] = in;
+    }
+    crc_tab_ready = 1;
+}
+
+static uint16_t crc_packed_calc(const uint64_t *msg, int len) {
+    uint16_t crc = 0xFFFF;
+    int nbytes = len >> 3;
+
+    // 每次吃 8 个比特: 3 次查表代替 64 次移位
+    for (int m = 0; m < nbytes; m++) {
+        uint8_t v = (uint8_t)(msg[m >> 3] >> ((m & 7) * 8));
+        crc = crc_zero8_hi[crc >> 8] ^ crc_zero8_lo[crc & 0xFF] ^ crc_bits8_tab[v];
+    }
+    for (int i = nbytes << 3; i < len; i++) {
+        crc = crc_step_byte(crc, (uint8_t)((msg[i >> 6] >> (i & 63)) & 1));
+    }
+    return crc;
+}
+
+void append_crc_packed(const uint64_t *payload, int payload_len, uint64_t *output_msg) {
+    int total_words = (payload_len + 16 + 63) / 64;
+    int full_words = payload_len / 64;
+
+    crc_packed_init();
+    memcpy(output_msg, payload, full_words * sizeof(uint64_t));
+    memset(output_msg + full_words, 0, (total_words - full_words) * sizeof(uint64_t));
+    if (payload_len & 63) {
+        output_msg[full_words] = payload[full_words] & ((1ULL << (payload_len & 63)) - 1);
+    }
+
+    uint16_t crc = crc_packed_calc(payload, payload_len);
+    for (int i = 0; i < 16; i++) {
+        int pos = payload_len + i;
+        output_msg[pos >> 6] |= (uint64_t)((crc >> (15 - i)) & 1) << (pos & 63);
+    }
+}
+
+int check_crc_packed(const uint64_t *msg, int total_len) {
+    int payload_len = total_len - 16;
+
+    crc_packed_init();
+    uint16_t crc = crc_packed_calc(msg, payload_len);
+    for (int i = 0; i < 16; i++) {
+        int pos = payload_len + i;
+        if (((msg[pos >> 6] >> (pos & 63)) & 1) != (uint64_t)((crc >> (15 - i)) & 1)) return 0;
+    }
+    return 1;
+}
+
+void polar_encode_packed(PolarContext *ctx, const uint64_t *message, uint64_t *x) {
+    // 字内蝶形掩码: 第 s 级中 (p >> s) & 1 == 0 的位置需要异或上 p + 2^s
+    static const uint64_t in_word_mask[6] = {
+        0x5555555555555555ULL, 0x3333333333333333ULL, 0x0F0F0F0F0F0F0F0FULL,
+        0x00FF00FF00FF00FFULL, 0x0000FFFF0000FFFFULL, 0x00000000FFFFFFFFULL
+    };
+    int n_words = (ctx->N + 63) / 64;
+    int in_word_stages = (ctx->n_stages < 6) ? ctx->n_stages : 6;
+
+    int msg_words = (ctx->K + 63) / 64;
+
+    // 按信息位连续段搬运, 每次最多搬到目标字末尾
+    memset(x, 0, n_words * sizeof(uint64_t));
+    for (int r = 0; r < ctx->n_info_runs; r++) {
+        int dst = ctx->run_dst[r], src = ctx->run_src[r], len = ctx->run_len[r];
+        while (len > 0) {
+            int chunk = 64 - (dst & 63);
+            if (chunk > len) chunk = len;
+
+            uint64_t bits = message[src >> 6] >> (src & 63);
+            if ((src & 63) && (src >> 6) + 1 < msg_words) {
+                bits |= message[(src >> 6) + 1] << (64 - (src & 63));
+            }
+            if (chunk < 64) bits &= (1ULL << chunk) - 1;
+            x[dst >> 6] |= bits << (dst & 63);
+
+            dst += chunk; src += chunk; len -= chunk;
+        }
+    }
+
+    // stage 0..5: 移位 + 掩码, 一条指令完成 32 个蝶形
+    for (int stage = 0; stage < in_word_stages; stage++) {
+        int step = 1 << stage;
+        for (int w = 0; w < n_words; w++) {
+            x[w] ^= (x[w] >> step) & in_word_mask[stage];
+        }
+    }
+
+    // stage 6..n-1: 跨字蝶形, 整字异或
+    for (int stage = 6; stage < ctx->n_stages; stage++) {
+        int wstep = 1 << (stage - 6);
+        for (int i = 0; i < n_words; i += 2 * wstep) {
+            for (int j = 0; j < wstep; j++) {
+                x[i + j] ^= x[i + j + wstep];
+            }
+        }
+    }
+}
+
 // ==========================================
 // 3. 物理信道 (保持不变)
 // ==========================================
@@ -305,6 +462,42 @@ int main() {
     append_crc(raw_payload, payload_len, msg_with_crc);
     polar_encode(engine, msg_with_crc, x);
 
+    // 打包编码器: 与 int 版逐位比对, 并测量单次编码耗时
+    uint64_t payload_packed[MAX_WORDS] = {0};
+    uint64_t msg_packed[MAX_WORDS] = {0};
+    uint64_t x_packed[MAX_WORDS] = {0};
+    for (int i = 0; i < payload_len; i++) {
+        payload_packed[i >> 6] |= (uint64_t)raw_payload[i] << (i & 63);
+    }
+    append_crc_packed(payload_packed, payload_len, msg_packed);
+    polar_encode_packed(engine, msg_packed, x_packed);
+
+    int mismatch = !check_crc_packed(msg_packed, K);
+    for (int i = 0; i < K; i++) {
+        if ((int)((msg_packed[i >> 6] >> (i & 63)) & 1) != msg_with_crc[i]) mismatch++;
+    }
+    for (int i = 0; i < N; i++) {
+        if ((int)((x_packed[i >> 6] >> (i & 63)) & 1) != x[i]) mismatch++;
+    }
+
+    int loops = 20000;
+    clock_t t0 = clock();
+    for (int r = 0; r < loops; r++) {
+        append_crc(raw_payload, payload_len, msg_with_crc);
+        polar_encode(engine, msg_with_crc, x);
+    }
+    clock_t t1 = clock();
+    for (int r = 0; r < loops; r++) {
+        append_crc_packed(payload_packed, payload_len, msg_packed);
+        polar_encode_packed(engine, msg_packed, x_packed);
+    }
+    clock_t t2 = clock();
+    double us_int = (double)(t1 - t0) * 1e6 / CLOCKS_PER_SEC / loops;
+    double us_packed = (double)(t2 - t1) * 1e6 / CLOCKS_PER_SEC / loops;
+    printf("[0/3] 编码：打包版与 int 版比对 %s, CRC+编码 int %.2f us, 打包 %.2f us (x%.1f)\n",
+           mismatch ? "不一致" : "一致", us_int, us_packed,
+           us_packed > 0 ? us_int / us_packed : 0.0);
+
     double noise_std_dev = 0.85; 
     for (int i = 0; i < N; i++) {
         double y = ((x[i] == 0) ? 1.0 : -1.0) + generate_gaussian_noise(noise_std_dev);
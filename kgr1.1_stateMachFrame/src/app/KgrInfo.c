@@ -13,7 +13,11 @@
 #include <string.h>
 #include "KgrInfo.h"
 
+#ifndef ANTIJAM_HOST_MOCK
 #include "dev_manager.h"
+#endif
+#include "antijam_fpga.h"
+#include "zs_printf.h"
 
 
 #define	KGR_B1I_B1C_L1_M        1
@@ -23,6 +27,9 @@
 
 #define    KGR_SUB_BAND_CNT         (4)
 
+#define    KGR_BATCH_OPS            (128)   //Ĵ, дԶύ
+#define    KGR_FIR_READY_TIMEOUT    (10)    //FIR ϵؾȴʱ ms
+
 //#define KGRINFO_DBG    
 #define DBG_TAG    "KGRINFO"
 #ifdef KGRINFO_DBG
@@ -41,6 +48,9 @@ float previous_error = 0;
 int init_point = 0;
 unsigned char g_KgrFreqId = HW_KGR_LC_B1;
 
+static fpga_reg_op_t s_kgrBatchOps[KGR_BATCH_OPS];
+static fpga_batch_t  s_kgrBatch;
+
 
 void dx_dly_ms(unsigned int tempDealy)
 {
@@ -158,114 +168,149 @@ int weight_int2x_fix(int num)
 	}
 	return mcu_to_fpga_read_kgr_reg(87);
 }
+/*ύһĴ, ʱͻضһ»ܴӡһ*/
+static int kgr_batch_submit(fpga_batch_t *b, const char *name)
+{
+	int ret;
+
+	ret = fpga_batch_submit(b);
+	if (ret != DX_EOK)
+		dx_kprintf("%s: reg [%d] ready timeout\r\n", name, b->timeoutAddr);
+	if (b->verifyErr)
+		dx_kprintf("%s: %d reg mismatch, first reg [%d] 0x%x read 0x%x\r\n",
+			name, b->verifyErr, b->errAddr, b->errExpect, b->errRead);
+	return ret;
+}
 void weight_write(int addr, int* weight, int num)
 {
+	fpga_batch_t *b = &s_kgrBatch;
+	u32 coef, lo, hi;
 	//weight_fix(48);
 
+	fpga_batch_begin(b, s_kgrBatchOps, KGR_BATCH_OPS);
 	for (int i = 0; i < num; i++) {
-		mcu_to_fpga_write_kgr_reg(addr, ((weight[i] & 0x3ffff) | (i << 20) | (0 << 31)));
-		mcu_to_fpga_write_kgr_reg(addr, ((weight[i] & 0x3ffff) | (i << 20) | (1 << 31)));
-		mcu_to_fpga_write_kgr_reg(addr, ((weight[i] & 0x3ffff) | (0 << 31)));
+		coef = weight[i] & 0x3ffff;
+		lo = coef | (i << 20);
+		hi = coef | ((2 * num - 1 - i) << 20);
 
-		mcu_to_fpga_write_kgr_reg(addr, ((weight[i] & 0x3ffff) | ((2 * num - 1 - i) << 20) | (0 << 31)));
-		mcu_to_fpga_write_kgr_reg(addr, ((weight[i] & 0x3ffff) | ((2 * num - 1 - i) << 20) | (1 << 31)));
-		mcu_to_fpga_write_kgr_reg(addr, ((weight[i] & 0x3ffff) | ((2 * num - 1 - i) << 20) | (0 << 31)));
+		fpga_batch_write(b, addr, lo);
+		fpga_batch_write(b, addr, lo | (1u << 31));
+		fpga_batch_write(b, addr, coef);
+
+		fpga_batch_write(b, addr, hi);
+		fpga_batch_write(b, addr, hi | (1u << 31));
+		fpga_batch_write(b, addr, hi);
 	}
+	kgr_batch_submit(b, "weight write");
 
 }
 
-void ddc_config(int Fretmp)
+static void ddc_config_queue(fpga_batch_t *b, int Fretmp)
 {
 	unsigned int configtemp = 0;
 	double tempconfig = 0;
 	tempconfig = (double)Fretmp / 12400 * 4294967296.0;
 	configtemp = (unsigned int)tempconfig;
 	dx_kprintf("ddc config 0x%x %d %lf\r\n", configtemp,configtemp,tempconfig);
-	mcu_to_fpga_write_kgr_reg(143, (unsigned int)configtemp);
+	fpga_batch_write(b, 143, (unsigned int)configtemp);
+}
+void ddc_config(int Fretmp)
+{
+	fpga_batch_begin(&s_kgrBatch, s_kgrBatchOps, KGR_BATCH_OPS);
+	ddc_config_queue(&s_kgrBatch, Fretmp);
+	kgr_batch_submit(&s_kgrBatch, "ddc config");
+}
+static void subBandNum_queue(fpga_batch_t *b, unsigned int numVal)
+{
+	//bit 16 17 18 óӴ
+	fpga_batch_rmw(b, 129, 0x00070000, (numVal & 0x7) << 16);
 }
 int subBandNum_set(unsigned int numVal)
 {
-
-	unsigned int setVal;
-	setVal = mcu_to_fpga_read_kgr_reg(129); //Ĵ޸
-	setVal = setVal & (0xFFF8FFFF); //bit 16 17 18 ó
-	setVal = setVal | ((numVal & 0x7) << 16);
-	mcu_to_fpga_write_kgr_reg(129, setVal);
-	return  0;
+	fpga_batch_begin(&s_kgrBatch, s_kgrBatchOps, KGR_BATCH_OPS);
+	subBandNum_queue(&s_kgrBatch, numVal);
+	return kgr_batch_submit(&s_kgrBatch, "subband num");
 
 }
 
 void PLfpga_filter_config(int addr, int* weight, int num)
 {
-	u32 fir_ready_status = 0;
+	fpga_batch_t *b = &s_kgrBatch;
 	unsigned int i = 0;
-	mcu_to_fpga_write_kgr_reg(addr, 0);
-	mcu_to_fpga_write_kgr_reg(addr + 1, (0 << 8) | 0x0);
+	u32 coef;
 
-	int tempVal = 0;
-	u32* ptempVal1 = 0;
-	u32 tempVal2 = 0;
-	u32 tempVal3 = 0;
+	fpga_batch_begin(b, s_kgrBatchOps, KGR_BATCH_OPS);
+	fpga_batch_write(b, addr, 0);
+	fpga_batch_write(b, addr + 1, (0 << 8) | 0x0);
 
-	ptempVal1 = &tempVal;
 	for (i = 0; i < num; i++)
 	{
 		/*reload data*/
-		/*д׼*/
-		fir_ready_status = mcu_to_fpga_read_kgr_reg(addr);
-		while (((fir_ready_status >> 2) && 0x1) == 0)
-		{
-			fir_ready_status = mcu_to_fpga_read_kgr_reg(addr);
-		}
-
-		tempVal = weight[i];
-
-		tempVal2 = *ptempVal1;
-		tempVal3 = ((tempVal2 & 0xFFFFFF) << 8);
-
-		mcu_to_fpga_write_kgr_reg(addr, (tempVal3 | (0x1)));
-		mcu_to_fpga_write_kgr_reg(addr, (tempVal3 & (0xFFFFFFFE)));
-
-		tempVal2 = mcu_to_fpga_read_kgr_reg(addr);
-		if((tempVal3+4)!=(tempVal2))
-		dx_kprintf("reg [%d] 0x%x read 0x%x\r\n", addr, tempVal3, tempVal2);
+		/*д׼ bit2*/
+		fpga_batch_wait(b, addr, 0x4, 0x4, KGR_FIR_READY_TIMEOUT);
 
+		coef = ((u32)weight[i] & 0xFFFFFF) << 8;
+		fpga_batch_write(b, addr, coef | 0x1);
+		fpga_batch_write(b, addr, coef);
 
+		/*ضӦΪϵӾλ, һύܴӡ*/
+		fpga_batch_check(b, addr, 0xFFFFFFFF, coef + 4);
 	}
-	dx_kprintf("XILINX fir reload data write done \r\n");
 
-	/*ϵдִconfig valid*/
-	fir_ready_status = mcu_to_fpga_read_kgr_reg(addr + 1);
-	while (((fir_ready_status >> 1) && 0x1) == 0)
-	{
-		fir_ready_status = mcu_to_fpga_read_kgr_reg(addr + 1);
-	}
+	/*ϵдִconfig valid, ȴ bit1*/
+	fpga_batch_wait(b, addr + 1, 0x2, 0x2, KGR_FIR_READY_TIMEOUT);
+	fpga_batch_delay(b, 1);
+	fpga_batch_write(b, addr + 1, (0 << 8) | 0x1);
+	fpga_batch_write(b, addr + 1, 0);
 
-	dx_dly_ms(1);
-	mcu_to_fpga_write_kgr_reg(addr + 1, (0 << 8) | 0x1);
-	mcu_to_fpga_write_kgr_reg(addr + 1, 0);
-	dx_kprintf("XILINX fir config write done \r\n");
+	if (kgr_batch_submit(b, "XILINX fir") == DX_EOK)
+		dx_kprintf("XILINX fir config write done \r\n");
 
 }
-void subBandDdc_freqconfig(int Fre, unsigned int subBandNum)
+static void subBandDdc_freqqueue(fpga_batch_t *b, int Fre, unsigned int subBandNum)
 {
 	int config = 0;
 	config = (double)((double)Fre / (SECONDE_DESC_LO) * 4294967296);
-	mcu_to_fpga_write_kgr_reg(61 + subBandNum, (((int)config)));
+	fpga_batch_write(b, 61 + subBandNum, (((int)config)));
+}
+void subBandDdc_freqconfig(int Fre, unsigned int subBandNum)
+{
+	fpga_batch_begin(&s_kgrBatch, s_kgrBatchOps, KGR_BATCH_OPS);
+	subBandDdc_freqqueue(&s_kgrBatch, Fre, subBandNum);
+	kgr_batch_submit(&s_kgrBatch, "subband ddc");
+}
+static void subBandDiv_enable_queue(fpga_batch_t *b)
+{
+	//ԴΪ1
+	subBandNum_queue(b, KGR_SUB_BAND_CNT - 1);
+
+	//ر·
+	//رddc·,д0ر·д1·
+	fpga_batch_rmw(b, 60, 0x80000000, 0);
+
+	//رӴȡ˲·,д0ر·д1·
+	fpga_batch_rmw(b, 65, 0x1, 0);
+
+	//رӴֵ˲·,д0ر·д1·
+	fpga_batch_rmw(b, 67, 0x80000000, 0);
+
+	//رudc·,д0ر·д1·
+	fpga_batch_write(b, 69, 0);
 }
 void weight_Set()
 {
-	unsigned int setVal;
+	fpga_batch_t *b = &s_kgrBatch;
 
+	fpga_batch_begin(b, s_kgrBatchOps, KGR_BATCH_OPS);
 
 	switch (g_KgrFreqId)
 	{
 	case HW_KGR_LC_B3:
 	{
 		Ch_set = 0;
-		ddc_config(4652);
-		subBandDdc_freqconfig(4000, 0);
-		subBandDdc_freqconfig(-4000, 1);
+		ddc_config_queue(b, 4652);
+		subBandDdc_freqqueue(b, 4000, 0);
+		subBandDdc_freqqueue(b, -4000, 1);
 
 
 		////weight_write(148,gFilter_coef[0],LPF1_LPF4_NUM);
@@ -282,17 +327,17 @@ void weight_Set()
 	case HW_KGR_LC_B1:
 	{
 		//1561.098   1575.42    31.098    35.19    39.282   45.42   51.558   
-		ddc_config(9300);//һ
+		ddc_config_queue(b, 9300);//һ
 		//subBandDdc_freqconfig(-20500,0); //[-20.5e6 -7.58e6 19e6];
 		//subBandDdc_freqconfig(-9000,1);
 		//subBandDdc_freqconfig(19000,2);
 
-		subBandDdc_freqconfig(-21902, 0); //[-20.5e6 -7.58e6 19e6];
-		subBandDdc_freqconfig(-7580, 1);
-		subBandDdc_freqconfig(17000, 2);
-		subBandDdc_freqconfig(21000, 3);
-		subBandDdc_freqconfig(-16902, 133);
-		subBandDdc_freqconfig(-2580, 134);
+		subBandDdc_freqqueue(b, -21902, 0); //[-20.5e6 -7.58e6 19e6];
+		subBandDdc_freqqueue(b, -7580, 1);
+		subBandDdc_freqqueue(b, 17000, 2);
+		subBandDdc_freqqueue(b, 21000, 3);
+		subBandDdc_freqqueue(b, -16902, 133);
+		subBandDdc_freqqueue(b, -2580, 134);
 
 
 		//ddc_config(3110);
@@ -313,55 +358,41 @@ void weight_Set()
 	}
 
 	//ýλСΪ206-10:Ĭֵ޸Ϊ300 Ӵȡλ
-	setVal = mcu_to_fpga_read_kgr_reg(65);
-	setVal = setVal | (0x200);
-	mcu_to_fpga_write_kgr_reg(65, setVal);
+	fpga_batch_rmw(b, 65, 0x200, 0x200);
 
 	//ýλСΪ206-10:Ĭֵ޸Ϊ3 Ӵֵλ
-	setVal = mcu_to_fpga_read_kgr_reg(67);
-	setVal = setVal | (0x4);
-	mcu_to_fpga_write_kgr_reg(67, setVal);
+	fpga_batch_rmw(b, 67, 0x4, 0x4);
 
 
-	//ʹƵʿ
-	setVal = mcu_to_fpga_read_kgr_reg(60);
-	setVal = setVal & (0xFFFFFFFE);
-	mcu_to_fpga_write_kgr_reg(60, setVal);
-	dx_dly_ms(1);
-	setVal = mcu_to_fpga_read_kgr_reg(60);
-	setVal = setVal | (0x1);
-	mcu_to_fpga_write_kgr_reg(60, setVal);
-	dx_dly_ms(1);
-	setVal = mcu_to_fpga_read_kgr_reg(60);
-	setVal = setVal & (0xFFFFFFFE);
-	mcu_to_fpga_write_kgr_reg(60, setVal);
+	//ʹƵʿ: bit0 0->1->0, ÿƽ 1ms, Ĵ 60 ֻضһ
+	fpga_batch_rmw(b, 60, 0x1, 0);
+	fpga_batch_delay(b, 1);
+	fpga_batch_rmw(b, 60, 0x1, 1);
+	fpga_batch_delay(b, 1);
+	fpga_batch_rmw(b, 60, 0x1, 0);
 
-	mcu_to_fpga_write_kgr_reg(131, 0x8600); //ĬϴڵˢƵ
+	fpga_batch_write(b, 131, 0x8600); //ĬϴڵˢƵ
 
 
 	//ԴΪ
-	subBandNum_set(KGR_SUB_BAND_CNT - 1);
+	subBandNum_queue(b, KGR_SUB_BAND_CNT - 1);
+
+	subBandDiv_enable_queue(b);
+	kgr_batch_submit(b, "weight set");
 
-	subBandDiv_enable();
+	//³ʼȨ
+	Weight_load_init();
 
 }
 unsigned int gSjrSetLenIndex = 0;
 int stap_sjr_length_set(int setLenIndex)
 {
-	unsigned int tmpSetVal = 0;
-
 	gSjrSetLenIndex = setLenIndex;
 
-	//üĴֵض
-	tmpSetVal = mcu_to_fpga_read_kgr_reg(156);
-	tmpSetVal = tmpSetVal & 0xFFFFFFF8;
-
-	//üĴֵֵ
-	tmpSetVal = tmpSetVal | (setLenIndex & 0x7);
-	dx_kprintf("set 0x%x \r\n", tmpSetVal);
-
-	//ֵֵĴ
-	mcu_to_fpga_write_kgr_reg(156, tmpSetVal);
+	//[2:0] ͳƳ, 156 ΪɻĴ, ض
+	kgr_reg_field(FPGA_STAP_SJR_CTRL_REG, 0x7, setLenIndex);
+	kgr_reg_flush();
+	dx_kprintf("set 0x%x \r\n", mcu_to_fpga_read_kgr_reg(FPGA_STAP_SJR_CTRL_REG));
 
 
 	return 0;
@@ -402,18 +433,9 @@ int stap_sjr_refresh_time(int ustime)
 }
 int stap_sjr_enable(int setenable)
 {
-	unsigned int tmpSetVal = 0;
-
-
-	//üĴֵض
-	tmpSetVal = mcu_to_fpga_read_kgr_reg(156);
-	tmpSetVal = tmpSetVal & 0x7FFFFFFF;
-
-	//üĴֵֵ
-	tmpSetVal = tmpSetVal | ((setenable & 0x1) << 31);
-
-	//ֵֵĴ
-	mcu_to_fpga_write_kgr_reg(156, tmpSetVal);
+	//[31] ͳʹ
+	kgr_reg_field(FPGA_STAP_SJR_CTRL_REG, 0x80000000, (u32)(setenable & 0x1) << 31);
+	kgr_reg_flush();
 
 
 	return 0;
@@ -492,26 +514,19 @@ void subBandWeight_set(unsigned int subBanNum, unsigned int setFlag)
 }
 void subBandDiv_bypass()
 {
-	unsigned int setVal;
 	//ԴΪ1
 	subBandNum_set(KGR_SUB_BAND_CNT - 1);
 
 	//·
 	//ddc·,д0ر·д1·
-	setVal = mcu_to_fpga_read_kgr_reg(60);
-
-	setVal = setVal | (0x80000000);
-	mcu_to_fpga_write_kgr_reg(60, setVal);
+	kgr_reg_set_bits(60, 0x80000000);
 
 	//Ӵȡ˲·,д0ر·д1·
-	setVal = mcu_to_fpga_read_kgr_reg(65);
-	setVal = setVal | (0x1);
-	mcu_to_fpga_write_kgr_reg(65, setVal);
+	kgr_reg_set_bits(65, 0x1);
 
 	//Ӵֵ˲·,д0ر·д1·
-	setVal = mcu_to_fpga_read_kgr_reg(67);
-	setVal = setVal | (0x80000000);
-	mcu_to_fpga_write_kgr_reg(67, setVal);
+	kgr_reg_set_bits(67, 0x80000000);
+	kgr_reg_flush();
 
 	//udc·,д0ر·д1·
 	mcu_to_fpga_write_kgr_reg(69, 1);
@@ -582,28 +597,9 @@ void StapMatrixNew_init()
 }
 void subBandDiv_enable()
 {
-	unsigned int setVal = 0;
-	//ԴΪ1
-	subBandNum_set(KGR_SUB_BAND_CNT - 1);
-
-	//ر·
-	//رddc·,д0ر·д1·
-	setVal = mcu_to_fpga_read_kgr_reg(60);
-	setVal = setVal & (0x7FFFFFFF);
-	mcu_to_fpga_write_kgr_reg(60, setVal);
-
-	//رӴȡ˲·,д0ر·д1·
-	setVal = mcu_to_fpga_read_kgr_reg(65);
-	setVal = setVal & (0xFFFFFFFE);
-	mcu_to_fpga_write_kgr_reg(65, setVal);
-
-	//رӴֵ˲·,д0ر·д1·
-	setVal = mcu_to_fpga_read_kgr_reg(67);
-	setVal = setVal & (0x7FFFFFFF);
-	mcu_to_fpga_write_kgr_reg(67, setVal);
-
-	//رudc·,д0ر·д1·
-	mcu_to_fpga_write_kgr_reg(69, 0);
+	fpga_batch_begin(&s_kgrBatch, s_kgrBatchOps, KGR_BATCH_OPS);
+	subBandDiv_enable_queue(&s_kgrBatch);
+	kgr_batch_submit(&s_kgrBatch, "subband enable");
 	//³ʼȨ
 	Weight_load_init();
 }
@@ -730,10 +726,9 @@ void Collect()
 /**********************************************/
 void Weight_hand_write_tst( )
 {
-	u32 u32Regs1,u32Regs2;
+	u32 u32Regs1;
 	u32Regs1 = mcu_to_fpga_read_kgr_reg(132);
 	mcu_to_fpga_write_kgr_reg(132,u32Regs1|(1<<8));
-	u32Regs2 = mcu_to_fpga_read_kgr_reg(132);
 
 	mcu_to_fpga_write_kgr_reg(134,65536);
 	mcu_to_fpga_write_kgr_reg(135,0);
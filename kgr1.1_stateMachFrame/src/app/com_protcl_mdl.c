@@ -14,6 +14,7 @@
 #include "shell.h"
 
 #include "antijam_fpga.h"
+#include "uart_service.h"
 
 
 #include "com_protcl_mdl.h"
@@ -21,142 +22,229 @@
 #include "string.h"
 #include "xparameters.h"
 
+#define AD_CAPTURE_TIMEOUT_MS	(100)	//ȴɼĳʱʱ
+#define AD_SAM_CTRL_REG			(100)
+#define AD_SAM_RUN_BIT			((u32)(1)<<21)
+
+/*ƹһ״̬*/
+#define AD_BUF_FREE				0
+#define AD_BUF_READY			1	//, ȴ
+#define AD_BUF_SENDING			2	//жڴȡ
+
+extern uint32_t tick_get(void);
+
 /*
-*ƣ com_data_ad_head_send()
-*ܣ AD֡ͷ
-*                    
-*			samNum: ݵ
-*			chnNum: ͨ
-*			signlebytnum: ֽڳȣ
-*			totalpackgCnt: ܰ
-*			curpackgCnt: ǰ
-*			
-*ֵ   
-*			0: ݷͳɹ
-*			1: ݷʧ
-**********************************
+*ADݷ״̬: ֡ƹʹ, һɷжȡʱ, ѭһһ
 */
-static unsigned char gSendBufText[64];
-static int com_data_ad_head_send(unsigned int samNum,unsigned int chnNum,
-									unsigned int signlebytnum,
-									unsigned int totalpackgCnt,
-									unsigned curpackgCnt)
+typedef struct
+{
+	u32 buf[2][AD_FRAME_LEN / 4];	//ֶ, ֱӶ
+	u8  state[2];
+	u8  fill;						//һĻ
+	u8  send;						//һ͵Ļ
+	u8  active;
+	u16 total;						//ܰ
+	u16 next;						//һҪİ
+	u32 capId;						//ɼ
+	u32 samCtrl;
+	void (*done)(int status);
+}ad_stream_t;
+
+static ad_stream_t s_adStream;
+
+/*CRC-32 (ʽ 0xEDB88320), ֽڲ, ֻ 16 */
+static const u32 s_crc32Nibble[16] =
+{
+	0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+	0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+	0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+	0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+static u32 com_crc32_update(u32 crc, const u8 *data, u32 len)
 {
+	u32 i;
 
-	unsigned char sizeBuf = 0;
-	unsigned char i;
-	//аͷݷ
-	sprintf(gSendBufText,"%s,%d,%d,%d,%d,%d,",AD_DATA_TRANS_HEAD,signlebytnum,
-		totalpackgCnt,
-		curpackgCnt,
-		samNum,
-		chnNum);
-	sizeBuf = strlen(gSendBufText);
-	for(i = 0;i < sizeBuf ; i++)
+	for (i = 0; i < len; i++)
 	{
-		XUartLite_SendByte(XPAR_UARTLITE_0_BASEADDR,gSendBufText[i]);
+		crc ^= data[i];
+		crc = (crc >> 4) ^ s_crc32Nibble[crc & 0xF];
+		crc = (crc >> 4) ^ s_crc32Nibble[crc & 0xF];
 	}
+	return crc;
+}
 
-	return 0;
-	
+static void com_put16(u8 *p, u16 v)
+{
+	p[0] = (u8)v;
+	p[1] = (u8)(v >> 8);
 }
 
+static void com_put32(u8 *p, u32 v)
+{
+	p[0] = (u8)v;
+	p[1] = (u8)(v >> 8);
+	p[2] = (u8)(v >> 16);
+	p[3] = (u8)(v >> 24);
+}
 
 /*
-*ƣ com_data_ad_end_send()
-*ܣ AD֡β
-*                    
-*			checksum: У
-*			
-*ֵ   
-*			0: ݷͳɹ
-*			1: ݷʧ
+*ƣ com_data_ad_frame_fill()
+*ܣ Ӳɼһݵ֡, д֡ͷ CRC
 **********************************
 */
-static int com_data_ad_end_send(unsigned short checksum)
+static void com_data_ad_frame_fill(ad_stream_t *s, u32 *frame, u16 pkg)
 {
-	unsigned char tempBuf[64];
+	u8 *p = (u8 *)frame;
+	u32 crc;
+
+	p[0] = AD_FRAME_SYNC0;
+	p[1] = AD_FRAME_SYNC1;
+	p[2] = AD_FRAME_SYNC2;
+	p[3] = AD_FRAME_SYNC3;
+	p[4] = AD_FRAME_VERSION;
+	p[5] = AD_FRAME_HDR_LEN;
+	com_put16(p + 6, AD_FRAME_PAYLOAD);
+	com_put32(p + 8, s->capId);
+	com_put16(p + 12, pkg);
+	com_put16(p + 14, s->total);
+	com_put32(p + 16, s->samCtrl);
+	com_put32(p + 20, tick_get());
+
+	mcu_to_fpga_read_kgr_block(ANTI4B3_SAM_ADDR_BASE + (u32)pkg * (AD_FRAME_PAYLOAD / 4),
+		frame + AD_FRAME_HDR_LEN / 4, AD_FRAME_PAYLOAD / 4);
+
+	crc = com_crc32_update(0xFFFFFFFF, p, AD_FRAME_HDR_LEN + AD_FRAME_PAYLOAD);
+	com_put32(p + AD_FRAME_HDR_LEN + AD_FRAME_PAYLOAD, ~crc);
+}
 
-	//аͷݷ
-	dx_kprintf("0x%x,0x0D0A\r\n",checksum);
+/*
+*ƣ com_data_ad_poll()
+*ܣ շĻ, л, һ֡; ȫ done
+*			жϷһ֡ỽѭ
+**********************************
+*/
+void com_data_ad_poll(void)
+{
+	ad_stream_t *s = &s_adStream;
+	void (*done)(int status);
 
-	return 0;
-	
-}									
+	if (!s->active)
+	{
+		return;
+	}
+
+	if (s->state[s->send] == AD_BUF_SENDING && !UartDbgTxBlockBusy())
+	{
+		s->state[s->send] = AD_BUF_FREE;
+		s->send ^= 1;
+	}
+	if (s->state[s->send] == AD_BUF_READY && UartDbgTxBlock((u8 *)s->buf[s->send], AD_FRAME_LEN) == 0)
+	{
+		s->state[s->send] = AD_BUF_SENDING;
+	}
+
+	//һ֡ڷʱһһ
+	while (s->state[s->fill] == AD_BUF_FREE && s->next < s->total)
+	{
+		com_data_ad_frame_fill(s, s->buf[s->fill], s->next++);
+		s->state[s->fill] = AD_BUF_READY;
+		s->fill ^= 1;
+	}
+
+	if (s->state[s->send] == AD_BUF_READY && UartDbgTxBlock((u8 *)s->buf[s->send], AD_FRAME_LEN) == 0)
+	{
+		s->state[s->send] = AD_BUF_SENDING;
+	}
 
+	if (s->next >= s->total && s->state[0] == AD_BUF_FREE && s->state[1] == AD_BUF_FREE)
+	{
+		s->active = 0;
+		done = s->done;
+		s->done = NULL;
+		if (done)
+		{
+			done(0);
+		}
+	}
+}
+
+int com_data_ad_busy(void)
+{
+	return s_adStream.active;
+}
 
 /*
-*ƣ com_data_ad_send()
-*ܣ ADݷ
+*ƣ com_data_ad_stream_start()
+*ܣ ȴɼADݷ, ֡ѭ com_data_ad_poll 
 *                    
-*			samNum: ݵ
-*			chnNum: ͨ
+*			tmptotalpackgCnt: ܰ
+*			done: ȫĻص, Ϊ NULL
 *			
 *ֵ   
-*			0: ݷͳɹ
-*			1: ݷʧ
+*			0: ѿʼ
+*			1: һηδɻɼδ
 **********************************
 */
-int com_data_ad_send(unsigned int tmptotalpackgCnt)
+int com_data_ad_stream_start(unsigned int tmptotalpackgCnt, void (*done)(int status))
 {
-	unsigned int tmpsignleByte;
-	unsigned int tmpcurrentCnt;
-	unsigned int i,j;
+	ad_stream_t *s = &s_adStream;
 	u32 u32SamCtrlReg;
-	u32 u32SamData  ;
-	u32 u32SamData1[4]  ;
-	u8 * pu8databuf;
-	u16 * pu16databuf;
-	u16 crcchecksum = 0;
-	float tmpTemp;
-
-	//
-	pu8databuf = &u32SamData;
-	pu16databuf = &u32SamData;
-	tmpsignleByte = 2*8*32; 	//512ֽڣ
-	u32SamCtrlReg = mcu_to_fpga_read_kgr_reg(100);
-
-	while((u32SamCtrlReg &((u32)(1)<<21)))
+	u32 start;
+
+	if (s->active)
 	{
-		u32SamCtrlReg = mcu_to_fpga_read_kgr_reg(100);
+		dx_kprintf("$JAMRG,busy,0x0D0A \r\n");
+		return 1;
 	}
 
-		//аͷݷ
-	dx_kprintf("$JAMRG,0x%x,0x0D0A \r\n",u32SamCtrlReg);
-
-	for(i = 0; i < tmptotalpackgCnt;  i++)
+	//ȴɼ, ʱ
+	start = tick_get();
+	u32SamCtrlReg = mcu_to_fpga_read_kgr_reg(AD_SAM_CTRL_REG);
+	while (u32SamCtrlReg & AD_SAM_RUN_BIT)
 	{
-		com_data_ad_head_send(0,0,tmpsignleByte,tmptotalpackgCnt,i);
-		for(j = 0;j < tmpsignleByte/4;j++)
+		if (tick_get() - start > AD_CAPTURE_TIMEOUT_MS)
 		{
-			u32SamData = mcu_to_fpga_read_kgr_reg(ANTI4B3_SAM_ADDR_BASE + i*tmpsignleByte/4 + j);
-			crcchecksum = crcchecksum^pu16databuf[0];
-			crcchecksum = crcchecksum^pu16databuf[1];
-			outbyte(pu8databuf[0]);
-			outbyte(pu8databuf[1]);
-			outbyte(pu8databuf[2]);
-			outbyte(pu8databuf[3]);
-
-			
+			dx_kprintf("$JAMRG,timeout,0x%x,0x0D0A \r\n", u32SamCtrlReg);
+			return 1;
 		}
-		com_data_ad_end_send(crcchecksum);
-		
+		u32SamCtrlReg = mcu_to_fpga_read_kgr_reg(AD_SAM_CTRL_REG);
 	}
-#if 0
 
-	for(int i=0;i<2048;i++)
-	{
-		for (int j=0; j<4; j++)
-		{
-			u32SamData1[j] = mcu_to_fpga_read_kgr_reg(ANTI4B3_SAM_ADDR_BASE + i*4 + j);
-		}
-		dx_kprintf("%d %d %d %d %d %d %d %d\r\n",
-				(short)(u32SamData1[0]&0xffff), (short) ((u32SamData1[0]>>16)&0xffff) ,
-				(short)(u32SamData1[1]&0xffff), (short) ((u32SamData1[1]>>16)&0xffff) ,
-				(short)(u32SamData1[2]&0xffff), (short) ((u32SamData1[2]>>16)&0xffff) ,
-				(short)(u32SamData1[3]&0xffff), (short) ((u32SamData1[3]>>16)&0xffff)) ;
+		//аͷݷ
+	dx_kprintf("$JAMRG,0x%x,0x0D0A \r\n",u32SamCtrlReg);
 
+	if (tmptotalpackgCnt > 0xFFFF)
+	{
+		tmptotalpackgCnt = 0xFFFF;
 	}
-#endif
-	
+	s->state[0] = AD_BUF_FREE;
+	s->state[1] = AD_BUF_FREE;
+	s->fill = 0;
+	s->send = 0;
+	s->total = (u16)tmptotalpackgCnt;
+	s->next = 0;
+	s->capId++;
+	s->samCtrl = u32SamCtrlReg;
+	s->done = done;
+	//һ֡ڱ (ʾ) ֮ѭ
+	s->active = 1;
+
+	return 0;
+}
+
+/*
+*ƣ com_data_ad_send()
+*ܣ ADݷ
+*                    
+*			tmptotalpackgCnt: ܰ
+*			
+*ֵ   
+*			0: ѿʼ
+*			1: һηδɻɼδ
+**********************************
+*/
+int com_data_ad_send(unsigned int tmptotalpackgCnt)
+{
+	return com_data_ad_stream_start(tmptotalpackgCnt, NULL);
 }
@@ -32,6 +32,7 @@
 #include "rf_rx1922.h"
 #include "pll_adf4351.h"
 #include "adc_mt9653.h"
+#include "gpio_spi.h"
 
 void ShellInit(void);
 int timerInit(void);
@@ -130,6 +131,7 @@ void PreDevManagerInit(void)
 	module_version_printf();
 
 	timerInit();
+	gpio_spi_calibrate();								//ʱ궨ģSPIʱ, Ƶ/PLL/ADCʼ֮ǰ
     ShellInit();
 #if 1
     rx1922_init();										//Ƶʼ
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2020-2025, ZS Development Team
+ *
+ * @file jam_detect.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author        Notes
+ * 2026-10-19     zs           the first version
+ */
+#include <math.h>
+#include <string.h>
+#include "jam_detect.h"
+
+#define JAM_DET_LEVEL_ALPHA     (1.0f / 8)  //ڼָоõ z ʱֵȨ
+#define JAM_DET_OUTLIER_SIGMA   (4.0f)      //z ֵĵ㲻ѧϰ
+
+void jam_detect_cfg_default(jam_detect_cfg_t *cfg)
+{
+    cfg->chanNum = JAM_DET_CH_MAX;
+    cfg->alpha = 1.0f / 64;
+    cfg->drift = 1.0f;
+    cfg->limit = 10.0f;
+    cfg->releaseSigma = 2.0f;
+    cfg->minSigma = 1.0f;
+    cfg->absThreshold = 0;
+    cfg->warmupSamples = 64;
+    cfg->onHoldMs = 20;
+    cfg->offHoldMs = 1000;
+}
+
+void jam_detect_init(jam_detect_t *d, const jam_detect_cfg_t *cfg)
+{
+    memset(d, 0, sizeof(*d));
+    d->cfg = *cfg;
+    if (d->cfg.chanNum > JAM_DET_CH_MAX) {
+        d->cfg.chanNum = JAM_DET_CH_MAX;
+    }
+    d->alarmCh = -1;
+}
+
+void jam_detect_set_cfg(jam_detect_t *d, const jam_detect_cfg_t *cfg)
+{
+    if (cfg->chanNum != d->cfg.chanNum) {
+        jam_detect_init(d, cfg);
+        return;
+    }
+    d->cfg = *cfg;
+}
+
+/*
+ * ߸: ѧϰڼ䰴ȡƽ (Ȩ 1/n, ), ֮ alpha ָȨ.
+ *  EWMA ʽ var = (1 - a) * (var + a * d^2), Ҫʷ.
+ */
+static void jam_det_learn(jam_det_chan_t *c, float x, float a)
+{
+    float diff = x - c->mean;
+
+    c->mean += a * diff;
+    c->var = (1.0f - a) * (c->var + a * diff * diff);
+}
+
+int jam_detect_update(jam_detect_t *d, const int32_t *power, uint32_t now)
+{
+    const jam_detect_cfg_t *cfg = &d->cfg;
+    int warm = d->samples >= cfg->warmupSamples;
+    float a = warm ? cfg->alpha : 1.0f / (float)(d->samples + 1);
+    float minVar = cfg->minSigma * cfg->minSigma;
+    float best = 0;
+    uint8_t alarm = 0;
+    int i;
+
+    d->alarmCh = -1;
+    for (i = 0; i < cfg->chanNum; i++) {
+        jam_det_chan_t *c = &d->ch[i];
+        float x = (float)power[i];
+        int hit = cfg->absThreshold > 0 && x > cfg->absThreshold;
+        int outlier = 0;
+
+        if (warm) {
+            float var = c->var > minVar ? c->var : minVar;
+            float z = (x - c->mean) / sqrtf(var);
+            float s = c->cusum + z - cfg->drift;
+
+            if (s < 0) {
+                s = 0;
+            } else if (s > 2 * cfg->limit) {
+                s = 2 * cfg->limit;
+            }
+            c->cusum = s;
+            c->level += JAM_DET_LEVEL_ALPHA * (z - c->level);
+            outlier = z > JAM_DET_OUTLIER_SIGMA;
+            // δȷϸʱ CUSUM 澯; ȷϺ z ĶʱֵжǷָ,
+            // ܸͨĻֹͣڼ, ʵĻƯʹ CUSUM ޷
+            if (d->jammed ? c->level > cfg->releaseSigma : s > cfg->limit) {
+                hit = 1;
+            }
+        }
+        if (hit) {
+            alarm = 1;
+            if (d->alarmCh < 0 || c->cusum > best) {
+                best = c->cusum;
+                d->alarmCh = (int8_t)i;
+            }
+        } else if (!outlier) {
+            // ֻδ澯ҲȺ», ڼѻָͨճ
+            jam_det_learn(c, x, a);
+        }
+    }
+    d->samples++;
+
+    if (alarm != d->alarm) {
+        d->alarm = alarm;
+        d->edgeTick = now;
+    }
+    if (!d->jammed && alarm && now - d->edgeTick >= cfg->onHoldMs) {
+        d->jammed = 1;
+        d->changeTick = now;
+        d->onsetCount++;
+        return JAM_DET_ONSET;
+    }
+    if (d->jammed && !alarm && now - d->edgeTick >= cfg->offHoldMs) {
+        d->jammed = 0;
+        d->changeTick = now;
+        for (i = 0; i < cfg->chanNum; i++) {
+            d->ch[i].cusum = 0;
+        }
+        return JAM_DET_CLEAR;
+    }
+    return JAM_DET_NONE;
+}
+
+float jam_detect_level(const jam_detect_t *d, int *ch)
+{
+    float best = 0;
+    int i, idx = 0;
+
+    for (i = 0; i < d->cfg.chanNum; i++) {
+        if (d->ch[i].cusum > best) {
+            best = d->ch[i].cusum;
+            idx = i;
+        }
+    }
+    if (ch != NULL) {
+        *ch = idx;
+    }
+    return best;
+}
@@ -12,6 +12,7 @@
 #include "KgrInfo.h"
 #include "sys_ctrl.h"
 #include "sleep.h"
+#include "jam_detect.h"
 
 extern unsigned char g_ublox_bd21_uartTransmit;
 #if 1
@@ -1088,6 +1089,7 @@ float gBeforeSJRvalThreshold = 100000;
 *
 *
 */
+void JamDetectEnable(unsigned char en);
 void testset_debug_sjr(unsigned int flagtmp,unsigned int jamDenflag,unsigned int mstime)
 {
 	unsigned int tmpval = 0;
@@ -1096,7 +1098,7 @@ void testset_debug_sjr(unsigned int flagtmp,unsigned int jamDenflag,unsigned int
 
 	gDebugJSR_flag = flagtmp;
 
-	gJamDetectEnableFlag = jamDenflag;
+	JamDetectEnable(jamDenflag);
 
 	
 	
@@ -1495,15 +1497,10 @@ void test_verAll()
 SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_FUNC),verAll, test_verAll, kgr ver CMD);
 
 
-void testloadRamData(unsigned int tempTotalPacke)//ȡfpgaе
+/*ADȫѭص, ¶Ϣ֮*/
+static void loadRamDataDone(int status)
 {
-	u32 u32SamCtrlReg;
-	u32 u32SamData[4]   ;
 	float tmpTemp;
-	unsigned int j;
-
-
-	com_data_ad_send(tempTotalPacke);
 
 	if(boardTempGet(&tmpTemp) == 0)
 	{
@@ -1515,9 +1512,79 @@ void testloadRamData(unsigned int tempTotalPacke)//
 	}
 
 }
+
+void testloadRamData(unsigned int tempTotalPacke)//ȡfpgaе
+{
+	//ֻ, ֡ѭ, 
+	com_data_ad_stream_start(tempTotalPacke, loadRamDataDone);
+}
 SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_FUNC), loadRamData, testloadRamData, testloadRamData CMD);
 
 
+extern jam_detect_t gJamDetect;
+extern unsigned int gJamTraceMs;
+extern unsigned char gJamDetectFlag;
+extern u8 gJamDetectEnableFlag;
+
+/*********************************************
+*  jamDetectCfg
+* ܣøż, ѧϰĹʻ
+*
+*		drift10: CUSUM οƫ, λ 0.1 sigma
+*		limit10: CUSUM 澯, λ 0.1 sigma
+*		onMs:    澯ʱȷϸ
+*		offMs:   ޸澯ʱȷϸʧ
+*		absThr:  Թ, 0 ʹ
+*/
+void jamDetectCfg(unsigned int drift10, unsigned int limit10, unsigned int onMs, unsigned int offMs, unsigned int absThr)
+{
+	jam_detect_cfg_t cfg = gJamDetect.cfg;
+
+	cfg.drift = drift10 / 10.0f;
+	cfg.limit = limit10 / 10.0f;
+	cfg.onHoldMs = onMs;
+	cfg.offHoldMs = offMs;
+	cfg.absThreshold = (float)absThr;
+	jam_detect_set_cfg(&gJamDetect, &cfg);
+	dx_kprintf("jam detect drift %.1f limit %.1f on %u ms off %u ms abs %u\r\n",
+			cfg.drift, cfg.limit, onMs, offMs, absThr);
+}
+SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_FUNC), jamDetectCfg, jamDetectCfg, jam detect config CMD);
+
+/*********************************************
+*  jamDetectEn
+* ܣ/رոż, ´ʱѧϰʻ
+*/
+void jamDetectEn(unsigned int en)
+{
+	JamDetectEnable(en);
+	dx_kprintf("jam detect %s\r\n", en ? "on" : "off");
+}
+SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_FUNC), jamDetectEn, jamDetectEn, jam detect enable CMD);
+
+void jamDetectStat(void)
+{
+	int i;
+
+	dx_kprintf("jam detect en %d jammed %d flag %d onsets %u samples %u alarm ch %d\r\n",
+			gJamDetectEnableFlag, gJamDetect.jammed, gJamDetectFlag,
+			gJamDetect.onsetCount, gJamDetect.samples, gJamDetect.alarmCh);
+	for (i = 0; i < gJamDetect.cfg.chanNum; i++)
+	{
+		dx_kprintf("ch%d mean %.1f var %.1f cusum %.2f\r\n", i,
+				gJamDetect.ch[i].mean, gJamDetect.ch[i].var, gJamDetect.ch[i].cusum);
+	}
+}
+SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_FUNC), jamDetectStat, jamDetectStat, jam detect status CMD);
+
+/* ms  $JAMPW ʼ¼, 0 ر; ץ tools/jam_replay ط*/
+void jamTrace(unsigned int ms)
+{
+	gJamTraceMs = ms;
+}
+SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_FUNC), jamTrace, jamTrace, jam power trace CMD);
+
+
 void FpgaWrite(u32 addr, u32 val)//
 {
 	mcu_to_fpga_write_kgr_reg(addr, val);
@@ -12,21 +12,61 @@
 #ifndef COM_PROTCL_MDL_ADFSH
 #define COM_PROTCL_MDL_ADFSH
 
-#define AD_DATA_TRANS_HEAD     "$JAMAD"
+/*
+*AD ݶ֡, ֶֽξΪС:
+*	[0]  ͬ 'J' 'M' 'A' 'D'
+*	[4]  汾 u8, ֡ͷ u8, ݳ u16
+*	[8]  ɼ u32, ÿβɼ 1
+*	[12] ǰ u16, ܰ u16
+*	[16] ɼƼĴ 100 ֵ u32
+*	[20] ʱ u32 (ms)
+*	[24] , ÿ 32 λְĿڴ˳
+*	[24+ݳ] CRC-32 (IEEE 802.3, ֡ͷ) u32
+* tools/ad_reasm ֺͬ CRC 
+*/
+#define AD_FRAME_SYNC0         'J'
+#define AD_FRAME_SYNC1         'M'
+#define AD_FRAME_SYNC2         'A'
+#define AD_FRAME_SYNC3         'D'
+#define AD_FRAME_VERSION       (1)
+#define AD_FRAME_HDR_LEN       (24)
+#define AD_FRAME_PAYLOAD       (512)	//512ֽ
+#define AD_FRAME_CRC_LEN       (4)
+#define AD_FRAME_LEN           (AD_FRAME_HDR_LEN + AD_FRAME_PAYLOAD + AD_FRAME_CRC_LEN)
 
 /*
 *ƣ com_data_ad_send()
-*ܣ ADݷ
+*ܣ ADݷ, ȴ
 *                    
-*			samNum: ݵ
-*			chnNum: ͨ
+*			tmptotalpackgCnt: ܰ, ÿ AD_FRAME_PAYLOAD ֽڣ
 *			
 *ֵ   
-*			0: ݷͳɹ
-*			1: ݷʧ
+*			0: ѿʼ
+*			1: һηδɻɼδ
 **********************************
 */
 int com_data_ad_send(unsigned int tmptotalpackgCnt);
 
+/*
+*ƣ com_data_ad_stream_start()
+*ܣ ͬ com_data_ad_send, ȫ֡ѭе done (status Ϊ 0)
+**********************************
+*/
+int com_data_ad_stream_start(unsigned int tmptotalpackgCnt, void (*done)(int status));
+
+/*
+*ƣ com_data_ad_poll()
+*ܣ ѭе: շĻ, Ӳɼһ
+**********************************
+*/
+void com_data_ad_poll(void);
+
+/*
+*ƣ com_data_ad_busy()
+*ܣ ADݷǷڽ
+**********************************
+*/
+int com_data_ad_busy(void);
+
 
-#endif
\ No newline at end of file
+#endif
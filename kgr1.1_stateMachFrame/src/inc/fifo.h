@@ -1,7 +1,49 @@
 #ifndef ZS_FIFO_H_DADFASFDASDF
 #define ZS_FIFO_H_DADFASFDASDF
 
+#ifdef FIFO_HOST_STRESS
+/*ѹ (tools/fifo_stress.c)  BSP ͷļ*/
+#include <stdint.h>
+typedef uint8_t  u8;
+typedef uint32_t u32;
+typedef int      BOOL;
+#define TRUE     1
+#define FALSE    0
+#else
 #include "dxdef.h"
+#endif
+
+/*
+ * ߵֽڶ, ж ()  () ֮ʹ.
+ * head ֻ޸, tail ֻ޸, ߶ļ,
+ * ԪظΪ head - tail, Ҫ size .
+ * Ϊ 2 , ȫ.
+ */
+typedef struct
+{
+	volatile u32 head;		/*д, ֻ޸*/
+	volatile u32 tail;		/*, ֻ޸*/
+	u32 mask;				/* - 1*/
+	u8 *buf;
+}zs_fifo_t;
+
+/*capacity Ϊ 2 , buf  capacity ֽ; ɹ 0*/
+int fifo_init(zs_fifo_t *q, u8 *buf, u32 capacity);
+
+/*: дһֽ/һֽ, Ƿд/дĸ (ʱֻдŵµĲ)*/
+BOOL fifo_enqueue(zs_fifo_t *q, u8 val);
+u32 fifo_enqueue_n(zs_fifo_t *q, const u8 *data, u32 len);
+
+/*: ȡһֽ/ max ֽ*/
+BOOL fifo_dequeue(zs_fifo_t *q, u8 *val);
+u32 fifo_dequeue_n(zs_fifo_t *q, u8 *data, u32 max);
+
+/*ǰԪظ; ߻һöǰȫĽֵ*/
+u32 fifo_count(const zs_fifo_t *q);
+u32 fifo_capacity(const zs_fifo_t *q);
+
+/*Դڽն (UartDbgRecvHandler д), Ϊݾɽӿڵķװ*/
+extern zs_fifo_t gZsQueue;
 
 BOOL dequeue(char * enVal);
 
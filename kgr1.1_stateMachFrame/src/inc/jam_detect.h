@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2020-2025, ZS Development Team
+ *
+ * @file jam_detect.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author        Notes
+ * 2026-10-19     zs           the first version
+ */
+
+#ifndef __JAM_DETECT_H__
+#define __JAM_DETECT_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * ʽż
+ *
+ * ÿָͨȨֵ/޸ʱĹʻ, Ա׼Ĺ
+ * z = (x - mean) / sigma  CUSUM: S = max(0, S + z - drift), S  limit Ϊ澯.
+ * 澯Ⱥ (z > 4) ѧϰ, Ѹѧ; S ޷ 2*limit.
+ * ȷϸźΪ z Ķʱֵ (Ȩ 1/8) ж:  releaseSigma Ϊָͨ,
+ * ָͨٻ, ڼߵĻƯƲʹ޷˳.
+ * 澯 onHoldMs ȷϸ, ޸澯 offHoldMs ȷϸʧ,
+ * ͻذʱ, ޹.
+ *
+ * ģֻ, ʼĴ, ĿطŹ (tools/jam_replay) .
+ */
+
+#define JAM_DET_CH_MAX      8
+
+// jam_detect_update ֵ
+#define JAM_DET_NONE        0
+#define JAM_DET_ONSET       1   // ȷϳָ
+#define JAM_DET_CLEAR       2   // ȷϸʧ
+
+typedef struct {
+    uint8_t  chanNum;           // ͨ,  JAM_DET_CH_MAX
+    float    alpha;             //  EWMA Ȩ (0, 1)
+    float    drift;             // CUSUM οƫ, λ sigma
+    float    limit;             // CUSUM 澯, λ sigma
+    float    releaseSigma;      // ڼͨ z ĶʱֵڸֵΪָ
+    float    minSigma;          // sigma  (ʵλ), ֹͨС
+    float    absThreshold;      // Թ, 澯 (ѧϰڼͬЧ); 0 ʹ
+    uint32_t warmupSamples;     // ѧϰ, ڼ䲻 CUSUM о
+    uint32_t onHoldMs;          // 澯ʱȷϸ, 0 Ϊȷ
+    uint32_t offHoldMs;         // ޸澯ʱȷϸʧ
+} jam_detect_cfg_t;
+
+typedef struct {
+    float mean;
+    float var;
+    float cusum;
+    float level;                // z Ķʱֵ
+} jam_det_chan_t;
+
+typedef struct {
+    jam_detect_cfg_t cfg;
+    jam_det_chan_t ch[JAM_DET_CH_MAX];
+    uint32_t samples;           // Ѵ
+    uint32_t edgeTick;          // ԭʼ澯״̬һα仯ʱ
+    uint32_t changeTick;        // һȷϸ/ʧʱ
+    uint32_t onsetCount;        // ȷϸŴ
+    uint8_t  alarm;             // ԭʼ澯 (δͻ)
+    uint8_t  jammed;            // ȷϺĸ״̬
+    int8_t   alarmCh;           // һθ澯ʱ CUSUM ͨ, ޸澯Ϊ -1
+} jam_detect_t;
+
+// Ĭϲ: 8 ͨ, alpha 1/64, drift 1, limit 10, releaseSigma 2, ѧϰ 64 , ȷ 20ms, ָ 1000ms
+void jam_detect_cfg_default(jam_detect_cfg_t *cfg);
+
+// ߺͳ, ѧϰ
+void jam_detect_init(jam_detect_t *d, const jam_detect_cfg_t *cfg);
+
+// ޸Ĳ, ѧϰĻ; ͨ仯ʱѧϰ
+void jam_detect_set_cfg(jam_detect_t *d, const jam_detect_cfg_t *cfg);
+
+// һ鹦 (chanNum ) ͵ǰʱ (ms, ),  JAM_DET_xxx
+int jam_detect_update(jam_detect_t *d, const int32_t *power, uint32_t now);
+
+// ǰ CUSUM ֵ (λ sigma), ch  NULL ʱضӦͨ
+float jam_detect_level(const jam_detect_t *d, int *ch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
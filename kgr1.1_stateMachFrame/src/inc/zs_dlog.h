@@ -0,0 +1,128 @@
+/******************************************************************************
+ * Copyright (C) 2024 ZS Development Team, Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @file zs_dlog.h
+ * @brief ӳٸʽ־: õֻ¼ʽ ID Ͳԭʼ, ˽
+ * @version 0.1
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Andy      first version
+******************************************************************************/
+
+#ifndef __ZS_DLOG_H__
+#define __ZS_DLOG_H__
+
+#include <stdint.h>
+#include "dxdef.h"
+#include "zs_printf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ÷: DLOG("adc1 dco old=%d new=%d\r\n", old, new);
+ *
+ *  DLOG_ENABLE ʱ, ʽ .dlog_fmt  (ӽűΪ INFO , ռĿڴ),
+ * ӵַΪ ID; õֻ IDʱͲת 32 λд뻷λ,
+ * ɺ̨ dlog_flush() Զԭ,  tools/dlog_decode ̼ ELF ԭı.
+ * δ DLOG_ENABLE ʱ DLOG ͬ dx_kprintf, õ޸.
+ *
+ * :
+ *  - ʽַ
+ *  - ÿռһ 32 λ,  DLOG_MAX_ARGS ; ֧ 64 λ
+ *  -  DLOG_FLOAT(x) װ,  float λģʽ¼
+ *  - %s ָֻ̼еĳַ, ˴ ELF жȡ
+ */
+
+#define DLOG_MAX_ARGS       12
+
+/* λС (32 λ), Ϊ 2  */
+#ifndef DLOG_RING_WORDS
+#define DLOG_RING_WORDS     1024
+#endif
+
+/* ¼ʽ (Ŀֽ 32 λ):
+ *   [0] ͷ: DLOG_TAG_RECORD |  << 16
+ *   [1] ʽ ID
+ *   [2] ʱ (tick_get, ms)
+ *   [3..] 
+ * λβŲһ¼ʱдͷ DLOG_TAG_PAD | , ᷢ */
+#define DLOG_TAG_MASK       0xFF000000u
+#define DLOG_TAG_RECORD     0xD1000000u
+#define DLOG_TAG_PAD        0xD0000000u
+#define DLOG_HDR_WORDS      3
+
+/*  ID: ļ¼,  0 Ϊ */
+#define DLOG_ID_DROPPED     0xFFFFFFFFu
+
+#ifdef DLOG_ENABLE
+
+#define DLOG_FMT_SECTION    SECTION(".dlog_fmt") DX_USED
+
+#define DLOG(...)   DLOG_SELECT_(__VA_ARGS__, DLOG_N_, DLOG_N_, DLOG_N_, DLOG_N_, \
+                                 DLOG_N_, DLOG_N_, DLOG_N_, DLOG_N_, \
+                                 DLOG_N_, DLOG_N_, DLOG_N_, DLOG_N_, DLOG_0_, 0)(__VA_ARGS__)
+
+#define DLOG_SELECT_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, NAME, ...)   NAME
+
+#define DLOG_0_(fmt) do { \
+        static const char _dlog_fmt[] DLOG_FMT_SECTION = fmt; \
+        dlog_write((u32)(uintptr_t)_dlog_fmt, NULL, 0); \
+    } while (0)
+
+#define DLOG_N_(fmt, ...) do { \
+        static const char _dlog_fmt[] DLOG_FMT_SECTION = fmt; \
+        const u32 _dlog_args[] = { DLOG_WORDS_(__VA_ARGS__) }; \
+        dlog_write((u32)(uintptr_t)_dlog_fmt, _dlog_args, sizeof(_dlog_args) / sizeof(_dlog_args[0])); \
+    } while (0)
+
+/* ת 32 λ */
+#define DLOG_W_(x)  ((u32)(uintptr_t)(x))
+#define DLOG_WORDS_(...) DLOG_SELECT_(__VA_ARGS__, 0, DLOG_W12_, DLOG_W11_, DLOG_W10_, DLOG_W9_, \
+                                      DLOG_W8_, DLOG_W7_, DLOG_W6_, DLOG_W5_, \
+                                      DLOG_W4_, DLOG_W3_, DLOG_W2_, DLOG_W1_, 0)(__VA_ARGS__)
+#define DLOG_W1_(a)                      DLOG_W_(a)
+#define DLOG_W2_(a, b)                   DLOG_W_(a), DLOG_W_(b)
+#define DLOG_W3_(a, b, c)                DLOG_W2_(a, b), DLOG_W_(c)
+#define DLOG_W4_(a, b, c, d)             DLOG_W3_(a, b, c), DLOG_W_(d)
+#define DLOG_W5_(a, b, c, d, e)          DLOG_W4_(a, b, c, d), DLOG_W_(e)
+#define DLOG_W6_(a, b, c, d, e, f)       DLOG_W5_(a, b, c, d, e), DLOG_W_(f)
+#define DLOG_W7_(a, b, c, d, e, f, g)    DLOG_W6_(a, b, c, d, e, f), DLOG_W_(g)
+#define DLOG_W8_(a, b, c, d, e, f, g, h) DLOG_W7_(a, b, c, d, e, f, g), DLOG_W_(h)
+#define DLOG_W9_(a, b, c, d, e, f, g, h, i)             DLOG_W8_(a, b, c, d, e, f, g, h), DLOG_W_(i)
+#define DLOG_W10_(a, b, c, d, e, f, g, h, i, j)         DLOG_W9_(a, b, c, d, e, f, g, h, i), DLOG_W_(j)
+#define DLOG_W11_(a, b, c, d, e, f, g, h, i, j, k)      DLOG_W10_(a, b, c, d, e, f, g, h, i, j), DLOG_W_(k)
+#define DLOG_W12_(a, b, c, d, e, f, g, h, i, j, k, l)   DLOG_W11_(a, b, c, d, e, f, g, h, i, j, k), DLOG_W_(l)
+
+#define DLOG_FLOAT(x)   dlog_float_bits((float)(x))
+
+#else
+
+#define DLOG(...)       dx_kprintf(__VA_ARGS__)
+#define DLOG_FLOAT(x)   ((double)(x))
+
+#endif
+
+dx_inline u32 dlog_float_bits(float f)
+{
+    union { float f; u32 u; } v;
+    v.f = f;
+    return v.u;
+}
+
+/* дһ¼, же; ʱ */
+void dlog_write(u32 fmt_id, const u32 *args, u32 nargs);
+
+/* ύļ¼ out , ط͵; ֻһ (̨) е */
+u32 dlog_flush(void (*out)(const void *data, u32 len));
+
+/* ̨ͨڵķͻλ (UartConsoleWrite)  */
+u32 dlog_flush_console(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
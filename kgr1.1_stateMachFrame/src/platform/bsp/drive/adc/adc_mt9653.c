@@ -26,6 +26,7 @@
 #include "xil_printf.h"
 #include "xparameters.h"
 #include "dxdef.h"
+#include "gpio_spi.h"
 
 
 #define MT9653_GPIO_SPI_CS0			(0)
@@ -38,119 +39,27 @@ void adc_dx_dly_us(unsigned int tmpVal)
 }
 
 /* Private variables ---------------------------------------------------------*/
+#define MT9653_SPI_HALF_NS			(500)
+#define MT9653_SPI_CS_NS			(500)
 
-/*****************************************************************************************************
-*	  : static void mt9653_gpio_spi_begin(eAdcMT9653ChipMux adcMT9653Mux)
-*	˵: ģSPIǰӲSPIΪMT9653_GPIO
-*		  :
-*            eAdcMT9653ChipMux adcMT9653Mux: ѡmt9653оƬ
-*	  ֵ: 
-******************************************************************************************************/
-static void mt9653_gpio_spi_begin(eAdcMT9653ChipMux adcmt9653Mux)
+/*3  SPI, ģʽ 0, λȷ; IC1 ʹ CS0, IC2 ûƬѡܽ*/
+static gpio_spi_bus_t s_mt9653Bus[2] =
 {
-	PERI_DX_PIN_OUTPUT_MODE(MT9653_GPIO_SPI_CLK);
-	PERI_DX_PIN_OUTPUT_MODE(MT9653_GPIO_SPI_SDIO);
-
-	PERI_DX_PIN_OUPUT_LOW(MT9653_GPIO_SPI_CLK);
-	PERI_DX_PIN_OUPUT_HIGH(MT9653_GPIO_SPI_SDIO);
-
-	switch (adcmt9653Mux)
 	{
-		case ADC_MT9653_IC1:
-		{
-			PERI_DX_PIN_OUTPUT_MODE(MT9653_GPIO_SPI_CS0);
-			PERI_DX_PIN_OUPUT_HIGH(MT9653_GPIO_SPI_CS0);
-		}
-		break;
-		case ADC_MT9653_IC2:
-		{
-
-		}
-		break;
-		default:
-			break;
-	}
-}
-
-/*****************************************************************************************************
-*	  : static void mt9653_gpio_spi_end(eAdcmt9653ChipMux adcmt9653Mux)
-*	˵: ģSPI󣬽mt9653_GPIOΪӲSPIģʽ
-*		  :
-*            eAdcmt9653ChipMux adcmt9653Mux: ѡmt9653оƬ
-*	  ֵ: 
-******************************************************************************************************/
-static void mt9653_gpio_spi_end(eAdcMT9653ChipMux adcmt9653Mux)
-{
-	PERI_DX_PIN_OUPUT_HIGH(MT9653_GPIO_SPI_CLK);
-	PERI_DX_PIN_OUPUT_HIGH(MT9653_GPIO_SPI_SDIO);
-
-	switch (adcmt9653Mux)
+		GPIO_SPI_PIN(MT9653_GPIO_SPI_CS0), GPIO_SPI_PIN(MT9653_GPIO_SPI_CLK),
+		GPIO_SPI_PIN(MT9653_GPIO_SPI_SDIO), GPIO_SPI_PIN(MT9653_GPIO_SPI_SDIO),
+		GPIO_SPI_PIN(MT9653_GPIO_SPI_CS0) | GPIO_SPI_PIN(MT9653_GPIO_SPI_CLK) | GPIO_SPI_PIN(MT9653_GPIO_SPI_SDIO),
+		GPIO_SPI_MODE0, GPIO_SPI_3WIRE, MT9653_SPI_HALF_NS, MT9653_SPI_CS_NS,
+	},
 	{
-		case ADC_MT9653_IC1:
-		{
-			PERI_DX_PIN_OUPUT_HIGH(MT9653_GPIO_SPI_CS0);
-		}
-		break;
-		case ADC_MT9653_IC2:
-		{
+		0, GPIO_SPI_PIN(MT9653_GPIO_SPI_CLK),
+		GPIO_SPI_PIN(MT9653_GPIO_SPI_SDIO), GPIO_SPI_PIN(MT9653_GPIO_SPI_SDIO),
+		GPIO_SPI_PIN(MT9653_GPIO_SPI_CLK) | GPIO_SPI_PIN(MT9653_GPIO_SPI_SDIO),
+		GPIO_SPI_MODE0, GPIO_SPI_3WIRE, MT9653_SPI_HALF_NS, MT9653_SPI_CS_NS,
+	},
+};
 
-		}
-		break;
-		default:
-			break;
-	}
-}
-
-/*****************************************************************************************************
-*	  : static void adc_mt9653_cs_level_mux(eAdcMT9653ChipMux adcMT9653Mux,
-*													eAdcMT9653CsLevelMux adcMT9653CsLevelMux)
-*	˵: ѡmt9653оƬ
-*		  :
-*			  eAdcMT9653ChipMux adcMT9653Mux: ѡmt9653оƬ
-*			  eAdcMT9653CsLevelMux adcMT9653CsLevelMux: ѡmt9653оƬѡߵ
-*	  ֵ: 
-******************************************************************************************************/
-static void adc_mt9653_cs_level_mux(eAdcMT9653ChipMux adcMT9653Mux,
-										eAdcMT9653CsLevelMux adcMT9653CsLevelMux)
-{
-	if (ADC_MT9653_CS_LOW == adcMT9653CsLevelMux)
-	{
-		switch (adcMT9653Mux)
-		{
-			case ADC_MT9653_IC1:
-			{
-				PERI_DX_PIN_OUPUT_LOW(MT9653_GPIO_SPI_CS0);
-			}
-			break;
-			case ADC_MT9653_IC2:
-			{
-
-			}
-			break;
-			default:
-				break;
-		}
-	}
-	else
-	{
-		switch (adcMT9653Mux)
-		{
-			case ADC_MT9653_IC1:
-			{
-				PERI_DX_PIN_OUPUT_HIGH(MT9653_GPIO_SPI_CS0);
-			}
-			break;
-			case ADC_MT9653_IC2:
-			{
-
-			}
-			break;
-			default:
-				break;
-		}
-	}
-
-}
+#define MT9653_BUS(mux)				(&s_mt9653Bus[(ADC_MT9653_IC1 == (mux)) ? 0 : 1])
 
 /*****************************************************************************************************
 *	  : static void adc_mt9653_gpio_spi_write_reg(eAdcMT9653ChipMux adcMT9653Mux,
@@ -164,85 +73,13 @@ static void adc_mt9653_cs_level_mux(eAdcMT9653ChipMux adcMT9653Mux,
 ******************************************************************************************************/
 static void adc_mt9653_gpio_spi_write_reg(eAdcMT9653ChipMux adcMT9653Mux, u16 addr, u8 val)
 {
-	u16 TxCmd;
-	u8 w_cnt;
-	u32 dly_time = 1;
-
-	addr &= 0x1FFF;/*13λЧַ*/
-	val &= 0xFF;/*8λ*/
-
-	//дָƴӣWλΪ
-	TxCmd = (0x0 << 15) | addr;
-
-	mt9653_gpio_spi_begin(adcMT9653Mux);
-	//<ʹ>Ч
-	adc_mt9653_cs_level_mux(adcMT9653Mux, ADC_MT9653_CS_LOW);
-	adc_dx_dly_us(dly_time);
-
-	//дָ
-	for (w_cnt = 0; w_cnt < 16; w_cnt++)
-	{
-		//<ʱ>,
-		PERI_DX_PIN_OUPUT_LOW(MT9653_GPIO_SPI_CLK);
-
-		//жϴд01
-		if (TxCmd & 0x8000)
-		{
-			//дΪ1MOSI
-			PERI_DX_PIN_OUPUT_HIGH(MT9653_GPIO_SPI_SDIO);
-		}
-		else
-		{
-			//дΪ0MOSI
-			PERI_DX_PIN_OUPUT_LOW(MT9653_GPIO_SPI_SDIO);
-		}
-		adc_dx_dly_us(dly_time);
-
-		//дһλ
-		TxCmd <<= 1;
-
-		//<ʱ>,
-		PERI_DX_PIN_OUPUT_HIGH(MT9653_GPIO_SPI_CLK);
-		adc_dx_dly_us(dly_time);
-	}
-
-	//д
-	for (w_cnt = 0; w_cnt < 8; w_cnt++)
-	{
-		//<ʱ>,
-		PERI_DX_PIN_OUPUT_LOW(MT9653_GPIO_SPI_CLK);
-
-		//жϴд01
-		if (val & 0x80)
-		{
-			//дΪ1MOSI
-			PERI_DX_PIN_OUPUT_HIGH(MT9653_GPIO_SPI_SDIO);
-		}
-		else
-		{
-			//дΪ0MOSI
-			PERI_DX_PIN_OUPUT_LOW(MT9653_GPIO_SPI_SDIO);
-		}
-		adc_dx_dly_us(dly_time);
-
-		//дһλ
-		val <<= 1;
-
-		//<ʱ>,
-		PERI_DX_PIN_OUPUT_HIGH(MT9653_GPIO_SPI_CLK);
-		adc_dx_dly_us(dly_time);
-	}
-	//<ʱ>,
-	PERI_DX_PIN_OUPUT_LOW(MT9653_GPIO_SPI_CLK);
-	//дɣ<ʹ>
-	adc_mt9653_cs_level_mux(adcMT9653Mux, ADC_MT9653_CS_HIGH);
-	adc_dx_dly_us(dly_time);
-	mt9653_gpio_spi_end(adcMT9653Mux);
+	//16λдָ(WλΪ, 13λЧַ) + 8λ
+	gpio_spi_write(MT9653_BUS(adcMT9653Mux), ((u32)(addr & 0x1FFF) << 8) | val, 24);
 }
 
 /*****************************************************************************************************
 *	  : static u32 adc_mt9653_gpio_spi_read_reg(eAdcMT9653ChipMux adcMT9653Mux, u16 addr)
-*	˵: mt9653ģspiд
+*	˵: mt9653ģspi߶
 *		  :
 *			  eAdcMT9653ChipMux adcMT9653Mux: ѡmt9653оƬ
 *		      u16 addr: Ĵַ
@@ -250,78 +87,8 @@ static void adc_mt9653_gpio_spi_write_reg(eAdcMT9653ChipMux adcMT9653Mux, u16 ad
 ******************************************************************************************************/
 static u8 adc_mt9653_gpio_spi_read_reg(eAdcMT9653ChipMux adcMT9653Mux, u16 addr)
 {
-	u8 r_cnt;
-	u8 w_cnt;
-	u16 TxCmd;
-	u8 value = 0, read_data;
-	u32 dly_time = 1;
-	
-	//λΪ1
-	addr &= 0x1FFF;/*13λЧַ*/
-
-	TxCmd = 0x8000 | addr;
-
-	mt9653_gpio_spi_begin(adcMT9653Mux);
-	//<ʹ>Ч
-	adc_mt9653_cs_level_mux(adcMT9653Mux, ADC_MT9653_CS_LOW);
-
-	//жϴд01
-	for (w_cnt = 0; w_cnt < 16; w_cnt++)
-	{
-		//<ʱ>,
-		PERI_DX_PIN_OUPUT_LOW(MT9653_GPIO_SPI_CLK);
-
-		//жϴд01
-		if (TxCmd & 0x8000)
-		{
-			//дΪ1MOSI
-			PERI_DX_PIN_OUPUT_HIGH(MT9653_GPIO_SPI_SDIO);
-		}
-		else
-		{
-			//дΪ0MOSI
-			PERI_DX_PIN_OUPUT_LOW(MT9653_GPIO_SPI_SDIO);
-		}
-		adc_dx_dly_us(dly_time);
-
-		//дһλ
-		TxCmd <<= 1;
-
-		//<ʱ>,
-		PERI_DX_PIN_OUPUT_HIGH(MT9653_GPIO_SPI_CLK);
-		adc_dx_dly_us(dly_time);
-	}
-
-	//SDIOģʽ
-	PERI_DX_PIN_INTPUT_MODE(MT9653_GPIO_SPI_SDIO);
-	for (r_cnt = 8; r_cnt > 0; r_cnt--)
-	{
-		//<ʱ>,
-		PERI_DX_PIN_OUPUT_LOW(MT9653_GPIO_SPI_CLK);
-
-		adc_dx_dly_us(dly_time);
-
-		//SDOжǰbit
-		read_data = PERI_DX_PIN_INTPUT(MT9653_GPIO_SPI_SDIO);
-
-		//λ֮ǰݽƴ
-		read_data = read_data << (r_cnt - 1);
-
-		value = value | read_data;
-
-		//<ʱ>,
-		PERI_DX_PIN_OUPUT_HIGH(MT9653_GPIO_SPI_CLK);
-
-		adc_dx_dly_us(dly_time);
-
-	}
-	//<ʱ>,
-	PERI_DX_PIN_OUPUT_LOW(MT9653_GPIO_SPI_CLK);
-	//ɣ<ʹ>
-	adc_mt9653_cs_level_mux(adcMT9653Mux, ADC_MT9653_CS_HIGH);
-	adc_dx_dly_us(dly_time);
-	mt9653_gpio_spi_end(adcMT9653Mux);
-	return (value & 0xFF);
+	//λΪ1, ָSDIOлΪ8λ
+	return (u8)gpio_spi_read(MT9653_BUS(adcMT9653Mux), 0x8000 | (addr & 0x1FFF), 16, 8);
 }
 
 void mt9653_ic0_write_reg(u16 addr, u8 val)
@@ -20,46 +20,474 @@
   ******************************************************************************
   */
 #include <stdio.h>
+#include <string.h>
+#ifndef ANTIJAM_HOST_MOCK
 /* Xilinx includes. */
 #include "xil_printf.h"
 #include "xparameters.h"
+#endif
 
 #include "antijam_fpga.h"
 
+#ifndef ANTIJAM_HOST_MOCK
 #include "xil_types.h"
 #include "xil_assert.h"
 #include "xil_io.h"
+#endif
+
+#include "../../../components/evloop/evloop.h"
+
+extern uint32_t tick_get(void);
+
+/*ӰӼĴ: valid/dirty ÿλӦһĴ*/
+typedef struct
+{
+	u32 val[KGR_REG_NUM];
+	u32 valid[KGR_REG_NUM / 32];
+	u32 dirty[KGR_REG_NUM / 32];
+}kgr_shadow_t;
+
+static kgr_shadow_t s_kgrShadow;
+static kgr_bus_stat_t s_kgrBusStat;
+
+/*
+* ֻ MCU дҴдĿƼĴ, Ĭÿζ.
+* 60  bit0 Ȩֵѡͨ, ÿζϵĵǰֵд.
+*/
+static u8 s_kgrRegAttr[KGR_REG_NUM] =
+{
+	[ANTI4B3_DATA_SWITCH] = KGR_REG_CACHEABLE,   /*·ѡ*/
+	[65]  = KGR_REG_CACHEABLE,                   /*Ӵȡ˲·/λ*/
+	[67]  = KGR_REG_CACHEABLE,                   /*Ӵֵ˲·/λ*/
+	[129] = KGR_REG_CACHEABLE,                   /*StapС*/
+	[FPGA_STAP_SJR_CTRL_REG] = KGR_REG_CACHEABLE,/*ͳƿ*/
+};
+
+#define KGR_BIT_TST(map, n)     ((map)[(n) >> 5] &   (1u << ((n) & 31)))
+#define KGR_BIT_SET(map, n)     ((map)[(n) >> 5] |=  (1u << ((n) & 31)))
+#define KGR_BIT_CLR(map, n)     ((map)[(n) >> 5] &= ~(1u << ((n) & 31)))
+
+#ifdef ANTIJAM_HOST_MOCK
+u32 g_kgrMockBus[KGR_MOCK_BUS_NUM];
+void (*g_kgrMockWriteHook)(u32 addr, u32 val);
+
+static u32 kgr_bus_read(u32 addr)
+{
+	s_kgrBusStat.reads++;
+	return g_kgrMockBus[KGR_MOCK_INDEX(addr)];
+}
+
+static void kgr_bus_write(u32 addr, u32 val)
+{
+	s_kgrBusStat.writes++;
+	g_kgrMockBus[KGR_MOCK_INDEX(addr)] = val;
+	if (g_kgrMockWriteHook)
+		g_kgrMockWriteHook(addr, val);
+}
+#else
+static inline u32 kgr_bus_read(u32 addr)
+{
+	s_kgrBusStat.reads++;
+	return *(volatile u32*)(XPAR_MCU_AHB_BASEADDR + addr*4);
+}
+
+static inline void kgr_bus_write(u32 addr, u32 val)
+{
+	s_kgrBusStat.writes++;
+	*(volatile u32*)(XPAR_MCU_AHB_BASEADDR + addr*4) = val;
+	//Xil_Out32(0x40100000 + addr*4,val);
+}
+#endif
 
 /*****************************************************************************************************
 *	  : s32 bd21_to_fpga_write_kgr_reg(u8 addr,u32 val)
-*	˵: bd21_fpgaģspiд
+*	˵: bd21_fpgaģspiд, ֱд߲ӰӼĴ
 *		  :
 *		      u8 addr: Ĵַ
 *	  ֵ: Ĵֵ
 ******************************************************************************************************/
 void mcu_to_fpga_write_kgr_reg(u32 addr, u32 val)
 {
-	*(volatile u32*)(XPAR_MCU_AHB_BASEADDR + addr*4) = val;
-	//Xil_Out32(0x40100000 + addr*4,val);
+	kgr_bus_write(addr, val);
+	if (addr < KGR_REG_NUM)
+	{
+		s_kgrShadow.val[addr] = val;
+		KGR_BIT_SET(s_kgrShadow.valid, addr);
+		KGR_BIT_CLR(s_kgrShadow.dirty, addr);
+	}
 }
 
 /*****************************************************************************************************
 *	  : s32 bd21_to_fpga_read_kgr_reg(u8 addr,u32 val)
-*	˵: bd21_fpgaģspiд
+*	˵: bd21_fpgaģspiд, ɻĴӰֵ
 *		  :
 *		      u8 addr: Ĵַ
 *	  ֵ: Ĵֵ
 ******************************************************************************************************/
 u32 mcu_to_fpga_read_kgr_reg(u32 addr)
 {
-	return *(volatile u32*)(XPAR_MCU_AHB_BASEADDR + addr*4);
+	if (addr >= KGR_REG_NUM || s_kgrRegAttr[addr] != KGR_REG_CACHEABLE)
+		return kgr_bus_read(addr);
+
+	if (!KGR_BIT_TST(s_kgrShadow.valid, addr))
+	{
+		s_kgrShadow.val[addr] = kgr_bus_read(addr);
+		KGR_BIT_SET(s_kgrShadow.valid, addr);
+	}
+	return s_kgrShadow.val[addr];
+}
+
+/*****************************************************************************************************
+*	  : mcu_to_fpga_read_kgr_block
+*	˵: ȡ num Ĵ (ɼ ANTI4B3_SAM_ADDR_BASE), ӰӼĴ.
+*	          û DMA,  CPU ַ, ѭûк
+*		  :
+*		      addr: ʼĴַ
+*		      dst : Ŀ껺
+*		      num : Ĵ
+******************************************************************************************************/
+void mcu_to_fpga_read_kgr_block(u32 addr, u32 *dst, u32 num)
+{
+	u32 i;
+#ifdef ANTIJAM_HOST_MOCK
+	for (i = 0; i < num; i++)
+		dst[i] = g_kgrMockBus[KGR_MOCK_INDEX(addr + i)];
+#else
+	const volatile u32 *src = (const volatile u32 *)(XPAR_MCU_AHB_BASEADDR + addr*4);
+
+	for (i = 0; i + 4 <= num; i += 4)
+	{
+		dst[i]     = src[i];
+		dst[i + 1] = src[i + 1];
+		dst[i + 2] = src[i + 2];
+		dst[i + 3] = src[i + 3];
+	}
+	for (; i < num; i++)
+		dst[i] = src[i];
+#endif
+	s_kgrBusStat.reads += num;
+}
+
+/*ƹӰֱӶ, ڻضУ͵*/
+u32 kgr_reg_read_hw(u32 addr)
+{
+	return kgr_bus_read(addr);
+}
+
+/*****************************************************************************************************
+*	  : kgr_reg_field
+*	˵: ޸ļĴλ reg = (reg & ~mask) | (val & mask), ֻӰ, kgr_reg_flush ʱд.
+*	          ɻļĴ򳬳ӰӷΧĵַд.
+******************************************************************************************************/
+void kgr_reg_field(u32 addr, u32 mask, u32 val)
+{
+	u32 cur;
+
+	if (addr >= KGR_REG_NUM || s_kgrRegAttr[addr] != KGR_REG_CACHEABLE)
+	{
+		cur = kgr_bus_read(addr);
+		mcu_to_fpga_write_kgr_reg(addr, (cur & ~mask) | (val & mask));
+		return;
+	}
+
+	cur = mcu_to_fpga_read_kgr_reg(addr);
+	s_kgrShadow.val[addr] = (cur & ~mask) | (val & mask);
+	if (s_kgrShadow.val[addr] != cur)
+		KGR_BIT_SET(s_kgrShadow.dirty, addr);
+}
+
+void kgr_reg_set_bits(u32 addr, u32 bits)
+{
+	kgr_reg_field(addr, bits, bits);
+}
+
+void kgr_reg_clr_bits(u32 addr, u32 bits)
+{
+	kgr_reg_field(addr, bits, 0);
+}
+
+/*****************************************************************************************************
+*	  : kgr_reg_flush
+*	˵: ַ˳дĴ, ͬһĴĶλ޸ĺϲΪһд
+*	  ֵ: дصļĴ
+******************************************************************************************************/
+int kgr_reg_flush(void)
+{
+	u32 pend, addr;
+	int i, n = 0;
+
+	for (i = 0; i < KGR_REG_NUM / 32; i++)
+	{
+		pend = s_kgrShadow.dirty[i];
+		s_kgrShadow.dirty[i] = 0;
+		while (pend)
+		{
+			addr = i * 32 + __builtin_ctz(pend);
+			pend &= pend - 1;
+			kgr_bus_write(addr, s_kgrShadow.val[addr]);
+			n++;
+		}
+	}
+	return n;
+}
+
+/*Ӱֵ (δдص޸), ´ζ·*/
+void kgr_reg_invalidate(u32 addr)
+{
+	if (addr < KGR_REG_NUM)
+	{
+		KGR_BIT_CLR(s_kgrShadow.valid, addr);
+		KGR_BIT_CLR(s_kgrShadow.dirty, addr);
+	}
+}
+
+void kgr_reg_invalidate_all(void)
+{
+	memset(s_kgrShadow.valid, 0, sizeof(s_kgrShadow.valid));
+	memset(s_kgrShadow.dirty, 0, sizeof(s_kgrShadow.dirty));
+}
+
+void kgr_reg_set_attr(u32 addr, u8 attr)
+{
+	if (addr < KGR_REG_NUM)
+	{
+		s_kgrRegAttr[addr] = attr;
+		kgr_reg_invalidate(addr);
+	}
+}
+
+void kgr_bus_stat_get(kgr_bus_stat_t *stat, int clear)
+{
+	*stat = s_kgrBusStat;
+	if (clear)
+		memset(&s_kgrBusStat, 0, sizeof(s_kgrBusStat));
+}
+
+/*****************************************************************************************************
+*	Ĵ
+*	ƽ̵ {addr, mask, val} , м CDMA ʱֱת;
+*	Ŀǰ CPU ˳ִ, д֮ûж, AHB ϱ.
+******************************************************************************************************/
+typedef struct
+{
+	u32 addr[FPGA_BATCH_CACHE_NUM];
+	u32 val[FPGA_BATCH_CACHE_NUM];
+	u8  valid[FPGA_BATCH_CACHE_NUM];
+	u8  next;
+}fpga_batch_cache_t;
+
+static int fpga_batch_cache_find(fpga_batch_cache_t *c, u32 addr)
+{
+	int i;
+	for (i = 0; i < FPGA_BATCH_CACHE_NUM; i++)
+	{
+		if (c->valid[i] && c->addr[i] == addr)
+			return i;
+	}
+	return -1;
+}
+
+static void fpga_batch_cache_set(fpga_batch_cache_t *c, u32 addr, u32 val)
+{
+	int i = fpga_batch_cache_find(c, addr);
+	if (i < 0)
+	{
+		i = c->next;
+		c->next = (c->next + 1) % FPGA_BATCH_CACHE_NUM;
+		c->addr[i] = addr;
+		c->valid[i] = 1;
+	}
+	c->val[i] = val;
+}
+
+static void fpga_batch_cache_drop(fpga_batch_cache_t *c, u32 addr)
+{
+	int i = fpga_batch_cache_find(c, addr);
+	if (i >= 0)
+		c->valid[i] = 0;
 }
 
+static int fpga_batch_poll(const fpga_reg_op_t *op)
+{
+	u32 start;
+	int i;
+
+	for (i = 0; i < FPGA_BATCH_WAIT_SPIN; i++)
+	{
+		if ((kgr_reg_read_hw(op->addr) & op->mask) == op->val)
+			return DX_EOK;
+	}
+	/*δ: ÿ tick زһ, ʱ˳*/
+	start = tick_get();
+	while ((kgr_reg_read_hw(op->addr) & op->mask) != op->val)
+	{
+		if (tick_get() - start > op->timeout)
+			return -DX_ETIMEOUT;
+		ev_cpu_idle();
+	}
+	return DX_EOK;
+}
+
+/* ms :  tick м, һ tick*/
+static void fpga_batch_sleep(u16 ms)
+{
+	u32 start = tick_get();
+
+	while (tick_get() - start <= ms)
+		ev_cpu_idle();
+}
+
+static void fpga_batch_mismatch(fpga_batch_t *b, u32 addr, u32 expect, u32 rd)
+{
+	if (b->verifyErr++ == 0)
+	{
+		b->errAddr = addr;
+		b->errExpect = expect;
+		b->errRead = rd;
+	}
+}
+
+static void fpga_batch_add(fpga_batch_t *b, u16 op, u32 addr, u32 mask, u32 val, u16 timeout)
+{
+	fpga_reg_op_t *p;
+
+	if (b->status != DX_EOK)
+		return;
+	if (b->count >= b->size)
+		fpga_batch_submit(b);
+
+	p = &b->ops[b->count++];
+	p->op = op;
+	p->timeout = timeout;
+	p->addr = addr;
+	p->mask = mask;
+	p->val = val;
+}
+
+/*****************************************************************************************************
+*	  : fpga_batch_begin
+*	˵: ʼһĴ, һ״̬У
+*		  :
+*		      ops : 
+*		      size: 
+******************************************************************************************************/
+void fpga_batch_begin(fpga_batch_t *b, fpga_reg_op_t *ops, u16 size)
+{
+	memset(b, 0, sizeof(*b));
+	b->ops = ops;
+	b->size = size;
+	b->status = DX_EOK;
+}
+
+void fpga_batch_write(fpga_batch_t *b, u32 addr, u32 val)
+{
+	fpga_batch_add(b, FPGA_BATCH_OP_WRITE, addr, 0xFFFFFFFF, val, 0);
+}
+
+/*дļĴɻض, ύʱ mask ͳһУ*/
+void fpga_batch_rmw(fpga_batch_t *b, u32 addr, u32 mask, u32 val)
+{
+	fpga_batch_add(b, FPGA_BATCH_OP_RMW, addr, mask, val & mask, 0);
+}
+
+void fpga_batch_wait(fpga_batch_t *b, u32 addr, u32 mask, u32 val, u16 timeoutMs)
+{
+	fpga_batch_add(b, FPGA_BATCH_OP_WAIT, addr, mask, val & mask, timeoutMs);
+}
+
+void fpga_batch_check(fpga_batch_t *b, u32 addr, u32 mask, u32 val)
+{
+	fpga_batch_add(b, FPGA_BATCH_OP_CHECK, addr, mask, val & mask, 0);
+}
+
+void fpga_batch_delay(fpga_batch_t *b, u16 ms)
+{
+	fpga_batch_add(b, FPGA_BATCH_OP_DELAY, 0, 0, 0, ms);
+}
+
+/*****************************************************************************************************
+*	  : fpga_batch_submit
+*	˵: ִŶӵĲضУд, 
+*	  ֵ: DX_EOK; ȴʱ -DX_ETIMEOUT (ʣִ)
+******************************************************************************************************/
+int fpga_batch_submit(fpga_batch_t *b)
+{
+	fpga_batch_cache_t cache;
+	fpga_reg_op_t *op;
+	u32 rd;
+	int i, done;
+
+	memset(&cache, 0, sizeof(cache));
+	for (done = 0; done < b->count && b->status == DX_EOK; done++)
+	{
+		op = &b->ops[done];
+		switch (op->op)
+		{
+		case FPGA_BATCH_OP_WRITE:
+			mcu_to_fpga_write_kgr_reg(op->addr, op->val);
+			fpga_batch_cache_set(&cache, op->addr, op->val);
+			break;
+		case FPGA_BATCH_OP_RMW:
+			i = fpga_batch_cache_find(&cache, op->addr);
+			rd = (i >= 0) ? cache.val[i] : mcu_to_fpga_read_kgr_reg(op->addr);
+			rd = (rd & ~op->mask) | op->val;
+			mcu_to_fpga_write_kgr_reg(op->addr, rd);
+			fpga_batch_cache_set(&cache, op->addr, rd);
+			break;
+		case FPGA_BATCH_OP_WAIT:
+			/*״̬Ĵֵдֵͬ, ûд*/
+			fpga_batch_cache_drop(&cache, op->addr);
+			if (fpga_batch_poll(op) != DX_EOK)
+			{
+				b->status = -DX_ETIMEOUT;
+				b->timeoutAddr = op->addr;
+			}
+			break;
+		case FPGA_BATCH_OP_CHECK:
+			fpga_batch_cache_drop(&cache, op->addr);
+			rd = kgr_reg_read_hw(op->addr);
+			if ((rd & op->mask) != op->val)
+				fpga_batch_mismatch(b, op->addr, op->val, rd);
+			break;
+		case FPGA_BATCH_OP_DELAY:
+			fpga_batch_sleep(op->timeout);
+			break;
+		}
+	}
+
+	/*ͳһضУ: ֻУûбǵλ*/
+	for (i = 0; i < done; i++)
+	{
+		u32 mask;
+		int j;
+
+		op = &b->ops[i];
+		if (op->op != FPGA_BATCH_OP_RMW)
+			continue;
+		mask = op->mask;
+		for (j = i + 1; j < done && mask != 0; j++)
+		{
+			if (b->ops[j].addr == op->addr
+				&& (b->ops[j].op == FPGA_BATCH_OP_RMW || b->ops[j].op == FPGA_BATCH_OP_WRITE))
+				mask &= ~b->ops[j].mask;
+		}
+		if (mask == 0)
+			continue;
+		rd = kgr_reg_read_hw(op->addr);
+		if ((rd & mask) != (op->val & mask))
+			fpga_batch_mismatch(b, op->addr, op->val, rd);
+	}
+
+	b->count = 0;
+	return b->status;
+}
 
 int dx_hw_antijam_fpga_init(void)
 {
 	u32 sam_data_buf[1024] = {0};
 	int i;
+
+	kgr_reg_invalidate_all();
 	// Ĵ
 #if 0
 	u32 reg_value;
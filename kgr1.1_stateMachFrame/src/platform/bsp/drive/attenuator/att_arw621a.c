@@ -27,6 +27,7 @@
 #include "xparameters.h"
 #include "dxdef.h"
 #include "antijam_fpga.h"
+#include "gpio_spi.h"
 #define PE43711_SPI_LEA		        (13)
 #define PE43711_SPI_LEB		       	(0)
 #define PE43711_SPI_SCLK 		    (14)
@@ -70,116 +71,20 @@ void att_dx_dly_us(unsigned int tmpVal)
 //    //Xil_ExceptionEnable();
 //}
 
-/*****************************************************************************************************
-*	  : static void pe43711_gpio_spi_begin(eAttPE43711ChipMux pe43711Mux)
-*	˵: ģSPIǰӲSPIΪGPIO
-*		  :
-*			  eAttPE43711ChipMux pe43711Mux: ѡpe43711оƬ
-*	  ֵ: 
-******************************************************************************************************/
-static void pe43711_gpio_spi_begin(eAttPE43711ChipMux pe43711Mux)
-{
-	PERI_DX_PIN_OUTPUT_MODE(PE43711_SPI_SCLK);
-	PERI_DX_PIN_OUTPUT_MODE(PE43711_SPI_SI);
-    //
-    PERI_DX_PIN_OUPUT_LOW(PE43711_SPI_SCLK);
-
-    switch (pe43711Mux)
-	{
-		case ATT_PE43711_IC0:
-		{
-			PERI_DX_PIN_OUTPUT_MODE(PE43711_SPI_LEA);
-			PERI_DX_PIN_OUPUT_HIGH(PE43711_SPI_LEA);
-		}
-		break;
-		case ATT_PE43711_IC1:
-		{
-			PERI_DX_PIN_OUTPUT_MODE(PE43711_SPI_LEB);
-			PERI_DX_PIN_OUPUT_HIGH(PE43711_SPI_LEB);
-		}
-		break;
-		default:
-			break;
-	}
-}
-
-/*****************************************************************************************************
-*	  : static void pe43711_gpio_spi_end(eAttPE43711ChipMux pe43711Mux)
-*	˵: ģSPI󣬽ΪӲSPIģʽ
-*		  :
-*			  eAttPE43711ChipMux pe43711Mux: ѡpe43711оƬ
-*	  ֵ: 
-******************************************************************************************************/
-static void pe43711_gpio_spi_end(eAttPE43711ChipMux pe43711Mux)
-{
-	PERI_DX_PIN_OUPUT_HIGH(PE43711_SPI_SCLK);
-    PERI_DX_PIN_OUPUT_HIGH(PE43711_SPI_SI);
-    switch (pe43711Mux)
-	{
-		case ATT_PE43711_IC0:
-		{
-			//PERI_DX_PIN_OUPUT_HIGH(PE43711_SPI_LEA);
-			PERI_DX_PIN_OUPUT_LOW(PE43711_SPI_LEA);
-		}
-		break;
-		case ATT_PE43711_IC1:
-		{
-			//PERI_DX_PIN_OUPUT_HIGH(PE43711_SPI_LEB);
-			PERI_DX_PIN_OUPUT_LOW(PE43711_SPI_LEB);
-		}
-		break;
-		default:
-			break;
-	}
-}
-
-/*****************************************************************************************************
-*	  : static void att_pe43711_cs_level_mux(eAttPE43711ChipMux pe43711Mux, AttPE43711CsLevelMux pe43711CsLevelMux)
-*	˵: ѡpe43711оƬ
-*		  :
-*			  eAttPE43711ChipMux pe43711Mux: ѡpe43711оƬ
-*			  AttPE43711CsLevelMux pe43711CsLevelMux: ѡPE43711оƬѡߵ
-*	  ֵ: 
-******************************************************************************************************/
-static void att_pe43711_cs_level_mux(eAttPE43711ChipMux pe43711Mux, AttPE43711CsLevelMux pe43711CsLevelMux)
+/*8 λλȷ, LE ;  SCLK/SI Ϊ, LE Ϊ*/
+static gpio_spi_bus_t s_pe43711Bus[2] =
 {
-	if (ATT_PE43711_CS_LOW == pe43711CsLevelMux)
 	{
-		switch (pe43711Mux)
-		{
-			case ATT_PE43711_IC0:
-			{
-				PERI_DX_PIN_OUPUT_LOW(PE43711_SPI_LEA);
-			}
-			break;
-			case ATT_PE43711_IC1:
-			{
-				PERI_DX_PIN_OUPUT_LOW(PE43711_SPI_LEB);
-			}
-			break;
-			default:
-				break;
-		}
-	}
-	else
+		GPIO_SPI_PIN(PE43711_SPI_LEA), GPIO_SPI_PIN(PE43711_SPI_SCLK), GPIO_SPI_PIN(PE43711_SPI_SI), 0,
+		GPIO_SPI_PIN(PE43711_SPI_SCLK) | GPIO_SPI_PIN(PE43711_SPI_SI),
+		GPIO_SPI_MODE0, GPIO_SPI_LSB_FIRST, 500, 1000,
+	},
 	{
-		switch (pe43711Mux)
-		{
-			case ATT_PE43711_IC0:
-			{
-				PERI_DX_PIN_OUPUT_HIGH(PE43711_SPI_LEA);
-			}
-			break;
-			case ATT_PE43711_IC1:
-			{
-				PERI_DX_PIN_OUPUT_HIGH(PE43711_SPI_LEB);
-			}
-			break;
-			default:
-				break;
-		}
-	}
-}
+		GPIO_SPI_PIN(PE43711_SPI_LEB), GPIO_SPI_PIN(PE43711_SPI_SCLK), GPIO_SPI_PIN(PE43711_SPI_SI), 0,
+		GPIO_SPI_PIN(PE43711_SPI_SCLK) | GPIO_SPI_PIN(PE43711_SPI_SI),
+		GPIO_SPI_MODE0, GPIO_SPI_LSB_FIRST, 500, 1000,
+	},
+};
 
 /*****************************************************************************************************
 *	  : static void att_pe43711_gpio_spi_write_reg(eAttPE43711ChipMux pe43711Mux, u8 val)
@@ -191,40 +96,8 @@ static void att_pe43711_cs_level_mux(eAttPE43711ChipMux pe43711Mux, AttPE43711Cs
 ******************************************************************************************************/
 static void att_pe43711_gpio_spi_write_reg(eAttPE43711ChipMux pe43711Mux, u8 val)
 {
-    u8 wcnt;
-    u32 dly_time = 1;
     //D[7]Ϊ0
-    u8 wdata = 0x7F & val;
-
-    pe43711_gpio_spi_begin(pe43711Mux);
-
-    att_pe43711_cs_level_mux(pe43711Mux, ATT_PE43711_CS_LOW);
-    att_dx_dly_us(dly_time);
-
-    for (wcnt = 0; wcnt < 8; wcnt++)
-    {
-    	PERI_DX_PIN_OUPUT_LOW(PE43711_SPI_SCLK);
-
-        if (wdata & 0x1)
-        {
-        	PERI_DX_PIN_OUPUT_HIGH(PE43711_SPI_SI);
-        }
-        else
-        {
-        	PERI_DX_PIN_OUPUT_LOW(PE43711_SPI_SI);
-        }
-        wdata >>= 1;
-
-        att_dx_dly_us(dly_time);
-        PERI_DX_PIN_OUPUT_HIGH(PE43711_SPI_SCLK);
-    }
-    //
-    PERI_DX_PIN_OUPUT_LOW(PE43711_SPI_SCLK);
-    att_dx_dly_us(10);
-    att_pe43711_cs_level_mux(pe43711Mux, ATT_PE43711_CS_HIGH);
-    att_dx_dly_us(10);
-    att_pe43711_cs_level_mux(pe43711Mux, ATT_PE43711_CS_LOW);
-    pe43711_gpio_spi_end(pe43711Mux);
+    gpio_spi_write(&s_pe43711Bus[(ATT_PE43711_IC1 == pe43711Mux) ? 1 : 0], 0x7F & val, 8);
 }
 
 /*****************************************************************************************************
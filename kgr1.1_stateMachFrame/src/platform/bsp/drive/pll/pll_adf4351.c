@@ -13,17 +13,30 @@
  *
  */
 #include <stdio.h>
+#ifndef ADF4351_HOST_TEST
 /* Xilinx includes. */
 #include "xil_printf.h"
 #include "xparameters.h"
+#endif
 
 #include "pll_adf4351.h"
+#ifndef ADF4351_HOST_TEST
+#include "gpio_spi.h"
+#endif
 
 #define ADF4351_SPI_SCLK 		        (17)
 #define ADF4351_SPI_DATA		        (18)
 #define ADF4351_SPI_LE		            (16)
 
-#define Y                               (10.000000)     //Ƶ
+#define ADF4351_PFD_HZ                  (20000000u)     //Ƶ: 10MHz ο, Ƶ, R=1
+#define ADF4351_VCO_MIN_HZ              (2200000000ull)
+#define ADF4351_VCO_MAX_HZ              (4400000000ull)
+#define ADF4351_RF_DIV_MAX              (6)             //Ƶ 64
+#define ADF4351_OUT_MIN_HZ              (ADF4351_VCO_MIN_HZ >> ADF4351_RF_DIV_MAX)
+#define ADF4351_OUT_MAX_HZ              (ADF4351_VCO_MAX_HZ)
+#define ADF4351_MOD_MAX                 (4095)
+#define ADF4351_BAND_SEL_DIV            (160)           //Ƶѡʱ = Fpfd / 160 = 125kHz, ֲ
+#define ADF4351_FREQ_CACHE_NUM          (8)
 
 void f4351_dx_dly_us(unsigned int tmptime)
 {
@@ -31,30 +44,54 @@ void f4351_dx_dly_us(unsigned int tmptime)
 }
 
 /* Private variables ---------------------------------------------------------*/
-
-//ģSPIǰӲSPIΪGPIO
-static void adf4351_begin(void)
+typedef struct
 {
-	PERI_DX_PIN_OUTPUT_MODE(ADF4351_SPI_LE);
-	PERI_DX_PIN_OUTPUT_MODE(ADF4351_SPI_SCLK);
-	PERI_DX_PIN_OUTPUT_MODE(ADF4351_SPI_DATA);
-    //
-	PERI_DX_PIN_OUPUT_HIGH(ADF4351_SPI_LE);
-	PERI_DX_PIN_OUPUT_LOW(ADF4351_SPI_SCLK);
-}
+    u64 hz;                 //0 Ϊ
+    u32 regs[6];            //regs[n] Ϊ Rn
+}adf4351_freq_cache_t;
+
+static adf4351_freq_cache_t s_adf4351FreqCache[ADF4351_FREQ_CACHE_NUM];
+static u32 s_adf4351FreqCacheNext;
+static u32 s_adf4351Regs[6];        //оƬиĴĵǰֵ
+static u32 s_adf4351RegsValid;      //s_adf4351Regs Чλ,  n λӦ Rn
+
+#ifdef ADF4351_HOST_TEST
+/*: ĴдɲԳʵ*/
+#define ADF4351_WRITE_REGS(regs, num)   adf4351_host_write((regs), (num))
+#else
+/*32 λλȷ, LE ͵ƽڼλ, LE , ߾Ϊ*/
+static gpio_spi_bus_t s_adf4351Bus =
+{
+	GPIO_SPI_PIN(ADF4351_SPI_LE), GPIO_SPI_PIN(ADF4351_SPI_SCLK), GPIO_SPI_PIN(ADF4351_SPI_DATA), 0,
+	GPIO_SPI_PIN(ADF4351_SPI_LE) | GPIO_SPI_PIN(ADF4351_SPI_SCLK) | GPIO_SPI_PIN(ADF4351_SPI_DATA),
+	GPIO_SPI_MODE0, 0, 500, 1000,
+};
+
+#define ADF4351_WRITE_REGS(regs, num)   gpio_spi_batch(&s_adf4351Bus, (regs), (num), 32)
+#endif
 
 /*****************************************************************************************************
-*	  : static void adf4351_end(void)
-*	˵: ģSPI󣬽ΪӲSPIģʽ
-*		  :
-*             
+*	  : static void adf4351_write_regs(const u32 *regs, u32 num)
+*	˵: һSPIỰڰ˳дһĴ, λ¼Ĵĵǰֵ
+*		  : 
+*             const u32 *regs: Ĵֵ ( 3 λΪĴ)
+*             u32 num: 
 *	  ֵ: 
 ******************************************************************************************************/
-static void adf4351_end(void)
+static void adf4351_write_regs(const u32 *regs, u32 num)
 {
-	PERI_DX_PIN_OUPUT_HIGH(ADF4351_SPI_LE);
-	PERI_DX_PIN_OUPUT_HIGH(ADF4351_SPI_SCLK);
-	PERI_DX_PIN_OUPUT_HIGH(ADF4351_SPI_DATA);
+    u32 i, n;
+
+    ADF4351_WRITE_REGS(regs, num);
+    for (i = 0; i < num; i++)
+    {
+        n = regs[i] & 0x7;
+        if (n <= ADF4351_R5_ADDR_BASE)
+        {
+            s_adf4351Regs[n] = regs[i];
+            s_adf4351RegsValid |= 1u << n;
+        }
+    }
 }
 
 /*****************************************************************************************************
@@ -66,60 +103,137 @@ static void adf4351_end(void)
 ******************************************************************************************************/
 static void adf4351_write(u32 val)
 {
-    uint32_t wcnt;
-    adf4351_begin();
-    u32 dly_time = 1;
-    PERI_DX_PIN_OUPUT_LOW(ADF4351_SPI_DATA);
+    adf4351_write_regs(&val, 1);
+}
 
-    f4351_dx_dly_us(dly_time);
-    PERI_DX_PIN_OUPUT_LOW(ADF4351_SPI_LE);
-    f4351_dx_dly_us(dly_time);
+/*****************************************************************************************************
+*	  : static void adf4351_best_frac(u32 num, u32 den, u32 maxDen, u32 *p, u32 *q)
+*	˵: ĸ maxDen ʱӽ num/den ķ p/q (չ + ),
+*             ȫ,  (maxDen=4095 ʱԼ 18 )
+*		  : 
+*             num/den: ƽķ, 0 <= num < den
+*             maxDen: ĸ
+*             p/q: 
+*	  ֵ: 
+******************************************************************************************************/
+static void adf4351_best_frac(u32 num, u32 den, u32 maxDen, u32 *p, u32 *q)
+{
+    u32 p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+    u32 n = num, d = den;
+    u32 a, t, k, pk, qk;
+    u64 e1, e2;
 
-    for (wcnt = 0; wcnt < 32; wcnt++)
+    while (d != 0)
+    {
+        a = n / d;
+        if (q0 + (u64)a * q1 > maxDen)
+            break;
+        t = p0 + a * p1;
+        p0 = p1;
+        p1 = t;
+        t = q0 + a * q1;
+        q0 = q1;
+        q1 = t;
+        t = n - a * d;
+        n = d;
+        d = t;
+    }
+    if (d == 0)
     {
-    	PERI_DX_PIN_OUPUT_LOW(ADF4351_SPI_SCLK);
+        /*ȷʾ*/
+        *p = p1;
+        *q = q1;
+        return;
+    }
+    /*һ p1/q1 ĸİѡһ*/
+    k = (maxDen - q0) / q1;
+    pk = p0 + k * p1;
+    qk = q0 + k * q1;
+    e1 = (u64)p1 * den > (u64)num * q1 ? (u64)p1 * den - (u64)num * q1 : (u64)num * q1 - (u64)p1 * den;
+    e2 = (u64)pk * den > (u64)num * qk ? (u64)pk * den - (u64)num * qk : (u64)num * qk - (u64)pk * den;
+    /*|p/q - num/den| = e / (q * den), ˱Ƚ*/
+    if (e1 * qk <= e2 * q1)
+    {
+        *p = p1;
+        *q = q1;
+    }
+    else
+    {
+        *p = pk;
+        *q = qk;
+    }
+}
 
-        if (val & 0x80000000)
-        {
-        	PERI_DX_PIN_OUPUT_HIGH(ADF4351_SPI_DATA);
-        }
-        else
-        {
-        	PERI_DX_PIN_OUPUT_LOW(ADF4351_SPI_DATA);
-        }
-        val <<= 1;
+/*****************************************************************************************************
+*	  : int adf4351_calc_pll(u64 freqHz, adf4351_pll_t *pll)
+*	˵:  freqHz ķƵ
+*             RFout = [INT + (FRAC/MOD)] * (Fpfd/RF Divider), Fvco = RFout * RF Divider (2.2G-4.4G)
+*             Fpfd = 20MHz (10MHz ο, Ƶ, R=1), N ֱӰʵʼƵʼ
+*		  : 
+*             freqHz: Ƶ (Hz), 35MHz~4400MHz
+*             pll: 
+*	  ֵ: ɹ 0, ƵʳΧ -1
+******************************************************************************************************/
+int adf4351_calc_pll(u64 freqHz, adf4351_pll_t *pll)
+{
+    u64 vco = freqHz;
+    u32 div = 0, num, p, q;
+    u64 n;
 
-        f4351_dx_dly_us(dly_time);
-        PERI_DX_PIN_OUPUT_HIGH(ADF4351_SPI_SCLK);
+    if (freqHz > ADF4351_VCO_MAX_HZ)
+        return -1;
+    while (vco < ADF4351_VCO_MIN_HZ)
+    {
+        if (++div > ADF4351_RF_DIV_MAX)
+            return -1;
+        vco <<= 1;
     }
-    //
-    PERI_DX_PIN_OUPUT_LOW(ADF4351_SPI_SCLK);
-    f4351_dx_dly_us(10);
-    PERI_DX_PIN_OUPUT_HIGH(ADF4351_SPI_LE);
-    f4351_dx_dly_us(10);
-    PERI_DX_PIN_OUPUT_LOW(ADF4351_SPI_LE);
-    adf4351_end();
+    n = vco / ADF4351_PFD_HZ;
+    num = (u32)(vco - n * ADF4351_PFD_HZ);
+    adf4351_best_frac(num, ADF4351_PFD_HZ, ADF4351_MOD_MAX, &p, &q);
+    if (p == q)
+    {
+        /*СֽλΪ 1*/
+        n++;
+        p = 0;
+    }
+    if (q < 2)
+    {
+        /*MOD СΪ 2*/
+        p *= 2;
+        q = 2;
+    }
+    pll->INT = (u16)n;
+    pll->FRAC = (u16)p;
+    pll->MOD = (u16)q;
+    pll->RF_Div = (u8)div;
+    return 0;
 }
 
 /*****************************************************************************************************
-*	  : void adf4351_set_freq(float Fre)
-*	˵: adf4351Ƶ(35 MHz to 4400 MHz)
+*	  : u64 adf4351_pll_freq_hz(const adf4351_pll_t *pll)
+*	˵: ƵӦʵƵ
 *		  : 
-*               freq: õƵ(λMHz -> (xx.x) M Hz)
-*	  ֵ: ɹ:DX_EOK	ʧܷ:-DX_EIO
-*   Reference frequency: 25MHz;Output frequency: 200MHz;VCO frequency: 3200MHz;Prescaler: 8/9;
-    RF divider: 16;VCO channel spacing frequency: 200KHz;PFD frequency: 10MHz;
-    INT: 320;FRAC: 0;MOD: 100;R: 1;Lock Clk Div: 6; bank clk div: 200; Phase: 1
-    RFout = [INT + (FRAC/MOD)] * (Fpfd/RF Divider)
-    Fpfd = REFIN * [(1 + D)/(R * (1 + T))] //default:25M
-    Fvco = RF divider * Output frequency   2.2G-4.4G
+*             pll: Ƶ
+*	  ֵ: Ƶ (Hz),  MOD * 2^RF_Div ضȡ
 ******************************************************************************************************/
-void adf4351_set_freq(double freq)		//	fre
+u64 adf4351_pll_freq_hz(const adf4351_pll_t *pll)
+{
+    u64 vco = ((u64)pll->INT * pll->MOD + pll->FRAC) * ADF4351_PFD_HZ;
+
+    return vco / ((u64)pll->MOD << pll->RF_Div);
+}
+
+/*****************************************************************************************************
+*	  : void adf4351_build_regs(const adf4351_pll_t *pll, u32 *regs)
+*	˵:  R0~R5 ļĴֵ, regs[n] Ϊ Rn
+*		  : 
+*             pll: Ƶ
+*             regs: 6 Ĵֵ
+*	  ֵ: 
+******************************************************************************************************/
+void adf4351_build_regs(const adf4351_pll_t *pll, u32 *regs)
 {
-    u8 RF_Div = 0;      //DB20 DB21 DB22 DB23   VCOϸ
-    u16 INT = 0;        //DB30-DB15             Ƶ֤鲿֣
-    u16 FRAC = 0;       //DB14-DB3              ƵСַӣ
-    u16 MOD = 0;        //DB14-DB3              ƵСַĸ
     adf4351_r0_t r0Val = { 0 };
     adf4351_r1_t r1Val = { 0 };
     adf4351_r2_t r2Val = { 0 };
@@ -127,42 +241,14 @@ void adf4351_set_freq(double freq)		//	fre
     adf4351_r4_t r4Val = { 0 };
     adf4351_r5_t r5Val = { 0 };
 
-    u8 RF_Div_sum = 1;
-    u32 VCO_Freq = freq;
-
-    double N = 0, num = 0;
-
-    while ((VCO_Freq < 2200) || (VCO_Freq > 4400))   //VCOϸϵVCO2.2GHz4.4GHz
-    {
-        RF_Div++;
-        if (RF_Div > 6) return;
-        VCO_Freq *= 2;
-        RF_Div_sum *= 2;
-    }
-
-    N = freq / (Y / RF_Div_sum);    //Ƶϵ
-    INT = N;        //õƵϵ
-    N = N - INT;    //õƵϵС
-
-    for (MOD = 2; MOD < 4096; MOD++)   //СƵķĸ
-    {
-        for (FRAC = 0; FRAC < MOD; FRAC++)
-        {
-            num = FRAC * 1.0 / MOD;
-            if ((num - N) > -0.0001 && (num - N) < 0.0000000001) break;
-        }
-        if ((num - N) > -0.0001 && (num - N) < 0.0000000001) break;
-    }
-    if (MOD == 4096) return;
-
     r5Val.Control = ADF4351_R5_ADDR_BASE;
     r5Val.Lock_Detect = 1;
-    adf4351_write(r5Val.r5_data);
+    regs[5] = r5Val.r5_data;
 
     r4Val.Control = ADF4351_R4_ADDR_BASE;
     r4Val.Feedback = 1;
-    r4Val.RF_Div = RF_Div;
-    r4Val.B_Clock_Div_Val = 80;
+    r4Val.RF_Div = pll->RF_Div;
+    r4Val.B_Clock_Div_Val = ADF4351_BAND_SEL_DIV;
     r4Val.VCO = 0;
     r4Val.MTLD = 0;
     r4Val.AuxOutput = 0;
@@ -170,7 +256,7 @@ void adf4351_set_freq(double freq)		//	fre
     r4Val.AuxOutpu_Power = 3;
     r4Val.RF_Output_En = 1;
     r4Val.Output_Power = 3;
-    adf4351_write(r4Val.r4_data);
+    regs[4] = r4Val.r4_data;
 
     r3Val.Control = ADF4351_R3_ADDR_BASE;
     r3Val.Band_Select_Clock = 0;
@@ -179,7 +265,7 @@ void adf4351_set_freq(double freq)		//	fre
     r3Val.CSR = 0;
     r3Val.Clock_Div_Mod = 0;
     r3Val.Clock_Div_Val = 150;
-    adf4351_write(r3Val.r3_data);
+    regs[3] = r3Val.r3_data;
 
     r2Val.Control = ADF4351_R2_ADDR_BASE;
     r2Val.L_Noise_Spur = 0;
@@ -195,19 +281,93 @@ void adf4351_set_freq(double freq)		//	fre
     r2Val.PD = 0;
     r2Val.Three_State = 0;
     r2Val.Counter_Reset = 0;
-    adf4351_write(r2Val.r2_data);
+    regs[2] = r2Val.r2_data;
 
     r1Val.Control = ADF4351_R1_ADDR_BASE;
-    r1Val.Modulus = MOD;
+    r1Val.Modulus = pll->MOD;
     r1Val.Phase = 0;
     r1Val.Prescaler = 1;
     r1Val.Phase_Adjust = 0;
-    adf4351_write(r1Val.r1_data);
+    regs[1] = r1Val.r1_data;
 
     r0Val.Control = ADF4351_R0_ADDR_BASE;
-    r0Val.Fractional = FRAC/2;//2 syd
-    r0Val.Integer = INT/2;//2 syd
-    adf4351_write(r0Val.r0_data);
+    r0Val.Fractional = pll->FRAC;
+    r0Val.Integer = pll->INT;
+    regs[0] = r0Val.r0_data;
+}
+
+/*****************************************************************************************************
+*	  : int adf4351_set_freq_hz(u64 freqHz)
+*	˵: adf4351Ƶ(35 MHz to 4400 MHz)
+*             ùƵʻĴֵ, ƵصЩƵʱټ;
+*             ֻдоƬǰֵͬļĴ. MOD/R ˫д R0 ʱЧ,
+*              R1~R5 дʱ R0 һд ().
+*		  : 
+*             freqHz: Ƶ (Hz)
+*	  ֵ: дļĴ, ƵʳΧ -1
+******************************************************************************************************/
+int adf4351_set_freq_hz(u64 freqHz)
+{
+    adf4351_freq_cache_t *c = NULL;
+    adf4351_pll_t pll;
+    u32 wr[6], num = 0, i;
+    int k;
+
+    /*ȼ鷶Χ, ԽƵ ( 0) л*/
+    if (freqHz < ADF4351_OUT_MIN_HZ || freqHz > ADF4351_OUT_MAX_HZ)
+        return -1;
+    for (i = 0; i < ADF4351_FREQ_CACHE_NUM; i++)
+    {
+        /*hz Ϊ 0 ǿ*/
+        if (s_adf4351FreqCache[i].hz != 0 && s_adf4351FreqCache[i].hz == freqHz)
+        {
+            c = &s_adf4351FreqCache[i];
+            break;
+        }
+    }
+    if (c == NULL)
+    {
+        if (adf4351_calc_pll(freqHz, &pll) != 0)
+            return -1;
+        c = &s_adf4351FreqCache[s_adf4351FreqCacheNext];
+        s_adf4351FreqCacheNext = (s_adf4351FreqCacheNext + 1) % ADF4351_FREQ_CACHE_NUM;
+        c->hz = freqHz;
+        adf4351_build_regs(&pll, c->regs);
+    }
+
+    for (k = 5; k >= 0; k--)
+    {
+        if (!(s_adf4351RegsValid & (1u << k)) || s_adf4351Regs[k] != c->regs[k] || (0 == k && num != 0))
+            wr[num++] = c->regs[k];
+    }
+    if (num != 0)
+        adf4351_write_regs(wr, num);
+    return (int)num;
+}
+
+/*****************************************************************************************************
+*	  : void adf4351_set_freq(double freq)
+*	˵: adf4351Ƶ(35 MHz to 4400 MHz)
+*		  : 
+*               freq: õƵ(λMHz -> (xx.x) M Hz)
+*	  ֵ: 
+******************************************************************************************************/
+void adf4351_set_freq(double freq)		//	fre
+{
+    if (freq <= 0)
+        return;
+    adf4351_set_freq_hz((u64)(freq * 1000000.0 + 0.5));
+}
+
+/*****************************************************************************************************
+*	  : void adf4351_invalidate_regs(void)
+*	˵: оƬλ, һƵʱдȫĴ
+*		  : 
+*	  ֵ: 
+******************************************************************************************************/
+void adf4351_invalidate_regs(void)
+{
+    s_adf4351RegsValid = 0;
 }
 
 void Frequency_66MHz(void)
@@ -239,6 +399,7 @@ void Frequency_66MHz(void)
     f4351_dx_dly_us(1000);
 }
 
+#ifndef ADF4351_HOST_TEST
 /*****************************************************************************************************
 *	  : static err_t adf4351_init(dx_device_t dev)
 *	˵: adf4351ʼ
@@ -253,11 +414,12 @@ static err_t adf4351_init(void)
     adf4351_r3_t r3Val = { 0 };
     adf4351_r4_t r4Val = { 0 };
     adf4351_r5_t r5Val = { 0 };
+    u32 regs[6];
 
     /*to write Register 5 to set digital lock detector*/
     r5Val.Control = ADF4351_R5_ADDR_BASE;
     r5Val.Lock_Detect = 1;
-    adf4351_write(r5Val.r5_data);
+    regs[0] = r5Val.r5_data;
     /*(DB23=1)The signal is taken from the VCO directly;
     (DB22-20:4H)the RF divider is 16;
     (DB19-12:50H)R is 80
@@ -274,7 +436,7 @@ static err_t adf4351_init(void)
     r4Val.AuxOutpu_Power = 3;
     r4Val.RF_Output_En = 1;
     r4Val.Output_Power = 3;
-    adf4351_write(r4Val.r4_data);
+    regs[1] = r4Val.r4_data;
     /*(DB14-3:96H)clock divider value is 150.*/
     r3Val.Control = ADF4351_R3_ADDR_BASE;
     r3Val.Band_Select_Clock = 0;
@@ -283,7 +445,7 @@ static err_t adf4351_init(void)
     r3Val.CSR = 0;
     r3Val.Clock_Div_Mod = 0;
     r3Val.Clock_Div_Val = 150;
-    adf4351_write(r3Val.r3_data);
+    regs[2] = r3Val.r3_data;
     /*(DB6=1)set PD polarity is positive;
     (DB7=1)LDP is 6nS;
     (DB8=0)enable fractional-N digital lock detect;
@@ -303,7 +465,7 @@ static err_t adf4351_init(void)
     r2Val.PD = 0;
     r2Val.Three_State = 0;
     r2Val.Counter_Reset = 0;       
-    adf4351_write(r2Val.r2_data);
+    regs[3] = r2Val.r2_data;
     /*(DB14-3:6H)MOD counter is 6;
     (DB26-15:6H)PHASE word is 1,neither the phase resync 
      nor the spurious optimization functions are being used
@@ -313,13 +475,14 @@ static err_t adf4351_init(void)
     r1Val.Phase = 1;
     r1Val.Prescaler = 1;
     r1Val.Phase_Adjust = 0;
-    adf4351_write(r1Val.r1_data);
+    regs[4] = r1Val.r1_data;
     /*(DB14-3:0H)FRAC value is 0;
     (DB30-15:140H)INT value is 320;*/
     r0Val.Control = ADF4351_R0_ADDR_BASE;
     r0Val.Fractional = 0;
     r0Val.Integer = 320;
-    adf4351_write(r0Val.r0_data);
+    regs[5] = r0Val.r0_data;
+    adf4351_write_regs(regs, 6);
     f4351_dx_dly_us(1000);
     /*Ĭ62MHz*/
     adf4351_set_freq(124);
@@ -337,6 +500,7 @@ void dx_hw_adf4351_init(void)
 {
     adf4351_init();
 }
+#endif
 
 
 
@@ -23,6 +23,7 @@
 
 #include "rf_rx1922.h"
 #include "sys_ctrl.h"
+#include "gpio_spi.h"
 //#include "KgrInfo.h"
 
 #define DBG_TAG    "RF_RX1922"
@@ -34,21 +35,6 @@
 #define RX1922_GPIO_SPI_MISO			(12)
 #define RX1922_GPIO_SPI_MOSI			(11)
 
-#define rf_rx1922_spi_csa_out()     			PERI_DX_PIN_OUTPUT_MODE(RX1922_GPIO_SPI_CS0)
-#define rf_rx1922_spi_csa_high()      			PERI_DX_PIN_OUPUT_HIGH(RX1922_GPIO_SPI_CS0)
-#define rf_rx1922_spi_csa_low()       			PERI_DX_PIN_OUPUT_LOW(RX1922_GPIO_SPI_CS0)
-
-#define rf_rx1922_spi_miso_in()      			PERI_DX_PIN_INTPUT_MODE(RX1922_GPIO_SPI_MISO)
-#define rf_rx1922_spi_miso_read()    			PERI_DX_PIN_INTPUT(RX1922_GPIO_SPI_MISO)
-
-#define rf_rx1922_spi_clk_out()     			PERI_DX_PIN_OUTPUT_MODE(RX1922_GPIO_SPI_CLK)
-#define rf_rx1922_spi_clk_high()     			PERI_DX_PIN_OUPUT_HIGH(RX1922_GPIO_SPI_CLK)
-#define rf_rx1922_spi_clk_low()      			PERI_DX_PIN_OUPUT_LOW(RX1922_GPIO_SPI_CLK)
-
-#define rf_rx1922_spi_mosi_out()     			PERI_DX_PIN_OUTPUT_MODE(RX1922_GPIO_SPI_MOSI)
-#define rf_rx1922_spi_mosi_high()				PERI_DX_PIN_OUPUT_HIGH(RX1922_GPIO_SPI_MOSI)
-#define rf_rx1922_spi_mosi_low()				PERI_DX_PIN_OUPUT_LOW(RX1922_GPIO_SPI_MOSI)
-
 void delay_dx_rf(unsigned int timeVal)
 {
 	for(int i = 0; i < timeVal*20; i++)
@@ -106,269 +92,60 @@ static const struct rf_rx1922_config IC0_B1_RX1922Regs_1490[] =
 
 
 
-//ģSPIǰӲSPIΪRX1922 GPIO
-/*****************************************************************************************************
-*	  : static void xnd2260_gpio_spi_begin(void)
-*	˵: ģSPIǰӲSPIΪRX1922 GPIO
-*		  :
-*             eRfRx1922ChipMux rfMux: ѡRX1922оƬ
-*	  ֵ: 
-******************************************************************************************************/
-static void rx1922_gpio_spi_begin(eRfRx1922ChipMux rfMux)
+/*4  SPI, ģʽ 0, λȷ: д 32 λ (W λ + 7 λַ + 24 λ),  8 λַ 24 λ*/
+static gpio_spi_bus_t s_rx1922Bus =
 {
-	rf_rx1922_spi_clk_out();
-	rf_rx1922_spi_miso_in();
-	rf_rx1922_spi_mosi_out();
+	GPIO_SPI_PIN(RX1922_GPIO_SPI_CS0), GPIO_SPI_PIN(RX1922_GPIO_SPI_CLK),
+	GPIO_SPI_PIN(RX1922_GPIO_SPI_MOSI), GPIO_SPI_PIN(RX1922_GPIO_SPI_MISO),
+	GPIO_SPI_PIN(RX1922_GPIO_SPI_CS0) | GPIO_SPI_PIN(RX1922_GPIO_SPI_CLK) | GPIO_SPI_PIN(RX1922_GPIO_SPI_MOSI),
+	GPIO_SPI_MODE0, 0, 2000, 2000,
+};
 
-	rf_rx1922_spi_clk_low();
-	rf_rx1922_spi_mosi_high();
-	switch (rfMux)
-	{
-		case RF_RX1922_C1:
-		{
-			rf_rx1922_spi_csa_out();
-			rf_rx1922_spi_csa_high();
-		}
-		break;
-		default:
-			break;
-	}
-}
+#define RX1922_WRITE_WORD(addr, val)		((((u32)(addr) & 0x7F) << 24) | ((val) & 0xFFFFFF))
+#define RX1922_READ_CMD(addr)				(0x80 | ((addr) & 0x7F))
 
-/*****************************************************************************************************
-*	  : static void rx1922_gpio_spi_end(eRfRx1922ChipMux rfMux)
-*	˵: ģSPI󣬽RX1922_GPIOΪӲSPIģʽ
-*		  :
-*             eRfRx1922ChipMux rfMux: ѡRX1922оƬ
-*	  ֵ: 
-******************************************************************************************************/
-static void rx1922_gpio_spi_end(eRfRx1922ChipMux rfMux)
+void rx1922_write_reg(u32 addr, u32 val)
 {
-	rf_rx1922_spi_clk_high();
-	rf_rx1922_spi_mosi_high();
-
-	switch (rfMux)
-	{
-		case RF_RX1922_C1:
-		{
-			rf_rx1922_spi_csa_high();
-		}
-		break;
-		default:
-			break;
-	}
+	gpio_spi_write(&s_rx1922Bus, RX1922_WRITE_WORD(addr, val), 32);
 }
 
-/*****************************************************************************************************
-*	  : static void rf_rx1922_cs_level_mux(eRfRx1922ChipMux rfMux, eRfRx1922CsLevelMux rfCsLevelMux)
-*	˵: ѡrx1922оƬ
-*		  :
-*			  eRfRx1922ChipMux rfMux: ѡrx1922оƬ
-* 			  eRfCsLevelMux rfCsLevelMux: ѡrx1922оƬѡߵ
-*	  ֵ: 
-******************************************************************************************************/
-static void rf_rx1922_cs_level_mux(eRfRx1922ChipMux rfMux, eRfRx1922CsLevelMux rfCsLevelMux)
+u32 rx1922_read_reg(u32 addr)
 {
-	if (RF_RX1922_CS_LOW == rfCsLevelMux)
-	{
-		switch (rfMux)
-		{
-			case RF_RX1922_C1:
-			{
-				rf_rx1922_spi_csa_low();
-			}
-			break;
-			default:
-				break;
-		}
-	}
-	else
-	{
-		switch (rfMux)
-		{
-			case RF_RX1922_C1:
-			{
-				rf_rx1922_spi_csa_high();
-			}
-			break;
-			default:
-				break;
-		}
-	}
+	return gpio_spi_read(&s_rx1922Bus, RX1922_READ_CMD(addr), 8, 24);
 }
 
 /*****************************************************************************************************
-*	  : static void rf_rx1922_gpio_spi_write_reg(eRfRx1922ChipMux rfMux, 
-															u8 addr, u32 val)
-*	˵: rx1922ģspiд
+*	  : static void rx1922_load_regs(const struct rf_rx1922_config *regs, u32 num)
+*	˵: һSPIỰдżĴ, ضУ
 *		  :
-*			  eRfRx1922ChipMux rfMux: ѡrx1922оƬ
-*		      u8 addr: Ĵַ
-*             u32 val: д
+*			  const struct rf_rx1922_config *regs: Ĵ
+*		      u32 num: Ĵ
 *	  ֵ: 
 ******************************************************************************************************/
-static void rf_rx1922_gpio_spi_write_reg(eRfRx1922ChipMux rfMux, u8 addr, u32 val)
+static void rx1922_load_regs(const struct rf_rx1922_config *regs, u32 num)
 {
-	u32 TxData;
-	u8 w_cnt;
-	u32 dly_time = 50;
-
-	addr &= 0x7F;/*7λЧַ*/
-	val &= 0xFFFFFF;/*24λ*/
-
-	//дƴӣWλΪ
-	TxData = ((0x0 << 31) | (addr << 24) | val);
-
-	rx1922_gpio_spi_begin(rfMux);
-	//delay_dx_rf(dly_time);
-	delay_dx_rf(dly_time);
-	//<ʹ>Ч
-	rf_rx1922_cs_level_mux(rfMux, RF_RX1922_CS_LOW);
-	delay_dx_rf(dly_time);
-	for (w_cnt = 0; w_cnt < 32; w_cnt++)
-	{
-		//<ʱ>,
-		rf_rx1922_spi_clk_low();
-
-		//жϴд01
-		if (TxData & 0x80000000)
-		{
-			//дΪ1MOSI
-			rf_rx1922_spi_mosi_high();
-		}
-		else
-		{
-			//дΪ0MOSI
-			rf_rx1922_spi_mosi_low();
-		}
-		delay_dx_rf(dly_time);
-
-		//дһλ
-		TxData <<= 1;
-
-		//<ʱ>,
-		rf_rx1922_spi_clk_high();
-		delay_dx_rf(dly_time);
-	}
-
-	//<ʱ>,
-	rf_rx1922_spi_clk_low();
-	//дɣ<ʹ>
-	rf_rx1922_cs_level_mux(rfMux, RF_RX1922_CS_HIGH);
-	delay_dx_rf(dly_time);
-	rx1922_gpio_spi_end(rfMux);
-	delay_dx_rf(dly_time);
-}
+	u32 i, temp;
 
-/*****************************************************************************************************
-*	  : static u32 rf_rx1922_gpio_spi_read_reg(eRfRx1922ChipMux rfMux, u8 addr)
-*	˵: rx1922ģspiд
-*		  :
-*			  eRfRx1922ChipMux rfMux: ѡrx1922оƬ
-*		      u8 addr: Ĵַ
-*	  ֵ: Ĵֵ
-******************************************************************************************************/
-static u32 rf_rx1922_gpio_spi_read_reg(eRfRx1922ChipMux rfMux, u8 addr)
-{
-	u8 w_cnt;
-	u32 r_cnt;
-	u32 value = 0, read_data;
-	u32 dly_time = 50;
-
-	//λΪ1
-	addr &= 0x7F;/*7λЧַ*/
-	addr = 0x80 | addr;
-
-	rx1922_gpio_spi_begin(rfMux);
-	delay_dx_rf(dly_time);
-	//<ʹ>Ч
-	rf_rx1922_cs_level_mux(rfMux, RF_RX1922_CS_LOW);
-
-	//жϴд01
-	for (w_cnt = 0; w_cnt < 8; w_cnt++)
+	gpio_spi_begin(&s_rx1922Bus);
+	for (i = 0; i < num; i++)
 	{
-		//<ʱ>,
-		rf_rx1922_spi_clk_low();
-
-		//жϴд01
-		if (addr & 0x80)
-		{
-			//дΪ1MOSI
-			rf_rx1922_spi_mosi_high();
-		}
-		else
-		{
-			//дΪ0MOSI
-			rf_rx1922_spi_mosi_low();
-		}
-		delay_dx_rf(dly_time);
-
-		//дһλ
-		addr <<= 1;
-
-		//<ʱ>,
-		rf_rx1922_spi_clk_high();
-		delay_dx_rf(dly_time);
+		gpio_spi_frame(&s_rx1922Bus, RX1922_WRITE_WORD(regs[i].RegAddr, regs[i].RegData), 32, 0);
 	}
-
-	for (r_cnt = 24; r_cnt > 0; r_cnt--)
+	for (i = 0; i < num; i++)
 	{
-		//<ʱ>,
-		rf_rx1922_spi_clk_low();
-
-		delay_dx_rf(dly_time);
-
-		//SDIжǰbit
-		read_data = rf_rx1922_spi_miso_read();
-
-		//λ֮ǰݽƴ
-		read_data = read_data << (r_cnt - 1);
-
-		value = value | read_data;
-
-		//<ʱ>,
-		rf_rx1922_spi_clk_high();
-
-		delay_dx_rf(dly_time);
-
+		temp = gpio_spi_frame(&s_rx1922Bus, RX1922_READ_CMD(regs[i].RegAddr), 8, 24);
+		if (regs[i].RegData != temp)
+			dx_kprintf(" KGR_B1I_B1C_L1_M rx1922: reg:%d write 0x%x read 0x%x\r\n", regs[i].RegAddr, regs[i].RegData, temp);
 	}
-	//<ʱ>,
-	rf_rx1922_spi_clk_low();
-	//ɣ<ʹ>
-	rf_rx1922_cs_level_mux(rfMux, RF_RX1922_CS_HIGH);
-	delay_dx_rf(dly_time);
-	rx1922_gpio_spi_end(rfMux);
-	delay_dx_rf(dly_time);
-	return (value & 0xFFFFFF);
-}
-
-void rx1922_write_reg(u32 addr, u32 val)
-{
-	rf_rx1922_gpio_spi_write_reg(RF_RX1922_C1, addr, val);
-}
-
-u32 rx1922_read_reg(u32 addr)
-{
-	return rf_rx1922_gpio_spi_read_reg(RF_RX1922_C1, addr);
+	gpio_spi_end(&s_rx1922Bus);
 }
 
 void rx1922_init(void)
 {
-	u32 i, temp;
 	if (HW_KGR_LC_B1 == g_KgrFreqId)
 	{
 		dx_kprintf(" KGR_B1I_B1C_L1_M 1490--------------------------------------------------------------<<<<<<<<<<<<<<<<<<<\r\n");
-		for (i = 0; i < sizeof(IC0_B1_RX1922Regs_1490) / sizeof(struct rf_rx1922_config); i++)
-		{
-			rx1922_write_reg(IC0_B1_RX1922Regs_1490[i].RegAddr, IC0_B1_RX1922Regs_1490[i].RegData);
-			delay_dx_rf(10);
-			temp = rx1922_read_reg(IC0_B1_RX1922Regs_1490[i].RegAddr);
-
-			if (IC0_B1_RX1922Regs_1490[i].RegData != temp)
-				dx_kprintf(" KGR_B1I_B1C_L1_M rx1922: reg:%d write 0x%x read 0x%x\r\n", IC0_B1_RX1922Regs_1490[i].RegAddr, IC0_B1_RX1922Regs_1490[i].RegData, temp);
-		}
-
-
+		rx1922_load_regs(IC0_B1_RX1922Regs_1490, sizeof(IC0_B1_RX1922Regs_1490) / sizeof(struct rf_rx1922_config));
 	}
 
 }
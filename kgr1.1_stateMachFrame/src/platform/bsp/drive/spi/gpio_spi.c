@@ -0,0 +1,651 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    gpio_spi.c
+  * @brief   This file provides code for the GPIO bit-banged SPI engine
+  *          shared by MT9653, ADF4351, RX1922 and PE43711.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025, ZS Development Team.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  * Change Logs:
+  * Date           Author       Notes
+  * 2026-10-19     zs        the first version
+  ******************************************************************************
+  */
+#include "gpio_spi.h"
+
+#ifdef GPIO_SPI_HOST_MOCK
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#else
+#include "sys_ctrl.h"
+#include "xgpio.h"
+extern uint32_t tick_get(void);
+#endif
+
+#define GPIO_SPI_CAL_MS                 (10)        /*궨ʱ*/
+#define GPIO_SPI_CAL_CHUNK              (100)       /*궨ʱÿæȵѭ*/
+#define GPIO_SPI_DEFAULT_LOOPS_PER_MS   (100000)    /*δ궨ʱıֵ, ʱƫ*/
+
+static u32 s_loopsPerMs = GPIO_SPI_DEFAULT_LOOPS_PER_MS;
+static u32 s_portOut;       /*ݼĴӰ, Ựʼʱͬ*/
+
+#ifdef GPIO_SPI_HOST_MOCK
+static void mock_port_write(u32 v);
+static u32 mock_port_read(void);
+static void mock_port_dir(u32 in, u32 out);
+static void mock_spin(u32 loops);
+static u32 tick_get(void);
+
+#define GPIO_SPI_PORT_WRITE(v)          mock_port_write(v)
+#define GPIO_SPI_PORT_READ()            mock_port_read()
+#define GPIO_SPI_PORT_DIR(in, out)      mock_port_dir((in), (out))
+#else
+/*ֱдݼĴ, һδ洢ͬʱʱӺ*/
+#define GPIO_SPI_PORT_WRITE(v)          XGpio_WriteReg(gPeriGpioSpi.BaseAddress, XGPIO_DATA_OFFSET, (v))
+#define GPIO_SPI_PORT_READ()            XGpio_ReadReg(gPeriGpioSpi.BaseAddress, XGPIO_DATA_OFFSET)
+/*Ĵ 1 Ϊ*/
+#define GPIO_SPI_PORT_DIR(in, out)      XGpio_SetDataDirection(&gPeriGpioSpi, PERI_FUNCTION_CHANNEL, \
+                                            (XGpio_GetDataDirection(&gPeriGpioSpi, PERI_FUNCTION_CHANNEL) | (in)) & ~(out))
+#endif
+
+static void gpio_spi_spin(u32 loops)
+{
+#ifdef GPIO_SPI_HOST_MOCK
+	mock_spin(loops);
+#else
+	volatile u32 n = loops;
+
+	while (n--)
+		;
+#endif
+}
+
+static u32 gpio_spi_ns_to_loops(u32 ns)
+{
+	return (u32)(((u64)ns * s_loopsPerMs + 999999) / 1000000);
+}
+
+/*****************************************************************************************************
+*	  : void gpio_spi_calibrate(void)
+*	˵:  tick_get Ϊ׼ͳ GPIO_SPI_CAL_MS ڵæѭ. ʱδʱ
+*			  (Ȳ tick 仯) ԭֵ.
+*		  : 
+*	  ֵ: 
+******************************************************************************************************/
+void gpio_spi_calibrate(void)
+{
+	u32 limit = GPIO_SPI_DEFAULT_LOOPS_PER_MS / GPIO_SPI_CAL_CHUNK * 4;
+	u32 start, chunks = 0;
+
+	/*뵽 tick */
+	start = tick_get();
+	while (tick_get() == start)
+	{
+		if (++chunks > limit)
+			return;
+		gpio_spi_spin(GPIO_SPI_CAL_CHUNK);
+	}
+	start = tick_get();
+	chunks = 0;
+	while (tick_get() - start < GPIO_SPI_CAL_MS)
+	{
+		if (++chunks > limit * GPIO_SPI_CAL_MS)
+			return;
+		gpio_spi_spin(GPIO_SPI_CAL_CHUNK);
+	}
+	if (chunks != 0)
+		s_loopsPerMs = chunks * GPIO_SPI_CAL_CHUNK / GPIO_SPI_CAL_MS;
+}
+
+u32 gpio_spi_loops_per_ms(void)
+{
+	return s_loopsPerMs;
+}
+
+void gpio_spi_delay_ns(u32 ns)
+{
+	gpio_spi_spin(gpio_spi_ns_to_loops(ns));
+}
+
+static u32 gpio_spi_clk_idle(const gpio_spi_bus_t *bus)
+{
+	return (bus->mode & 0x2) ? bus->clkMask : 0;
+}
+
+/*ǰڵʱӵƽ: CPHA=0 Ϊеƽ (ǰر), CPHA=1 ΪЧƽ*/
+static u32 gpio_spi_clk_first(const gpio_spi_bus_t *bus)
+{
+	return gpio_spi_clk_idle(bus) ^ ((bus->mode & 0x1) ? bus->clkMask : 0);
+}
+
+static u32 gpio_spi_cs_active(const gpio_spi_bus_t *bus)
+{
+	return (bus->flags & GPIO_SPI_CS_ACTIVE_HIGH) ? bus->csMask : 0;
+}
+
+static void gpio_spi_build_lut(gpio_spi_bus_t *bus)
+{
+	u32 clkA = gpio_spi_clk_first(bus);
+	u32 n, i, b;
+
+	for (n = 0; n < 16; n++)
+	{
+		for (i = 0; i < 4; i++)
+		{
+			if (bus->flags & GPIO_SPI_LSB_FIRST)
+				b = (n >> i) & 0x1;
+			else
+				b = (n >> (3 - i)) & 0x1;
+			bus->lut[n][i] = (b ? bus->mosiMask : 0) | clkA;
+		}
+	}
+	bus->ready = 1;
+}
+
+/*****************************************************************************************************
+*	  : void gpio_spi_begin(gpio_spi_bus_t *bus)
+*	˵: ʼһλỰ: ùܽŷ, ͬӰӼĴ, ƬѡЧ, ʱӿ
+*		  :
+*             gpio_spi_bus_t *bus: 
+*	  ֵ: 
+******************************************************************************************************/
+void gpio_spi_begin(gpio_spi_bus_t *bus)
+{
+	u32 pins = bus->csMask | bus->clkMask | bus->mosiMask;
+	u32 w;
+
+	if (!bus->ready)
+		gpio_spi_build_lut(bus);
+	/*ÿΰǰ궨, 궨״ʹ*/
+	bus->halfLoops = gpio_spi_ns_to_loops(bus->halfNs);
+	bus->csLoops = gpio_spi_ns_to_loops(bus->csNs);
+
+	GPIO_SPI_PORT_DIR(bus->misoMask & ~bus->mosiMask, pins);
+	w = GPIO_SPI_PORT_READ();
+	w = (w & ~pins) | (bus->csMask ^ gpio_spi_cs_active(bus)) | gpio_spi_clk_idle(bus)
+		| (bus->idleMask & bus->mosiMask);
+	GPIO_SPI_PORT_WRITE(w);
+	s_portOut = w;
+	gpio_spi_spin(bus->csLoops);
+}
+
+/*****************************************************************************************************
+*	  : void gpio_spi_end(gpio_spi_bus_t *bus)
+*	˵: Ự, ߹ܽŰ idleMask 
+*		  :
+*             gpio_spi_bus_t *bus: 
+*	  ֵ: 
+******************************************************************************************************/
+void gpio_spi_end(gpio_spi_bus_t *bus)
+{
+	u32 pins = bus->csMask | bus->clkMask | bus->mosiMask;
+	u32 w;
+
+	w = (s_portOut & ~pins) | (bus->idleMask & pins);
+	GPIO_SPI_PORT_WRITE(w);
+	s_portOut = w;
+}
+
+/*****************************************************************************************************
+*	  : u32 gpio_spi_frame(gpio_spi_bus_t *bus, u32 tx, u8 txBits, u8 rxBits)
+*	˵: ڻỰڴһ֡
+*		  :
+*             gpio_spi_bus_t *bus: 
+*             u32 tx:  ( txBits λ)
+*             u8 txBits: λ, 4 ıҲ 32
+*             u8 rxBits: ͺյλ,  32
+*	  ֵ: յ, 󷵻 0
+******************************************************************************************************/
+u32 gpio_spi_frame(gpio_spi_bus_t *bus, u32 tx, u8 txBits, u8 rxBits)
+{
+	u32 clk = bus->clkMask;
+	u32 half = bus->halfLoops;
+	u32 rest, w, rx = 0, bit;
+	const u32 *nib;
+	int k, step, i;
+
+	if (txBits > 32 || (txBits & 0x3) != 0 || rxBits > 32)
+		return 0;
+
+	/*ƬѡЧ, ܽŵĵƽ֡ڲ*/
+	rest = (s_portOut & ~(bus->csMask | clk | bus->mosiMask)) | gpio_spi_cs_active(bus);
+	w = rest | gpio_spi_clk_idle(bus) | (s_portOut & bus->mosiMask);
+	GPIO_SPI_PORT_WRITE(w);
+	gpio_spi_spin(bus->csLoops);
+
+	if (bus->flags & GPIO_SPI_LSB_FIRST)
+	{
+		k = 0;
+		step = 4;
+	}
+	else
+	{
+		k = txBits - 4;
+		step = -4;
+	}
+	for (; txBits != 0; txBits -= 4, k += step)
+	{
+		nib = bus->lut[(tx >> k) & 0xF];
+		for (i = 0; i < 4; i++)
+		{
+			w = rest | nib[i];
+			GPIO_SPI_PORT_WRITE(w);
+			gpio_spi_spin(half);
+			GPIO_SPI_PORT_WRITE(w ^ clk);
+			gpio_spi_spin(half);
+		}
+	}
+
+	if (rxBits != 0)
+	{
+		if (bus->flags & GPIO_SPI_3WIRE)
+			GPIO_SPI_PORT_DIR(bus->misoMask, 0);
+		w = (w & ~clk) | gpio_spi_clk_first(bus);
+		for (i = 0; i < rxBits; i++)
+		{
+			GPIO_SPI_PORT_WRITE(w);
+			gpio_spi_spin(half);
+			bit = (GPIO_SPI_PORT_READ() & bus->misoMask) ? 1 : 0;
+			if (bus->flags & GPIO_SPI_LSB_FIRST)
+				rx |= bit << i;
+			else
+				rx = (rx << 1) | bit;
+			GPIO_SPI_PORT_WRITE(w ^ clk);
+			gpio_spi_spin(half);
+		}
+	}
+
+	/*ʱӻصеƽ, ֺͷƬѡ (LE )*/
+	w = (w & ~clk) | gpio_spi_clk_idle(bus);
+	GPIO_SPI_PORT_WRITE(w);
+	gpio_spi_spin(bus->csLoops);
+	w ^= bus->csMask;
+	GPIO_SPI_PORT_WRITE(w);
+	gpio_spi_spin(bus->csLoops);
+	if (rxBits != 0 && (bus->flags & GPIO_SPI_3WIRE))
+		GPIO_SPI_PORT_DIR(0, bus->mosiMask);
+	s_portOut = w;
+	return rx;
+}
+
+void gpio_spi_write(gpio_spi_bus_t *bus, u32 tx, u8 bits)
+{
+	gpio_spi_begin(bus);
+	gpio_spi_frame(bus, tx, bits, 0);
+	gpio_spi_end(bus);
+}
+
+u32 gpio_spi_read(gpio_spi_bus_t *bus, u32 cmd, u8 cmdBits, u8 rxBits)
+{
+	u32 rx;
+
+	gpio_spi_begin(bus);
+	rx = gpio_spi_frame(bus, cmd, cmdBits, rxBits);
+	gpio_spi_end(bus);
+	return rx;
+}
+
+void gpio_spi_batch(gpio_spi_bus_t *bus, const u32 *words, u32 count, u8 bits)
+{
+	u32 i;
+
+	gpio_spi_begin(bus);
+	for (i = 0; i < count; i++)
+		gpio_spi_frame(bus, words[i], bits, 0);
+	gpio_spi_end(bus);
+}
+
+#ifdef GPIO_SPI_HOST_MOCK
+/*
+ * β: ˿д밴 (ʱ, , ) ¼, ʱģѭٶƽʱ;
+ * 豸ģڶ֡λ֮Ӧ. ԰ʵʹܽø,
+ * Ӽ¼аؽ֡ݲʱӰ, -v  VCD .
+ * : gcc -O2 -DGPIO_SPI_HOST_MOCK -Iplatform/inc platform/bsp/drive/spi/gpio_spi.c -o gpio_spi_mock ( src Ŀ¼)
+ */
+#define MOCK_LOOPS_PER_MS       (50000)     /*ģ CPU: ÿѭ 20ns*/
+#define MOCK_REC_MAX            (8192)
+#define MOCK_FRAME_MAX          (16)
+
+typedef struct
+{
+	u64 ns;
+	u32 out;
+	u32 dir;
+}mock_rec_t;
+
+typedef struct
+{
+	u32 val;
+	u8 bits;
+}mock_frame_t;
+
+static mock_rec_t s_rec[MOCK_REC_MAX];
+static u32 s_recNum;
+static u64 s_mockNs;
+static u32 s_mockOut;
+static u32 s_mockDir = 0xFFFFFFFF;
+
+/*豸: ƬѡЧ cmdBits 𰴸λȷ resp*/
+static struct
+{
+	const gpio_spi_bus_t *bus;
+	u32 resp;
+	u8 cmdBits;
+	u8 respBits;
+	u32 edges;
+	u32 contention;
+}s_dev;
+
+static u32 tick_get(void)
+{
+	return (u32)(s_mockNs / 1000000);
+}
+
+static void mock_spin(u32 loops)
+{
+	s_mockNs += (u64)loops * 1000000 / MOCK_LOOPS_PER_MS;
+}
+
+static void mock_record(void)
+{
+	if (s_recNum < MOCK_REC_MAX)
+	{
+		s_rec[s_recNum].ns = s_mockNs;
+		s_rec[s_recNum].out = s_mockOut;
+		s_rec[s_recNum].dir = s_mockDir;
+		s_recNum++;
+	}
+}
+
+static void mock_port_write(u32 v)
+{
+	const gpio_spi_bus_t *bus = s_dev.bus;
+
+	if (bus != NULL)
+	{
+		u32 csOn = gpio_spi_cs_active(bus);
+		u32 clkA = gpio_spi_clk_first(bus);
+
+		if ((s_mockOut & bus->csMask) != csOn && (v & bus->csMask) == csOn)
+			s_dev.edges = 0;
+		else if ((v & bus->csMask) == csOn && (s_mockOut & bus->clkMask) == clkA
+			&& (v & bus->clkMask) != clkA)
+			s_dev.edges++;
+	}
+	s_mockOut = v;
+	mock_record();
+}
+
+static u32 mock_port_read(void)
+{
+	const gpio_spi_bus_t *bus = s_dev.bus;
+	u32 v = s_mockOut & ~s_mockDir;
+	int idx;
+
+	if (bus != NULL && (s_mockOut & bus->csMask) == gpio_spi_cs_active(bus)
+		&& s_dev.edges >= s_dev.cmdBits)
+	{
+		idx = s_dev.edges - s_dev.cmdBits;
+		/*豸·ʱлΪ*/
+		if ((s_mockDir & bus->misoMask) == 0)
+			s_dev.contention++;
+		if (idx < s_dev.respBits && ((s_dev.resp >> (s_dev.respBits - 1 - idx)) & 0x1))
+			v |= bus->misoMask;
+	}
+	return v;
+}
+
+static void mock_port_dir(u32 in, u32 out)
+{
+	s_mockDir = (s_mockDir | in) & ~out;
+	mock_record();
+}
+
+/*Ӽ¼ from ʼؽ, ֡; minHalf ֡ʱӵƽ̱ʱ*/
+static u32 mock_decode(const gpio_spi_bus_t *bus, u32 from, mock_frame_t *fr, u32 max, u64 *minHalf)
+{
+	u32 csOn = gpio_spi_cs_active(bus);
+	u32 clkA = gpio_spi_clk_first(bus);
+	u32 prev = from ? s_rec[from - 1].out : 0;
+	u64 lastClk = 0;
+	u32 num = 0, i, cur;
+	int inFrame = 0;
+
+	*minHalf = ~0ULL;
+	for (i = from; i < s_recNum; i++)
+	{
+		cur = s_rec[i].out;
+		if (!inFrame && (prev & bus->csMask) != csOn && (cur & bus->csMask) == csOn)
+		{
+			inFrame = 1;
+			lastClk = s_rec[i].ns;
+			if (num < max)
+			{
+				fr[num].val = 0;
+				fr[num].bits = 0;
+			}
+		}
+		else if (inFrame && (cur & bus->csMask) != csOn)
+		{
+			inFrame = 0;
+			num++;
+		}
+		else if (inFrame && ((prev ^ cur) & bus->clkMask))
+		{
+			if (s_rec[i].ns - lastClk < *minHalf)
+				*minHalf = s_rec[i].ns - lastClk;
+			lastClk = s_rec[i].ns;
+			/*ֻͳλ*/
+			if ((prev & bus->clkMask) == clkA && (s_rec[i].dir & bus->mosiMask) == 0 && num < max)
+			{
+				u32 b = (cur & bus->mosiMask) ? 1 : 0;
+
+				if (bus->flags & GPIO_SPI_LSB_FIRST)
+					fr[num].val |= b << fr[num].bits;
+				else
+					fr[num].val = (fr[num].val << 1) | b;
+				fr[num].bits++;
+			}
+		}
+		prev = cur;
+	}
+	return num;
+}
+
+static void mock_dump_vcd(const char *path)
+{
+	FILE *fp = fopen(path, "w");
+	u32 i;
+	int b;
+
+	if (fp == NULL)
+	{
+		perror(path);
+		return;
+	}
+	fprintf(fp, "$timescale 1ns $end\n$scope module gpio $end\n");
+	fprintf(fp, "$var wire 32 ! data $end\n$var wire 32 \" tri $end\n");
+	fprintf(fp, "$upscope $end\n$enddefinitions $end\n");
+	for (i = 0; i < s_recNum; i++)
+	{
+		fprintf(fp, "#%llu\nb", (unsigned long long)s_rec[i].ns);
+		for (b = 31; b >= 0; b--)
+			fputc('0' + ((s_rec[i].out >> b) & 1), fp);
+		fprintf(fp, " !\nb");
+		for (b = 31; b >= 0; b--)
+			fputc('0' + ((s_rec[i].dir >> b) & 1), fp);
+		fprintf(fp, " \"\n");
+	}
+	fclose(fp);
+	printf("waveform: %s (%u samples)\n", path, s_recNum);
+}
+
+static int s_fail;
+
+static void mock_check(const char *name, int ok)
+{
+	printf("%-40s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+		s_fail++;
+}
+
+/* from ʼֵ֡Ƚ*/
+static void mock_expect(const char *name, const gpio_spi_bus_t *bus, u32 from,
+						const u32 *val, const u8 *bits, u32 count)
+{
+	mock_frame_t fr[MOCK_FRAME_MAX];
+	u64 minHalf;
+	u32 num, i, writes;
+	int ok;
+
+	num = mock_decode(bus, from, fr, MOCK_FRAME_MAX, &minHalf);
+	ok = num == count;
+	for (i = 0; ok && i < count; i++)
+	{
+		if (fr[i].bits != bits[i] || fr[i].val != val[i])
+		{
+			printf("  frame %u: got %u bits 0x%x, expect %u bits 0x%x\n",
+				i, fr[i].bits, fr[i].val, bits[i], val[i]);
+			ok = 0;
+		}
+	}
+	if (num != count)
+		printf("  got %u frames, expect %u\n", num, count);
+	if (minHalf < bus->halfNs)
+	{
+		printf("  clock half period %llu ns < %u ns\n", (unsigned long long)minHalf, bus->halfNs);
+		ok = 0;
+	}
+	writes = s_recNum - from;
+	printf("  %u frames, %u port writes, min half %llu ns, %.3f ms\n", num, writes,
+		(unsigned long long)minHalf, (double)(s_rec[s_recNum - 1].ns - s_rec[from].ns) / 1e6);
+	mock_check(name, ok);
+}
+
+/*еһ*/
+static gpio_spi_bus_t s_mt9653 =
+{
+	GPIO_SPI_PIN(0), GPIO_SPI_PIN(1), GPIO_SPI_PIN(2), GPIO_SPI_PIN(2),
+	GPIO_SPI_PIN(0) | GPIO_SPI_PIN(1) | GPIO_SPI_PIN(2),
+	GPIO_SPI_MODE0, GPIO_SPI_3WIRE, 500, 500,
+};
+
+static gpio_spi_bus_t s_adf4351 =
+{
+	GPIO_SPI_PIN(16), GPIO_SPI_PIN(17), GPIO_SPI_PIN(18), 0,
+	GPIO_SPI_PIN(16) | GPIO_SPI_PIN(17) | GPIO_SPI_PIN(18),
+	GPIO_SPI_MODE0, 0, 500, 1000,
+};
+
+static gpio_spi_bus_t s_rx1922 =
+{
+	GPIO_SPI_PIN(9), GPIO_SPI_PIN(10), GPIO_SPI_PIN(11), GPIO_SPI_PIN(12),
+	GPIO_SPI_PIN(9) | GPIO_SPI_PIN(10) | GPIO_SPI_PIN(11),
+	GPIO_SPI_MODE0, 0, 2000, 2000,
+};
+
+static gpio_spi_bus_t s_pe43711 =
+{
+	GPIO_SPI_PIN(13), GPIO_SPI_PIN(14), GPIO_SPI_PIN(15), 0,
+	GPIO_SPI_PIN(14) | GPIO_SPI_PIN(15),
+	GPIO_SPI_MODE0, GPIO_SPI_LSB_FIRST, 500, 1000,
+};
+
+/* CPOL=1/CPHA=1 ͸ЧƬѡ*/
+static gpio_spi_bus_t s_mode3 =
+{
+	GPIO_SPI_PIN(20), GPIO_SPI_PIN(21), GPIO_SPI_PIN(22), GPIO_SPI_PIN(23),
+	GPIO_SPI_PIN(21),
+	GPIO_SPI_MODE3, GPIO_SPI_CS_ACTIVE_HIGH, 100, 100,
+};
+
+int main(int argc, char **argv)
+{
+	static const u32 adfWords[6] = { 0x00580005, 0x00E5003C, 0x000004B3, 0x00004E42, 0x08008029, 0x00D30010 };
+	static const u8 adfBits[6] = { 32, 32, 32, 32, 32, 32 };
+	u32 val[2];
+	u8 bits[2];
+	u32 from, rx;
+
+	gpio_spi_calibrate();
+	printf("calibrated %u loops/ms (model %u)\n", gpio_spi_loops_per_ms(), MOCK_LOOPS_PER_MS);
+	mock_check("calibrate", gpio_spi_loops_per_ms() == MOCK_LOOPS_PER_MS);
+
+	/*MT9653 д 0x21 = 0x30: 16 λ + 8 λ*/
+	from = s_recNum;
+	gpio_spi_write(&s_mt9653, (0x0021 << 8) | 0x30, 24);
+	val[0] = 0x002130;
+	bits[0] = 24;
+	mock_expect("mt9653 write", &s_mt9653, from, val, bits, 1);
+
+	/*MT9653 оƬ ID:  SDIO , 豸 0xB5*/
+	s_dev.bus = &s_mt9653;
+	s_dev.resp = 0xB5;
+	s_dev.cmdBits = 16;
+	s_dev.respBits = 8;
+	s_dev.contention = 0;
+	from = s_recNum;
+	rx = gpio_spi_read(&s_mt9653, 0x8000 | 0x01, 16, 8);
+	val[0] = 0x8001;
+	bits[0] = 16;
+	mock_expect("mt9653 read cmd", &s_mt9653, from, val, bits, 1);
+	printf("  read 0x%02x, contention %u\n", rx, s_dev.contention);
+	mock_check("mt9653 read data", rx == 0xB5 && s_dev.contention == 0);
+	mock_check("mt9653 sdio back to output", (s_mockDir & s_mt9653.mosiMask) == 0);
+
+	/*ADF4351 R5..R0 һỰд, ÿ֡ LE */
+	s_dev.bus = NULL;
+	from = s_recNum;
+	gpio_spi_batch(&s_adf4351, adfWords, 6, 32);
+	mock_expect("adf4351 batch", &s_adf4351, from, adfWords, adfBits, 6);
+
+	/*RX1922 4 ߶: 8 λַ + 24 λ, ڼ MOSI һλ*/
+	s_dev.bus = &s_rx1922;
+	s_dev.resp = 0xAFC09F;
+	s_dev.cmdBits = 8;
+	s_dev.respBits = 24;
+	s_dev.contention = 0;
+	from = s_recNum;
+	rx = gpio_spi_read(&s_rx1922, 0x80 | 25, 8, 24);
+	val[0] = ((0x80 | 25) << 24) | 0xFFFFFF;
+	bits[0] = 32;
+	mock_expect("rx1922 read cmd", &s_rx1922, from, val, bits, 1);
+	mock_check("rx1922 read data", rx == 0xAFC09F && s_dev.contention == 0);
+
+	/*PE43711 λȷ*/
+	s_dev.bus = NULL;
+	from = s_recNum;
+	gpio_spi_write(&s_pe43711, 0x35, 8);
+	val[0] = 0x35;
+	bits[0] = 8;
+	mock_expect("pe43711 write lsb first", &s_pe43711, from, val, bits, 1);
+	mock_check("pe43711 le idles low", (s_mockOut & s_pe43711.csMask) == 0);
+
+	/*ģʽ 3*/
+	s_dev.bus = &s_mode3;
+	s_dev.resp = 0x5A;
+	s_dev.cmdBits = 12;
+	s_dev.respBits = 8;
+	s_dev.contention = 0;
+	from = s_recNum;
+	rx = gpio_spi_read(&s_mode3, 0xC3A, 12, 8);
+	val[0] = 0xC3A << 8;
+	bits[0] = 20;
+	mock_expect("mode3 cmd", &s_mode3, from, val, bits, 1);
+	mock_check("mode3 read data", rx == 0x5A);
+
+	if (argc > 2 && strcmp(argv[1], "-v") == 0)
+		mock_dump_vcd(argv[2]);
+	printf("%s\n", s_fail ? "FAILED" : "all passed");
+	return s_fail != 0;
+}
+#endif
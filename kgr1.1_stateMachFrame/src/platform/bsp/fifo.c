@@ -1,62 +1,147 @@
 #include "fifo.h"
 
-typedef struct
-{
-	char front;
-	char rear;
-	char size;
-	char capacity;
-	char data[128];
-}QueueZS;
+#include <string.h>
 
-QueueZS gZsQueue;
+/*
+ * ȡԷ޸ĵļ acquire, Լļ release:
+ * дٷ head, ȶٷ tail.
+ * MicroBlaze ൱ڱ, ̲߳ʱ֤ڴ˳.
+ */
+#define FIFO_LOAD_ACQ(p)		__atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define FIFO_STORE_REL(p, v)	__atomic_store_n((p), (v), __ATOMIC_RELEASE)
 
-unsigned char initQueue(unsigned char capVal)
-{
-	gZsQueue.front = 0;
-	gZsQueue.rear = -1;
-	gZsQueue.size = 0;
-	gZsQueue.capacity = capVal;
+#define FIFO_DBG_CAPACITY		128
+
+static u8 s_dbgQueueBuf[FIFO_DBG_CAPACITY];
+zs_fifo_t gZsQueue = { 0, 0, FIFO_DBG_CAPACITY - 1, s_dbgQueueBuf };
 
+int fifo_init(zs_fifo_t *q, u8 *buf, u32 capacity)
+{
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+	{
+		return -1;
+	}
+	q->head = 0;
+	q->tail = 0;
+	q->mask = capacity - 1;
+	q->buf = buf;
 	return 0;
 }
 
-BOOL isEmpty()
+BOOL fifo_enqueue(zs_fifo_t *q, u8 val)
 {
-	return (gZsQueue.size == 0);
+	u32 head = q->head;
+
+	if (head - FIFO_LOAD_ACQ(&q->tail) > q->mask)
+	{
+		return FALSE;
+	}
+	q->buf[head & q->mask] = val;
+	FIFO_STORE_REL(&q->head, head + 1);
+	return TRUE;
 }
 
-BOOL isFull()
+u32 fifo_enqueue_n(zs_fifo_t *q, const u8 *data, u32 len)
 {
-	return (gZsQueue.size == gZsQueue.capacity);
+	u32 head = q->head;
+	u32 space = q->mask + 1 - (head - FIFO_LOAD_ACQ(&q->tail));
+	u32 off = head & q->mask;
+	u32 first;
+
+	if (len > space)
+	{
+		len = space;
+	}
+	/*ο: ĩβ, ٴͷʼ*/
+	first = q->mask + 1 - off;
+	if (first > len)
+	{
+		first = len;
+	}
+	memcpy(q->buf + off, data, first);
+	memcpy(q->buf, data + first, len - first);
+	FIFO_STORE_REL(&q->head, head + len);
+	return len;
 }
 
-BOOL enqueue(unsigned char enVal)
+BOOL fifo_dequeue(zs_fifo_t *q, u8 *val)
 {
-	if(isFull())
+	u32 tail = q->tail;
+
+	if (FIFO_LOAD_ACQ(&q->head) == tail)
 	{
 		return FALSE;
 	}
+	*val = q->buf[tail & q->mask];
+	FIFO_STORE_REL(&q->tail, tail + 1);
+	return TRUE;
+}
 
-	gZsQueue.rear = (gZsQueue.rear+ 1)% gZsQueue.capacity;
-	gZsQueue.data[gZsQueue.rear] = enVal;
-	gZsQueue.size++;
+u32 fifo_dequeue_n(zs_fifo_t *q, u8 *data, u32 max)
+{
+	u32 tail = q->tail;
+	u32 avail = FIFO_LOAD_ACQ(&q->head) - tail;
+	u32 off = tail & q->mask;
+	u32 first;
 
-	return TRUE;
+	if (max > avail)
+	{
+		max = avail;
+	}
+	first = q->mask + 1 - off;
+	if (first > max)
+	{
+		first = max;
+	}
+	memcpy(data, q->buf + off, first);
+	memcpy(data + first, q->buf, max - first);
+	FIFO_STORE_REL(&q->tail, tail + max);
+	return max;
 }
 
-BOOL dequeue(char * enVal)
+u32 fifo_count(const zs_fifo_t *q)
+{
+	return FIFO_LOAD_ACQ(&q->head) - FIFO_LOAD_ACQ(&q->tail);
+}
+
+u32 fifo_capacity(const zs_fifo_t *q)
+{
+	return q->mask + 1;
+}
+
+/*ɽӿ: capVal ȡΪ 2 ,  FIFO_DBG_CAPACITY*/
+unsigned char initQueue(unsigned char capVal)
 {
-	if(isEmpty())
+	u32 cap = FIFO_DBG_CAPACITY;
+
+	while (cap > 1 && cap > capVal)
 	{
-		*enVal = 0;
-		return FALSE;
+		cap >>= 1;
 	}
+	return (unsigned char)fifo_init(&gZsQueue, s_dbgQueueBuf, cap);
+}
+
+BOOL isEmpty()
+{
+	return fifo_count(&gZsQueue) == 0;
+}
 
-	*enVal = gZsQueue.data[gZsQueue.front];
-	gZsQueue.front = (gZsQueue.front+1)%gZsQueue.capacity;
+BOOL isFull()
+{
+	return fifo_count(&gZsQueue) == fifo_capacity(&gZsQueue);
+}
 
-	gZsQueue.size--;
+BOOL enqueue(unsigned char enVal)
+{
+	return fifo_enqueue(&gZsQueue, enVal);
+}
 
+BOOL dequeue(char * enVal)
+{
+	if (!fifo_dequeue(&gZsQueue, (u8 *)enVal))
+	{
+		*enVal = 0;
+		return FALSE;
+	}
 	return TRUE;
 }
@@ -46,6 +46,8 @@
 #include "xparameters.h"
 #include "xtmrctr.h"
 #include "xil_exception.h"
+#include "../components/evloop/evloop.h"
+#include "../components/timer_wheel/timer_wheel.h"
 
 #ifdef XPAR_INTC_0_DEVICE_ID
 #include "xintc.h"
@@ -136,6 +138,12 @@ XTmrCtr TimerCounterInst;   /* The instance of the Timer Counter */
  */
 volatile uint32_t gTimerTick;
 
+/*
+ * System software timers, advanced once per tick from TimerCounterHandler.
+ * Set up by tw_init in PreInit, before timerInit enables the tick interrupt.
+ */
+tw_wheel_t gTimerWheel;
+
 
 
 /*****************************************************************************/
@@ -291,6 +299,8 @@ void TimerCounterHandler(void *CallBackRef, u8 TmrCtrNumber)
 	 */
 	if (XTmrCtr_IsExpired(InstancePtr, TmrCtrNumber)) {
 		gTimerTick++;
+		/* run due software timers; idle ticks cost one compare */
+		tw_advance(&gTimerWheel, gTimerTick);
         #if 0
 		if (gTimerTick == 3) {
 			XTmrCtr_SetOptions(InstancePtr, TmrCtrNumber, 0);
@@ -453,6 +463,8 @@ uint32_t tick_delay_ms(uint32_t ms)
 		{
 			break;
 		}
+		/* sleep until the next tick interrupt instead of spinning */
+		ev_cpu_idle();
 	}
 	return 0;
 }
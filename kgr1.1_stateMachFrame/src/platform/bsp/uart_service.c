@@ -25,6 +25,23 @@
 #include "board.h"
 #include "fifo.h"
 #include "../usr/userTask.h"
+#include "../components/evloop/evloop.h"
+
+#ifdef __MICROBLAZE__
+#include "mb_interface.h"
+#define UART_MSR_IE		0x2
+/*ѭвͻʱж, ԭжϿ״̬*/
+#define UART_LOCK_DECL	u32 msr
+#define UART_LOCK()		do { msr = mfmsr(); microblaze_disable_interrupts(); } while (0)
+#define UART_UNLOCK()	do { if (msr & UART_MSR_IE) microblaze_enable_interrupts(); } while (0)
+/*ǰжѹر (жϷлʼ׶), Ϳжϲ*/
+#define UART_IRQ_MASKED()	(!(msr & UART_MSR_IE))
+#else
+#define UART_LOCK_DECL
+#define UART_LOCK()
+#define UART_UNLOCK()
+#define UART_IRQ_MASKED()	(0)
+#endif
 
 #ifdef XPAR_INTC_0_DEVICE_ID
 #include "xintc.h"
@@ -73,6 +90,36 @@ static XUartLite UartUbloxInst;
 unsigned char gdbgGetchar = 0;
 
 int (* gpfUartPutByte[7] )(char ch) = {0}; //uart pl0 put byte
+int (* gpfUartPutBurst[7] )(char *data, int len) = {0}; //һдһ, δעʱ˻ֽд
+
+
+/*UartLite FIFO, һжȡֽ*/
+#define UART_RX_BURST			16
+/*͸ͻλС, Ϊ2*/
+#define UART_TX_RING_SIZE		1024
+#define UART_TX_RING_MASK		(UART_TX_RING_SIZE - 1)
+
+/*͸ͻλ: ԴڽжϺ͵ԴڵĿ̨д, Ŀ괮ڷFIFOжȡ
+ *жϲǶ, ѭдȡʱж*/
+typedef struct
+{
+	u8 buf[UART_TX_RING_SIZE];
+	volatile u32 head;		/*д*/
+	volatile u32 tail;		/*ȡ, ֻUartTxRefill޸*/
+} UartTxRing_t;
+
+typedef struct
+{
+	u32 base;				/*UartLiteַ*/
+	void (*recv)(u8 *data, u32 len);	/*ݷַ*/
+	UartTxRing_t *tx;		/*͸ͻλ, NULLʾΪ͸Ŀ*/
+	u32 txDrop;				/*ͻλֽ*/
+	const u8 *blk;			/*鷢͵, ύǰд뻷λݷɷжֱӴȡ*/
+	volatile u32 blkLen;	/*鳤, ɺɷж*/
+	u32 blkPos;
+	u32 blkMark;			/*ύʱλд, ֮дݵ鷢ٷ*/
+	u8 irqOn;				/*Ϳжѿ, δʱдԼƶ*/
+} UartPort_t;
 /****************************************************************************/
 /**
 *
@@ -83,8 +130,7 @@ int (* gpfUartPutByte[7] )(char ch) = {0}; //uart pl0 put byte
 * user should modify this function to fit the application.
 *
 * @param	IntcInstancePtr is a pointer to the instance of INTC driver.
-* @param	UartLiteInstPtr is a pointer to the instance of UartLite driver.
-*		XPAR_<UARTLITE_instance>_DEVICE_ID value from xparameters.h.
+* @param	Port is the service port whose UartPortIsr is connected.
 * @param	UartLiteIntrId is the Interrupt ID and is typically
 *		XPAR_<INTC_instance>_<UARTLITE_instance>_VEC_ID
 *		value from xparameters.h.
@@ -94,8 +140,10 @@ int (* gpfUartPutByte[7] )(char ch) = {0}; //uart pl0 put byte
 * @note		None.
 *
 ****************************************************************************/
+static void UartPortIsr(void *CallBackRef);
+
 static int UartSetupIntrSystem(XIntc *IntcPtr,
-				XUartLite *UartLiteInstPtr,
+				UartPort_t *Port,
 				u16 UartLiteIntrId)
 {
 	int Status;
@@ -116,8 +164,8 @@ static int UartSetupIntrSystem(XIntc *IntcPtr,
 	 * interrupt processing for the device.
 	 */
 	Status = XIntc_Connect(IntcPtr, UartLiteIntrId,
-			(XInterruptHandler)XUartLite_InterruptHandler,
-			(void *)UartLiteInstPtr);
+			(XInterruptHandler)UartPortIsr,
+			(void *)Port);
 	if (Status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
@@ -146,111 +194,297 @@ static int UartSetupIntrSystem(XIntc *IntcPtr,
 	return XST_SUCCESS;
 }
 
-/****************************************************************************/
 /**
-*
-* This function is the handler which performs processing to receive data from
-* the UartLite. It is called from an interrupt context such that the amount of
-* processing performed should be minimized. It is called when any data is
-* present in the receive FIFO of the UartLite such that the data can be
-* retrieved from the UartLite. The amount of data present in the FIFO is not
-* known when this function is called.
-*
-* This handler provides an example of how to handle data for the UartLite, but
-* is application specific.
-*
-* @param	CallBackRef contains a callback reference from the driver,
-*		in this case it is the instance pointer for the UartLite driver.
-* @param	EventData contains the number of bytes sent or received for sent
-*		and receive events.
-*
-* @return	None.
-*
-* @note		None.
-*
-****************************************************************************/
-static void Bd210ComRecvHandler(void *CallBackRef, unsigned int EventData)
+ * @brief ӽFIFOȡһ, UART_RX_BURSTֽ
+ * @return ȡֽ, 0ʾFIFOѿ
+ */
+static u32 UartRxDrain(u32 base, u8 *burst)
 {
-	err_t err;
-	uint8_t res;
-	res = XUartLite_RecvByte(XPAR_BD21_UART0_BASEADDR);
-	if(gpfUartPutByte[PLUART_INDEX_2_BD21_1])
-		gpfUartPutByte[PLUART_INDEX_2_BD21_1](res);
-	if(g_ublox_bd21_uartTransmit == 3)
+	u32 n = 0;
+
+	while (n < UART_RX_BURST && !XUartLite_IsReceiveEmpty(base))
+	{
+		burst[n++] = (u8)XUartLite_ReadReg(base, XUL_RX_FIFO_OFFSET);
+	}
+	return n;
+}
+
+/**
+ * @brief һдӦĽջλ
+ */
+static void UartRxCommit(int index, u8 *data, u32 len)
+{
+	u32 i;
+
+	if (gpfUartPutBurst[index])
 	{
-		XUartLite_SendByte(XPAR_FPGA_DEBUG_UART1_BASEADDR,res);
+		gpfUartPutBurst[index]((char *)data, len);
 	}
+	else if (gpfUartPutByte[index])
+	{
+		for (i = 0; i < len; i++)
+		{
+			gpfUartPutByte[index](data[i]);
+		}
+	}
+}
+
+/**
+ * @brief λдend֮ǰ뷢FIFO, ֱFIFOȡend
+ * @return Ƿȡend
+ */
+static int UartTxRingDrain(UartPort_t *port, u32 end)
+{
+	UartTxRing_t *ring = port->tx;
+	u32 tail = ring->tail;
+
+	while (tail != end && !XUartLite_IsTransmitFull(port->base))
+	{
+		XUartLite_WriteReg(port->base, XUL_TX_FIFO_OFFSET, ring->buf[tail & UART_TX_RING_MASK]);
+		tail++;
+	}
+	ring->tail = tail;
+	return tail == end;
+}
 
+/**
+ * @brief ͻλ뷢FIFO, ֱFIFO򻺳ȡ
+ *        ȴʱд˳: ύǰд ->  -> ֮д,
+ *        м䲻
+ *        ڷFIFOже, ͸Ϳ̨дʱҲһ
+ */
+static void UartTxRefill(UartPort_t *port)
+{
+	if (port->blkLen == 0)
+	{
+		UartTxRingDrain(port, port->tx->head);
+		return;
+	}
+	if (!UartTxRingDrain(port, port->blkMark))
+	{
+		return;
+	}
+	while (port->blkPos < port->blkLen && !XUartLite_IsTransmitFull(port->base))
+	{
+		XUartLite_WriteReg(port->base, XUL_TX_FIFO_OFFSET, port->blk[port->blkPos++]);
+	}
+	if (port->blkPos == port->blkLen)
+	{
+		/*һѽFIFO, Խ, ѭһ*/
+		port->blkLen = 0;
+		ev_wake(EV_WAKE_UART);
+		UartTxRingDrain(port, port->tx->head);
+	}
 }
 
-static void Bd211ComRecvHandler(void *CallBackRef, unsigned int EventData)
+/**
+ * @brief ͸дĿ괮ڵķͻλ
+ *        FIFOѿʱٲͿж, дֱһFIFO
+ */
+static void UartTxForward(UartPort_t *port, const u8 *data, u32 len)
 {
-	err_t err;
-	uint8_t res;
-	res = XUartLite_RecvByte(XPAR_BD21_UART1_BASEADDR);
-	if(gpfUartPutByte[PLUART_INDEX_3_BD21_2])
-		gpfUartPutByte[PLUART_INDEX_3_BD21_2](res);
+	UartTxRing_t *ring = port->tx;
+	u32 head = ring->head;
+	u32 space = UART_TX_RING_SIZE - (head - ring->tail);
+	u32 i;
 
+	if (len > space)
+	{
+		port->txDrop += len - space;
+		len = space;
+	}
+	for (i = 0; i < len; i++)
+	{
+		ring->buf[(head + i) & UART_TX_RING_MASK] = data[i];
+	}
+	ring->head = head + len;
+	UartTxRefill(port);
 }
 
+static void Bd210ComRecvHandler(u8 *data, u32 len);
+static void Bd211ComRecvHandler(u8 *data, u32 len);
+static void UartDbgRecvHandler(u8 *data, u32 len);
+static void UartUbloxRecvHandler(u8 *data, u32 len);
+
+static UartTxRing_t UartDbgTxRing;
+static UartTxRing_t UartUbloxTxRing;
+static UartTxRing_t UartBd210TxRing;
+
+static UartPort_t UartPortDbg    = { DBG_UART_ADDR,    UartDbgRecvHandler,   &UartDbgTxRing,   0 };
+static UartPort_t UartPortUblox  = { UBLOX_UART_ADDR,  UartUbloxRecvHandler, &UartUbloxTxRing, 0 };
+static UartPort_t UartPortBd21_0 = { BD21_0_UART_ADDR, Bd210ComRecvHandler,  &UartBd210TxRing, 0 };
+static UartPort_t UartPortBd21_1 = { BD21_1_UART_ADDR, Bd211ComRecvHandler,  NULL,             0 };
+
 /****************************************************************************/
 /**
 *
-* This function is the handler which performs processing to receive data from
-* the UartLite. It is called from an interrupt context such that the amount of
-* processing performed should be minimized. It is called when any data is
-* present in the receive FIFO of the UartLite such that the data can be
-* retrieved from the UartLite. The amount of data present in the FIFO is not
-* known when this function is called.
+* UartLiteжϷ: FIFOȡ, FIFOʱ͸λ岹.
+* XUartLite_InterruptHandler, ĻصֻXUartLite_Send/Recv
+* ĻϹ, ޷ȡͻλ巢.
 *
-* This handler provides an example of how to handle data for the UartLite, but
-* is application specific.
-*
-* @param	CallBackRef contains a callback reference from the driver,
-*		in this case it is the instance pointer for the UartLite driver.
-* @param	EventData contains the number of bytes sent or received for sent
-*		and receive events.
+* @param	CallBackRef is the UartPort_t of the interrupting UartLite.
 *
 * @return	None.
 *
-* @note		None.
-*
 ****************************************************************************/
-static void UartDbgRecvHandler(void *CallBackRef, unsigned int EventData)
+static void UartPortIsr(void *CallBackRef)
 {
-	uint8_t res;
-	gdbgGetchar = XUartLite_RecvByte(DBG_UART_ADDR);
-	enqueue(gdbgGetchar);
+	UartPort_t *port = (UartPort_t *)CallBackRef;
+	u32 status = XUartLite_GetStatusReg(port->base);
+	u8 burst[UART_RX_BURST];
+	u32 len;
 
-	if(gpfUartPutByte[PLUART_INDEX_0_PC])
-		gpfUartPutByte[PLUART_INDEX_0_PC](gdbgGetchar);
-	if(g_ublox_bd21_uartTransmit == 1)
+	/* жֻFIFOɿձΪǿʱ, ȡFIFOΪ˳ */
+	while ((len = UartRxDrain(port->base, burst)) != 0)
 	{
-		XUartLite_SendByte(XPAR_UBLOX_UART_BASEADDR,gdbgGetchar);
+		port->recv(burst, len);
 	}
+	if ((status & XUL_SR_TX_FIFO_EMPTY) && port->tx != NULL)
+	{
+		UartTxRefill(port);
+	}
+}
 
+static void Bd210ComRecvHandler(u8 *data, u32 len)
+{
+	UartRxCommit(PLUART_INDEX_2_BD21_1, data, len);
 	if(g_ublox_bd21_uartTransmit == 3)
 	{
-		XUartLite_SendByte(XPAR_BD21_UART0_BASEADDR,gdbgGetchar);
+		UartTxForward(&UartPortDbg, data, len);
 	}
 }
 
+static void Bd211ComRecvHandler(u8 *data, u32 len)
+{
+	UartRxCommit(PLUART_INDEX_3_BD21_2, data, len);
+}
 
-static void UartUbloxRecvHandler(void *CallBackRef, unsigned int EventData)
+static void UartDbgRecvHandler(u8 *data, u32 len)
 {
-	uint8_t res;
-	res = XUartLite_RecvByte(UBLOX_UART_ADDR);
+	fifo_enqueue_n(&gZsQueue, data, len);
+	gdbgGetchar = data[len - 1];
+
+	UartRxCommit(PLUART_INDEX_0_PC, data, len);
+	if(g_ublox_bd21_uartTransmit == 1)
+	{
+		UartTxForward(&UartPortUblox, data, len);
+	}
 
-	if(gpfUartPutByte[PLUART_INDEX_1_UBLOX])
-		gpfUartPutByte[PLUART_INDEX_1_UBLOX](res);
+	if(g_ublox_bd21_uartTransmit == 3)
+	{
+		UartTxForward(&UartPortBd21_0, data, len);
+	}
+}
+
+
+static void UartUbloxRecvHandler(u8 *data, u32 len)
+{
+	UartRxCommit(PLUART_INDEX_1_UBLOX, data, len);
 	if(g_ublox_bd21_uartTransmit == 1)
 	{
-		XUartLite_SendByte(DBG_UART_ADDR,res);
+		UartTxForward(&UartPortDbg, data, len);
 	}
 
 	//enqueue(gdbgGetchar);
 }
 
+/**
+ * @brief Դ鷢, ݲ, ɷжFIFO
+ *        ǰdata뱣Ч; ͬһʱֻһڷ
+ * @return 0 ѿʼ, -1 һδ
+ */
+int UartDbgTxBlock(const u8 *data, u32 len)
+{
+	UART_LOCK_DECL;
+
+	if (UartPortDbg.blkLen != 0)
+	{
+		return -1;
+	}
+	if (len == 0)
+	{
+		return 0;
+	}
+	UART_LOCK();
+	UartPortDbg.blk = data;
+	UartPortDbg.blkPos = 0;
+	UartPortDbg.blkMark = UartDbgTxRing.head;
+	UartPortDbg.blkLen = len;
+	/*FIFOѿʱٲͿж, һ*/
+	UartTxRefill(&UartPortDbg);
+	UART_UNLOCK();
+	return 0;
+}
+
+/**
+ * @brief ̨ (dx_kprintf, shell, ־) дԴڷͻλ, 鷢ͺ͸ݰ˳򷢳
+ *        ʱȴжȡ. Ϳжϲʱȴ:
+ *        жѹر (жϷл) ڷ, ֻװµĲ, ඪtxDrop;
+ *        Ϳжδ (ʼ׶), ѯдֽڽFIFOٷ
+ */
+void UartConsoleWrite(const u8 *data, u32 len)
+{
+	UartPort_t *port = &UartPortDbg;
+	UartTxRing_t *ring = port->tx;
+	u32 head, n, i;
+	int wait;
+	UART_LOCK_DECL;
+
+	do
+	{
+		UART_LOCK();
+		wait = port->irqOn && !UART_IRQ_MASKED();
+		head = ring->head;
+		n = UART_TX_RING_SIZE - (head - ring->tail);
+		if (n > len)
+		{
+			n = len;
+		}
+		for (i = 0; i < n; i++)
+		{
+			ring->buf[(head + i) & UART_TX_RING_MASK] = data[i];
+		}
+		ring->head = head + n;
+		UartTxRefill(port);
+		UART_UNLOCK();
+		data += n;
+		len -= n;
+
+		if (!wait)
+		{
+			if (port->irqOn || port->blkLen != 0)
+			{
+				break;
+			}
+			/*ֻп̨д, λڱ֮ǰҲѯĿ̨*/
+			while ((s32)(head + n - ring->tail) > 0)
+			{
+				UART_LOCK();
+				UartTxRefill(port);
+				UART_UNLOCK();
+			}
+		}
+	} while (len > 0);
+
+	port->txDrop += len;
+}
+
+/**
+ * @brief Դ鷢Ƿڽ
+ */
+int UartDbgTxBlockBusy(void)
+{
+	return UartPortDbg.blkLen != 0;
+}
+
+/**
+ * @brief ͸ͻλʱֽ
+ */
+u32 UartForwardDropCount(void)
+{
+	return UartPortDbg.txDrop + UartPortUblox.txDrop + UartPortBd21_0.txDrop;
+}
+
 
 /****************************************************************************/
 /**
@@ -305,21 +539,12 @@ static int Bd210UartInit(void)
 	 * can occur. This function is application specific.
 	 */
 	Status = UartSetupIntrSystem(&IntcInstancePtr,
-					 &UartLiteBD21_0Inst,
+					 &UartPortBd21_0,
 					 BD21_0_UART_IRPT_INTR);
 	if (Status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
 
-	/*
-	 * Setup the handlers for the UartLite that will be called from the
-	 * interrupt context when data has been sent and received,
-	 * specify a pointer to the UartLite driver instance as the callback
-	 * reference so the handlers are able to access the instance data.
-	 */
-	XUartLite_SetRecvHandler(&UartLiteBD21_0Inst, Bd210ComRecvHandler,
-							 &UartLiteBD21_0Inst);
-
 	/*
 	 * Enable the interrupt of the UartLite so that the interrupts
 	 * will occur.
@@ -354,21 +579,12 @@ static int Bd211UartInit(void)
 	 * can occur. This function is application specific.
 	 */
 	Status = UartSetupIntrSystem(&IntcInstancePtr,
-					 &UartLiteBD21_1Inst,
+					 &UartPortBd21_1,
 					 BD21_1_UART_IRPT_INTR);
 	if (Status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
 
-	/*
-	 * Setup the handlers for the UartLite that will be called from the
-	 * interrupt context when data has been sent and received,
-	 * specify a pointer to the UartLite driver instance as the callback
-	 * reference so the handlers are able to access the instance data.
-	 */
-	XUartLite_SetRecvHandler(&UartLiteBD21_1Inst, Bd211ComRecvHandler,
-							 &UartLiteBD21_1Inst);
-
 	/*
 	 * Enable the interrupt of the UartLite so that the interrupts
 	 * will occur.
@@ -431,26 +647,18 @@ static int DbgUartInit(void)
 	 * can occur. This function is application specific.
 	 */
 	Status = UartSetupIntrSystem(&IntcInstancePtr,
-					 &UartLiteDbgInst,
+					 &UartPortDbg,
 					 DBG_UART_IRPT_INTR);
 	if (Status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
 
-	/*
-	 * Setup the handlers for the UartLite that will be called from the
-	 * interrupt context when data has been sent and received,
-	 * specify a pointer to the UartLite driver instance as the callback
-	 * reference so the handlers are able to access the instance data.
-	 */
-	XUartLite_SetRecvHandler(&UartLiteDbgInst, UartDbgRecvHandler,
-							 &UartLiteDbgInst);
-
 	/*
 	 * Enable the interrupt of the UartLite so that the interrupts
 	 * will occur.
 	 */
 	XUartLite_EnableInterrupt(&UartLiteDbgInst);
+	UartPortDbg.irqOn = 1;
 
 	return XST_SUCCESS;
 }
@@ -508,21 +716,12 @@ static int UbloxUartInit(void)
 	 * can occur. This function is application specific.
 	 */
 	Status = UartSetupIntrSystem(&IntcInstancePtr,
-					 &UartUbloxInst,
+					 &UartPortUblox,
 					 UBLOX_UART_IRPT_INTR);
 	if (Status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
 
-	/*
-	 * Setup the handlers for the UartLite that will be called from the
-	 * interrupt context when data has been sent and received,
-	 * specify a pointer to the UartLite driver instance as the callback
-	 * reference so the handlers are able to access the instance data.
-	 */
-	XUartLite_SetRecvHandler(&UartUbloxInst, UartUbloxRecvHandler,
-			&UartUbloxInst);
-
 	/*
 	 * Enable the interrupt of the UartLite so that the interrupts
 	 * will occur.
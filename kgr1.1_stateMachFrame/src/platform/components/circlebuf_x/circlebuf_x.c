@@ -1,4 +1,5 @@
 #include "circlebuf_x.h"
+#include <string.h>
 //#include <dxdbg.h>
 
 void initializeBuffer(CircularBuffer *cBuffer, char *pbuf, int size) {
@@ -235,21 +236,29 @@ int readBufferMultipleNoMutex(CircularBuffer *cBuffer, char *data, int length) {
     return successCount;
 }
 
+// жд: οдŸ tail߲ῴδд
 int writeBufferMultipleNoMutex(CircularBuffer *cBuffer, char *data, int length) {
-    int successCount = 0;
+    int tail = cBuffer->tail;
+    int capacity = getWritableCapacityNoMutex(cBuffer);
+    int first;
 
-    for (int i = 0; i < length; ++i) {
-        if ((cBuffer->tail + 1) % cBuffer->size == cBuffer->head) {
-            // 
-            break; // дʧܣѭ
-        } else {
-            cBuffer->buffer[cBuffer->tail] = data[i];
-            cBuffer->tail = (cBuffer->tail + 1) % cBuffer->size;
-            successCount++;
-        }
+    if (length > capacity) {
+        length = capacity; // ռ䲻㣬ֻдܷµĲ
+    }
+    first = cBuffer->size - tail;
+    if (first > length) {
+        first = length;
     }
+    memcpy(&cBuffer->buffer[tail], data, first);
+    memcpy(cBuffer->buffer, data + first, length - first);
 
-    return successCount;
+    tail += length;
+    if (tail >= cBuffer->size) {
+        tail -= cBuffer->size;
+    }
+    cBuffer->tail = tail;
+
+    return length;
 }
 
 int readBufferMultipleAndClearNoMutex(CircularBuffer *cBuffer, char *data, int length) {
@@ -0,0 +1,211 @@
+#include "evloop.h"
+#include <stddef.h>
+
+#ifdef EV_HOST_SIM
+#include <pthread.h>
+#endif
+
+#define EV_QUEUE_MASK       (EV_QUEUE_SIZE - 1)
+
+#if (EV_QUEUE_SIZE & EV_QUEUE_MASK) != 0
+#error "EV_QUEUE_SIZE must be a power of two"
+#endif
+
+/*
+ * н߶: ÿԪ,  CAS ռдλúд, 󷢲.
+ * ѭдһ뱻жϴʱ, жԿռԪ, Ҫж.
+ */
+typedef struct {
+    volatile uint32_t seq;
+    int data;
+} ev_cell_t;
+
+static ev_cell_t s_cell[EV_QUEUE_SIZE];
+static volatile uint32_t s_head;        // дλ
+static uint32_t s_tail;                 // ߶λ, ֻѭз
+static volatile uint32_t s_wake;
+static volatile uint32_t s_drop;
+static uint32_t s_sleep;
+
+// ڶʱ: жѹ s_fired, ѭȡߵ s_firedRun 
+static ev_timer_t *s_fired;
+static ev_timer_t *s_firedRun;
+
+#ifdef EV_HOST_SIM
+static pthread_mutex_t s_simLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_simCond = PTHREAD_COND_INITIALIZER;
+static uint32_t s_simIrq;
+
+// ж: Ѵ ev_cpu_idle ߳
+static void ev_sim_irq(void)
+{
+    pthread_mutex_lock(&s_simLock);
+    s_simIrq++;
+    pthread_cond_broadcast(&s_simCond);
+    pthread_mutex_unlock(&s_simLock);
+}
+#endif
+
+void ev_init(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < EV_QUEUE_SIZE; i++) {
+        s_cell[i].seq = i;
+    }
+    s_head = 0;
+    s_tail = 0;
+    s_wake = 0;
+    s_drop = 0;
+    s_sleep = 0;
+    s_fired = NULL;
+    s_firedRun = NULL;
+}
+
+void ev_wake(uint32_t bits)
+{
+    __atomic_fetch_or(&s_wake, bits, __ATOMIC_RELEASE);
+#ifdef EV_HOST_SIM
+    ev_sim_irq();
+#endif
+}
+
+int ev_post(int event)
+{
+    uint32_t pos = __atomic_load_n(&s_head, __ATOMIC_RELAXED);
+    ev_cell_t *cell;
+
+    for (;;) {
+        cell = &s_cell[pos & EV_QUEUE_MASK];
+        int32_t dif = (int32_t)(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - pos);
+
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&s_head, &pos, pos + 1, 0,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+            // ʧʱ pos ѸΪǰдλ
+        } else if (dif < 0) {
+            // һֵĵԪδȡ, 
+            __atomic_fetch_add(&s_drop, 1, __ATOMIC_RELAXED);
+            return 0;
+        } else {
+            pos = __atomic_load_n(&s_head, __ATOMIC_RELAXED);
+        }
+    }
+    cell->data = event;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+    ev_wake(EV_WAKE_EVENT);
+    return 1;
+}
+
+int ev_fetch(int *event)
+{
+    ev_cell_t *cell = &s_cell[s_tail & EV_QUEUE_MASK];
+
+    if (s_firedRun == NULL) {
+        s_firedRun = __atomic_exchange_n(&s_fired, NULL, __ATOMIC_ACQUIRE);
+    }
+    if (s_firedRun != NULL) {
+        ev_timer_t *t = s_firedRun;
+        s_firedRun = t->firedNext;
+        *event = t->event;
+        __atomic_store_n(&t->fired, 0, __ATOMIC_RELEASE);
+        return 1;
+    }
+
+    // Ԫδ (, ߱д;) ʱΪ, ٴλ
+    if (__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) != s_tail + 1) {
+        return 0;
+    }
+    *event = cell->data;
+    __atomic_store_n(&cell->seq, s_tail + EV_QUEUE_SIZE, __ATOMIC_RELEASE);
+    s_tail++;
+    return 1;
+}
+
+/* ---------------- ¼ʱ ---------------- */
+
+// ƽʱֵ (ʱж) ִ
+static void ev_timer_fire(void *arg)
+{
+    ev_timer_t *t = (ev_timer_t *)arg;
+
+    if (t->fired) {
+        return;
+    }
+    t->fired = 1;
+    t->firedNext = __atomic_load_n(&s_fired, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&s_fired, &t->firedNext, t, 0,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+    ev_wake(EV_WAKE_EVENT);
+}
+
+void ev_timer_init(ev_timer_t *t, int event)
+{
+    tw_timer_init(&t->tw, ev_timer_fire, t);
+    t->event = event;
+    t->firedNext = NULL;
+    t->fired = 0;
+}
+
+void ev_timer_start(ev_timer_t *t, uint32_t delay, uint32_t period)
+{
+    tw_start(&gTimerWheel, &t->tw, delay, period);
+}
+
+void ev_timer_stop(ev_timer_t *t)
+{
+    tw_stop(&gTimerWheel, &t->tw);
+}
+
+int ev_timer_active(const ev_timer_t *t)
+{
+    return tw_pending(&t->tw);
+}
+
+/* ----------------  ---------------- */
+
+void ev_cpu_idle(void)
+{
+    s_sleep++;
+#ifdef EV_HOST_SIM
+    pthread_mutex_lock(&s_simLock);
+    {
+        uint32_t irq = s_simIrq;
+        while (irq == s_simIrq) {
+            pthread_cond_wait(&s_simCond, &s_simLock);
+        }
+    }
+    pthread_mutex_unlock(&s_simLock);
+#elif EV_USE_SLEEP && defined(__MICROBLAZE__)
+    // ж ( 1ms ʱж) ỽ
+    __asm__ __volatile__ ("sleep");
+#endif
+}
+
+/*
+ * 黽ѱ־֮䵽жϻǰ, ʱҪһжϲ,
+ * ʱж 1ms, ӳ 1  tick.
+ * ʱжÿ tick  CPU , ֻжʱͶ¼ŷ.
+ */
+uint32_t ev_wait(void)
+{
+    uint32_t bits;
+
+    while ((bits = __atomic_exchange_n(&s_wake, 0, __ATOMIC_ACQUIRE)) == 0) {
+        ev_cpu_idle();
+    }
+    return bits;
+}
+
+uint32_t ev_drop_count(void)
+{
+    return s_drop;
+}
+
+uint32_t ev_sleep_count(void)
+{
+    return s_sleep;
+}
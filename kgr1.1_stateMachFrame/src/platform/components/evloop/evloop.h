@@ -0,0 +1,74 @@
+#ifndef _EVLOOP_H_
+#define _EVLOOP_H_
+
+#include <stdint.h>
+#include "../timer_wheel/timer_wheel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * ¼ѭ֧
+ *
+ * 1. ¼:  (ж/ѭ)  (ѭ), , жпֱͶ
+ * 2. ѱ־: ڵȵƽֻλ, εϲΪһλ
+ * 3. ¼ʱ: ϵͳʱ gTimerWheel , ʱڶʱжй뵽,
+ *    ռ¼, ʱҲᶪ; һεδȡʱϲΪһ
+ * 4. ev_wait: û¼ͻѱ־ʱ CPU  (MicroBlaze sleep / )
+ *
+ * ev_post/ev_wake же.
+ * ʱ EV_HOST_SIM (ʱͬʱ TW_HOST_SIM), ߳ƽ gTimerWheel,
+ * ÿģжϺ ev_wake(0), ൱жϰ CPU л.
+ */
+
+#ifndef EV_QUEUE_SIZE
+#define EV_QUEUE_SIZE       32      // Ϊ 2 
+#endif
+
+// ָ, δ sleep  MicroBlaze  0 ˻ؿת
+#ifndef EV_USE_SLEEP
+#define EV_USE_SLEEP        1
+#endif
+
+// ԭ
+#define EV_WAKE_EVENT       (1u << 0)   // ¼зǿ
+#define EV_WAKE_UART        (1u << 1)   // յ (/GNSS/FPGA)
+
+typedef struct ev_timer {
+    tw_timer_t tw;
+    int event;              // Ͷݵ¼
+    struct ev_timer *firedNext;
+    volatile uint8_t fired; // ѵ, ȴ ev_fetch ȡ
+} ev_timer_t;
+
+void ev_init(void);
+
+// Ͷ¼ѭ;  0
+int ev_post(int event);
+// ȡһ¼ (ȡڶʱ, ȡ), Ϊշ 0; ѭ
+int ev_fetch(int *event);
+// λѱ־
+void ev_wake(uint32_t bits);
+
+void ev_timer_init(ev_timer_t *t, int event);
+// delay ms Ͷ t->event, period  0 ʱ˺ÿ period ms Ͷһ; Ķʱ¼ʱ
+void ev_timer_start(ev_timer_t *t, uint32_t delay, uint32_t period);
+// ѵڵδ ev_fetch ȡߵ¼Իʹ
+void ev_timer_stop(ev_timer_t *t);
+int ev_timer_active(const ev_timer_t *t);
+
+// лԭΪֹ, زѱ־
+uint32_t ev_wait(void);
+// ߵһж
+void ev_cpu_idle(void);
+
+// ͳ: ¼, ߴ
+uint32_t ev_drop_count(void);
+uint32_t ev_sleep_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
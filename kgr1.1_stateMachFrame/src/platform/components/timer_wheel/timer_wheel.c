@@ -0,0 +1,306 @@
+#if defined(TW_HOST_SIM) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE     // PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP
+#endif
+#include "timer_wheel.h"
+#include <stddef.h>
+
+#if defined(TW_HOST_SIM)
+#include <pthread.h>
+// صпʱ, Ҫ
+static pthread_mutex_t s_twLock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+#define TW_LOCK_DECL
+#define TW_LOCK()       pthread_mutex_lock(&s_twLock)
+#define TW_UNLOCK()     pthread_mutex_unlock(&s_twLock)
+#elif defined(__MICROBLAZE__)
+#include "mb_interface.h"
+#define TW_MSR_IE       0x2
+// жϿ״̬, жеʱǰж
+#define TW_LOCK_DECL    uint32_t msr
+#define TW_LOCK()       do { msr = mfmsr(); microblaze_disable_interrupts(); } while (0)
+#define TW_UNLOCK()     do { if (msr & TW_MSR_IE) microblaze_enable_interrupts(); } while (0)
+#else
+#define TW_LOCK_DECL
+#define TW_LOCK()
+#define TW_UNLOCK()
+#endif
+
+#define TW_SLOT_MASK        (TW_SLOTS - 1)
+#define TW_LEVEL_SHIFT(l)   ((l) * TW_SLOT_BITS)
+//  l ֱɵ
+#define TW_LEVEL_SPAN(l)    (1u << TW_LEVEL_SHIFT((l) + 1))
+#define TW_MAX_DELTA        (TW_LEVEL_SPAN(TW_LEVELS - 1) - 1)
+#define TW_RUNNING          0xFF
+
+static void tw_link(tw_wheel_t *w, tw_timer_t *t, uint32_t level, uint32_t slot)
+{
+    tw_timer_t **head = &w->slot[level][slot];
+
+    t->next = *head;
+    if (*head) {
+        (*head)->pprev = &t->next;
+    }
+    *head = t;
+    t->pprev = head;
+    t->level = (uint8_t)level;
+    t->slot = (uint8_t)slot;
+    w->bitmap[level] |= (uint64_t)1 << slot;
+}
+
+static void tw_unlink(tw_wheel_t *w, tw_timer_t *t)
+{
+    *t->pprev = t->next;
+    if (t->next) {
+        t->next->pprev = t->pprev;
+    }
+    t->pprev = NULL;
+    if (t->level != TW_RUNNING && w->slot[t->level][t->slot] == NULL) {
+        w->bitmap[t->level] &= ~((uint64_t)1 << t->slot);
+    }
+}
+
+/*
+ *  base Զѡ:  < 64^(L+1) Ĺڵ L , Եʱ̵ĵ L λۺ.
+ *  L Ĳۺڵǰ֮һȦ, òʱ.
+ */
+static void tw_place(tw_wheel_t *w, tw_timer_t *t)
+{
+    uint32_t expire = t->expire;
+    uint32_t delta;
+    uint32_t level;
+    uint32_t start;
+
+    // ѹڵһ tick ִ, ڶʱӸʱ
+    if (TW_TIME_BEFORE(expire, w->base)) {
+        expire = w->base;
+        t->expire = expire;
+    }
+    delta = expire - w->base;
+    if (delta > TW_MAX_DELTA) {
+        // Χȹ߼ԶĲ, ʱʵʱ·
+        expire = w->base + TW_MAX_DELTA;
+    }
+    for (level = 0; level < TW_LEVELS - 1; level++) {
+        if (expire - w->base < TW_LEVEL_SPAN(level)) {
+            break;
+        }
+    }
+    tw_link(w, t, level, (expire >> TW_LEVEL_SHIFT(level)) & TW_SLOT_MASK);
+
+    // ò۵
+    start = (expire >> TW_LEVEL_SHIFT(level)) << TW_LEVEL_SHIFT(level);
+    if (TW_TIME_BEFORE(start, w->base)) {
+        start = w->base;
+    }
+    if (w->count == 0 || TW_TIME_BEFORE(start, w->next)) {
+        w->next = start;
+    }
+    w->count++;
+}
+
+// ѵ level ǰ۵Ķʱͼ
+static void tw_cascade(tw_wheel_t *w, uint32_t level)
+{
+    uint32_t slot = (w->base >> TW_LEVEL_SHIFT(level)) & TW_SLOT_MASK;
+    tw_timer_t *t = w->slot[level][slot];
+
+    w->slot[level][slot] = NULL;
+    w->bitmap[level] &= ~((uint64_t)1 << slot);
+    while (t) {
+        tw_timer_t *next = t->next;
+        w->count--;
+        tw_place(w, t);
+        t = next;
+    }
+}
+
+//  from  () ѭһǿղ۵ľ, ûз -1
+static int tw_scan(uint64_t bitmap, uint32_t from)
+{
+    uint64_t rot;
+
+    if (bitmap == 0) {
+        return -1;
+    }
+    rot = from ? (bitmap >> from) | (bitmap << (TW_SLOTS - from)) : bitmap;
+    return __builtin_ctzll(rot);
+}
+
+static int tw_find_next(tw_wheel_t *w, uint32_t *tick)
+{
+    uint32_t level;
+    int found = 0;
+
+    for (level = 0; level < TW_LEVELS; level++) {
+        uint32_t shift = TW_LEVEL_SHIFT(level);
+        uint32_t index = (w->base >> shift) & TW_SLOT_MASK;
+        // base ڲʱǰδ ( 0 ), ǰѽ, һ
+        uint32_t skip = (w->base & ((1u << shift) - 1)) ? 1 : 0;
+        int dist = tw_scan(w->bitmap[level], (index + skip) & TW_SLOT_MASK);
+        uint32_t start;
+
+        if (dist < 0) {
+            continue;
+        }
+        start = ((w->base >> shift) + (uint32_t)dist + skip) << shift;
+        if (level == 0) {
+            start = w->base + (uint32_t)dist;
+        }
+        if (!found || TW_TIME_BEFORE(start, *tick)) {
+            *tick = start;
+            found = 1;
+        }
+    }
+    return found;
+}
+
+//  w->base һ tick: 𼶽ִе 0 ǰ
+static void tw_run_tick(tw_wheel_t *w)
+{
+    uint32_t level;
+    uint32_t slot;
+    tw_timer_t *run;
+
+    for (level = 1; level < TW_LEVELS; level++) {
+        if ((w->base & ((1u << TW_LEVEL_SHIFT(level)) - 1)) != 0) {
+            break;
+        }
+        tw_cascade(w, level);
+    }
+
+    slot = w->base & TW_SLOT_MASK;
+    run = w->slot[0][slot];
+    w->slot[0][slot] = NULL;
+    w->bitmap[0] &= ~((uint64_t)1 << slot);
+    // ƽ base, ص 0 ʱĶʱ䵽һ tick, ڱظִ
+    w->base++;
+
+    if (run == NULL) {
+        return;
+    }
+    // ժµͷƵջ, صֹͣʱʱԿժ
+    run->pprev = &run;
+    for (tw_timer_t *t = run; t; t = t->next) {
+        t->level = TW_RUNNING;
+    }
+    while (run) {
+        tw_timer_t *t = run;
+
+        tw_unlink(w, t);
+        w->count--;
+        if (t->period) {
+            t->expire += t->period;
+            // һ (ƽʱ) 
+            if (TW_TIME_BEFORE(t->expire, w->base)) {
+                t->expire = w->base - 1 + t->period;
+            }
+            tw_place(w, t);
+        }
+        t->cb(t->arg);
+    }
+}
+
+void tw_init(tw_wheel_t *w, uint32_t now)
+{
+    uint32_t level, slot;
+
+    for (level = 0; level < TW_LEVELS; level++) {
+        for (slot = 0; slot < TW_SLOTS; slot++) {
+            w->slot[level][slot] = NULL;
+        }
+        w->bitmap[level] = 0;
+    }
+    w->base = now + 1;
+    w->next = w->base;
+    w->count = 0;
+}
+
+void tw_timer_init(tw_timer_t *t, tw_callback_t cb, void *arg)
+{
+    t->next = NULL;
+    t->pprev = NULL;
+    t->expire = 0;
+    t->period = 0;
+    t->cb = cb;
+    t->arg = arg;
+    t->level = 0;
+    t->slot = 0;
+}
+
+void tw_start(tw_wheel_t *w, tw_timer_t *t, uint32_t delay, uint32_t period)
+{
+    TW_LOCK_DECL;
+
+    TW_LOCK();
+    if (t->pprev) {
+        tw_unlink(w, t);
+        w->count--;
+    }
+    // base Ϊһ tick, ǰʱΪ base - 1
+    t->expire = w->base - 1 + delay;
+    t->period = period;
+    tw_place(w, t);
+    TW_UNLOCK();
+}
+
+void tw_stop(tw_wheel_t *w, tw_timer_t *t)
+{
+    TW_LOCK_DECL;
+
+    TW_LOCK();
+    if (t->pprev) {
+        tw_unlink(w, t);
+        w->count--;
+    }
+    TW_UNLOCK();
+}
+
+int tw_pending(const tw_timer_t *t)
+{
+    return t->pprev != NULL;
+}
+
+uint32_t tw_remaining(tw_wheel_t *w, const tw_timer_t *t)
+{
+    uint32_t now = w->base - 1;
+
+    if (t->pprev == NULL || TW_TIME_BEFORE_EQ(t->expire, now)) {
+        return 0;
+    }
+    return t->expire - now;
+}
+
+void tw_advance(tw_wheel_t *w, uint32_t now)
+{
+    TW_LOCK_DECL;
+
+    TW_LOCK();
+    //  tick ûжʱ, ֻȽһ
+    while (TW_TIME_BEFORE_EQ(w->base, now)) {
+        if (w->count == 0 || TW_TIME_AFTER(w->next, now)) {
+            w->base = now + 1;
+            break;
+        }
+        //  tick: мĲȫΪ, ԽĽҲûжʱ
+        if (!tw_find_next(w, &w->next) || TW_TIME_AFTER(w->next, now)) {
+            w->base = now + 1;
+            break;
+        }
+        w->base = w->next;
+        tw_run_tick(w);
+        if (w->count && !tw_find_next(w, &w->next)) {
+            w->next = w->base;
+        }
+    }
+    TW_UNLOCK();
+}
+
+int tw_next_expiry(tw_wheel_t *w, uint32_t *tick)
+{
+    int found;
+    TW_LOCK_DECL;
+
+    TW_LOCK();
+    found = w->count ? tw_find_next(w, tick) : 0;
+    TW_UNLOCK();
+    return found;
+}
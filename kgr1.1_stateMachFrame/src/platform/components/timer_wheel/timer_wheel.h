@@ -0,0 +1,78 @@
+#ifndef _TIMER_WHEEL_H_
+#define _TIMER_WHEEL_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * ֲʱʱ
+ *
+ * 4  x 64 ,  L ÿۿ 64^L tick,  2^24 tick (1ms ʱԼ 4.6 Сʱ),
+ * ԶĶʱȹ߼, ʱ¼λ.
+ * /ֹͣ O(1); ƽʱֻжʱĲ, мĿ tick λͼһ,
+ * ˴Զڶʱÿ tick Ŀ, ֱʱ.
+ *
+ * صڵ tw_advance ִ (ĿΪʱж), Ӧ,
+ * һֻͶ¼; صп/ֹͣʱ, Լ.
+ * ѭе tw_start/tw_stop ʱڲж, жеƽ.
+ * Լ tools/tw_stress.c.
+ */
+
+#define TW_LEVELS           4
+#define TW_SLOT_BITS        6
+#define TW_SLOTS            (1u << TW_SLOT_BITS)
+
+// ưȫʱ̱Ƚ (uint32_t tick), ʱС 2^31
+#define TW_TIME_BEFORE(a, b)        ((int32_t)((uint32_t)(a) - (uint32_t)(b)) < 0)
+#define TW_TIME_AFTER(a, b)         TW_TIME_BEFORE(b, a)
+#define TW_TIME_BEFORE_EQ(a, b)     (!TW_TIME_AFTER(a, b))
+#define TW_TIME_AFTER_EQ(a, b)      (!TW_TIME_BEFORE(a, b))
+
+typedef void (*tw_callback_t)(void *arg);
+
+typedef struct tw_timer {
+    struct tw_timer *next;
+    struct tw_timer **pprev;    // NULL: δ
+    uint32_t expire;            //  tick
+    uint32_t period;            // 0 Ϊ
+    tw_callback_t cb;
+    void *arg;
+    uint8_t level;              // ڼͲ, ֹͣʱάλͼ
+    uint8_t slot;
+} tw_timer_t;
+
+typedef struct {
+    tw_timer_t *slot[TW_LEVELS][TW_SLOTS];
+    uint64_t bitmap[TW_LEVELS];     // ǿղ
+    uint32_t base;                  // һ tick
+    uint32_t next;                  // жʱڵ tick, ƫ, ƫ
+    uint32_t count;
+} tw_wheel_t;
+
+// ϵͳ 1ms ʱ,  TimerCounterHandler ƽ (timer.c); ʱǰ tw_init (PreInit )
+extern tw_wheel_t gTimerWheel;
+
+// now Ϊǰ tick, ˺ tw_advance  now ʱ
+void tw_init(tw_wheel_t *w, uint32_t now);
+void tw_timer_init(tw_timer_t *t, tw_callback_t cb, void *arg);
+
+// delay tick ص, period  0 ʱ˺ÿ period tick صһ; Ķʱ¼ʱ
+void tw_start(tw_wheel_t *w, tw_timer_t *t, uint32_t delay, uint32_t period);
+void tw_stop(tw_wheel_t *w, tw_timer_t *t);
+int tw_pending(const tw_timer_t *t);
+// ൽڻʣ tick , δ 0
+uint32_t tw_remaining(tw_wheel_t *w, const tw_timer_t *t);
+
+//  now Ϊֹ ( now) ȫڶʱ
+void tw_advance(tw_wheel_t *w, uint32_t now);
+// 絽ʱ̵½,  tick /תʹ; ûжʱ 0
+int tw_next_expiry(tw_wheel_t *w, uint32_t *tick);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,154 @@
+/******************************************************************************
+ * Copyright (C) 2024 ZS Development Team, Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @file zs_dlog.c
+ * @brief ӳٸʽ־λ
+ * @version 0.1
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Andy      first version
+******************************************************************************/
+#include <string.h>
+#include "zs_dlog.h"
+
+#ifndef _WIN32
+#include "uart_service.h"
+#endif
+
+#ifndef DLOG_TIMESTAMP
+extern uint32_t tick_get(void);
+#define DLOG_TIMESTAMP()    tick_get()
+#endif
+
+#if (DLOG_RING_WORDS & (DLOG_RING_WORDS - 1)) != 0
+#error "DLOG_RING_WORDS must be a power of two"
+#endif
+#define DLOG_RING_MASK      (DLOG_RING_WORDS - 1)
+
+/* д: жͨ CAS ռдλ, ݺдͷύ
+ * : ̨˳ύ¼, δύͷֹּͣ */
+#if defined(__GNUC__)
+#define DLOG_CAS(p, o, n)   __sync_bool_compare_and_swap((p), (o), (n))
+#define DLOG_ADD(p, v)      __sync_fetch_and_add((p), (v))
+#define DLOG_SUB(p, v)      __sync_fetch_and_sub((p), (v))
+#define DLOG_BARRIER()      __sync_synchronize()
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define DLOG_CAS(p, o, n)   (_InterlockedCompareExchange((volatile long *)(p), (long)(n), (long)(o)) == (long)(o))
+#define DLOG_ADD(p, v)      _InterlockedExchangeAdd((volatile long *)(p), (long)(v))
+#define DLOG_SUB(p, v)      _InterlockedExchangeAdd((volatile long *)(p), -(long)(v))
+#define DLOG_BARRIER()      _ReadWriteBarrier()
+#endif
+
+static volatile u32 s_dlog_ring[DLOG_RING_WORDS];
+static volatile u32 s_dlog_head;        /* Ԥ, ɵ */
+static volatile u32 s_dlog_tail;        /* ѷ, ֻɶ޸ */
+static volatile u32 s_dlog_dropped;
+
+void dlog_write(u32 fmt_id, const u32 *args, u32 nargs)
+{
+    u32 len = DLOG_HDR_WORDS + nargs;
+    u32 head, pos, pad, i;
+
+    if (nargs > DLOG_MAX_ARGS)
+    {
+        return;
+    }
+
+    /* Ԥռ: ¼Խβ, ŲʱͬβһԤ */
+    do
+    {
+        head = s_dlog_head;
+        pos = head & DLOG_RING_MASK;
+        pad = (pos + len > DLOG_RING_WORDS) ? DLOG_RING_WORDS - pos : 0;
+        if (head + pad + len - s_dlog_tail > DLOG_RING_WORDS)
+        {
+            DLOG_ADD(&s_dlog_dropped, 1);
+            return;
+        }
+    } while (!DLOG_CAS(&s_dlog_head, head, head + pad + len));
+
+    if (pad != 0)
+    {
+        s_dlog_ring[pos] = DLOG_TAG_PAD | pad;
+        pos = 0;
+    }
+
+    s_dlog_ring[pos + 1] = fmt_id;
+    s_dlog_ring[pos + 2] = DLOG_TIMESTAMP();
+    for (i = 0; i < nargs; i++)
+    {
+        s_dlog_ring[pos + DLOG_HDR_WORDS + i] = args[i];
+    }
+    DLOG_BARRIER();
+    s_dlog_ring[pos] = DLOG_TAG_RECORD | (nargs << 16);
+}
+
+u32 dlog_flush(void (*out)(const void *data, u32 len))
+{
+    u32 sent = 0;
+    u32 tail = s_dlog_tail;
+    u32 dropped;
+
+    while (tail != s_dlog_head)
+    {
+        u32 pos = tail & DLOG_RING_MASK;
+        u32 hdr = s_dlog_ring[pos];
+        u32 len;
+
+        if ((hdr & DLOG_TAG_MASK) == DLOG_TAG_PAD)
+        {
+            len = hdr & 0xFFFF;
+        }
+        else if ((hdr & DLOG_TAG_MASK) == DLOG_TAG_RECORD)
+        {
+            len = DLOG_HDR_WORDS + ((hdr >> 16) & 0xFF);
+            DLOG_BARRIER();
+            out((const void *)&s_dlog_ring[pos], len * sizeof(u32));
+            sent += len;
+        }
+        else
+        {
+            break;      /* дԤδύ */
+        }
+
+        /* ͷſռ, ֤ԺͷύǰĶ 0 */
+        memset((void *)&s_dlog_ring[pos], 0, len * sizeof(u32));
+        DLOG_BARRIER();
+        tail += len;
+        s_dlog_tail = tail;
+    }
+
+    /* ڻд֮, м¼֮󱨸 */
+    dropped = s_dlog_dropped;
+    if (dropped != 0)
+    {
+        u32 rec[DLOG_HDR_WORDS + 1];
+
+        rec[0] = DLOG_TAG_RECORD | (1u << 16);
+        rec[1] = DLOG_ID_DROPPED;
+        rec[2] = DLOG_TIMESTAMP();
+        rec[3] = dropped;
+        out(rec, sizeof(rec));
+        DLOG_SUB(&s_dlog_dropped, dropped);
+        sent += DLOG_HDR_WORDS + 1;
+    }
+    return sent;
+}
+
+static void dlog_out_console(const void *data, u32 len)
+{
+#if defined(STDOUT_BASEADDRESS) || defined(VERSAL_PLM)
+    /*  dx_kprintf ͬ, Դڷͻλ,  AD ֡м */
+    UartConsoleWrite((const u8 *)data, len);
+#else
+    DX_UNUSED(data);
+    DX_UNUSED(len);
+#endif
+}
+
+u32 dlog_flush_console(void)
+{
+    return dlog_flush(dlog_out_console);
+}
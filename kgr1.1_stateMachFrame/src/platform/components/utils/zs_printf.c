@@ -43,7 +43,7 @@
 #include "zs_printf.h"
 #ifndef _WIN32
 #include "xparameters.h"
-extern void outbyte (char8 c);
+#include "uart_service.h"
 #endif // !_WIN32
 
 #ifndef PICO_PRINTF_CONSOLEBUF_SIZE
@@ -962,7 +962,6 @@ void dx_kprintf(const char *fmt, ...)
 {
     va_list args;
     int length;
-    int i;
     static char dx_log_buf[PICO_PRINTF_CONSOLEBUF_SIZE*4];
 
     va_start(args, fmt);
@@ -976,10 +975,9 @@ void dx_kprintf(const char *fmt, ...)
         length = PICO_PRINTF_CONSOLEBUF_SIZE - 1;
 
 #if defined(STDOUT_BASEADDRESS) || defined(VERSAL_PLM)
-    for(i = 0; i < length; i++)
-    {
-    	outbyte(dx_log_buf[i]);
-    }
+    /* the console shares the debug UART with AD frames, queue it behind
+     * them in the TX ring instead of writing the FIFO directly */
+    UartConsoleWrite((const u8 *)dx_log_buf, length);
 #endif
     va_end(args);
 }
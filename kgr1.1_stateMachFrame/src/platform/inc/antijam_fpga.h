@@ -24,7 +24,17 @@
 #define _ANTIJAM_FPGA_H
 
 /* Includes ------------------------------------------------------------------*/
+#ifdef ANTIJAM_HOST_MOCK
+/*ͳƹ߲ BSP ͷļ*/
+#include <stdint.h>
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef int32_t  s32;
+enum { DX_EOK = 0, DX_ERROR, DX_ETIMEOUT };
+#else
 #include "dxdef.h"
+#endif
 
 
 #ifdef __cplusplus
@@ -109,11 +119,100 @@ extern "C" {
 
 
 
+/******************KGR ĴӰӻ
+* ַ 0..KGR_REG_NUM-1 ļĴԷ:
+*   - KGR_REG_VOLATILE  : ״̬/FIFO/FPGA идļĴ, ÿζ (Ĭ);
+*   - KGR_REG_CACHEABLE : ֻ MCU дĿƼĴ, һζӰֵ.
+* mcu_to_fpga_write_kgr_reg ֱд߲Ӱ; mcu_to_fpga_read_kgr_reg ԿɻĴӰ.
+* kgr_reg_field/kgr_reg_set_bits/kgr_reg_clr_bits ֻӰӲ, kgr_reg_flush һΰַ˳д.
+* FPGA λ¼غ kgr_reg_invalidate_all.
+*  ANTIJAM_HOST_MOCK ʱ߻ڴ, ͳƷʴ.
+**/
+#define KGR_REG_NUM                    256
+
+#define KGR_REG_VOLATILE               0
+#define KGR_REG_CACHEABLE              1
+
+typedef struct
+{
+	u32 reads;                         /*߶*/
+	u32 writes;                        /*д*/
+}kgr_bus_stat_t;
+
+u32 kgr_reg_read_hw(u32 addr);
+void kgr_reg_field(u32 addr, u32 mask, u32 val);
+void kgr_reg_set_bits(u32 addr, u32 bits);
+void kgr_reg_clr_bits(u32 addr, u32 bits);
+int kgr_reg_flush(void);
+void kgr_reg_invalidate(u32 addr);
+void kgr_reg_invalidate_all(void);
+void kgr_reg_set_attr(u32 addr, u8 attr);
+void kgr_bus_stat_get(kgr_bus_stat_t *stat, int clear);
+
+#ifdef ANTIJAM_HOST_MOCK
+#define KGR_MOCK_BUS_NUM               8192
+/*Ĵֱӳ, ɼַ۵*/
+#define KGR_MOCK_INDEX(addr)           ((addr) < KGR_REG_NUM ? (addr) \
+                                        : KGR_REG_NUM + ((addr) - KGR_REG_NUM) % (KGR_MOCK_BUS_NUM - KGR_REG_NUM))
+extern u32 g_kgrMockBus[KGR_MOCK_BUS_NUM];
+/*ÿд֮, ģ FPGA ľλͻضֵ*/
+extern void (*g_kgrMockWriteHook)(u32 addr, u32 val);
+#endif
+
+/******************Ĵ
+* һĴд, д, ȴλųһύ:
+*   - ͬһд֮䲻ж, ;
+*   - дļĴֵڻ, ͬһĴζдֻضһ;
+*   - ȴλʱ, ȶѯ, δߵһж ( 1ms) ز;
+*   - ʱѡͨȺЧǰĽʱ,  tick , ᱻϲʡ;
+*   - дĽύʱͳһضУ, һֻ, ɵ߻ܴӡ.
+* дʱԶύ. ĳȴʱ, ʣȫֱһ begin.
+**/
+#define FPGA_BATCH_OP_WRITE            0   /*д*/
+#define FPGA_BATCH_OP_RMW              1   /*д: reg = (reg & ~mask) | (val & mask)*/
+#define FPGA_BATCH_OP_WAIT             2   /*ȴ (reg & mask) == val*/
+#define FPGA_BATCH_OP_CHECK            3   /*ضȽ (reg & mask) == val, д󼴱ļĴ*/
+#define FPGA_BATCH_OP_DELAY            4   /*ʱ timeout ms*/
+
+#define FPGA_BATCH_CACHE_NUM           8   /*ڶдļĴ*/
+#define FPGA_BATCH_WAIT_SPIN           32  /*ȴʱѯĴ, ֮ tick */
+
+typedef struct
+{
+	u16 op;
+	u16 timeout;                       /*WAIT ʱʱ / DELAY ʱʱ ms*/
+	u32 addr;
+	u32 mask;
+	u32 val;
+}fpga_reg_op_t;
+
+typedef struct
+{
+	fpga_reg_op_t *ops;
+	u16 size;
+	u16 count;
+	int status;                        /*DX_EOK  -DX_ETIMEOUT*/
+	u32 timeoutAddr;                   /*ʱļĴ*/
+	u32 verifyErr;                     /*ضһµĴ*/
+	u32 errAddr;                       /*һһµļĴֵ/ضֵ*/
+	u32 errExpect;
+	u32 errRead;
+}fpga_batch_t;
+
+void fpga_batch_begin(fpga_batch_t *b, fpga_reg_op_t *ops, u16 size);
+void fpga_batch_write(fpga_batch_t *b, u32 addr, u32 val);
+void fpga_batch_rmw(fpga_batch_t *b, u32 addr, u32 mask, u32 val);
+void fpga_batch_wait(fpga_batch_t *b, u32 addr, u32 mask, u32 val, u16 timeoutMs);
+void fpga_batch_check(fpga_batch_t *b, u32 addr, u32 mask, u32 val);
+void fpga_batch_delay(fpga_batch_t *b, u16 ms);
+int fpga_batch_submit(fpga_batch_t *b);
+
 void antijam_fpga_write_reg(u8 addr, u32 val);
 u32 antijam_fpga_read_reg(u8 addr);
 int dx_hw_antijam_fpga_init(void);
 void mcu_to_fpga_write_kgr_reg(u32 addr, u32 val);
 u32 mcu_to_fpga_read_kgr_reg(u32 addr);
+void mcu_to_fpga_read_kgr_block(u32 addr, u32 *dst, u32 num);
 
 extern u32 Value[9];
 extern int IntrFlag;
@@ -0,0 +1,115 @@
+/*
+ ******************************************************************************
+ * @file    gpio_spi.h
+ *
+ * @brief   This file contains all the functions prototypes for the
+ *          gpio_spi.c driver.
+ ******************************************************************************
+ *
+ * Copyright (c) 2025, ZS Development Team
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     zs           the first version
+ *
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __GPIO_SPI_H__
+#define __GPIO_SPI_H__
+
+#ifdef __cplusplus
+  extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#ifdef GPIO_SPI_HOST_MOCK
+/*βԲ BSP ͷļ*/
+#include <stdint.h>
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+#else
+#include "dxdef.h"
+#endif
+
+/*
+ * ͨ GPIO ģ SPI
+ *
+ * MT9653/ADF4351/RX1922/PE43711  gPeriGpioSpi ͨ 1 , һ˿ӰӼĴ:
+ * ỰʼʱݼĴͬһ, ֮ÿʱֻһд (ʱ + ͬʱ),
+ * ܽŶд. ݰֽڲ, Ѱݹܽźǰڵʱӵƽ,
+ * ֻʱλ.
+ * ʱ tick_get 궨ѭ, λ ns.
+ * ÿֳ 4 ı (4~32).
+ */
+
+/*SPI ģʽ: CPOL Ϊʱӿеƽ, CPHA=0 ǰز, CPHA=1 ز*/
+#define GPIO_SPI_MODE0                  (0)
+#define GPIO_SPI_MODE1                  (1)
+#define GPIO_SPI_MODE2                  (2)
+#define GPIO_SPI_MODE3                  (3)
+
+/*flags*/
+#define GPIO_SPI_LSB_FIRST              (0x01)  /*λȷ, Ĭϸλȷ*/
+#define GPIO_SPI_CS_ACTIVE_HIGH         (0x02)  /*ƬѡЧ, ĬϵЧ*/
+#define GPIO_SPI_3WIRE                  (0x04)  /*SDIO ˫, ʱлΪ*/
+
+#define GPIO_SPI_PIN(n)                 (1u << (n))
+
+typedef struct
+{
+	/*, ̬ʼ*/
+	u32 csMask;         /*Ƭѡ/LE ܽ, 0 ʾƬѡ*/
+	u32 clkMask;
+	u32 mosiMask;       /*3 ʱΪ SDIO*/
+	u32 misoMask;       /*3 ʱ mosiMask ͬ, ֻдΪ 0*/
+	u32 idleMask;       /*Ựʱߵ߹ܽ, ߹ܽ*/
+	u8  mode;           /*GPIO_SPI_MODEx*/
+	u8  flags;          /*GPIO_SPI_xxx*/
+	u16 halfNs;         /*ʱӰ*/
+	u16 csNs;           /*Ƭѡ/ʱ, Ҳ*/
+
+	/*ʱ, gpio_spi_begin ״εʱ*/
+	u8  ready;
+	u32 halfLoops;
+	u32 csLoops;
+	u32 lut[16][4];     /*ֽ -> 4 ǰڶ˿ (ܽ)*/
+}gpio_spi_bus_t;
+
+/* tick_get 궨ʱѭ, ڶʱ; δ궨ʱĬֵʱ*/
+void gpio_spi_calibrate(void);
+u32 gpio_spi_loops_per_ms(void);
+
+/*
+ * Ự: begin ùܽŷͬӰӼĴ, ƬѡЧ, ʱӴڿеƽ;
+ * end  idleMask ߹ܽŵƽ. Ựڿ gpio_spi_frame.
+ */
+void gpio_spi_begin(gpio_spi_bus_t *bus);
+void gpio_spi_end(gpio_spi_bus_t *bus);
+
+/*
+ * һ֡: ƬѡЧ ->  txBits λ -> (3 ʱ SDIO )  rxBits λ -> ƬѡЧ.
+ * ȡ tx ĵ txBits λ, ؽյ rxBits λ; rxBits Ϊ 0 ʱ 0.
+ */
+u32 gpio_spi_frame(gpio_spi_bus_t *bus, u32 tx, u8 txBits, u8 rxBits);
+
+/*֡д, ԰һỰ*/
+void gpio_spi_write(gpio_spi_bus_t *bus, u32 tx, u8 bits);
+u32 gpio_spi_read(gpio_spi_bus_t *bus, u32 cmd, u8 cmdBits, u8 rxBits);
+
+/*
+ * һỰд count ֡, ÿ֡ bits λ. ܽŷӰӼĴֻһ,
+ * ÿ֮֡Ƭѡ/LE  (⼸֡).
+ */
+void gpio_spi_batch(gpio_spi_bus_t *bus, const u32 *words, u32 count, u8 bits);
+
+/*궨æ, мĴ֮Ķʱʹ*/
+void gpio_spi_delay_ns(u32 ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -23,8 +23,17 @@
 #endif
 
 /* Includes ------------------------------------------------------------------*/
+#ifdef ADF4351_HOST_TEST
+/* (tools/adf4351_sweep)  BSP ͷļ*/
+#include <stdint.h>
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+#else
 #include "dxdef.h"
 #include "sys_ctrl.h"
+#endif
 
 /** @defgroup ADF4351 Infos
   * @{
@@ -149,6 +158,27 @@ typedef union
   */
 void dx_hw_adf4351_init(void);
 
+/*Ƶ: RFout = [INT + (FRAC/MOD)] * Fpfd / 2^RF_Div*/
+typedef struct
+{
+    u16 INT;
+    u16 FRAC;
+    u16 MOD;
+    u8  RF_Div;
+} adf4351_pll_t;
+
+int adf4351_calc_pll(u64 freqHz, adf4351_pll_t *pll);
+u64 adf4351_pll_freq_hz(const adf4351_pll_t *pll);
+void adf4351_build_regs(const adf4351_pll_t *pll, u32 *regs);
+int adf4351_set_freq_hz(u64 freqHz);
+void adf4351_set_freq(double freq);
+void adf4351_invalidate_regs(void);
+
+#ifdef ADF4351_HOST_TEST
+/*Գʵ, ˳һλỰдļĴ*/
+void adf4351_host_write(const u32 *regs, u32 num);
+#endif
+
 /**
   *@}
   *
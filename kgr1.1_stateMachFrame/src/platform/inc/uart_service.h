@@ -22,6 +22,10 @@ extern "C" {
 
 
 void UartDevInit(void);
+u32 UartForwardDropCount(void);
+int UartDbgTxBlock(const u8 *data, u32 len);
+int UartDbgTxBlockBusy(void);
+void UartConsoleWrite(const u8 *data, u32 len);
 
 #ifdef __cplusplus
 }
@@ -163,6 +163,25 @@ unsigned char pairedChars[][2] = {
 static Shell *shellList[SHELL_MAX_NUMBER] = {NULL};
 
 
+#if SHELL_USING_CMD_INDEX == 1
+#define     SHELL_CMD_INDEX_NONE        0xFFFF
+
+/**
+ * @brief 
+ *        ʱȷ, shellͬһ, shellInitʱ
+ *        SHELL_CMD_INDEX_MAXʱ, ˻
+ */
+static struct
+{
+    void *base;                                             /**< ѽַ */
+    unsigned short nameCount;                               /**<  */
+    unsigned short name[SHELL_CMD_INDEX_MAX];               /**< ±() */
+    unsigned short keyHead[256];                            /**< ֽ -> ׸± */
+    unsigned short keyNext[SHELL_CMD_INDEX_MAX];            /**< ֽͬһ± */
+} shellCmdIndex;
+#endif /** SHELL_USING_CMD_INDEX == 1 */
+
+
 static void shellAdd(Shell *shell);
 static void shellWritePrompt(Shell *shell, unsigned char newline);
 static void shellWriteReturnValue(Shell *shell, int value);
@@ -173,6 +192,9 @@ ShellCommand* shellSeekCommand(Shell *shell,
                                ShellCommand *base,
                                unsigned short compareLength);
 static void shellWriteCommandHelp(Shell *shell, char *cmd);
+#if SHELL_USING_CMD_INDEX == 1
+static void shellBuildIndex(Shell *shell);
+#endif
 
 /**
  * @brief shell ʼ
@@ -185,6 +207,10 @@ void shellInit(Shell *shell, char *buffer, unsigned short size)
     shell->parser.cursor = 0;
     shell->info.user = NULL;
     shell->status.isChecked = 1;
+    shell->status.isBatch = 0;
+#if SHELL_WRITE_BUFFER > 0
+    shell->output.length = 0;
+#endif
 
     shell->parser.buffer = buffer;
     shell->parser.bufferSize = size / (SHELL_HISTORY_MAX_NUMBER + 1);
@@ -225,6 +251,9 @@ void shellInit(Shell *shell, char *buffer, unsigned short size)
 #endif
 
     shellAdd(shell);
+#if SHELL_USING_CMD_INDEX == 1
+    shellBuildIndex(shell);
+#endif
 
     shellSetUser(shell, shellSeekCommand(shell,
                                          SHELL_DEFAULT_USER,
@@ -287,6 +316,60 @@ Shell* shellGetCurrent(void)
 }
 
 
+#if SHELL_WRITE_BUFFER > 0
+/**
+ * @brief shell дݴ
+ * 
+ * @param shell shell
+ */
+void shellFlush(Shell *shell)
+{
+    if (shell->output.length)
+    {
+        shell->write(shell->output.buffer, shell->output.length);
+        shell->output.length = 0;
+    }
+}
+#endif /** SHELL_WRITE_BUFFER > 0 */
+
+
+/**
+ * @brief shell 
+ *        ڼݴ, д
+ * 
+ * @param shell shell
+ * @param data 
+ * @param len ݳ
+ * 
+ * @return unsigned short дַ
+ */
+static unsigned short shellOutput(Shell *shell, const char *data, unsigned short len)
+{
+#if SHELL_WRITE_BUFFER > 0
+    if (shell->output.length + len > SHELL_WRITE_BUFFER)
+    {
+        shellFlush(shell);
+    }
+    if (len >= SHELL_WRITE_BUFFER)
+    {
+        shell->write((char *)data, len);
+    }
+    else
+    {
+        memcpy(shell->output.buffer + shell->output.length, data, len);
+        shell->output.length += len;
+    }
+    if (!shell->status.isBatch)
+    {
+        shellFlush(shell);
+    }
+    return len;
+#else
+    return shell->write((char *)data, len);
+#endif
+}
+
+
 /**
  * @brief shellдַ
  * 
@@ -295,7 +378,7 @@ Shell* shellGetCurrent(void)
  */
 static void shellWriteByte(Shell *shell, char data)
 {
-    shell->write(&data, 1);
+    shellOutput(shell, &data, 1);
 }
 
 
@@ -316,7 +399,7 @@ unsigned short shellWriteString(Shell *shell, const char *string)
     {
         count ++;
     }
-    return shell->write((char *)string, count);
+    return shellOutput(shell, string, count);
 }
 
 
@@ -341,12 +424,12 @@ static unsigned short shellWriteCommandDesc(Shell *shell, const char *string)
     
     if (count > 36)
     {
-        shell->write((char *)string, 36);
-        shell->write("...", 3);
+        shellOutput(shell, string, 36);
+        shellOutput(shell, "...", 3);
     }
     else
     {
-        shell->write((char *)string, count);
+        shellOutput(shell, string, count);
     }
     return count > 36 ? 36 : 39;
 }
@@ -402,7 +485,7 @@ void shellPrint(Shell *shell, const char *fmt, ...)
     {
         len = SHELL_PRINT_BUFFER;
     }
-    shell->write(buffer, len);
+    shellOutput(shell, buffer, len);
 }
 #endif
 
@@ -428,7 +511,8 @@ void shellScan(Shell *shell, char *fmt, ...)
         do {
             if (shell->read(&buffer[index], 1) == 1)
             {
-                shell->write(&buffer[index], 1);
+                shellWriteByte(shell, buffer[index]);
+                shellFlush(shell);
                 index++;
             }
         } while (buffer[index -1] != '\r' && buffer[index -1] != '\n' && index < SHELL_SCAN_BUFFER);
@@ -1013,6 +1097,88 @@ static void shellRemoveParamQuotes(Shell *shell)
 }
 
 
+#if SHELL_USING_CMD_INDEX == 1
+/**
+ * @brief shell 
+ *        , ڰƥ
+ * 
+ * @param shell shell
+ */
+static void shellBuildIndex(Shell *shell)
+{
+    ShellCommand *base = (ShellCommand *)shell->commandList.base;
+    unsigned short count = shell->commandList.count;
+
+    if (shellCmdIndex.base == base || count > SHELL_CMD_INDEX_MAX)
+    {
+        return;
+    }
+
+    shellCmdIndex.nameCount = 0;
+    for (unsigned short i = 0; i < 256; i++)
+    {
+        shellCmdIndex.keyHead[i] = SHELL_CMD_INDEX_NONE;
+    }
+    /* ͷ, ˳ */
+    for (unsigned short i = count; i > 0; i--)
+    {
+        if (base[i - 1].attr.attrs.type == SHELL_TYPE_KEY)
+        {
+            unsigned char first = (base[i - 1].data.key.value >> 24) & 0xFF;
+            shellCmdIndex.keyNext[i - 1] = shellCmdIndex.keyHead[first];
+            shellCmdIndex.keyHead[first] = i - 1;
+        }
+    }
+    /* , ͬ˳; ֻڳʼʱִһ */
+    for (unsigned short i = 0; i < count; i++)
+    {
+        if (base[i].attr.attrs.type == SHELL_TYPE_KEY)
+        {
+            continue;
+        }
+        const char *name = shellGetCommandName(&base[i]);
+        unsigned short pos = shellCmdIndex.nameCount++;
+        while (pos > 0
+               && strcmp(shellGetCommandName(&base[shellCmdIndex.name[pos - 1]]), name) > 0)
+        {
+            shellCmdIndex.name[pos] = shellCmdIndex.name[pos - 1];
+            pos--;
+        }
+        shellCmdIndex.name[pos] = i;
+    }
+    shellCmdIndex.base = base;
+}
+
+
+/**
+ * @brief shell в
+ * 
+ * @param cmd ǰ׺
+ * @return unsigned short һСcmdеλ
+ */
+static unsigned short shellSeekIndex(const char *cmd)
+{
+    ShellCommand *base = (ShellCommand *)shellCmdIndex.base;
+    unsigned short low = 0;
+    unsigned short high = shellCmdIndex.nameCount;
+
+    while (low < high)
+    {
+        unsigned short mid = (low + high) / 2;
+        if (strcmp(shellGetCommandName(&base[shellCmdIndex.name[mid]]), cmd) < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+#endif /** SHELL_USING_CMD_INDEX == 1 */
+
+
 /**
  * @brief shellƥ
  * 
@@ -1028,6 +1194,26 @@ ShellCommand* shellSeekCommand(Shell *shell,
                                unsigned short compareLength)
 {
     const char *name;
+#if SHELL_USING_CMD_INDEX == 1
+    if (!compareLength && base == shellCmdIndex.base)
+    {
+        /* ͬұ˳, صһȨ޵ */
+        for (unsigned short pos = shellSeekIndex(cmd);
+             pos < shellCmdIndex.nameCount; pos++)
+        {
+            ShellCommand *command = &base[shellCmdIndex.name[pos]];
+            if (strcmp(cmd, shellGetCommandName(command)) != 0)
+            {
+                break;
+            }
+            if (shellCheckPermission(shell, command) == 0)
+            {
+                return command;
+            }
+        }
+        return NULL;
+    }
+#endif
     unsigned short count = shell->commandList.count -
         ((size_t)base - (size_t)shell->commandList.base) / sizeof(ShellCommand);
     for (unsigned short i = 0; i < count; i++)
@@ -1241,6 +1427,8 @@ setVar, shellSetVar, set var);
 unsigned int shellRunCommand(Shell *shell, ShellCommand *command)
 {
     int returnValue = 0;
+    /* ƹshellֱ, дԱ֤˳ */
+    shellFlush(shell);
     shell->status.isActive = 1;
     if (command->attr.attrs.type == SHELL_TYPE_CMD_MAIN)
     {
@@ -1577,6 +1765,7 @@ void shellTab(Shell *shell)
     {
         shell->parser.buffer[shell->parser.length] = 0;
         ShellCommand *base = (ShellCommand *)shell->commandList.base;
+        /* : Ҳ벹ȫ, ѡ˳г */
         for (short i = 0; i < shell->commandList.count; i++)
         {
             if (shellCheckPermission(shell, &base[i]) == 0
@@ -1759,15 +1948,55 @@ SHELL_CMD_PERMISSION(0)|SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN)|SHELL_CMD_DISABLE_RE
 help, shellHelp, show command info\r\nhelp [cmd]);
 
 /**
- * @brief shell 봦
+ * @brief shell ƥ
+ * 
+ * @param shell shell
+ * @param key 
+ * @param data , ƥ
+ * @param keyByteOffset ǰֽڰֵеƫ
+ * @param keyFilter Ѽ¼ֵ
+ * @return int 1 ִ, ƥ
+ */
+static int shellMatchKey(Shell *shell, ShellCommand *key,
+                         char *data, char keyByteOffset, int keyFilter)
+{
+    /* ֤Ȩ */
+    if (shellCheckPermission(shell, key) != 0)
+    {
+        return 0;
+    }
+    /* ֵֽͬƥ */
+    if ((key->data.key.value & keyFilter) == shell->parser.keyValue
+        && (key->data.key.value & (0xFF << keyByteOffset))
+            == (*data << keyByteOffset))
+    {
+        shell->parser.keyValue |= *data << keyByteOffset;
+        *data = 0x00;
+        if (keyByteOffset == 0 
+            || (key->data.key.value & (0xFF << (keyByteOffset - 8)))
+                == 0x00000000)
+        {
+            if (key->data.key.function)
+            {
+                key->data.key.function(shell);
+            }
+            shell->parser.keyValue = 0x00000000;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * @brief shell ֽ
  * 
  * @param shell shell
  * @param data 
  */
-void shellHandler(Shell *shell, char data)
+static void shellHandlerByte(Shell *shell, char data)
 {
     SHELL_ASSERT(data, return);
-    SHELL_LOCK(shell);
 
 #if SHELL_LOCK_TIMEOUT > 0
     if (shell->info.user->data.user.password
@@ -1802,31 +2031,31 @@ void shellHandler(Shell *shell, char data)
 
     /* ShellCommandбԽаֵƥ */
     ShellCommand *base = (ShellCommand *)shell->commandList.base;
+#if SHELL_USING_CMD_INDEX == 1
+    if (base == shellCmdIndex.base)
+    {
+        /* ֻֽͬİ */
+        unsigned char first = (keyByteOffset == 24)
+                            ? (unsigned char)data
+                            : (shell->parser.keyValue >> 24) & 0xFF;
+        for (unsigned short i = shellCmdIndex.keyHead[first];
+             i != SHELL_CMD_INDEX_NONE; i = shellCmdIndex.keyNext[i])
+        {
+            if (shellMatchKey(shell, &base[i], &data, keyByteOffset, keyFilter))
+            {
+                break;
+            }
+        }
+    }
+    else
+#endif
     for (short i = 0; i < shell->commandList.count; i++)
     {
-        /* жǷǰ岢֤Ȩ */
+        /* жǷǰ */
         if (base[i].attr.attrs.type == SHELL_TYPE_KEY
-            && shellCheckPermission(shell, &(base[i])) == 0)
+            && shellMatchKey(shell, &base[i], &data, keyByteOffset, keyFilter))
         {
-            /* ֵֽͬƥ */
-            if ((base[i].data.key.value & keyFilter) == shell->parser.keyValue
-                && (base[i].data.key.value & (0xFF << keyByteOffset))
-                    == (data << keyByteOffset))
-            {
-                shell->parser.keyValue |= data << keyByteOffset;
-                data = 0x00;
-                if (keyByteOffset == 0 
-                    || (base[i].data.key.value & (0xFF << (keyByteOffset - 8)))
-                        == 0x00000000)
-                {
-                    if (base[i].data.key.function)
-                    {
-                        base[i].data.key.function(shell);
-                    }
-                    shell->parser.keyValue = 0x00000000;
-                    break;
-                }
-            }
+            break;
         }
     }
 
@@ -1840,19 +2069,58 @@ void shellHandler(Shell *shell, char data)
     {
         shell->info.activeTime = SHELL_GET_TICK();
     }
+}
+
+
+/**
+ * @brief shell 봦
+ *        봦ɺдԵ, ճʱֻд
+ * 
+ * @param shell shell
+ * @param data 
+ * @param len ݳ
+ */
+void shellHandlerBatch(Shell *shell, char *data, unsigned short len)
+{
+    SHELL_LOCK(shell);
+    char batch = shell->status.isBatch;
+    shell->status.isBatch = 1;
+    for (unsigned short i = 0; i < len; i++)
+    {
+        shellHandlerByte(shell, data[i]);
+    }
+    shell->status.isBatch = batch;
+    if (!batch)
+    {
+        shellFlush(shell);
+    }
     SHELL_UNLOCK(shell);
 }
 
 
+/**
+ * @brief shell 봦
+ * 
+ * @param shell shell
+ * @param data 
+ */
+void shellHandler(Shell *shell, char data)
+{
+    shellHandlerBatch(shell, &data, 1);
+}
+
+
 #if SHELL_SUPPORT_END_LINE == 1
 void shellWriteEndLine(Shell *shell, char *buffer, int len)
 {
     SHELL_LOCK(shell);
+    char batch = shell->status.isBatch;
+    shell->status.isBatch = 1;
     if (!shell->status.isActive)
     {
         shellWriteString(shell, shellText[SHELL_TEXT_CLEAR_LINE]);
     }
-    shell->write(buffer, len);
+    shellOutput(shell, buffer, len);
 
     if (!shell->status.isActive)
     {
@@ -1866,6 +2134,11 @@ void shellWriteEndLine(Shell *shell, char *buffer, int len)
             }
         }
     }
+    shell->status.isBatch = batch;
+    if (!batch)
+    {
+        shellFlush(shell);
+    }
     SHELL_UNLOCK(shell);
 }
 #endif /** SHELL_SUPPORT_END_LINE == 1 */
@@ -1880,14 +2153,15 @@ void shellWriteEndLine(Shell *shell, char *buffer, int len)
 void shellTask(void *param)
 {
     Shell *shell = (Shell *)param;
-    char data;
+    char data[SHELL_READ_BUFFER];
+    signed short len;
 #if SHELL_TASK_WHILE == 1
     while(1)
     {
 #endif
-        if (shell->read && shell->read(&data, 1) == 1)
+        if (shell->read && (len = shell->read(data, SHELL_READ_BUFFER)) > 0)
         {
-            shellHandler(shell, data);
+            shellHandlerBatch(shell, data, len);
         }
 #if SHELL_TASK_WHILE == 1
         //vTaskDelay(5);
@@ -1997,6 +2271,10 @@ int shellRun(Shell *shell, const char *cmd)
         shell->parser.length = shellStringCopy(shell->parser.buffer, (char *)cmd);
         shellExec(shell);
         shell->status.isActive = active;
+        if (!shell->status.isBatch)
+        {
+            shellFlush(shell);
+        }
         return 0;
     }
 }
@@ -440,7 +440,15 @@ typedef struct shell_def
         unsigned char isChecked : 1;                            /**< Уͨ */
         unsigned char isActive : 1;                             /**< ǰShell */
         unsigned char tabFlag : 1;                              /**< tab־ */
+        unsigned char isBatch : 1;                              /**< , ݴ */
     } status;
+#if SHELL_WRITE_BUFFER > 0
+    struct
+    {
+        char buffer[SHELL_WRITE_BUFFER];                        /**< ݴ滺 */
+        unsigned short length;                                  /**< ݴݳ */
+    } output;
+#endif
     signed short (*read)(char *, unsigned short);               /**< shell */
     signed short (*write)(char *, unsigned short);              /**< shellд */
 #if SHELL_USING_LOCK == 1
@@ -532,6 +540,12 @@ void shellPrint(Shell *shell, const char *fmt, ...);
 void shellScan(Shell *shell, char *fmt, ...);
 Shell* shellGetCurrent(void);
 void shellHandler(Shell *shell, char data);
+void shellHandlerBatch(Shell *shell, char *data, unsigned short len);
+#if SHELL_WRITE_BUFFER > 0
+void shellFlush(Shell *shell);
+#else
+#define shellFlush(shell)
+#endif
 void shellWriteEndLine(Shell *shell, char *buffer, int len);
 void shellTask(void *param);
 int shellRun(Shell *shell, const char *cmd);
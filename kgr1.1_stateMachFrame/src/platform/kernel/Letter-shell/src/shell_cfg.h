@@ -165,6 +165,23 @@
 #define     SHELL_PRINT_BUFFER          128
 #endif /** SHELL_PRINT_BUFFER */
 
+#ifndef SHELL_READ_BUFFER
+/**
+ * @brief shellTaskζȡֽ
+ *        shellһηصǰɶȫ(ֵ)shellHandler
+ */
+#define     SHELL_READ_BUFFER           32
+#endif /** SHELL_READ_BUFFER */
+
+#ifndef SHELL_WRITE_BUFFER
+/**
+ * @brief shellݴ滺С
+ *        ʱԺбݴ棬һһд
+ *        Ϊ0ʱÿֱӵshellд
+ */
+#define     SHELL_WRITE_BUFFER          256
+#endif /** SHELL_WRITE_BUFFER */
+
 #ifndef SHELL_SCAN_BUFFER
 /**
  * @brief shellʽĻС
@@ -264,4 +281,22 @@
 #define     SHELL_SUPPORT_ARRAY_PARAM   0
 #endif /** SHELL_SUPPORT_ARRAY_PARAM */
 
+#ifndef SHELL_USING_CMD_INDEX
+/**
+ * @brief ʹ
+ *        ʹܺshellInitʱ򡢰ֽڽ
+ *        ҺͰƥ䲻ٱ
+ */
+#define     SHELL_USING_CMD_INDEX       1
+#endif /** SHELL_USING_CMD_INDEX */
+
+#ifndef SHELL_CMD_INDEX_MAX
+/**
+ * @brief 
+ *        (û)ֵʱ˻
+ *        ռ (256 + 2 * SHELL_CMD_INDEX_MAX) * 2 ֽ
+ */
+#define     SHELL_CMD_INDEX_MAX         256
+#endif /** SHELL_CMD_INDEX_MAX */
+
 #endif
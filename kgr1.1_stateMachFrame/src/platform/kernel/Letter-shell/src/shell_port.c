@@ -14,32 +14,26 @@ Shell shell;
 
 static short sshellRead(char * buf, unsigned short len )
 {
-	char ret = 1;
+	unsigned short count = 0;
 	char ch;
 	//ret = gDbgUart.pfRecvByte(&ch);
-	//ע⣬ֻʵֵֽڷ
 	// ret = dequeue(&ch);
-	ret = PLUART_RX_BYTE_GET(PLUART_INDEX_0_PC,ch);
-	if(ret == TRUE)
+	//һȡǰѽյȫݣshellTask
+	while(count < len && PLUART_RX_BYTE_GET(PLUART_INDEX_0_PC,ch) == TRUE)
 	{
-		*buf=ch;
-		return 1;
+		buf[count++]=ch;
 	}
-	return 0;
+	return count;
 }
 
 static short sshellWrite(char * buf, unsigned short len )
 {
-    uint16_t send  = 0;
-    while (send < len)
-    {
-    	XUartLite_SendByte(XPAR_FPGA_DEBUG_UART1_BASEADDR, buf[send++]);
+    //Դڷͻλ, ڷ͵ AD ֡м
+    UartConsoleWrite((const u8 *)buf, len);
         // FUartPs_write(&g_UART, buf[send++]);
         //         while((FUartPs_getLineStatus(&g_UART) & Uart_line_thre) != Uart_line_thre);
         // gUartShell.pfSendByte(buf[send++]);   
 
-    }
-
     return len;
 }
 
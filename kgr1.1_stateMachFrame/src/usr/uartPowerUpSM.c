@@ -22,7 +22,7 @@ static T_STATEMACHFuncUnit state1_unit[eState_Max] = {
 };
 
 static T_STATEMACHCtrl gStatePowerUp = {{eState_Head1, &sprotocolData}, state1_unit};
-void dx_kprintf(const char *fmt, ...);
+#include "zs_dlog.h"
 static int StateHandle(void *p,unsigned char ch) {
     T_STATEMACHCtrl *pStateCtrl = (T_STATEMACHCtrl *)p;
     T_Uart4sm_data *pData = (T_Uart4sm_data *)pStateCtrl->attr.usrData;
@@ -99,7 +99,7 @@ static int StateHandle(void *p,unsigned char ch) {
     switch (pStateCtrl->attr.state)
     {
         case eState_Head1:
-            dx_kprintf("ch 0x%x state %d\r\n",ch,pStateCtrl->attr.state);
+            DLOG("ch 0x%x state %d\r\n",ch,pStateCtrl->attr.state);
             if (ch == 0xA5) {
                 pStateCtrl->attr.state = eState_Head2;
             }
@@ -134,7 +134,7 @@ static int StateHandle(void *p,unsigned char ch) {
             if(tmpflag == 0)
             {
                 tmpflag = 1;
-                dx_kprintf("Alreay Receive Update Cmd !\r\n",ch);
+                DLOG("Alreay Receive Update Cmd !\r\n");
             }
             break;
 #if 0
@@ -7,10 +7,8 @@
 T_SMCtrl gCtrl;
 
 
-static int s_intEvent[8] = {0};
-CircularBuffer_Int geventBuf;
 
-void dx_kprintf(const char *fmt, ...);
+#include "zs_dlog.h"
 void Lv1Action_PowerUpIdle(void * p);
 void Lv1Action_UpdateBD21(void * p) ;
 void Lv1Action_NormalWork(void * p) ;
@@ -41,8 +39,8 @@ void StateMachInit(void)
     gCtrl.lv1sm.pstateTab = g_Lv1TransitionTable;
     gCtrl.lv1sm.state = LV1_STATE_IDLE;
 
-    memset((char*)&geventBuf, 0, sizeof(geventBuf));
-    initializeBufferInt(&geventBuf, s_intEvent, sizeof(s_intEvent)/sizeof(s_intEvent[0]));
+    ev_init();
+    ev_timer_init(&gCtrl.lv1sm_usr_data.tPowerUp, EVENT_CMD_POWERUP_TIMEOUT);
 
 
 }
@@ -70,17 +68,19 @@ void Lv1ProcessEvent(T_STATEMACHCtrl_LV1* psm, int event) {
 }
 
 //* return : 1 suceess, 0 fail
+//* жҲɵ
 int Event_Put(int data)
 {
-    return writeBufferIntNoMutex(&geventBuf, data);
+    return ev_post(data);
 }
 
 int Event_Get(int *pdata)
 {
-    return readBufferIntNoMutex(&geventBuf, pdata);
+    return ev_fetch(pdata);
 }
 extern Shell shell;
 void Lv1Action_PowerUpIdle(void * p) { 
+    Lv1Context_t * pContext = (Lv1Context_t *)p;
     //* PowerUp Wait Message
     unsigned char ret = 1;
 	unsigned char ch;
@@ -92,14 +92,14 @@ void Lv1Action_PowerUpIdle(void * p) {
     {
         if(PowerUpStrCheck(ch))
         {
+            ev_timer_stop(&gCtrl.lv1sm_usr_data.tPowerUp);
             Event_Put(EVENT_CMD_UPDATEBD21);
         }
     }
-    //* timeout send normal work event
-    if( tick_diff(gCtrl.lv1sm_usr_data.u32PowerUptick) >500 )
+    //* timeout event is posted by tPowerUp (started in PreLaterInit)
+    if( pContext->event == EVENT_CMD_POWERUP_TIMEOUT )
     {
-        Event_Put(EVENT_CMD_POWERUP_TIMEOUT);
-        dx_kprintf("Send Timeout Event\n"); 
+        DLOG("Send Timeout Event\n"); 
     }
 }
 void uartDelayRemap(u8 val,u32 delay_ms);
@@ -110,7 +110,7 @@ void Lv1Action_UpdateBD21(void * p) {
     if(tmpflagBD21 == 0)
     {
         tmpflagBD21 = 1;
-        dx_kprintf("Lv1Action_UpdateBD21 !\n");
+        DLOG("Lv1Action_UpdateBD21 !\n");
         tick_delay_ms(100);
         uartDelayRemap(2,100);
 
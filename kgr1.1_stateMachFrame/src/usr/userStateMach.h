@@ -11,6 +11,7 @@ extern "C" {
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include "../platform/components/evloop/evloop.h"
 
 // ģ״̬
 typedef enum {
@@ -106,7 +107,7 @@ typedef struct {
 typedef struct {
     T_STATEMACHCtrl_LV1 lv1sm;
     struct {
-        uint32_t u32PowerUptick;
+        ev_timer_t tPowerUp;        //* ϵȴʱ
     } lv1sm_usr_data;
 } T_SMCtrl;
 
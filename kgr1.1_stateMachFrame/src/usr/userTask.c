@@ -9,9 +9,12 @@
 
 #include "uart_service.h"
 #include "zs_printf.h"
+#include "zs_dlog.h"
 #include "KgrInfo.h"
 #include "userTask.h"
 #include "userStateMach.h"
+#include "com_protcl_mdl.h"
+#include "jam_detect.h"
 
 
 int _putchar_shell(char a);
@@ -20,6 +23,10 @@ int _isr_putchar_bd21_1(char a);
 int _isr_putchar_bd21_2(char a);
 int _isr_putchar_pc(char a);
 int _isr_putchar_ublox(char a);
+int _isr_putburst_bd21_1(char *data, int len);
+int _isr_putburst_bd21_2(char *data, int len);
+int _isr_putburst_pc(char *data, int len);
+int _isr_putburst_ublox(char *data, int len);
 
 int _putchar(void* p,char a);
 int _getchar(void* p,char *a);
@@ -62,9 +69,21 @@ unsigned char DCShowSet_flag = 0;
 int DBS_set = 0;
 unsigned int gDebugJsr_msTime = 0;
 
+#define JAM_DETECT_PERIOD_MS      (5)         //ż⹦ʲ ms
+#define JAM_DETECT_POWER_REG      (12)        //ͨʼĴ 12~19
+#define JAM_DETECT_CTRL_REG       (0x83)
+#define JAM_DETECT_CTRL_ONSET     (0x8600)    //⵽ (4 Ԫ)
+#define JAM_DETECT_CTRL_CLEAR     (0x470000)  //ʧ
+
+jam_detect_t gJamDetect;
+unsigned int gJamTraceMs = 0;                 // 0 ʱ $JAMPW ʼ¼,  tools/jam_replay ط
+static ev_timer_t s_jamDetectTimer;
+static uint32_t s_jamTraceTick = 0;
+
 #if 1
 //*******************************/
 extern int (* gpfUartPutByte[7] )(char ch); 
+extern int (* gpfUartPutBurst[7] )(char *data, int len);
 T_UartCtrl gUartPL[7];
 
 static char uartbuf[512] = {0};
@@ -90,7 +109,8 @@ extern T_SMCtrl gCtrl;
 extern void StateMachInit(void);
 void PreInit(void)
 {
-
+    // ʱԵǰ tick , κ ev_timer_start ֮ǰ;  base Ϊ 0 ʱ״ƽǰĶʱǰһ tick
+    tw_init(&gTimerWheel, tick_get());
 
     memset((char*)&gUartPL,0,sizeof(gUartPL));
 
@@ -110,6 +130,7 @@ void PreInit(void)
     // gUartPL2.pfRecvByte = _uart_pl2_getchar; //
 
     gpfUartPutByte[PLUART_INDEX_0_PC] = _isr_putchar_pc;
+    gpfUartPutBurst[PLUART_INDEX_0_PC] = _isr_putburst_pc;
 
 	// memset((char*)&gUartPL2,0,sizeof(gUartPL2));
     initializeBuffer(&gUartPL[PLUART_INDEX_1_UBLOX].rx.cirbuf, uartbuf_rx_ublox, sizeof(uartbuf_rx_ublox));
@@ -127,6 +148,7 @@ void PreInit(void)
     // gUartPL2.pfRecvByte = _uart_pl2_getchar; //
 
     gpfUartPutByte[PLUART_INDEX_1_UBLOX] = _isr_putchar_ublox;
+    gpfUartPutBurst[PLUART_INDEX_1_UBLOX] = _isr_putburst_ublox;
 
 	// memset((char*)&gUartPL0,0,sizeof(gUartPL0));
     initializeBuffer(&gUartPL[PLUART_INDEX_2_BD21_1].rx.cirbuf, uartbuf_rx_bd21_1, sizeof(uartbuf_rx_bd21_1));
@@ -144,6 +166,7 @@ void PreInit(void)
     // gUartPL0.pfRecvByte = _uart_pl0_getchar; //
 
     gpfUartPutByte[PLUART_INDEX_2_BD21_1] = _isr_putchar_bd21_1;
+    gpfUartPutBurst[PLUART_INDEX_2_BD21_1] = _isr_putburst_bd21_1;
 
     //Uart PL2
     // memset((char*)&gUartPL2,0,sizeof(gUartPL2));
@@ -162,6 +185,7 @@ void PreInit(void)
     // gUartPL2.pfRecvByte = _uart_pl2_getchar; //
 
     gpfUartPutByte[PLUART_INDEX_3_BD21_2] = _isr_putchar_bd21_2;
+    gpfUartPutBurst[PLUART_INDEX_3_BD21_2] = _isr_putburst_bd21_2;
 
     //mcu uart
     // memset((char*)&gUartMcu,0,sizeof(gUartMcu));
@@ -185,36 +209,126 @@ void PreInit(void)
 	StateMachInit();
 }
 
+/*
+ * ż: ѭ JAM_DETECT_PERIOD_MS һζȫͨ,
+ *  jam_detect ģо, ״̬仯ʱ FPGA  gJamDetectFlag
+ */
+static void JamDetectInit(void)
+{
+	jam_detect_cfg_t cfg;
+
+	jam_detect_cfg_default(&cfg);
+	jam_detect_init(&gJamDetect, &cfg);
+	ev_timer_init(&s_jamDetectTimer, EVENT_JAM_DETECT);
+	ev_timer_start(&s_jamDetectTimer, JAM_DETECT_PERIOD_MS, JAM_DETECT_PERIOD_MS);
+}
+
+/*
+ * /رոż. ر, ɹرձΪ (ѧϰʻ) ʱ, ³ʼ;
+ * ǰڸ״̬, FPGA  gJamDetectFlag ͬʱָΪʧ, ֤һ
+ */
+void JamDetectEnable(unsigned char en)
+{
+	jam_detect_cfg_t cfg;
+
+	if (en == 0 || gJamDetectEnableFlag == 0)
+	{
+		if (gJamDetect.jammed || gJamDetectFlag)
+		{
+			mcu_to_fpga_write_kgr_reg(JAM_DETECT_CTRL_REG, JAM_DETECT_CTRL_CLEAR);
+			gJamDetectFlag = 0;
+		}
+		/*jam_detect_init ṹ, òֱӴ gJamDetect.cfg */
+		cfg = gJamDetect.cfg;
+		jam_detect_init(&gJamDetect, &cfg);
+	}
+	gJamDetectEnableFlag = en;
+}
+
+static void JamDetectProcess(void)
+{
+	u32 raw[JAM_DET_CH_MAX];
+	int32_t power[JAM_DET_CH_MAX];
+	uint32_t now = tick_get();
+	int i;
+
+	if(gJamDetectEnableFlag == 0)
+	{
+		return;
+	}
+
+	mcu_to_fpga_read_kgr_block(JAM_DETECT_POWER_REG, raw, JAM_DET_CH_MAX);
+	for (i = 0; i < JAM_DET_CH_MAX; i++)
+	{
+		power[i] = (int32_t)((long long)raw[i] * 1024 / fip);
+	}
+
+	switch (jam_detect_update(&gJamDetect, power, now))
+	{
+	case JAM_DET_ONSET:
+		mcu_to_fpga_write_kgr_reg(JAM_DETECT_CTRL_REG, JAM_DETECT_CTRL_ONSET);
+		gJamDetectFlag = 1;
+		dx_kprintf("Module Detect  Jam !!!!!!------------<<<< ch %d\r\n", gJamDetect.alarmCh);
+		break;
+	case JAM_DET_CLEAR:
+		mcu_to_fpga_write_kgr_reg(JAM_DETECT_CTRL_REG, JAM_DETECT_CTRL_CLEAR);
+		gJamDetectFlag = 0;
+		dx_kprintf("Module No Found Jam ------------<<<<\r\n");
+		break;
+	default:
+		break;
+	}
+
+	if (gJamTraceMs != 0 && now - s_jamTraceTick >= gJamTraceMs)
+	{
+		s_jamTraceTick = now;
+		DLOG("$JAMPW,%u,%d,%d,%d,%d,%d,%d,%d,%d\r\n", now,
+				power[0], power[1], power[2], power[3], power[4], power[5], power[6], power[7]);
+	}
+}
+
 void PreLaterInit(void)
 {
-	gCtrl.lv1sm_usr_data.u32PowerUptick = tick_get();
+	ev_timer_start(&gCtrl.lv1sm_usr_data.tPowerUp, 500, 0);
+	JamDetectInit();
 }
 
 
+/*
+ * ѭ: û¼ʹʱ CPU .
+ * ÿλȴ굽ڶʱжͶݵ¼, ٰ EVENT_IDLE ѯһ鴮ڽ.
+ */
 void TaskProcess(void)
 {
-	int ret,event;
+	int event;
+	int pending, remain;
 	while (1)
 	{
-#if 1
-		// 1. ⲿ벢¼
-		ret = Event_Get(&event);
-		// printf("event : %d\n",event);
-		if ( ret ) {
-			//* get valid event
+		ev_wait();
+
+		// 1. жϺͶʱͶݵ¼
+		while (Event_Get(&event)) {
+			if (event == EVENT_JAM_DETECT) {
+				JamDetectProcess();
+				continue;
+			}
 			Lv1ProcessEvent(&gCtrl.lv1sm, event);
 		}
-		else
-		{
-			//*periodly handle handle
-			event = EVENT_IDLE;
-			Lv1ProcessEvent(&gCtrl.lv1sm, event);
+
+		// 2. ѯǰ״̬
+		pending = getRemainingCountNoMutex(&gUartPL[PLUART_INDEX_0_PC].rx.cirbuf);
+		Lv1ProcessEvent(&gCtrl.lv1sm, EVENT_IDLE);
+		// һѯֻһ, нչδȡʱһּ; ǰ״̬ (͸) ʱת
+		remain = getRemainingCountNoMutex(&gUartPL[PLUART_INDEX_0_PC].rx.cirbuf);
+		if (remain > 0 && remain < pending) {
+			ev_wake(EV_WAKE_UART);
 		}
 
+		// 3. ADݷ: жϷһ֡ỽѭ
+		com_data_ad_poll();
+#ifdef DLOG_ENABLE
+		dlog_flush_console();
 #endif
-
-		// Lv1ProcessEvent( &gCtrl.lv1sm, 0);
-		// shellTask((void *)&shell);
 	}
 }
 
@@ -226,27 +340,66 @@ int _putchar_shell(char a)
 
 int _isr_putchar_fpga(char a)
 {
-    return writeBufferNoMutex(&gUartPL[PLUART_INDEX_4_FPGA].rx.cirbuf, a);
+    int ret = writeBufferNoMutex(&gUartPL[PLUART_INDEX_4_FPGA].rx.cirbuf, a);
+    ev_wake(EV_WAKE_UART);
+    return ret;
 }
 
 int _isr_putchar_bd21_1(char a)
 {
-    return writeBufferNoMutex(&gUartPL[PLUART_INDEX_2_BD21_1].rx.cirbuf, a);
+    int ret = writeBufferNoMutex(&gUartPL[PLUART_INDEX_2_BD21_1].rx.cirbuf, a);
+    ev_wake(EV_WAKE_UART);
+    return ret;
 }
 
 int _isr_putchar_bd21_2(char a)
 {
-    return writeBufferNoMutex(&gUartPL[PLUART_INDEX_3_BD21_2].rx.cirbuf, a);
+    int ret = writeBufferNoMutex(&gUartPL[PLUART_INDEX_3_BD21_2].rx.cirbuf, a);
+    ev_wake(EV_WAKE_UART);
+    return ret;
 }
 
 int _isr_putchar_pc(char a)
 {
-    return writeBufferNoMutex(&gUartPL[PLUART_INDEX_0_PC].rx.cirbuf, a);
+    int ret = writeBufferNoMutex(&gUartPL[PLUART_INDEX_0_PC].rx.cirbuf, a);
+    ev_wake(EV_WAKE_UART);
+    return ret;
 }
 
 int _isr_putchar_ublox(char a)
 {
-    return writeBufferNoMutex(&gUartPL[PLUART_INDEX_1_UBLOX].rx.cirbuf, a);
+    int ret = writeBufferNoMutex(&gUartPL[PLUART_INDEX_1_UBLOX].rx.cirbuf, a);
+    ev_wake(EV_WAKE_UART);
+    return ret;
+}
+
+//жһȡFIFOд, нջصѭ, е
+int _isr_putburst_bd21_1(char *data, int len)
+{
+    int ret = writeBufferMultipleNoMutex(&gUartPL[PLUART_INDEX_2_BD21_1].rx.cirbuf, data, len);
+    ev_wake(EV_WAKE_UART);
+    return ret;
+}
+
+int _isr_putburst_bd21_2(char *data, int len)
+{
+    int ret = writeBufferMultipleNoMutex(&gUartPL[PLUART_INDEX_3_BD21_2].rx.cirbuf, data, len);
+    ev_wake(EV_WAKE_UART);
+    return ret;
+}
+
+int _isr_putburst_pc(char *data, int len)
+{
+    int ret = writeBufferMultipleNoMutex(&gUartPL[PLUART_INDEX_0_PC].rx.cirbuf, data, len);
+    ev_wake(EV_WAKE_UART);
+    return ret;
+}
+
+int _isr_putburst_ublox(char *data, int len)
+{
+    int ret = writeBufferMultipleNoMutex(&gUartPL[PLUART_INDEX_1_UBLOX].rx.cirbuf, data, len);
+    ev_wake(EV_WAKE_UART);
+    return ret;
 }
 
 
@@ -524,83 +677,4 @@ void AttConfigTask(void *argument)
 	    }
 }
 
-void JamDetectTask(void *argument)
-{
-
-	unsigned int tmpJsrdebuCnt = 0;
-	unsigned int tmpbefpow = 0;
-	unsigned int tmpaftpow = 0;
-	float tmpjsr = 0;
-	int valbuffer[9] = {0};
-	int maxValtemp = 0;
-	int detectJamflag = 0;
-	int detectNoJamCnt = 0;
-
-	while (1)
-	{
-		vTaskDelay(1);
-		{
-				//ͨԴڴӡjsrֵ
-				if (gDebugJSR_flag >= 1)
-				{
-					if(tmpJsrdebuCnt > gDebugJsr_msTime)
-					{
-						tmpjsr = stap_sjr_get(&tmpbefpow,&tmpaftpow);
-						dx_kprintf("current sjr [%f]--bef = %d aft = %d  max PowVal [%d]\r\n",tmpjsr,tmpbefpow,tmpaftpow,maxValtemp);
-						tmpJsrdebuCnt = 0;
-						
-					}
-					tmpJsrdebuCnt++;
-					
-				}
-#if 1
-				if(gJamDetectEnableFlag >= 1)
-				{
-					
-					if(gJamDetectEnableFlag >= 2)
-					{
-						read_power(valbuffer,NULL);
-			    		maxValtemp=(int)find_max_value(valbuffer);
-						maxValtemp = maxValtemp/10;						
-					}
-
-					if(maxValtemp > DETCET_JAM_POWER_THRESHOLD)
-					{
-						if(detectJamflag == 0)
-						{
-							dx_kprintf("Module Detect  Jam !!!!!!------------<<<<\r\n",tmpjsr,tmpbefpow,tmpaftpow,maxValtemp);
-							if(KGR_5 == 1)
-							{
-								mcu_to_fpga_write_kgr_reg(0x83,0xef00);
-							}
-							else
-							{
-								mcu_to_fpga_write_kgr_reg(0x83,0x8600);
-							}
-						}
-						detectJamflag = 1;
-						detectNoJamCnt = 0;
-					}
-					else
-					{
-						if(detectJamflag == 1)
-						{
-							if(detectNoJamCnt > 1000)
-							{
-								dx_kprintf("Module No Found Jam ------------<<<<\r\n",tmpjsr,tmpbefpow,tmpaftpow,maxValtemp);
-								detectJamflag = 0;
-								mcu_to_fpga_write_kgr_reg(0x83,0x470000);
-							}
-
-							detectNoJamCnt++;
-						}
-						
-						
-					}					
-				}
-#endif
-		}
-	}
-}
-
 #endif
@@ -54,6 +54,7 @@ typedef enum {
     EVENT_CMD_SWITCH_SHELL,   //* Power Up and Timeout ,Enter Normal Work
     EVENT_IDLE,
     EVENT_TICK,
+    EVENT_JAM_DETECT,         //* żڵ, ѭֱӴ
     EVENT_MAX,
 } EventType_t;
 
@@ -182,6 +183,7 @@ extern T_UartCtrl gUartPL[7];
 
 
 extern void PreInit(void);
+void JamDetectEnable(unsigned char en);
 
 uint32_t tick_diff(uint32_t old);
 uint32_t tick_get(void);
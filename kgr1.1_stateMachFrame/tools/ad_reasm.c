@@ -0,0 +1,310 @@
+// 主机工具: 从调试串口抓包中重组 loadRamData 发出的 AD 二进制帧 (格式见 src/inc/com_protcl_mdl.h)
+// 按同步字 "JMAD" 搜索帧, 帧头检查和 CRC-32 不通过时后移一个字节重新搜索,
+// 帧之间混入的控制台文本 ($JAMRG/$JAMTE/提示符) 自动跳过.
+// 用法: ad_reasm <串口抓包文件> [-c 采集序号] [-o 输出.bin] [-t]
+//       -c  选择采集序号, 默认为抓包中最后一次采集
+//       -o  按包号顺序写出原始采样数据, 缺失的包以 0 填充
+//       -t  每 16 字节一行打印 8 个 int16 采样 (与固件旧的调试输出一致)
+// 编译: gcc -std=c99 -O2 -o ad_reasm ad_reasm.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define AD_FRAME_VERSION    1
+#define AD_FRAME_HDR_LEN    24
+#define AD_FRAME_CRC_LEN    4
+#define AD_PAYLOAD_MAX      4096
+#define AD_FRAME_MAX        (AD_FRAME_HDR_LEN + AD_PAYLOAD_MAX + AD_FRAME_CRC_LEN)
+#define MAX_CAPTURES        64
+#define READ_CHUNK          65536
+
+typedef struct {
+    uint32_t id;
+    uint32_t sam_ctrl;
+    uint16_t total;
+    uint16_t payload_len;
+    uint32_t received;
+    uint32_t dup;
+    uint8_t *have;              // 每包是否已收到
+    uint8_t *data;              // total * payload_len
+} capture_t;
+
+typedef struct {
+    capture_t cap[MAX_CAPTURES];
+    int count;
+    uint64_t frames;
+    uint64_t crc_err;
+    uint64_t skipped;           // 帧外字节 (文本或损坏数据)
+} reasm_t;
+
+static uint32_t crc_table[256];
+
+static void crc_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? (c >> 1) ^ 0xEDB88320u : c >> 1;
+        }
+        crc_table[i] = c;
+    }
+}
+
+static uint32_t crc32(const uint8_t *p, size_t len) {
+    uint32_t c = 0xFFFFFFFFu;
+    while (len--) {
+        c = crc_table[(c ^ *p++) & 0xFF] ^ (c >> 8);
+    }
+    return ~c;
+}
+
+static uint16_t get16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static capture_t *capture_get(reasm_t *r, uint32_t id, uint16_t total, uint16_t payload_len, uint32_t sam_ctrl) {
+    capture_t *c;
+
+    for (int i = r->count - 1; i >= 0; i--) {
+        c = &r->cap[i];
+        if (c->id == id && c->total == total && c->payload_len == payload_len) {
+            return c;
+        }
+    }
+    if (r->count == MAX_CAPTURES) {
+        // 丢弃最早的一次采集
+        free(r->cap[0].have);
+        free(r->cap[0].data);
+        memmove(&r->cap[0], &r->cap[1], sizeof(r->cap[0]) * (MAX_CAPTURES - 1));
+        r->count--;
+    }
+    c = &r->cap[r->count];
+    memset(c, 0, sizeof(*c));
+    c->id = id;
+    c->total = total;
+    c->payload_len = payload_len;
+    c->sam_ctrl = sam_ctrl;
+    c->have = (uint8_t *)calloc(total ? total : 1, 1);
+    c->data = (uint8_t *)calloc((size_t)total * payload_len + 1, 1);
+    if (c->have == NULL || c->data == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    r->count++;
+    return c;
+}
+
+// 尝试在 p 处解析一帧; 返回帧长度, 不是有效帧返回 0, 数据不够返回 -1
+static long frame_parse(reasm_t *r, const uint8_t *p, size_t avail) {
+    uint16_t payload_len, pkg, total;
+    size_t len;
+    capture_t *c;
+
+    if (avail < AD_FRAME_HDR_LEN) {
+        return -1;
+    }
+    payload_len = get16(p + 6);
+    pkg = get16(p + 12);
+    total = get16(p + 14);
+    if (p[4] != AD_FRAME_VERSION || p[5] != AD_FRAME_HDR_LEN || payload_len == 0 ||
+        payload_len > AD_PAYLOAD_MAX || total == 0 || pkg >= total) {
+        return 0;
+    }
+    len = AD_FRAME_HDR_LEN + payload_len + AD_FRAME_CRC_LEN;
+    if (avail < len) {
+        return -1;
+    }
+    if (crc32(p, len - AD_FRAME_CRC_LEN) != get32(p + len - AD_FRAME_CRC_LEN)) {
+        r->crc_err++;
+        return 0;
+    }
+
+    c = capture_get(r, get32(p + 8), total, payload_len, get32(p + 16));
+    if (c->have[pkg]) {
+        c->dup++;
+    } else {
+        c->have[pkg] = 1;
+        c->received++;
+    }
+    memcpy(c->data + (size_t)pkg * payload_len, p + AD_FRAME_HDR_LEN, payload_len);
+    r->frames++;
+    return (long)len;
+}
+
+// 处理缓冲区, 返回已消费的字节数; 末尾不完整的帧留到下次
+static size_t reasm_feed(reasm_t *r, const uint8_t *buf, size_t len, int eof) {
+    size_t pos = 0;
+
+    while (pos + 4 <= len) {
+        const uint8_t *hit = memchr(buf + pos, 'J', len - pos - 3);
+        long n;
+
+        if (hit == NULL) {
+            r->skipped += len - 3 - pos;
+            pos = len - 3;
+            break;
+        }
+        r->skipped += (size_t)(hit - (buf + pos));
+        pos = (size_t)(hit - buf);
+        if (memcmp(hit, "JMAD", 4) != 0) {
+            pos++;
+            r->skipped++;
+            continue;
+        }
+        n = frame_parse(r, hit, len - pos);
+        if (n < 0) {
+            if (!eof) {
+                return pos;
+            }
+            n = 0;
+        }
+        if (n == 0) {
+            pos++;
+            r->skipped++;
+            continue;
+        }
+        pos += (size_t)n;
+    }
+    if (eof) {
+        r->skipped += len - pos;
+        return len;
+    }
+    return pos;
+}
+
+static void print_missing(const capture_t *c) {
+    int first = -1, printed = 0;
+
+    for (int i = 0; i <= c->total; i++) {
+        int miss = i < c->total && !c->have[i];
+        if (miss && first < 0) {
+            first = i;
+        } else if (!miss && first >= 0) {
+            if (printed++ < 16) {
+                if (first == i - 1) {
+                    printf(" %d", first);
+                } else {
+                    printf(" %d-%d", first, i - 1);
+                }
+            }
+            first = -1;
+        }
+    }
+    if (printed > 16) {
+        printf(" ...");
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv) {
+    const char *in_path = NULL, *out_path = NULL;
+    long want_id = -1;
+    int text = 0;
+    reasm_t r;
+    uint8_t *buf;
+    size_t have = 0;
+    FILE *fp;
+    capture_t *sel = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            want_id = strtol(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-t") == 0) {
+            text = 1;
+        } else if (in_path == NULL) {
+            in_path = argv[i];
+        } else {
+            in_path = NULL;
+            break;
+        }
+    }
+    if (in_path == NULL) {
+        fprintf(stderr, "usage: %s <capture> [-c id] [-o out.bin] [-t]\n", argv[0]);
+        return 1;
+    }
+    fp = fopen(in_path, "rb");
+    if (fp == NULL) {
+        perror(in_path);
+        return 1;
+    }
+
+    crc_init();
+    memset(&r, 0, sizeof(r));
+    buf = (uint8_t *)malloc(READ_CHUNK + AD_FRAME_MAX);
+    if (buf == NULL) {
+        fclose(fp);
+        return 1;
+    }
+
+    // 分块读入, 每次保留末尾不完整的帧
+    for (;;) {
+        size_t n = fread(buf + have, 1, READ_CHUNK, fp);
+        size_t used;
+        int eof = n == 0;
+
+        have += n;
+        used = reasm_feed(&r, buf, have, eof);
+        memmove(buf, buf + used, have - used);
+        have -= used;
+        if (eof) {
+            break;
+        }
+    }
+    fclose(fp);
+    free(buf);
+
+    printf("frames %llu, crc errors %llu, skipped bytes %llu\n",
+           (unsigned long long)r.frames, (unsigned long long)r.crc_err, (unsigned long long)r.skipped);
+    for (int i = 0; i < r.count; i++) {
+        capture_t *c = &r.cap[i];
+        printf("capture %u: ctrl 0x%x, %u/%u packets of %u bytes",
+               c->id, c->sam_ctrl, c->received, c->total, c->payload_len);
+        if (c->dup) {
+            printf(", %u duplicate", c->dup);
+        }
+        if (c->received < c->total) {
+            printf(", missing:");
+            print_missing(c);
+        } else {
+            printf("\n");
+        }
+        if (want_id < 0 || (uint32_t)want_id == c->id) {
+            sel = c;
+        }
+    }
+    if (sel == NULL) {
+        fprintf(stderr, "no capture%s found\n", want_id >= 0 ? " with that id" : "");
+        return 1;
+    }
+
+    if (out_path != NULL) {
+        fp = fopen(out_path, "wb");
+        if (fp == NULL) {
+            perror(out_path);
+            return 1;
+        }
+        fwrite(sel->data, sel->payload_len, sel->total, fp);
+        fclose(fp);
+    }
+    if (text) {
+        size_t len = (size_t)sel->total * sel->payload_len;
+        for (size_t off = 0; off + 16 <= len; off += 16) {
+            for (int k = 0; k < 8; k++) {
+                printf(k ? " %d" : "%d", (int16_t)get16(sel->data + off + k * 2));
+            }
+            printf("\n");
+        }
+    }
+
+    for (int i = 0; i < r.count; i++) {
+        free(r.cap[i].have);
+        free(r.cap[i].data);
+    }
+    return sel->received == sel->total ? 0 : 2;
+}
@@ -0,0 +1,307 @@
+// 主机工具: 扫频检查 ADF4351 分频参数计算 (src/platform/bsp/drive/pll/pll_adf4351.c)
+//   1. 35~4400MHz 按步进扫频, 检查参数范围, 统计频率误差, 并与穷举所有 MOD (2~4095) 的最优解比较;
+//   2. 统计每次计算的耗时, 并按同样的步进对旧算法 (二重循环搜索) 抽样对比误差和耗时;
+//   3. 在若干频点间随机跳频, 检查寄存器缓存/差分写入后芯片寄存器与完整计算结果一致,
+//      统计每次跳频写入的寄存器个数和按模拟 SPI 时序估算的总线时间; 越界频率 (含 0) 不命中空缓存项.
+// 用法: adf4351_sweep [-s 步进Hz] [-L 旧算法抽样点数] [-n 跳频次数] [-v]
+// 编译: gcc -std=c99 -O2 -DADF4351_HOST_TEST -I../src/platform/inc -o adf4351_sweep adf4351_sweep.c ../src/platform/bsp/drive/pll/pll_adf4351.c
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pll_adf4351.h"
+
+#define PFD_HZ          20000000ull
+#define F_MIN_HZ        35000000ull
+#define F_MAX_HZ        4400000000ull
+#define MOD_MAX         4095
+#define INT_MIN_89      75          // 8/9 预分频时 INT 下限
+
+// 与驱动中 gpio_spi 总线配置一致: 半周期 500ns, 片选建立/保持 1000ns, 每帧 32 位
+#define SPI_FRAME_NS    (32 * 2 * 500 + 3 * 1000)
+#define SPI_SESSION_NS  (2 * 1000)
+
+static u32 s_chip[6];               // 模拟芯片中的寄存器
+static u32 s_lastWrite[6];
+static unsigned long s_frames;
+
+void adf4351_host_write(const u32 *regs, u32 num)
+{
+    u32 i;
+
+    for (i = 0; i < num; i++) {
+        s_chip[regs[i] & 0x7] = regs[i];
+        s_lastWrite[i] = regs[i];
+    }
+    s_frames += num;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// |实际频率 - 目标| * MOD * 2^div, 精确整数
+static u64 err_scaled(u64 f, u32 in, u32 frac, u32 mod, u32 div)
+{
+    u64 a = ((u64)in * mod + frac) * PFD_HZ;
+    u64 b = (f * mod) << div;
+
+    return a > b ? a - b : b - a;
+}
+
+// 穷举: 对每个 MOD 取最接近的 FRAC, 返回最小误差 (Hz)
+static double brute_err(u64 f, u32 div)
+{
+    u64 vco = f << div;
+    u64 in = vco / PFD_HZ;
+    u64 rem = vco - in * PFD_HZ;
+    double best = 1e30;
+    u32 q;
+
+    for (q = 2; q <= MOD_MAX; q++) {
+        u64 p = (rem * q + PFD_HZ / 2) / PFD_HZ;
+        u64 a = (in * q + p) * PFD_HZ;
+        u64 b = vco * q;
+        double e = (double)(a > b ? a - b : b - a) / ((double)q * (1u << div));
+
+        if (e < best) {
+            best = e;
+        }
+    }
+    return best;
+}
+
+// 旧算法 (改动前的 adf4351_set_freq), 返回实际输出频率 (MHz), *iters 为内层循环次数
+static double legacy_freq(double freq, unsigned long *iters)
+{
+    unsigned RF_Div = 0, RF_Div_sum = 1;
+    unsigned VCO_Freq = (unsigned)freq;
+    unsigned short INT, FRAC = 0, MOD;
+    double N, num = 0;
+
+    *iters = 0;
+    while ((VCO_Freq < 2200) || (VCO_Freq > 4400)) {
+        RF_Div++;
+        if (RF_Div > 6) {
+            return -1;
+        }
+        VCO_Freq *= 2;
+        RF_Div_sum *= 2;
+    }
+    N = freq / (10.0 / RF_Div_sum);
+    INT = (unsigned short)N;
+    N = N - INT;
+    for (MOD = 2; MOD < 4096; MOD++) {
+        for (FRAC = 0; FRAC < MOD; FRAC++) {
+            (*iters)++;
+            num = FRAC * 1.0 / MOD;
+            if ((num - N) > -0.0001 && (num - N) < 0.0000000001) break;
+        }
+        if ((num - N) > -0.0001 && (num - N) < 0.0000000001) break;
+    }
+    if (MOD == 4096) {
+        return -1;
+    }
+    // 写入芯片的是 INT/2, FRAC/2, 鉴相 20MHz
+    return ((INT / 2) + (double)(FRAC / 2) / MOD) * 20.0 / RF_Div_sum;
+}
+
+static u32 rnd(u32 *s)
+{
+    *s ^= *s << 13;
+    *s ^= *s >> 17;
+    *s ^= *s << 5;
+    return *s;
+}
+
+int main(int argc, char **argv)
+{
+    u64 step = 99991;
+    unsigned legacyPts = 200, hops = 100000;
+    int verbose = 0, fail = 0;
+    adf4351_pll_t pll;
+    u64 f;
+    unsigned long pts = 0, worseThanBrute = 0, rangeErr = 0;
+    double maxErr = 0, maxErrF = 0, sumErr = 0, t0, tCalc = 0;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            step = strtoull(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-L") && i + 1 < argc) {
+            legacyPts = (unsigned)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            hops = (unsigned)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-v")) {
+            verbose = 1;
+        } else {
+            fprintf(stderr, "usage: %s [-s stepHz] [-L legacyPoints] [-n hops] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (step == 0) {
+        step = 1;
+    }
+
+    // 1. 扫频: 范围, 误差, 与穷举最优比较
+    for (f = F_MIN_HZ; f <= F_MAX_HZ; f += step) {
+        double e, eb;
+
+        t0 = now_ns();
+        if (adf4351_calc_pll(f, &pll) != 0) {
+            printf("  %.6f MHz: out of range\n", f / 1e6);
+            rangeErr++;
+            continue;
+        }
+        tCalc += now_ns() - t0;
+        pts++;
+        if (pll.MOD < 2 || pll.MOD > MOD_MAX || pll.FRAC >= pll.MOD || pll.INT < INT_MIN_89
+            || pll.RF_Div > 6 || pll.INT * PFD_HZ < 2200000000ull - PFD_HZ
+            || pll.INT * PFD_HZ > 4400000000ull) {
+            if (rangeErr++ < 8) {
+                printf("  %.6f MHz: INT %u FRAC %u MOD %u div %u out of range\n",
+                       f / 1e6, pll.INT, pll.FRAC, pll.MOD, pll.RF_Div);
+            }
+            continue;
+        }
+        e = (double)err_scaled(f, pll.INT, pll.FRAC, pll.MOD, pll.RF_Div)
+            / ((double)pll.MOD * (1u << pll.RF_Div));
+        eb = brute_err(f, pll.RF_Div);
+        if (e > eb * (1 + 1e-12) + 1e-9) {
+            if (worseThanBrute++ < 8) {
+                printf("  %.6f MHz: err %.3f Hz, best possible %.3f Hz\n", f / 1e6, e, eb);
+            }
+        }
+        if (e > maxErr) {
+            maxErr = e;
+            maxErrF = f / 1e6;
+        }
+        sumErr += e;
+        if (verbose) {
+            printf("%.6f INT %u FRAC %u MOD %u div %u err %.3f Hz\n",
+                   f / 1e6, pll.INT, pll.FRAC, pll.MOD, pll.RF_Div, e);
+        }
+    }
+    printf("sweep 35~4400MHz step %llu Hz: %lu points\n", (unsigned long long)step, pts);
+    printf("  error: max %.3f Hz at %.6f MHz, mean %.3f Hz\n", maxErr, maxErrF, sumErr / pts);
+    printf("  worse than exhaustive search: %lu, out of range: %lu\n", worseThanBrute, rangeErr);
+    printf("  calc time: %.1f ns per frequency (host)\n", tCalc / pts);
+    // 分母 <= 4095 的分数在 [0,1) 上最大间隔 1/4095, 误差上限 Fpfd / (2 * 4095) / 2^div
+    if (maxErr > PFD_HZ / (2.0 * MOD_MAX) || worseThanBrute || rangeErr) {
+        fail = 1;
+    }
+    // 频率低端和高端的超出范围
+    if (adf4351_calc_pll(F_MIN_HZ - 1000000, &pll) == 0 || adf4351_calc_pll(F_MAX_HZ + 1, &pll) == 0) {
+        printf("  out-of-range frequency accepted\n");
+        fail = 1;
+    }
+
+    // 2. 旧算法抽样对比
+    if (legacyPts) {
+        double lMax = 0, lSum = 0, lT = 0, nT = 0;
+        unsigned long it, itMax = 0, n = 0;
+        u64 span = (F_MAX_HZ - F_MIN_HZ) / legacyPts;
+
+        for (f = F_MIN_HZ + span / 3; f <= F_MAX_HZ && n < legacyPts; f += span) {
+            double fo, e;
+
+            t0 = now_ns();
+            fo = legacy_freq(f / 1e6, &it);
+            lT += now_ns() - t0;
+            t0 = now_ns();
+            adf4351_calc_pll(f, &pll);
+            nT += now_ns() - t0;
+            if (fo < 0) {
+                continue;
+            }
+            e = fo * 1e6 - (double)f;
+            e = e < 0 ? -e : e;
+            lMax = e > lMax ? e : lMax;
+            lSum += e;
+            itMax = it > itMax ? it : itMax;
+            n++;
+        }
+        printf("legacy search, %lu points: max error %.0f Hz, mean %.0f Hz, max %lu iterations\n",
+               n, lMax, lSum / n, itMax);
+        printf("  time per frequency: legacy %.1f us, new %.3f us (host)\n", lT / n / 1e3, nT / n / 1e3);
+    }
+
+    // 3. 跳频: 缓存 + 差分写入
+    {
+        static const u64 band[][2] = {
+            { 1160000000ull, 1300000000ull }, { 1550000000ull, 1620000000ull },
+            { 35000000ull, 80000000ull }, { 2200000000ull, 4400000000ull },
+        };
+        u64 set[12];
+        u32 seed = 0x2545F491, expect[6], k;
+        unsigned long hist[7] = { 0 }, mism = 0, r0Last = 0, h;
+        double tHop = 0, worstBus = 0, busSum = 0;
+        unsigned maxNum = 0;
+
+        adf4351_invalidate_regs();
+        // 缓存全空时, 0 和越界频率不能命中空项, 也不能写芯片
+        s_frames = 0;
+        if (adf4351_set_freq_hz(0) != -1 || adf4351_set_freq_hz(F_MAX_HZ + 1) != -1
+            || adf4351_set_freq_hz(34375000ull - 1) != -1 || s_frames != 0) {
+            printf("  out-of-range frequency written (%lu frames)\n", s_frames);
+            fail = 1;
+        }
+        for (k = 0; k < 12; k++) {
+            const u64 *b = band[k % 4];
+            set[k] = b[0] + (rnd(&seed) % (u32)((b[1] - b[0]) / 1000)) * 1000ull;
+        }
+        s_frames = 0;
+        for (h = 0; h < hops; h++) {
+            // 大部分在前 8 个频点 (缓存命中), 偶尔跳到其余 4 个 (替换缓存)
+            u32 sel = rnd(&seed) % 16;
+            u64 fh = set[sel < 12 ? sel % 8 : 8 + sel % 4];
+            int num;
+            double bus;
+
+            t0 = now_ns();
+            num = adf4351_set_freq_hz(fh);
+            tHop += now_ns() - t0;
+            if (num < 0) {
+                mism++;
+                continue;
+            }
+            hist[num]++;
+            maxNum = (unsigned)num > maxNum ? (unsigned)num : maxNum;
+            bus = num ? SPI_SESSION_NS + num * (double)SPI_FRAME_NS : 0;
+            busSum += bus;
+            worstBus = bus > worstBus ? bus : worstBus;
+            if (num && (s_lastWrite[num - 1] & 0x7) == 0) {
+                r0Last++;
+            } else if (num) {
+                mism++;
+            }
+            adf4351_calc_pll(fh, &pll);
+            adf4351_build_regs(&pll, expect);
+            if (memcmp(expect, s_chip, sizeof(expect)) != 0) {
+                if (mism++ < 4) {
+                    printf("  hop %lu to %.6f MHz: chip registers differ\n", h, fh / 1e6);
+                }
+            }
+        }
+        printf("hopping %u times over 12 frequencies (8-entry cache):\n", hops);
+        printf("  registers written per hop:");
+        for (k = 0; k <= 6; k++) {
+            printf(" %u:%lu", k, hist[k]);
+        }
+        printf("\n  mean %.2f frames, R0 last in every write: %s, mismatches: %lu\n",
+               (double)s_frames / hops, r0Last == hops - hist[0] ? "yes" : "no", mism);
+        printf("  host time %.1f ns per hop, SPI bus estimate mean %.1f us, worst %.1f us\n",
+               tHop / hops, busSum / hops / 1e3, worstBus / 1e3);
+        if (mism || r0Last != hops - hist[0] || worstBus >= 1e6) {
+            fail = 1;
+        }
+    }
+
+    printf("%s\n", fail ? "FAILED" : "all passed");
+    return fail;
+}
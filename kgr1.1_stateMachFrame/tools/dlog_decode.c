@@ -0,0 +1,315 @@
+// 主机工具: 解码固件 dlog_flush() 发出的二进制日志 (见 src/inc/zs_dlog.h)
+// 格式串 ID 是 .dlog_fmt 段中的链接地址, 从固件 ELF 中取回格式串后按参数字还原文本
+// 用法: dlog_decode <固件ELF> <串口抓包文件> [-t]
+//       -t  每行前加时间戳
+// 编译: gcc -std=c99 -O2 -o dlog_decode dlog_decode.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define DLOG_TAG_MASK       0xFF000000u
+#define DLOG_TAG_RECORD     0xD1000000u
+#define DLOG_HDR_WORDS      3
+#define DLOG_MAX_ARGS       12
+#define DLOG_ID_DROPPED     0xFFFFFFFFu
+
+#define SHT_PROGBITS        1
+#define SHF_ALLOC           2
+
+typedef struct {
+    uint32_t addr;
+    uint32_t size;
+    const uint8_t *data;
+} section_t;
+
+typedef struct {
+    uint8_t *image;
+    size_t len;
+    int big_endian;
+    int is64;
+    section_t fmt;              // .dlog_fmt
+    section_t *rodata;          // 已加载的数据段, 用于还原 %s
+    size_t rodata_count;
+} elf_t;
+
+static uint8_t *read_file(const char *path, size_t *len) {
+    FILE *fp = fopen(path, "rb");
+    uint8_t *buf;
+    long size;
+
+    if (fp == NULL) {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    buf = (uint8_t *)malloc(size > 0 ? (size_t)size : 1);
+    if (buf == NULL || fread(buf, 1, (size_t)size, fp) != (size_t)size) {
+        free(buf);
+        fclose(fp);
+        return NULL;
+    }
+    fclose(fp);
+    *len = (size_t)size;
+    return buf;
+}
+
+// MicroBlaze 可配置为大端或小端, 字节序以 ELF 头为准
+static uint16_t rd16(const elf_t *e, const uint8_t *p) {
+    return e->big_endian ? (uint16_t)((p[0] << 8) | p[1]) : (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rd32(const elf_t *e, const uint8_t *p) {
+    return e->big_endian ? ((uint32_t)rd16(e, p) << 16) | rd16(e, p + 2)
+                         : (uint32_t)rd16(e, p) | ((uint32_t)rd16(e, p + 2) << 16);
+}
+
+static uint64_t rd64(const elf_t *e, const uint8_t *p) {
+    return e->big_endian ? ((uint64_t)rd32(e, p) << 32) | rd32(e, p + 4)
+                         : (uint64_t)rd32(e, p) | ((uint64_t)rd32(e, p + 4) << 32);
+}
+
+// 读取段表字段: ELF32 为 32 位, ELF64 中地址/偏移/大小为 64 位
+static uint64_t rd_word(const elf_t *e, const uint8_t *p) {
+    return e->is64 ? rd64(e, p) : rd32(e, p);
+}
+
+static int elf_load(elf_t *e, const char *path) {
+    memset(e, 0, sizeof(*e));
+    e->image = read_file(path, &e->len);
+    if (e->image == NULL) {
+        return -1;
+    }
+    if (e->len < 0x40 || memcmp(e->image, "\x7F" "ELF", 4) != 0) {
+        fprintf(stderr, "%s: 不是 ELF 文件\n", path);
+        return -1;
+    }
+    e->is64 = (e->image[4] == 2);
+    e->big_endian = (e->image[5] == 2);
+
+    uint64_t shoff = e->is64 ? rd64(e, e->image + 0x28) : rd32(e, e->image + 0x20);
+    uint16_t shentsize = rd16(e, e->image + (e->is64 ? 0x3A : 0x2E));
+    uint16_t shnum = rd16(e, e->image + (e->is64 ? 0x3C : 0x30));
+    uint16_t shstrndx = rd16(e, e->image + (e->is64 ? 0x3E : 0x32));
+    if (shoff + (uint64_t)shnum * shentsize > e->len || shstrndx >= shnum) {
+        return -1;
+    }
+    // 段表项: name(4) type(4) flags addr offset size, 后三项和 flags 在 ELF64 中为 8 字节
+    size_t w = e->is64 ? 8 : 4;
+    const uint8_t *shstr_sh = e->image + shoff + (size_t)shstrndx * shentsize;
+    uint64_t shstr_off = rd_word(e, shstr_sh + 8 + 2 * w);
+
+    e->rodata = (section_t *)calloc(shnum, sizeof(section_t));
+    for (uint16_t i = 0; i < shnum; i++) {
+        const uint8_t *sh = e->image + shoff + (size_t)i * shentsize;
+        const char *name = (const char *)e->image + shstr_off + rd32(e, sh);
+        uint32_t type = rd32(e, sh + 4);
+        uint64_t flags = rd_word(e, sh + 8);
+        uint64_t offset = rd_word(e, sh + 8 + 2 * w);
+        section_t sec;
+
+        // 日志 ID 为 32 位, 只取地址低 32 位
+        sec.addr = (uint32_t)rd_word(e, sh + 8 + w);
+        sec.size = (uint32_t)rd_word(e, sh + 8 + 3 * w);
+        if (offset + sec.size > e->len || type != SHT_PROGBITS) {
+            continue;
+        }
+        sec.data = e->image + offset;
+        if (strcmp(name, ".dlog_fmt") == 0) {
+            e->fmt = sec;
+        } else if (flags & SHF_ALLOC) {
+            e->rodata[e->rodata_count++] = sec;
+        }
+    }
+    if (e->fmt.data == NULL) {
+        fprintf(stderr, "%s: 没有 .dlog_fmt 段, 固件编译时是否定义了 DLOG_ENABLE?\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+static const char *elf_fmt_string(const elf_t *e, uint32_t id) {
+    if (id < e->fmt.addr || id - e->fmt.addr >= e->fmt.size) {
+        return NULL;
+    }
+    return (const char *)e->fmt.data + (id - e->fmt.addr);
+}
+
+// %s 参数是目标板地址, 在已加载的段中找到以 '\0' 结尾的字符串
+static const char *elf_string_at(const elf_t *e, uint32_t addr) {
+    for (size_t i = 0; i < e->rodata_count; i++) {
+        const section_t *s = &e->rodata[i];
+        if (addr >= s->addr && addr - s->addr < s->size &&
+            memchr(s->data + (addr - s->addr), '\0', s->size - (addr - s->addr)) != NULL) {
+            return (const char *)s->data + (addr - s->addr);
+        }
+    }
+    return NULL;
+}
+
+// 按格式串逐个转换消耗参数字, 每个转换交给主机 printf 处理宽度/精度等标志
+static void print_record(const elf_t *e, const char *fmt, const uint32_t *args, uint32_t nargs) {
+    uint32_t used = 0;
+
+    while (*fmt) {
+        if (*fmt != '%') {
+            const char *p = strchr(fmt, '%');
+            size_t n = p ? (size_t)(p - fmt) : strlen(fmt);
+            fwrite(fmt, 1, n, stdout);
+            fmt += n;
+            continue;
+        }
+        if (fmt[1] == '%') {
+            putchar('%');
+            fmt += 2;
+            continue;
+        }
+
+        // 复制 标志/宽度/精度, 去掉长度修饰 (参数统一为 32 位)
+        char spec[32];
+        size_t n = 0;
+        int star[2];
+        int stars = 0;
+        spec[n++] = *fmt++;
+        while (*fmt && strchr("-+ #0123456789.*", *fmt) != NULL && n < sizeof(spec) - 3) {
+            if (*fmt == '*' && stars < 2) {
+                star[stars++] = (used < nargs) ? (int32_t)args[used++] : 0;
+            }
+            spec[n++] = *fmt++;
+        }
+        while (*fmt && strchr("hlzjtL", *fmt) != NULL) {
+            fmt++;
+        }
+        char conv = *fmt ? *fmt++ : '\0';
+        uint32_t w = (used < nargs) ? args[used] : 0;
+        if (conv != '\0') {
+            used++;
+        }
+        if (used > nargs) {
+            printf("<缺少参数>");
+            continue;
+        }
+
+        switch (conv) {
+            case 'd': case 'i':
+                spec[n++] = 'd';
+                spec[n] = '\0';
+                if (stars == 2) printf(spec, star[0], star[1], (int32_t)w);
+                else if (stars == 1) printf(spec, star[0], (int32_t)w);
+                else printf(spec, (int32_t)w);
+                break;
+            case 'u': case 'x': case 'X': case 'o': case 'c':
+                spec[n++] = conv;
+                spec[n] = '\0';
+                if (stars == 2) printf(spec, star[0], star[1], (unsigned)w);
+                else if (stars == 1) printf(spec, star[0], (unsigned)w);
+                else printf(spec, (unsigned)w);
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': {
+                float f;
+                memcpy(&f, &w, sizeof(f));     // DLOG_FLOAT() 记录的是 float 位模式
+                spec[n++] = conv;
+                spec[n] = '\0';
+                if (stars == 2) printf(spec, star[0], star[1], (double)f);
+                else if (stars == 1) printf(spec, star[0], (double)f);
+                else printf(spec, (double)f);
+                break;
+            }
+            case 's': {
+                const char *s = elf_string_at(e, w);
+                char addr_text[24];
+                if (s == NULL) {
+                    snprintf(addr_text, sizeof(addr_text), "<str@0x%08x>", w);
+                    s = addr_text;
+                }
+                spec[n++] = 's';
+                spec[n] = '\0';
+                if (stars == 2) printf(spec, star[0], star[1], s);
+                else if (stars == 1) printf(spec, star[0], s);
+                else printf(spec, s);
+                break;
+            }
+            case 'p':
+                printf("0x%08x", w);
+                break;
+            default:
+                fwrite(spec, 1, n, stdout);
+                if (conv != '\0') putchar(conv);
+                break;
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    elf_t elf;
+    size_t len;
+    uint8_t *cap;
+    int show_time = 0;
+    uint64_t records = 0, dropped = 0, skipped = 0;
+    int line_start = 1;
+
+    if (argc == 4 && strcmp(argv[3], "-t") == 0) {
+        show_time = 1;
+    } else if (argc != 3) {
+        printf("用法: %s <固件ELF> <串口抓包文件> [-t]\n", argv[0]);
+        return 1;
+    }
+    if (elf_load(&elf, argv[1]) != 0) {
+        fprintf(stderr, "读取 ELF 失败: %s\n", argv[1]);
+        return 1;
+    }
+    cap = read_file(argv[2], &len);
+    if (cap == NULL) {
+        fprintf(stderr, "读取抓包文件失败: %s\n", argv[2]);
+        return 1;
+    }
+
+    size_t pos = 0;
+    while (pos + DLOG_HDR_WORDS * 4 <= len) {
+        uint32_t hdr = rd32(&elf, cap + pos);
+        uint32_t nargs = (hdr >> 16) & 0xFF;
+        uint32_t id = rd32(&elf, cap + pos + 4);
+        size_t rec_len = (DLOG_HDR_WORDS + nargs) * 4;
+        const char *fmt = NULL;
+
+        // 头标记、参数个数和 ID 都合法才认为是一条记录, 否则逐字节重新同步
+        if ((hdr & DLOG_TAG_MASK) != DLOG_TAG_RECORD || (hdr & 0xFFFF) != 0 ||
+            nargs > DLOG_MAX_ARGS || pos + rec_len > len ||
+            (id != DLOG_ID_DROPPED && (fmt = elf_fmt_string(&elf, id)) == NULL)) {
+            pos++;
+            skipped++;
+            continue;
+        }
+
+        uint32_t args[DLOG_MAX_ARGS];
+        for (uint32_t i = 0; i < nargs; i++) {
+            args[i] = rd32(&elf, cap + pos + (DLOG_HDR_WORDS + i) * 4);
+        }
+        uint32_t timestamp = rd32(&elf, cap + pos + 8);
+
+        if (id == DLOG_ID_DROPPED) {
+            if (!line_start) putchar('\n');
+            printf("[%10u] <dlog: 缓冲区满, 丢弃 %u 条>\n", timestamp, nargs ? args[0] : 0);
+            dropped += nargs ? args[0] : 0;
+            line_start = 1;
+        } else {
+            if (show_time && line_start) {
+                printf("[%10u] ", timestamp);
+            }
+            print_record(&elf, fmt, args, nargs);
+            size_t fl = strlen(fmt);
+            line_start = (fl > 0 && fmt[fl - 1] == '\n');
+        }
+        records++;
+        pos += rec_len;
+    }
+
+    fprintf(stderr, "%llu 条记录, 丢弃 %llu 条, 跳过 %llu 字节\n",
+            (unsigned long long)records, (unsigned long long)dropped,
+            (unsigned long long)(skipped + (len - pos)));
+    free(cap);
+    free(elf.rodata);
+    free(elf.image);
+    return 0;
+}
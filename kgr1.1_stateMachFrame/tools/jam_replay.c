@@ -0,0 +1,467 @@
+// 主机工具: 用记录的功率序列回放干扰检测 (src/app/jam_detect.c), 统计检测时延和虚警率
+// 输入每行一个样本, 两种格式都可以, 其余行 (控制台文本, # 注释) 跳过:
+//   $JAMPW,<tick>,<p0>,...,<pN-1>          固件 jam_trace 命令的输出
+//                                          (固件定义 DLOG_ENABLE 时先用 dlog_decode 还原, 不加 -t)
+//   <tick> <p0> ... <pN-1> [真值 0/1]      空格或逗号分隔, 末尾可带干扰真值
+// 真值也可以用 -j 起始:结束 (ms, 可重复) 给出, 优先于行内真值.
+// 用法: jam_replay <trace> [-n 通道数] [-a alpha] [-k drift] [-h limit] [-s minSigma]
+//                  [-T 绝对门限] [-r releaseSigma] [-w 学习样本] [-on ms] [-off ms] [-j a:b ...] [-L 旧门限] [-v]
+//       jam_replay -g <seed> [-n 通道数] > trace.txt     生成带真值的合成序列
+//       -L  同时回放旧算法 (最大功率硬门限, 连续 1000 个样本低于门限才恢复) 作对比
+//       -v  打印每次确认/恢复事件
+// 编译: gcc -std=c99 -O2 -I../src/inc -o jam_replay jam_replay.c ../src/app/jam_detect.c -lm
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "jam_detect.h"
+
+#define MAX_INTERVALS       256
+#define LEGACY_RELEASE_CNT  1000
+
+typedef struct {
+    uint32_t tick;
+    uint8_t truth;
+    int32_t p[JAM_DET_CH_MAX];
+} sample_t;
+
+typedef struct {
+    uint32_t start, end;        // [start, end)
+} interval_t;
+
+typedef struct {
+    uint32_t tick;
+    int type;
+} event_t;
+
+typedef struct {
+    sample_t *s;
+    size_t count, cap;
+    interval_t truth[MAX_INTERVALS];
+    int truth_count;
+} trace_t;
+
+typedef struct {
+    event_t *ev;
+    size_t count, cap;
+} events_t;
+
+static int parse_line(char *line, int chans, sample_t *out) {
+    double v[JAM_DET_CH_MAX + 2];
+    int n = 0;
+    char *p = line, *end;
+
+    if (strncmp(p, "$JAMPW,", 7) == 0) {
+        p += 7;
+    } else if (*p == '#' || *p == '$') {
+        return 0;
+    }
+    while (n < chans + 2) {
+        while (*p == ' ' || *p == '\t' || *p == ',') {
+            p++;
+        }
+        if (*p == '\0' || *p == '\r' || *p == '\n') {
+            break;
+        }
+        v[n] = strtod(p, &end);
+        if (end == p) {
+            return 0;
+        }
+        n++;
+        p = end;
+    }
+    if (n != chans + 1 && n != chans + 2) {
+        return 0;
+    }
+    out->tick = (uint32_t)v[0];
+    for (int i = 0; i < chans; i++) {
+        out->p[i] = (int32_t)v[i + 1];
+    }
+    out->truth = n == chans + 2 && v[chans + 1] != 0;
+    return 1;
+}
+
+static int trace_load(trace_t *t, const char *path, int chans) {
+    char line[1024];
+    sample_t s;
+    FILE *fp = fopen(path, "r");
+
+    if (fp == NULL) {
+        perror(path);
+        return -1;
+    }
+    memset(&s, 0, sizeof(s));
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (!parse_line(line, chans, &s)) {
+            continue;
+        }
+        if (t->count == t->cap) {
+            t->cap = t->cap ? t->cap * 2 : 4096;
+            t->s = (sample_t *)realloc(t->s, t->cap * sizeof(sample_t));
+            if (t->s == NULL) {
+                fprintf(stderr, "out of memory\n");
+                exit(1);
+            }
+        }
+        t->s[t->count++] = s;
+    }
+    fclose(fp);
+    return 0;
+}
+
+// 没有 -j 时由行内真值得到干扰区间
+static void truth_from_labels(trace_t *t) {
+    int in = 0;
+
+    for (size_t i = 0; i < t->count; i++) {
+        if (t->s[i].truth && !in && t->truth_count < MAX_INTERVALS) {
+            t->truth[t->truth_count].start = t->s[i].tick;
+            in = 1;
+        } else if (!t->s[i].truth && in) {
+            t->truth[t->truth_count++].end = t->s[i].tick;
+            in = 0;
+        }
+    }
+    if (in) {
+        t->truth[t->truth_count++].end = t->s[t->count - 1].tick + 1;
+    }
+}
+
+static void events_add(events_t *e, uint32_t tick, int type) {
+    if (e->count == e->cap) {
+        e->cap = e->cap ? e->cap * 2 : 256;
+        e->ev = (event_t *)realloc(e->ev, e->cap * sizeof(event_t));
+        if (e->ev == NULL) {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    e->ev[e->count].tick = tick;
+    e->ev[e->count].type = type;
+    e->count++;
+}
+
+static void run_detector(const trace_t *t, const jam_detect_cfg_t *cfg, events_t *e) {
+    jam_detect_t d;
+
+    jam_detect_init(&d, cfg);
+    for (size_t i = 0; i < t->count; i++) {
+        int r = jam_detect_update(&d, t->s[i].p, t->s[i].tick);
+        if (r != JAM_DET_NONE) {
+            events_add(e, t->s[i].tick, r);
+        }
+    }
+}
+
+// 旧 JamDetectTask: find_max_value 只比较前 7 个通道, 超门限立即告警, 连续 1000 次低于门限才恢复
+static void run_legacy(const trace_t *t, int chans, int32_t threshold, events_t *e) {
+    int jammed = 0, below = 0;
+
+    for (size_t i = 0; i < t->count; i++) {
+        int32_t max = t->s[i].p[0];
+        for (int c = 0; c < chans && c < 7; c++) {
+            if (t->s[i].p[c] > max) {
+                max = t->s[i].p[c];
+            }
+        }
+        if (max > threshold) {
+            if (!jammed) {
+                events_add(e, t->s[i].tick, JAM_DET_ONSET);
+            }
+            jammed = 1;
+            below = 0;
+        } else if (jammed && ++below > LEGACY_RELEASE_CNT) {
+            events_add(e, t->s[i].tick, JAM_DET_CLEAR);
+            jammed = 0;
+        }
+    }
+}
+
+static int in_truth(const trace_t *t, uint32_t tick) {
+    for (int i = 0; i < t->truth_count; i++) {
+        if (tick >= t->truth[i].start && tick < t->truth[i].end) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void report(const char *name, const trace_t *t, const events_t *e, int verbose) {
+    uint32_t t0 = t->s[0].tick, t1 = t->s[t->count - 1].tick;
+    double jam_ms = 0, quiet_ms, flagged_quiet = 0;
+    double lat_sum = 0, lat_max = 0, rel_sum = 0;
+    int detected = 0, released = 0, early = 0, false_alarm = 0;
+    size_t k;
+
+    for (int i = 0; i < t->truth_count; i++) {
+        jam_ms += t->truth[i].end - t->truth[i].start;
+    }
+    quiet_ms = (double)(t1 - t0) - jam_ms;
+
+    for (k = 0; k < e->count; k++) {
+        if (e->ev[k].type == JAM_DET_ONSET && !in_truth(t, e->ev[k].tick)) {
+            false_alarm++;
+            if (verbose) {
+                printf("  %s: false alarm at %u ms\n", name, e->ev[k].tick);
+            }
+        }
+    }
+
+    // 每个干扰区间: 区间内第一次确认为检测时延, 此后第一次恢复在区间结束之后为恢复时延, 之前为提前恢复
+    for (int i = 0; i < t->truth_count; i++) {
+        const interval_t *iv = &t->truth[i];
+        uint32_t onset = iv->start;
+        int hit = 0;
+
+        for (k = 0; k < e->count; k++) {
+            if (e->ev[k].type == JAM_DET_ONSET && e->ev[k].tick >= iv->start && e->ev[k].tick < iv->end) {
+                double lat = e->ev[k].tick - iv->start;
+                lat_sum += lat;
+                if (lat > lat_max) {
+                    lat_max = lat;
+                }
+                detected++;
+                hit = 1;
+                onset = e->ev[k].tick;
+                break;
+            }
+        }
+        // 区间开始前已处于干扰状态 (上一次未恢复) 也算检测到, 时延记为 0
+        if (!hit) {
+            int state = 0;
+            for (k = 0; k < e->count && e->ev[k].tick < iv->start; k++) {
+                state = e->ev[k].type == JAM_DET_ONSET;
+            }
+            if (state) {
+                detected++;
+                hit = 1;
+            }
+        }
+        if (verbose) {
+            printf("  %s: jam %u-%u ms %s\n", name, iv->start, iv->end, hit ? "detected" : "MISSED");
+        }
+        if (hit) {
+            for (k = 0; k < e->count; k++) {
+                if (e->ev[k].type == JAM_DET_CLEAR && e->ev[k].tick >= onset) {
+                    if (e->ev[k].tick < iv->end) {
+                        early++;
+                        if (verbose) {
+                            printf("  %s: released %u ms before jam end\n", name, iv->end - e->ev[k].tick);
+                        }
+                    } else {
+                        rel_sum += e->ev[k].tick - iv->end;
+                        released++;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    // 无干扰时间内被判为干扰的比例
+    {
+        int state = 0;
+        uint32_t from = t0;
+        k = 0;
+        for (size_t i = 0; i < t->count; i++) {
+            uint32_t tick = t->s[i].tick;
+            while (k < e->count && e->ev[k].tick <= tick) {
+                state = e->ev[k++].type == JAM_DET_ONSET;
+            }
+            if (i + 1 < t->count && state && !in_truth(t, tick)) {
+                flagged_quiet += t->s[i + 1].tick - tick;
+            }
+            (void)from;
+        }
+    }
+
+    printf("%s:\n", name);
+    printf("  jams detected %d/%d", detected, t->truth_count);
+    if (detected) {
+        printf(", onset latency mean %.1f ms max %.0f ms", lat_sum / detected, lat_max);
+    }
+    if (released) {
+        printf(", release latency mean %.1f ms", rel_sum / released);
+    }
+    if (early) {
+        printf(", %d released early", early);
+    }
+    printf("\n");
+    printf("  false alarms %d in %.1f s without jam (%.2f per hour), jam flagged %.3f%% of quiet time\n",
+           false_alarm, quiet_ms / 1000.0, quiet_ms > 0 ? false_alarm * 3600000.0 / quiet_ms : 0.0,
+           quiet_ms > 0 ? flagged_quiet * 100.0 / quiet_ms : 0.0);
+}
+
+static double gauss(uint64_t *s) {
+    double u1, u2;
+
+    *s = *s * 6364136223846793005ull + 1442695040888963407ull;
+    u1 = ((*s >> 11) + 1.0) / 9007199254740993.0;
+    *s = *s * 6364136223846793005ull + 1442695040888963407ull;
+    u2 = (*s >> 11) / 9007199254740992.0;
+    return sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+}
+
+// 合成序列: 5ms 一个样本, 10 分钟; 基线缓慢漂移, 偶发单点脉冲, 穿插不同强度和持续时间的干扰
+static void generate(uint64_t seed, int chans) {
+    const uint32_t period = 5, total = 600000;
+    double base[JAM_DET_CH_MAX], sigma[JAM_DET_CH_MAX];
+    uint64_t s = seed * 0x9E3779B97F4A7C15ull + 1;
+    uint32_t next_jam = 20000, jam_end = 0;
+    double jam_gain = 0;
+    int jam_mask = 0;
+
+    for (int c = 0; c < chans; c++) {
+        base[c] = 200 + 40 * gauss(&s);
+        sigma[c] = 6 + fabs(3 * gauss(&s));
+    }
+    printf("# synthetic trace seed %llu: tick p0..p%d truth\n", (unsigned long long)seed, chans - 1);
+    for (uint32_t tick = 0; tick < total; tick += period) {
+        int jam;
+
+        if (tick >= next_jam && jam_end <= tick) {
+            // 干扰强度 3~30 sigma, 持续 0.2~20 s, 一个或多个通道
+            jam_gain = 3 + 27 * fabs(gauss(&s)) / 3;
+            jam_end = tick + 200 + (uint32_t)(fabs(gauss(&s)) * 8000);
+            jam_mask = (int)((s >> 20) % ((1u << chans) - 1)) + 1;
+            next_jam = jam_end + 10000 + (uint32_t)(fabs(gauss(&s)) * 30000);
+        }
+        jam = tick < jam_end && tick >= next_jam - (next_jam - jam_end) - (jam_end - tick) ? 0 : 0;
+        jam = tick < jam_end;
+        printf("%u", tick);
+        for (int c = 0; c < chans; c++) {
+            double drift = 10 * sin(tick / 90000.0 + c);
+            double v = base[c] + drift + sigma[c] * gauss(&s);
+            if ((s >> 8) % 20000 == 0) {
+                v += 8 * sigma[c];      // 单点脉冲
+            }
+            if (jam && (jam_mask >> c & 1)) {
+                v += jam_gain * sigma[c];
+            }
+            printf(" %d", (int)v);
+        }
+        printf(" %d\n", jam);
+    }
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    jam_detect_cfg_t cfg;
+    trace_t t;
+    events_t ev, legacy;
+    int chans = JAM_DET_CH_MAX, verbose = 0, gen = 0;
+    long legacy_thr = -1;
+    uint64_t seed = 0;
+
+    jam_detect_cfg_default(&cfg);
+    memset(&t, 0, sizeof(t));
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(a, "-v") == 0) {
+            verbose = 1;
+        } else if (v == NULL && a[0] == '-') {
+            path = NULL;
+            break;
+        } else if (strcmp(a, "-g") == 0) {
+            gen = 1;
+            seed = strtoull(v, NULL, 0);
+            i++;
+        } else if (strcmp(a, "-n") == 0) {
+            chans = atoi(v);
+            i++;
+        } else if (strcmp(a, "-a") == 0) {
+            cfg.alpha = (float)atof(v);
+            i++;
+        } else if (strcmp(a, "-k") == 0) {
+            cfg.drift = (float)atof(v);
+            i++;
+        } else if (strcmp(a, "-h") == 0) {
+            cfg.limit = (float)atof(v);
+            i++;
+        } else if (strcmp(a, "-r") == 0) {
+            cfg.releaseSigma = (float)atof(v);
+            i++;
+        } else if (strcmp(a, "-s") == 0) {
+            cfg.minSigma = (float)atof(v);
+            i++;
+        } else if (strcmp(a, "-T") == 0) {
+            cfg.absThreshold = (float)atof(v);
+            i++;
+        } else if (strcmp(a, "-w") == 0) {
+            cfg.warmupSamples = (uint32_t)strtoul(v, NULL, 0);
+            i++;
+        } else if (strcmp(a, "-on") == 0) {
+            cfg.onHoldMs = (uint32_t)strtoul(v, NULL, 0);
+            i++;
+        } else if (strcmp(a, "-off") == 0) {
+            cfg.offHoldMs = (uint32_t)strtoul(v, NULL, 0);
+            i++;
+        } else if (strcmp(a, "-L") == 0) {
+            legacy_thr = strtol(v, NULL, 0);
+            i++;
+        } else if (strcmp(a, "-j") == 0) {
+            unsigned long s0, s1;
+            if (sscanf(v, "%lu:%lu", &s0, &s1) != 2 || s1 <= s0 || t.truth_count == MAX_INTERVALS) {
+                fprintf(stderr, "bad interval %s\n", v);
+                return 1;
+            }
+            t.truth[t.truth_count].start = (uint32_t)s0;
+            t.truth[t.truth_count++].end = (uint32_t)s1;
+            i++;
+        } else if (path == NULL && a[0] != '-') {
+            path = a;
+        } else {
+            path = NULL;
+            gen = 0;
+            break;
+        }
+    }
+    if (chans < 1 || chans > JAM_DET_CH_MAX) {
+        fprintf(stderr, "channel count must be 1..%d\n", JAM_DET_CH_MAX);
+        return 1;
+    }
+    cfg.chanNum = (uint8_t)chans;
+    if (gen) {
+        generate(seed, chans);
+        return 0;
+    }
+    if (path == NULL) {
+        fprintf(stderr, "usage: %s <trace> [-n chans] [-a alpha] [-k drift] [-h limit] [-s minSigma] [-T abs] [-r release]\n"
+                        "       [-w warmup] [-on ms] [-off ms] [-j start:end ...] [-L legacy_thr] [-v]\n"
+                        "       %s -g <seed> [-n chans]\n", argv[0], argv[0]);
+        return 1;
+    }
+    if (trace_load(&t, path, chans) != 0) {
+        return 1;
+    }
+    if (t.count < 2) {
+        fprintf(stderr, "no samples in %s\n", path);
+        return 1;
+    }
+    if (t.truth_count == 0) {
+        truth_from_labels(&t);
+    }
+
+    printf("%zu samples, %.1f s, %d jam intervals\n", t.count,
+           (t.s[t.count - 1].tick - t.s[0].tick) / 1000.0, t.truth_count);
+    printf("cusum: alpha %g drift %g limit %g release %g minSigma %g abs %g warmup %u on %u ms off %u ms\n",
+           cfg.alpha, cfg.drift, cfg.limit, cfg.releaseSigma, cfg.minSigma, cfg.absThreshold,
+           cfg.warmupSamples, cfg.onHoldMs, cfg.offHoldMs);
+
+    memset(&ev, 0, sizeof(ev));
+    run_detector(&t, &cfg, &ev);
+    report("cusum", &t, &ev, verbose);
+
+    if (legacy_thr >= 0) {
+        memset(&legacy, 0, sizeof(legacy));
+        run_legacy(&t, chans, (int32_t)legacy_thr, &legacy);
+        report("legacy threshold", &t, &legacy, verbose);
+        free(legacy.ev);
+    }
+    free(ev.ev);
+    free(t.s);
+    return 0;
+}
@@ -0,0 +1,166 @@
+// 主机工具: KGR 寄存器批量操作的总线访问次数检查
+// 用 ANTIJAM_HOST_MOCK 编译 KgrInfo.c 和 antijam_fpga.c, 总线换成内存数组,
+// 写钩子模拟 FIR 系数寄存器的就绪位 (bit2) 和 config valid 就绪位 (bit1).
+// 检查内容:
+//   weight_Set: 读写次数 (两次调用, 第二次可缓存寄存器不再读总线), 寄存器 60 的 bit0 选通
+//               0->1->0 且每个电平保持至少 1ms, 其它位保持原值;
+//   PLfpga_filter_config: 读写次数, 系数回读校验无误, 就绪超时时返回且不再写 config valid.
+// 期望次数按当前 KgrInfo.c 的操作序列推算, 修改寄存器序列后需同步更新.
+// 用法: kgr_bus_count [-v]
+// 编译: gcc -std=gnu99 -O2 -DANTIJAM_HOST_MOCK -I../src/platform/inc -I../src/inc -o kgr_bus_count kgr_bus_count.c ../src/app/KgrInfo.c ../src/platform/bsp/drive/antijam/antijam_fpga.c -lm
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "antijam_fpga.h"
+
+#define FIR_ADDR        180
+#define FIR_NUM         80          // LPF1_LPF4_NUM, 超过一批描述符, 中途自动提交
+#define STROBE_REG      60
+#define MAX_STROBE      16
+
+extern void weight_Set(void);
+extern void PLfpga_filter_config(int addr, int *weight, int num);
+
+// KgrInfo.c 引用的应用层变量
+int Ch_set;
+int ch;
+
+static int s_verbose;
+static unsigned long s_errors;
+static uint32_t s_tick;
+static int s_firReady = 1;
+
+static struct {
+    uint32_t tick;
+    uint32_t val;
+} s_strobe[MAX_STROBE];
+static int s_strobeCount;
+
+void dx_kprintf(const char *fmt, ...)
+{
+    va_list ap;
+
+    if (!s_verbose) {
+        return;
+    }
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+}
+
+// 假时钟: 每次让出 CPU 前进 1ms
+uint32_t tick_get(void)
+{
+    return s_tick;
+}
+
+void ev_cpu_idle(void)
+{
+    s_tick++;
+}
+
+static void mock_write(u32 addr, u32 val)
+{
+    if (addr == FIR_ADDR && s_firReady) {
+        g_kgrMockBus[addr] = val | 0x4;
+    } else if (addr == FIR_ADDR + 1 && s_firReady) {
+        g_kgrMockBus[addr] = val | 0x2;
+    } else if (addr == STROBE_REG && s_strobeCount < MAX_STROBE) {
+        s_strobe[s_strobeCount].tick = s_tick;
+        s_strobe[s_strobeCount].val = val;
+        s_strobeCount++;
+    }
+}
+
+static void expect(const char *name, unsigned long got, unsigned long want)
+{
+    if (got != want) {
+        printf("  %s: %lu, expected %lu\n", name, got, want);
+        s_errors++;
+    } else if (s_verbose) {
+        printf("  %s: %lu\n", name, got);
+    }
+}
+
+// 第一次调用: 批量部分读 65/67/60/129 各一次, 回读校验 7 次, 写 19 次;
+// Weight_load_init 两轮各读 132 两次, 写 9 次. 第二次调用 65/67/129 命中影子.
+static void test_weight_set(void)
+{
+    static const u32 want_reads[2] = { 11 + 4, 8 + 4 };
+    kgr_bus_stat_t st;
+    int pass, i;
+
+    printf("weight_Set\n");
+    g_kgrMockBus[STROBE_REG] = 0x00001230;  // 选通位为 0, 其它位应保持
+    for (pass = 0; pass < 2; pass++) {
+        s_strobeCount = 0;
+        kgr_bus_stat_get(&st, 1);
+        weight_Set();
+        kgr_bus_stat_get(&st, 1);
+        expect(pass ? "second reads" : "first reads", st.reads, want_reads[pass]);
+        expect(pass ? "second writes" : "first writes", st.writes, 19 + 18);
+
+        // 60 的写入: bit0 0, 1, 0, 然后关闭 ddc 旁路 (bit31 清零)
+        expect("reg 60 writes", s_strobeCount, 4);
+        for (i = 0; i < s_strobeCount && i < 4; i++) {
+            u32 bit0 = (i == 1);
+
+            if ((s_strobe[i].val & 0x1) != bit0 || (s_strobe[i].val & 0x7FFFFFFE) != 0x00001230) {
+                printf("  reg 60 write #%d: 0x%08X\n", i, (unsigned)s_strobe[i].val);
+                s_errors++;
+            }
+            if (i > 0 && i < 3 && s_strobe[i].tick - s_strobe[i - 1].tick < 1) {
+                printf("  reg 60 write #%d only %u ms after previous\n", i,
+                       (unsigned)(s_strobe[i].tick - s_strobe[i - 1].tick));
+                s_errors++;
+            }
+        }
+    }
+}
+
+// 每个系数: 等待就绪读 1 次, 写 2 次, 回读校验 1 次; 前后各写 2 次, 结尾等待读 1 次
+static void test_filter_config(void)
+{
+    static int weight[FIR_NUM];
+    kgr_bus_stat_t st;
+    int i;
+
+    printf("PLfpga_filter_config\n");
+    for (i = 0; i < FIR_NUM; i++) {
+        weight[i] = (i * 2654435761u) & 0xFFFFFF;
+    }
+
+    kgr_bus_stat_get(&st, 1);
+    PLfpga_filter_config(FIR_ADDR, weight, FIR_NUM);
+    kgr_bus_stat_get(&st, 1);
+    expect("reads", st.reads, 2 * FIR_NUM + 1);
+    expect("writes", st.writes, 2 * FIR_NUM + 4);
+    expect("config valid", g_kgrMockBus[FIR_ADDR + 1] & 0x1, 0);
+
+    // 就绪位不置起: 第一个等待超时后本批次剩余操作不再执行
+    s_firReady = 0;
+    g_kgrMockBus[FIR_ADDR] = 0;
+    g_kgrMockBus[FIR_ADDR + 1] = 0;
+    kgr_bus_stat_get(&st, 1);
+    PLfpga_filter_config(FIR_ADDR, weight, FIR_NUM);
+    kgr_bus_stat_get(&st, 1);
+    expect("timeout writes", st.writes, 2);
+    s_firReady = 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && !strcmp(argv[1], "-v")) {
+        s_verbose = 1;
+    } else if (argc > 1) {
+        fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+        return 2;
+    }
+
+    g_kgrMockWriteHook = mock_write;
+    test_weight_set();
+    test_filter_config();
+
+    printf("%lu errors\n", s_errors);
+    return s_errors ? 1 : 0;
+}
@@ -0,0 +1,331 @@
+// 主机工具: 分层时间轮 (src/platform/components/timer_wheel) 随机测试
+// 随机启动/停止/推进定时器, 与逐个比较到期时刻的参考实现对照:
+//   每个到期 tick 触发的定时器集合, tw_pending/tw_remaining, tw_next_expiry 下界.
+// 延时覆盖 0, 各级边界附近, 以及超过 2^24 需要重新放置的远期定时器; 推进步长有单 tick,
+// 短跳和跨多级降级点的长跳; 时刻从 -s 指定的起点开始, 默认跨越 32 位回绕.
+// 回调中随机重启或停止自身 (只操作自身, 同一 tick 内的执行顺序不影响结果).
+// 用法: tw_stress [-n 操作数] [-t 定时器数] [-r 随机种子] [-s 起始tick] [-v]
+// 编译: gcc -std=c99 -O2 -I../src/platform/components/timer_wheel -o tw_stress tw_stress.c ../src/platform/components/timer_wheel/timer_wheel.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "timer_wheel.h"
+
+#define MAX_TIMERS      1024
+#define MAX_FIRES       (MAX_TIMERS * 64)
+
+typedef struct {
+    int active;
+    uint64_t expire;            // 参考实现用 64 位虚拟时间, 不回绕
+    uint32_t period;
+} ref_timer_t;
+
+static tw_wheel_t s_wheel;
+static tw_timer_t s_timer[MAX_TIMERS];
+static ref_timer_t s_ref[MAX_TIMERS];
+static int s_count = 256;
+static uint32_t s_origin;       // 虚拟时间 0 对应的 tick
+static uint64_t s_now;          // 已推进到的虚拟时间
+
+static uint64_t s_rng = 0x9E3779B97F4A7C15ull;
+
+// 回调记录: 时间轮中触发的 (tick, id)
+static struct {
+    uint64_t tick;
+    int id;
+} s_fire[MAX_FIRES];
+static int s_fireCount;
+static unsigned long s_errors;
+
+static uint32_t rnd(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 7;
+    s_rng ^= s_rng << 17;
+    return (uint32_t)(s_rng >> 16);
+}
+
+// 回调中对自身的操作, 由 (id, 触发 tick) 决定, 时间轮和参考实现得到相同结果
+typedef enum { CB_NONE, CB_STOP, CB_RESTART } cb_action_t;
+
+static cb_action_t cb_action(int id, uint64_t tick, uint32_t *delay)
+{
+    uint64_t h = (tick * 0x9E3779B97F4A7C15ull) ^ ((uint64_t)id * 0xC2B2AE3D27D4EB4Full);
+
+    h ^= h >> 29;
+    switch (h % 8) {
+    case 0:
+        return CB_STOP;
+    case 1:
+    case 2:
+        *delay = (uint32_t)((h >> 8) % 5000);   // 含 0: 下一个 tick
+        return CB_RESTART;
+    default:
+        return CB_NONE;
+    }
+}
+
+// 回调中的当前时刻: 正在处理的 tick = base - 1, 换算为不回绕的虚拟时间 (距 s_now 不超过 2^32)
+static uint64_t virt_now(void)
+{
+    uint32_t cur = s_wheel.base - 1 - s_origin;
+
+    return s_now + (uint32_t)(cur - (uint32_t)s_now);
+}
+
+static void on_expire(void *arg)
+{
+    int id = (int)(intptr_t)arg;
+    uint64_t tick = virt_now();
+    uint32_t delay = 0;
+
+    if (s_fireCount < MAX_FIRES) {
+        s_fire[s_fireCount].tick = tick;
+        s_fire[s_fireCount].id = id;
+    }
+    s_fireCount++;
+    switch (cb_action(id, tick, &delay)) {
+    case CB_STOP:
+        tw_stop(&s_wheel, &s_timer[id]);
+        break;
+    case CB_RESTART:
+        tw_start(&s_wheel, &s_timer[id], delay, s_timer[id].period);
+        break;
+    default:
+        break;
+    }
+}
+
+static void ref_start(int id, uint64_t now, uint32_t delay, uint32_t period)
+{
+    s_ref[id].active = 1;
+    s_ref[id].expire = now + (delay ? delay : 1);
+    s_ref[id].period = period;
+}
+
+// 参考实现推进到 now, 触发记录按 (tick, id) 排序后与时间轮的记录比较
+static int fire_cmp(const void *a, const void *b)
+{
+    const uint64_t *x = (const uint64_t *)a, *y = (const uint64_t *)b;
+
+    return (*x > *y) - (*x < *y);
+}
+
+static void check_advance(uint64_t to)
+{
+    static uint64_t got[MAX_FIRES], want[MAX_FIRES];
+    int nGot, nWant = 0;
+    int i;
+
+    s_fireCount = 0;
+    tw_advance(&s_wheel, (uint32_t)(s_origin + to));
+
+    // 参考: 每次取最早到期的 tick, 该 tick 的定时器按 id 顺序处理
+    for (;;) {
+        uint64_t t = UINT64_MAX;
+
+        for (i = 0; i < s_count; i++) {
+            if (s_ref[i].active && s_ref[i].expire < t) {
+                t = s_ref[i].expire;
+            }
+        }
+        if (t > to) {
+            break;
+        }
+        for (i = 0; i < s_count; i++) {
+            ref_timer_t *r = &s_ref[i];
+            uint32_t delay = 0;
+
+            if (!r->active || r->expire != t) {
+                continue;
+            }
+            if (nWant < MAX_FIRES) {
+                want[nWant] = (t << 16) | (uint64_t)i;
+            }
+            nWant++;
+            if (r->period) {
+                r->expire += r->period;
+            } else {
+                r->active = 0;
+            }
+            switch (cb_action(i, t, &delay)) {
+            case CB_STOP:
+                r->active = 0;
+                break;
+            case CB_RESTART:
+                ref_start(i, t, delay, r->period);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    s_now = to;
+
+    if (s_fireCount > MAX_FIRES || nWant > MAX_FIRES) {
+        fprintf(stderr, "too many expiries in one advance (%d/%d)\n", s_fireCount, nWant);
+        exit(2);
+    }
+    nGot = s_fireCount;
+    for (i = 0; i < nGot; i++) {
+        got[i] = (s_fire[i].tick << 16) | (uint64_t)s_fire[i].id;
+    }
+    qsort(got, nGot, sizeof(got[0]), fire_cmp);
+    qsort(want, nWant, sizeof(want[0]), fire_cmp);
+    if (nGot != nWant || memcmp(got, want, nGot * sizeof(got[0])) != 0) {
+        if (s_errors++ < 8) {
+            printf("  advance to %llu: wheel fired %d, reference %d\n",
+                   (unsigned long long)to, nGot, nWant);
+            for (i = 0; i < nGot || i < nWant; i++) {
+                if (i < nGot && i < nWant && got[i] == want[i]) {
+                    continue;
+                }
+                printf("    #%d wheel %llu:%d reference %llu:%d\n", i,
+                       i < nGot ? (unsigned long long)(got[i] >> 16) : 0ull,
+                       i < nGot ? (int)(got[i] & 0xFFFF) : -1,
+                       i < nWant ? (unsigned long long)(want[i] >> 16) : 0ull,
+                       i < nWant ? (int)(want[i] & 0xFFFF) : -1);
+                break;
+            }
+        }
+    }
+}
+
+static void check_state(void)
+{
+    uint64_t earliest = UINT64_MAX;
+    uint32_t next;
+    int i, found;
+
+    for (i = 0; i < s_count; i++) {
+        uint32_t remain = tw_remaining(&s_wheel, &s_timer[i]);
+        uint32_t want = s_ref[i].active ? (uint32_t)(s_ref[i].expire - s_now) : 0;
+
+        if (tw_pending(&s_timer[i]) != s_ref[i].active || remain != want) {
+            if (s_errors++ < 8) {
+                printf("  t=%llu timer %d: pending %d/%d remaining %u/%u\n",
+                       (unsigned long long)s_now, i, tw_pending(&s_timer[i]), s_ref[i].active,
+                       remain, want);
+            }
+        }
+        if (s_ref[i].active && s_ref[i].expire < earliest) {
+            earliest = s_ref[i].expire;
+        }
+    }
+    found = tw_next_expiry(&s_wheel, &next);
+    if (found != (earliest != UINT64_MAX)
+        || (found && (TW_TIME_AFTER(next, (uint32_t)(s_origin + earliest))
+                      || TW_TIME_BEFORE_EQ(next, (uint32_t)(s_origin + s_now))))) {
+        if (s_errors++ < 8) {
+            printf("  t=%llu next expiry %d:%u, reference earliest %llu\n",
+                   (unsigned long long)s_now, found, (unsigned)(next - s_origin),
+                   (unsigned long long)earliest);
+        }
+    }
+}
+
+// 延时分布: 近距离, 各级边界附近, 超出 2^24 的远期
+static uint32_t rnd_delay(void)
+{
+    static const uint32_t edge[] = { 64, 4096, 262144, 16777216 };
+    uint32_t r = rnd() % 16;
+
+    if (r < 6) {
+        return rnd() % 100;
+    }
+    if (r < 10) {
+        return rnd() % 5000;
+    }
+    if (r < 13) {
+        uint32_t e = edge[rnd() % 4];
+        return e - 2 + rnd() % 5;
+    }
+    if (r < 15) {
+        return rnd() % 16777216;
+    }
+    return 16777216 + rnd() % (1u << 28);
+}
+
+static uint32_t rnd_step(void)
+{
+    uint32_t r = rnd() % 16;
+
+    if (r < 8) {
+        return 1;
+    }
+    if (r < 13) {
+        return rnd() % 200;
+    }
+    if (r < 15) {
+        return rnd() % 300000;
+    }
+    return rnd() % (1u << 26);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long ops = 200000, op;
+    unsigned long starts = 0, stops = 0, advances = 0;
+    int verbose = 0;
+    int i;
+
+    s_origin = 0xFFFFFFFFu - 1000000;
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            ops = strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            s_count = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            s_rng = strtoull(argv[++i], NULL, 0) | 1;
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            s_origin = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-v")) {
+            verbose = 1;
+        } else {
+            fprintf(stderr, "usage: %s [-n ops] [-t timers] [-r seed] [-s startTick] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (s_count < 1 || s_count > MAX_TIMERS) {
+        fprintf(stderr, "timers must be 1~%d\n", MAX_TIMERS);
+        return 2;
+    }
+
+    tw_init(&s_wheel, s_origin);
+    for (i = 0; i < s_count; i++) {
+        tw_timer_init(&s_timer[i], on_expire, (void *)(intptr_t)i);
+    }
+
+    for (op = 0; op < ops; op++) {
+        uint32_t r = rnd() % 16;
+        int id = (int)(rnd() % (uint32_t)s_count);
+
+        if (r < 7) {
+            uint32_t delay = rnd_delay();
+            uint32_t period = (rnd() % 3 == 0) ? 1 + rnd_delay() % 20000 : 0;
+
+            tw_start(&s_wheel, &s_timer[id], delay, period);
+            ref_start(id, s_now, delay, period);
+            starts++;
+        } else if (r < 9) {
+            tw_stop(&s_wheel, &s_timer[id]);
+            s_ref[id].active = 0;
+            stops++;
+        } else {
+            check_advance(s_now + rnd_step());
+            advances++;
+        }
+        if ((op & 15) == 0) {
+            check_state();
+        }
+        if (verbose && (op % 100000) == 0) {
+            printf("op %lu: t=%llu, %u timers pending\n", op, (unsigned long long)s_now, s_wheel.count);
+        }
+    }
+    check_state();
+
+    printf("%lu ops (%lu starts, %lu stops, %lu advances), %d timers, %llu ticks from 0x%08X: %lu errors\n",
+           ops, starts, stops, advances, s_count, (unsigned long long)s_now, (unsigned)s_origin, s_errors);
+    return s_errors ? 1 : 0;
+}
@@ -1,321 +1,347 @@
+// 格式化输出使用 xprintf 模块 (分块写出, 不再逐字符输出)
+// 编译: gcc -std=c99 -DXPRINTF_USE_STDOUT main.c ../xprintf/xprintf.c -lm
 #include <stdio.h>
 #include <stdint.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../xprintf/xprintf.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-typedef struct {
-    int width;          // 字段宽度
-    bool left_align;    // 左对齐标志
-    char pad_char;      // 填充字符
-    bool is_uppercase;  // 大写标志
-    int min_digits;     // 最小位数
-    int precision;      // 浮点数精度
-} format_info;
-
-// 辅助函数：向缓冲区写入字符
-static char print_buffer[32];
-static int buffer_pos = 0;
-
-void my_putchar(char c) {
-    // 实际实现时替换为您的输出函数
-    putchar(c);
-}
+#define MEMDIS_BYTES_PER_LINE   16
+#define MEMDIS_LINE_MAX         128
+
+// memdisplay_ex 选项
+#define MEMDIS_SQUEEZE          0x01    // 与上一行内容相同的连续行折叠为一行 "*"
+
+// 每个单元后的空格数, 保持原有列宽
+static const uint8_t cell_pad[9] = { 0, 2, 4, 0, 8, 0, 0, 0, 3 };
+
+// 字节 -> 两个十六进制字符
+static char hex_pairs[256][2];
+static bool hex_pairs_ready;
+static bool host_little_endian;
 
-void my_puts(const char *s) {
-    while (*s) {
-        my_putchar(*s++);
+static void hex_pairs_init(void) {
+    const char *digits = "0123456789ABCDEF";
+    const uint16_t probe = 1;
+
+    for (int i = 0; i < 256; i++) {
+        hex_pairs[i][0] = digits[i >> 4];
+        hex_pairs[i][1] = digits[i & 0xF];
     }
+    host_little_endian = (*(const uint8_t *)&probe == 1);
+    hex_pairs_ready = true;
 }
 
-// 辅助函数：获取整数部分的位数
-int get_num_width(uint64_t num, int base) {
-    int width = 0;
-    do {
-        width++;
-        num /= base;
-    } while (num > 0);
-    return width;
+static char *put_spaces(char *p, size_t n) {
+    memset(p, ' ', n);
+    return p + n;
 }
 
-// 辅助函数：处理浮点数
-void print_float(double num, int precision) {
-    // 处理负数
-    if (num < 0) {
-        my_putchar('-');
-        num = -num;
+#if defined(__SSE2__)
+// 16 字节一次转换: 高低半字节各自映射为 '0'-'9'/'A'-'F', 再与空格交错成 "XX  " 单元
+static char *render_cells_sse2(char *p, const uint8_t *row) {
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i ascii0 = _mm_set1_epi8('0');
+    const __m128i alpha = _mm_set1_epi8('A' - '0' - 10);
+    const __m128i spaces = _mm_set1_epi8(' ');
+    __m128i v = _mm_loadu_si128((const __m128i *)row);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+    __m128i lo = _mm_and_si128(v, mask);
+
+    hi = _mm_add_epi8(_mm_add_epi8(hi, ascii0), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), alpha));
+    lo = _mm_add_epi8(_mm_add_epi8(lo, ascii0), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), alpha));
+
+    __m128i pairs0 = _mm_unpacklo_epi8(hi, lo);     // 字节 0-7 的 "XX"
+    __m128i pairs1 = _mm_unpackhi_epi8(hi, lo);     // 字节 8-15
+    _mm_storeu_si128((__m128i *)(p +  0), _mm_unpacklo_epi16(pairs0, spaces));
+    _mm_storeu_si128((__m128i *)(p + 16), _mm_unpackhi_epi16(pairs0, spaces));
+    _mm_storeu_si128((__m128i *)(p + 32), _mm_unpacklo_epi16(pairs1, spaces));
+    _mm_storeu_si128((__m128i *)(p + 48), _mm_unpackhi_epi16(pairs1, spaces));
+    return p + 64;
+}
+
+// 可打印字符 (32-126) 原样输出, 其余为 '.'
+static char *render_ascii_sse2(char *p, const uint8_t *row) {
+    __m128i v = _mm_loadu_si128((const __m128i *)row);
+    // 有符号比较: 0x80-0xFF 为负数, 自然落在范围外
+    __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(31)),
+                                      _mm_cmplt_epi8(v, _mm_set1_epi8(127)));
+    __m128i out = _mm_or_si128(_mm_and_si128(printable, v),
+                               _mm_andnot_si128(printable, _mm_set1_epi8('.')));
+    _mm_storeu_si128((__m128i *)p, out);
+    return p + 16;
+}
+#endif
+
+/*
+ * 把一行 (最多 16 字节) 渲染到 out, 返回长度
+ * 格式与原逐项 xprintf 输出一致: 地址, 按 unit_size 分组的十六进制值 (主机字节序), ASCII
+ * 不足一行时缺少的单元以空格补齐, 保持 ASCII 列对齐
+ */
+static size_t memdis_render_line(char *out, const uint8_t *row, size_t n,
+                                 uint64_t addr, size_t unit_size) {
+    char *p = out;
+
+    // 地址: 0x + 指针宽度的十六进制
+    *p++ = '0';
+    *p++ = 'x';
+    for (int shift = (int)sizeof(void *) * 8 - 8; shift >= 0; shift -= 8) {
+        const char *pair = hex_pairs[(addr >> shift) & 0xFF];
+        *p++ = pair[0];
+        *p++ = pair[1];
     }
-    
-    // 处理整数部分
-    uint64_t int_part = (uint64_t)num;
-    double frac_part = num - int_part;
-    
-    // 打印整数部分
-    if (int_part == 0) {
-        my_putchar('0');
-    } else {
-        char int_buffer[20];
-        int i = 0;
-        while (int_part > 0) {
-            int_buffer[i++] = '0' + (int_part % 10);
-            int_part /= 10;
-        }
-        while (i > 0) {
-            my_putchar(int_buffer[--i]);
-        }
+    p = put_spaces(p, 2);
+
+#if defined(__SSE2__)
+    if (unit_size == 1 && n == MEMDIS_BYTES_PER_LINE) {
+        p = render_cells_sse2(p, row);
+        p = put_spaces(p, 2);
+        p = render_ascii_sse2(p, row);
+        *p++ = '\n';
+        return (size_t)(p - out);
     }
-    
-    // 如果指定了精度，打印小数部分
-    if (precision > 0) {
-        my_putchar('.');
-        
-        // 处理小数部分
-        while (precision > 0) {
-            frac_part *= 10;
-            int digit = (int)frac_part;
-            my_putchar('0' + digit);
-            frac_part -= digit;
-            precision--;
+#endif
+
+    for (size_t i = 0; i < MEMDIS_BYTES_PER_LINE; i += unit_size) {
+        if (i + unit_size <= n) {
+            for (size_t k = 0; k < unit_size; k++) {
+                // 按数值显示: 小端主机从最高地址字节开始
+                size_t idx = host_little_endian ? i + unit_size - 1 - k : i + k;
+                const char *pair = hex_pairs[row[idx]];
+                *p++ = pair[0];
+                *p++ = pair[1];
+            }
+            p = put_spaces(p, cell_pad[unit_size]);
+        } else {
+            p = put_spaces(p, unit_size * 2 + cell_pad[unit_size]);
         }
     }
+
+    p = put_spaces(p, 2);
+    for (size_t i = 0; i < n; i++) {
+        *p++ = (row[i] >= 32 && row[i] <= 126) ? (char)row[i] : '.';
+    }
+    *p++ = '\n';
+    return (size_t)(p - out);
 }
 
-// 辅助函数：解析格式化信息
-format_info parse_format(const char **format) {
-    format_info info = {0, false, ' ', false, 0, 6};  // 默认精度为6
-    
-    // 检查左对齐标志
-    if (**format == '-') {
-        info.left_align = true;
-        (*format)++;
+/*
+ * 显示 data 开始的 length 字节, 地址列从 base_addr 开始编号
+ * 每行渲染到一个缓冲区后调用一次 write
+ */
+void memdisplay_ex(const void *data, size_t length, size_t unit_size, uint64_t base_addr,
+                   unsigned flags, xprintf_write_t write, void *arg) {
+    const uint8_t *mem = (const uint8_t *)data;
+    char line[MEMDIS_LINE_MAX];
+    size_t len;
+    bool squeezing = false;
+
+    if (unit_size != 1 && unit_size != 2 && unit_size != 4 && unit_size != 8) {
+        xformat(write, arg, "Invalid unit_size. Please use 1, 2, 4, or 8.\n");
+        return;
     }
-    
-    // 检查填充字符
-    if (**format == '0') {
-        info.pad_char = '0';
-        (*format)++;
+    if (!hex_pairs_ready) {
+        hex_pairs_init();
     }
-    
-    // 解析宽度
-    while (**format >= '0' && **format <= '9') {
-        info.width = info.width * 10 + (**format - '0');
-        (*format)++;
+
+    // 打印列头
+    len = (size_t)xsnprintf(line, sizeof(line), "%-10s", "Address");
+    for (size_t i = 0; i < MEMDIS_BYTES_PER_LINE; ++i) {
+        len += (size_t)xsnprintf(line + len, sizeof(line) - len, "0x%X ", (unsigned)i);
     }
-    
-    // 解析精度
-    if (**format == '.') {
-        (*format)++;
-        info.precision = 0;
-        while (**format >= '0' && **format <= '9') {
-            info.precision = info.precision * 10 + (**format - '0');
-            (*format)++;
+    write(arg, line, len);
+    write(arg, "  ASCII\n", 8);
+
+    // 打印横线
+    memset(line, '-', 18 + MEMDIS_BYTES_PER_LINE * 5);
+    line[18 + MEMDIS_BYTES_PER_LINE * 5] = '\n';
+    write(arg, line, 18 + MEMDIS_BYTES_PER_LINE * 5 + 1);
+
+    for (size_t off = 0; off < length; off += MEMDIS_BYTES_PER_LINE) {
+        size_t n = length - off;
+        if (n > MEMDIS_BYTES_PER_LINE) {
+            n = MEMDIS_BYTES_PER_LINE;
+        }
+
+        // 与上一行完全相同则折叠, 最后一行总是输出以显示结束地址
+        if ((flags & MEMDIS_SQUEEZE) && off > 0 && n == MEMDIS_BYTES_PER_LINE &&
+            off + n < length && memcmp(mem + off, mem + off - MEMDIS_BYTES_PER_LINE, n) == 0) {
+            if (!squeezing) {
+                write(arg, "*\n", 2);
+                squeezing = true;
+            }
+            continue;
         }
+        squeezing = false;
+
+        len = memdis_render_line(line, mem + off, n, base_addr + off, unit_size);
+        write(arg, line, len);
     }
-    
-    return info;
 }
 
-// 辅助函数：填充字符
-void pad_space(char pad_char, int count) {
-    while (count-- > 0) {
-        my_putchar(pad_char);
-    }
+static void xprintf_sink(void *arg, const char *buf, size_t len) {
+    (void)arg;
+    xprintf_write(buf, len);
 }
 
-// 辅助函数：输出十六进制数
-void print_hex(uint64_t num, int min_digits, bool uppercase) {
-    char hex[16];
-    int i = 0;
-    
-    if (num == 0) {
-        int zeros = min_digits ? min_digits : 1;
-        while (zeros--) my_putchar('0');
-        return;
-    }
-    
-    while (num) {
-        int digit = num & 0xF;
-        hex[i++] = digit < 10 ? '0' + digit : 
-                   (uppercase ? 'A' : 'a') + (digit - 10);
-        num >>= 4;
-    }
-    
-    while (i < min_digits) hex[i++] = '0';
-    
-    while (i--) my_putchar(hex[i]);
+void memdisplay(void *start_addr, size_t length, size_t unit_size) {
+    memdisplay_ex(start_addr, length, unit_size, (uintptr_t)start_addr, 0, xprintf_sink, NULL);
 }
 
-void xprintf(const char *format, ...) {
-    va_list args;
-    va_start(args, format);
-    
-    while (*format) {
-        if (*format == '%') {
-            format++; // 跳过%
-            
-            // 解析格式化信息
-            format_info info = parse_format(&format);
-            
-            switch (*format) {
-                case 'f': {
-                    double num = va_arg(args, double);
-                    // 计算整个数字的长度（包括小数点和小数部分）
-                    char temp_buf[32];
-                    int num_len = snprintf(temp_buf, sizeof(temp_buf), "%.*f", 
-                                         info.precision, num);
-                    
-                    if (!info.left_align) {
-                        pad_space(info.pad_char, info.width - num_len);
-                    }
-                    print_float(num, info.precision);
-                    if (info.left_align) {
-                        pad_space(info.pad_char, info.width - num_len);
-                    }
-                    break;
-                }
-                
-                case 's': {
-                    char *str = va_arg(args, char *);
-                    int len = 0;
-                    char *p = str;
-                    while (*p++) len++;
-                    
-                    if (!info.left_align) {
-                        pad_space(info.pad_char, info.width - len);
-                    }
-                    my_puts(str);
-                    if (info.left_align) {
-                        pad_space(info.pad_char, info.width - len);
-                    }
-                    break;
-                }
-                
-                case 'p': {
-                    void *ptr = va_arg(args, void *);
-                    my_putchar('0');
-                    my_putchar('x');
-                    print_hex((uint64_t)ptr, sizeof(void*) * 2, true);
-                    break;
-                }
-                
-                case 'X':
-                    info.is_uppercase = true;
-                    // fall through
-                case 'x': {
-                    unsigned int num = va_arg(args, unsigned int);
-                    if (info.pad_char == '0' && info.width > 0) {
-                        print_hex(num, info.width, info.is_uppercase);
-                    } else {
-                        int num_width = get_num_width(num, 16);
-                        if (!info.left_align && info.width > num_width) {
-                            pad_space(info.pad_char, info.width - num_width);
-                        }
-                        print_hex(num, 0, info.is_uppercase);
-                        if (info.left_align && info.width > num_width) {
-                            pad_space(info.pad_char, info.width - num_width);
-                        }
-                    }
-                    break;
-                }
-                
-                case 'c': {
-                    char c = (char)va_arg(args, int);
-                    my_putchar(c);
-                    break;
-                }
-                
-                case 'l': {
-                    format++;
-                    if (*format == 'l' && *(format + 1) == 'X') {
-                        format++;
-                        uint64_t num = va_arg(args, uint64_t);
-                        print_hex(num, 16, true);
-                    }
-                    break;
-                }
-                
-                default:
-                    my_putchar('%');
-                    my_putchar(*format);
-                    break;
+/* ============================================================
+ * 二进制导出: 大块内存不做文本转换, 原样发出, 主机端再渲染
+ * [memdump_header_t][数据 length 字节][CRC32 (小端)]
+ * ============================================================ */
+#define MEMDUMP_MAGIC       0x504D444DU     // "MDMP"
+#define MEMDUMP_VERSION     1
+#define MEMDUMP_CHUNK       4096
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t addr;          // 导出区域的起始地址, 主机端显示用
+    uint64_t length;
+} memdump_header_t;
+
+static uint32_t crc32_table[256];
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len) {
+    if (crc32_table[1] == 0) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320U ^ (c >> 1) : c >> 1;
             }
-        } else {
-            my_putchar(*format);
+            crc32_table[i] = c;
         }
-        format++;
     }
-    
-    va_end(args);
+    crc = ~crc;
+    while (len--) {
+        crc = crc32_table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
 }
 
-void memdisplay(void *start_addr, size_t length, size_t unit_size) {
-    if (unit_size != 1 && unit_size != 2 && unit_size != 4 && unit_size != 8) {
-        xprintf("Invalid unit_size. Please use 1, 2, 4, or 8.\n");
-        return;
+void memdump_binary(const void *start_addr, size_t length, xprintf_write_t write, void *arg) {
+    const uint8_t *mem = (const uint8_t *)start_addr;
+    memdump_header_t hdr = { MEMDUMP_MAGIC, MEMDUMP_VERSION, (uintptr_t)start_addr, length };
+    uint32_t crc = 0;
+    uint8_t tail[4];
+
+    write(arg, (const char *)&hdr, sizeof(hdr));
+    for (size_t off = 0; off < length; off += MEMDUMP_CHUNK) {
+        size_t n = (length - off > MEMDUMP_CHUNK) ? MEMDUMP_CHUNK : length - off;
+        crc = crc32_update(crc, mem + off, n);
+        write(arg, (const char *)mem + off, n);
     }
+    tail[0] = (uint8_t)crc;
+    tail[1] = (uint8_t)(crc >> 8);
+    tail[2] = (uint8_t)(crc >> 16);
+    tail[3] = (uint8_t)(crc >> 24);
+    write(arg, (const char *)tail, sizeof(tail));
+}
 
-    size_t bytes_per_line = 16;
-    uint8_t *mem = (uint8_t *)start_addr;
+/* ============================================================
+ * 主机端工具
+ * ============================================================ */
+static uint8_t *load_file(const char *path, size_t *len) {
+    FILE *fp = fopen(path, "rb");
+    uint8_t *buf;
+    long size;
 
-    // 打印列头
-    xprintf("%-10s", "Address");
-    for (size_t i = 0; i < bytes_per_line; ++i) {
-        xprintf("0x%X ", i);
+    if (fp == NULL) {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    buf = (uint8_t *)malloc(size > 0 ? (size_t)size : 1);
+    if (buf == NULL || fread(buf, 1, (size_t)size, fp) != (size_t)size) {
+        free(buf);
+        fclose(fp);
+        return NULL;
     }
-    xprintf("  ASCII\n");
+    fclose(fp);
+    *len = (size_t)size;
+    return buf;
+}
 
-    // 打印横线
-    xprintf("------------------");
-    for (size_t i = 0; i < bytes_per_line; ++i) {
-        xprintf("-----");
+static void file_sink(void *arg, const char *buf, size_t len) {
+    fwrite(buf, 1, len, (FILE *)arg);
+}
+
+// 解析 memdump_binary 的输出, 校验后按原地址折叠显示
+static int decode_capture(const char *path, size_t unit_size) {
+    size_t len;
+    uint8_t *cap = load_file(path, &len);
+    memdump_header_t hdr;
+    int ret = -1;
+
+    if (cap == NULL || len < sizeof(hdr)) {
+        fprintf(stderr, "读取失败: %s\n", path);
+        free(cap);
+        return -1;
     }
-    xprintf("\n");
-
-    size_t addr = 0;
-    while (addr < length) {
-        // 打印行头地址
-        xprintf("%p  ", (void *)(mem + addr));
-
-        // 打印每行的内容
-        for (size_t i = 0; i < bytes_per_line && addr < length; i += unit_size) {
-            switch (unit_size) {
-                case 1:
-                    xprintf("%02X  ", mem[addr + i]);
-                    break;
-                case 2:
-                    xprintf("%04X    ", *((uint16_t *)(mem + addr + i)));
-                    break;
-                case 4:
-                    xprintf("%08X        ", *((uint32_t *)(mem + addr + i)));
-                    break;
-                case 8:
-                    xprintf("%016llX   ", *((uint64_t *)(mem + addr + i)));
-                    break;
-                default:
-                    // 不太可能到达这里，因为上面已经检查了 unit_size 的合法性
-                    break;
-            }
+    memcpy(&hdr, cap, sizeof(hdr));
+    if (hdr.magic != MEMDUMP_MAGIC || hdr.version != MEMDUMP_VERSION ||
+        hdr.length > len - sizeof(hdr) || len - sizeof(hdr) - hdr.length < 4) {
+        fprintf(stderr, "不是有效的导出文件: %s\n", path);
+    } else {
+        const uint8_t *data = cap + sizeof(hdr);
+        const uint8_t *t = data + hdr.length;
+        uint32_t crc = (uint32_t)t[0] | ((uint32_t)t[1] << 8) | ((uint32_t)t[2] << 16) | ((uint32_t)t[3] << 24);
+        if (crc32_update(0, data, (size_t)hdr.length) != crc) {
+            fprintf(stderr, "CRC 校验失败, 数据可能不完整\n");
         }
+        memdisplay_ex(data, (size_t)hdr.length, unit_size, hdr.addr, MEMDIS_SQUEEZE, file_sink, stdout);
+        ret = 0;
+    }
+    free(cap);
+    return ret;
+}
 
-        // 打印ASCII码
-        xprintf("  ");
-        for (size_t i = 0; i < bytes_per_line && addr < length; ++i) {
-            char c = (mem[addr + i] >= 32 && mem[addr + i] <= 126) ? mem[addr + i] : '.';
-            xprintf("%c", c);
+int main(int argc, char *argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "-f") == 0) {
+        // 以折叠方式显示文件内容: main -f <文件> [unit]
+        size_t len;
+        uint8_t *data = load_file(argv[2], &len);
+        if (data == NULL) {
+            fprintf(stderr, "读取失败: %s\n", argv[2]);
+            return 1;
         }
-
-        xprintf("\n");
-        addr += bytes_per_line;
+        memdisplay_ex(data, len, argc > 3 ? (size_t)atoi(argv[3]) : 1, 0, MEMDIS_SQUEEZE, file_sink, stdout);
+        free(data);
+        return 0;
+    }
+    if (argc == 4 && strcmp(argv[1], "-b") == 0) {
+        // 生成二进制导出: main -b <文件> <输出>
+        size_t len;
+        uint8_t *data = load_file(argv[2], &len);
+        FILE *out = fopen(argv[3], "wb");
+        if (data == NULL || out == NULL) {
+            fprintf(stderr, "打开文件失败\n");
+            return 1;
+        }
+        memdump_binary(data, len, file_sink, out);
+        fclose(out);
+        free(data);
+        return 0;
+    }
+    if (argc >= 3 && strcmp(argv[1], "-r") == 0) {
+        // 还原二进制导出: main -r <导出文件> [unit]
+        return decode_capture(argv[2], argc > 3 ? (size_t)atoi(argv[3]) : 1) == 0 ? 0 : 1;
     }
-}
 
-int main() {
-    int arr[256];
     char ch[256];
-    size_t arr_length = sizeof(arr) / sizeof(arr[0]);
 
     for (size_t i = 0; i < 256; i++) {
-        arr[i] = i;
         ch[i] = i;
     }
 
@@ -1,9 +1,24 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
+#include <pthread.h>
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #pragma pack(push, 1)
 
@@ -159,11 +174,13 @@ typedef struct {
 // CRC-CCITT多项式
 #define CRC_POLY 0x1021
 
-// 计算CRC-CCITT校验
-uint16_t crc_ccitt(const uint8_t *data, size_t len) {
-    uint16_t crc = 0x0;
-    for (size_t i = 0; i < len; i++) {
-        crc ^= (uint16_t)data[i] << 8;
+static uint16_t crc_ccitt_table[256];
+static int crc_ccitt_table_ready = 0;
+
+// 构造CRC-CCITT直接查询表 (首次调用 crc_ccitt 时自动构造)
+static void crc_ccitt_build_table(void) {
+    for (int i = 0; i < 256; i++) {
+        uint16_t crc = (uint16_t)(i << 8);
         for (int j = 0; j < 8; j++) {
             if (crc & 0x8000) {
                 crc = (crc << 1) ^ CRC_POLY;
@@ -171,10 +188,81 @@ uint16_t crc_ccitt(const uint8_t *data, size_t len) {
                 crc <<= 1;
             }
         }
+        crc_ccitt_table[i] = crc;
+    }
+    crc_ccitt_table_ready = 1;
+}
+
+// 计算CRC-CCITT校验 (查表法, 每字节一次查表)
+uint16_t crc_ccitt(const uint8_t *data, size_t len) {
+    uint16_t crc = 0x0;
+    if (!crc_ccitt_table_ready) {
+        crc_ccitt_build_table();
+    }
+    for (size_t i = 0; i < len; i++) {
+        crc = (uint16_t)((crc << 8) ^ crc_ccitt_table[(crc >> 8) ^ data[i]]);
     }
     return crc;
 }
 
+// ==========================================
+// 解析输出: 默认直接写 stdout; 多线程解码时每个线程把输出写入自己的内存缓冲,
+// 再由主线程按文件顺序输出
+// ==========================================
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+    int failed;                 // 内存不足
+} OutBuf;
+
+static THREAD_LOCAL OutBuf *g_frame_out = NULL;
+
+static int frame_printf(const char *fmt, ...) {
+    OutBuf *ob = g_frame_out;
+    va_list ap;
+    int n;
+
+    if (ob == NULL) {
+        va_start(ap, fmt);
+        n = vprintf(fmt, ap);
+        va_end(ap);
+        return n;
+    }
+
+    va_start(ap, fmt);
+    n = vsnprintf(ob->data ? ob->data + ob->len : NULL, ob->cap - ob->len, fmt, ap);
+    va_end(ap);
+    if (n < 0) {
+        ob->failed = 1;
+        return n;
+    }
+    if ((size_t)n >= ob->cap - ob->len) {
+        size_t cap = ob->cap ? ob->cap : (64 << 10);
+        while (cap - ob->len <= (size_t)n) {
+            cap *= 2;
+        }
+        char *data = (char *)realloc(ob->data, cap);
+        if (data == NULL) {
+            ob->failed = 1;
+            return -1;
+        }
+        ob->data = data;
+        ob->cap = cap;
+        va_start(ap, fmt);
+        vsnprintf(ob->data + ob->len, ob->cap - ob->len, fmt, ap);
+        va_end(ap);
+    }
+    ob->len += (size_t)n;
+    return n;
+}
+
 // 解析抗干扰状态
 void parse_jam_status(const JamStatus *jam_status) {
     #if 0
@@ -198,11 +286,11 @@ void parse_jam_status(const JamStatus *jam_status) {
          (static_cast<uint32_t>(jam_status->data[5]) >> 3)) & 0x7F;
 
     // 打印解析结果
-    printf("抗干扰状态:\n");
-    printf("  处理状态: %s\n", (jam_status->data[0] & 0x01) ? "启用" : "默认");
-    printf("  受干扰: %s\n", (jam_status->data[0] & 0x02) ? "是" : "否");
-    printf("  干扰源数量: %d\n", (jam_status->data[0] >> 2) & 0x07);
-    printf("  干扰强度: %.0fdB, %.0fdB, %.0fdB, %.0fdB, %.0fdB, %.0fdB\n",
+    frame_printf("抗干扰状态:\n");
+    frame_printf("  处理状态: %s\n", (jam_status->data[0] & 0x01) ? "启用" : "默认");
+    frame_printf("  受干扰: %s\n", (jam_status->data[0] & 0x02) ? "是" : "否");
+    frame_printf("  干扰源数量: %d\n", (jam_status->data[0] >> 2) & 0x07);
+    frame_printf("  干扰强度: %.0fdB, %.0fdB, %.0fdB, %.0fdB, %.0fdB, %.0fdB\n",
            jam_strength1, jam_strength2, jam_strength3,
            jam_strength4, jam_strength5, jam_strength6);
     #endif
@@ -212,7 +300,7 @@ void parse_jam_status(const JamStatus *jam_status) {
 void parse_and_print(SatellitePositionInfo *frame) {
     // 基础信息验证
     if (frame->header1 != 0x55 || frame->header2 != 0xAA || (frame->info_flag != 0x36 && frame->info_flag != 0x35)) {
-        printf("无效帧头: %02X %02X %02X\n", frame->header1, frame->header2, frame->info_flag);
+        frame_printf("无效帧头: %02X %02X %02X\n", frame->header1, frame->header2, frame->info_flag);
         return;
     }
     
@@ -228,11 +316,11 @@ void parse_and_print(SatellitePositionInfo *frame) {
     uint16_t frame_crc = crc_value;
     
     if (calc_crc != frame_crc) {
-        printf("CRC校验失败: 计算值 %04X vs 帧值 %04X\n", calc_crc, frame_crc);
+        frame_printf("CRC校验失败: 计算值 %04X vs 帧值 %04X\n", calc_crc, frame_crc);
         return;
     }
     
-    printf("\n============ 卫星定位信息 ============\n");
+    frame_printf("\n============ 卫星定位信息 ============\n");
     
     // 基础定位信息
     uint16_t date = frame->date_ymd;
@@ -240,37 +328,37 @@ void parse_and_print(SatellitePositionInfo *frame) {
     int month = (date >> 5) & 0x0F;
     int day = date & 0x1F;
     
-    printf("时间: %04d-%02d-%02d %uus\n", year, month, day, frame->time_24h * 40);
-    printf("定位状态: %s\n", frame->pos_flag ? "已定位" : "未定位");
-    printf("位置: 经度 %.6f°, 纬度 %.6f°, 高度 %.2fm\n", 
+    frame_printf("时间: %04d-%02d-%02d %uus\n", year, month, day, frame->time_24h * 40);
+    frame_printf("定位状态: %s\n", frame->pos_flag ? "已定位" : "未定位");
+    frame_printf("位置: 经度 %.6f°, 纬度 %.6f°, 高度 %.2fm\n", 
            (double)frame->longitude * 0.00000001 * (180.0 / M_PI),
            (double)frame->latitude * 0.00000001 * (180.0 / M_PI),
            (double)frame->height * 0.01);
-    printf("速度: 东向 %.2fm/s, 北向 %.2fm/s, 天向 %.2fm/s\n",
+    frame_printf("速度: 东向 %.2fm/s, 北向 %.2fm/s, 天向 %.2fm/s\n",
            (double)frame->velocity_e * 0.01,
            (double)frame->velocity_n * 0.01,
            (double)frame->velocity_u * 0.01);
     
     // 北斗信息
-    printf("北斗周数: %u, 周秒: %.3fs\n", frame->bd_week, frame->bd_week_ms / 1000.0);
+    frame_printf("北斗周数: %u, 周秒: %.3fs\n", frame->bd_week, frame->bd_week_ms / 1000.0);
     
     // 卫星状态
-    printf("卫星: 可视%d颗, 可用%d颗, PDOP: %.2f\n", 
+    frame_printf("卫星: 可视%d颗, 可用%d颗, PDOP: %.2f\n", 
            frame->vin, frame->van, frame->pdop * 0.01);
     
     // 状态信息
-    printf("状态信息:\n");
-    printf("  毁钥状态: %d\n", frame->destroy_key);
-    printf("  工作状态: %s\n", frame->pen ? "军码" : "民码");
-    printf("  自检状态: %s\n", 
+    frame_printf("状态信息:\n");
+    frame_printf("  毁钥状态: %d\n", frame->destroy_key);
+    frame_printf("  工作状态: %s\n", frame->pen ? "军码" : "民码");
+    frame_printf("  自检状态: %s\n", 
            frame->status.self_test_status == 1 ? "成功" : 
            frame->status.self_test_status == 3 ? "失败" : "默认");
-    printf("  定位模式: %d\n", frame->status.pos_mode);
-    printf("  定位情况: %s\n", frame->status.pos_status == 0 ? "定位" : "未定位");
-    printf("  天线状态: %s\n", 
+    frame_printf("  定位模式: %d\n", frame->status.pos_mode);
+    frame_printf("  定位情况: %s\n", frame->status.pos_status == 0 ? "定位" : "未定位");
+    frame_printf("  天线状态: %s\n", 
            frame->status.ant_status == 1 ? "机载天线" : 
            frame->status.ant_status == 2 ? "弹载天线" : "默认");
-    printf("  天线模式: %s\n", frame->ant_mode ? "直通模式" : "抗干扰模式");
+    frame_printf("  天线模式: %s\n", frame->ant_mode ? "直通模式" : "抗干扰模式");
     
     // 抗干扰状态
     parse_jam_status(&frame->jam_status);
@@ -284,24 +372,24 @@ void parse_and_print(SatellitePositionInfo *frame) {
             break;
         }
     }
-    printf("\n卫星详细信息(%d颗):\n", sat_valid);
+    frame_printf("\n卫星详细信息(%d颗):\n", sat_valid);
     for (int i = 0; i < 16; i++) {
         SatelliteInfo *sat = &frame->sats[i];
         if(sat->prn == 0)
             continue;
-        printf("卫星 %d:\n", i + 1);
-        printf("  PRN: %d, 参与定位: %s, 信噪比: %ddB\n", 
+        frame_printf("卫星 %d:\n", i + 1);
+        frame_printf("  PRN: %d, 参与定位: %s, 信噪比: %ddB\n", 
                sat->prn, sat->participate ? "是" : "否", sat->snr);
-        printf("  仰角: %d°, 方位角: %d°\n", sat->elevation, sat->azimuth);
-        printf("  伪距: %.1fm, 伪距率: %.4fm/s\n", 
+        frame_printf("  仰角: %d°, 方位角: %d°\n", sat->elevation, sat->azimuth);
+        frame_printf("  伪距: %.1fm, 伪距率: %.4fm/s\n", 
                sat->pseudorange * 0.1, sat->pseudorange_rate * 0.01);
-        printf("  位置: (%.2fm, %.2fm, %.2fm)\n", 
+        frame_printf("  位置: (%.2fm, %.2fm, %.2fm)\n", 
                sat->pos_x * 0.05, sat->pos_y * 0.05, sat->pos_z * 0.05);
-        printf("  速度: (%.5fm/s, %.5fm/s, %.5fm/s)\n", 
+        frame_printf("  速度: (%.5fm/s, %.5fm/s, %.5fm/s)\n", 
                sat->vel_x * 0.001, sat->vel_y * 0.001, sat->vel_z * 0.001);
     }
     
-    printf("======================================\n");
+    frame_printf("======================================\n");
 }
 
 // 解析抗干扰状态
@@ -321,11 +409,11 @@ void parse_anti_status(const uint8_t anti_status[6]) {
     uint8_t jam_strength6 = (anti_status[2] >> 4) & 0x07;
     
     // 打印解析结果
-    printf("抗干扰状态:\n");
-    printf("  处理状态: %s\n", proc_status ? "启用" : "默认");
-    printf("  受干扰: %s\n", jam_present ? "是" : "否");
-    printf("  干扰源数量: %d\n", jam_count);
-    printf("  干扰强度: [%d] %.0fdB, [%d] %.0fdB, [%d] %.0fdB, [%d] %.0fdB, [%d] %.0fdB, [%d] %.0fdB\n", 
+    frame_printf("抗干扰状态:\n");
+    frame_printf("  处理状态: %s\n", proc_status ? "启用" : "默认");
+    frame_printf("  受干扰: %s\n", jam_present ? "是" : "否");
+    frame_printf("  干扰源数量: %d\n", jam_count);
+    frame_printf("  干扰强度: [%d] %.0fdB, [%d] %.0fdB, [%d] %.0fdB, [%d] %.0fdB, [%d] %.0fdB, [%d] %.0fdB\n", 
            1, jam_strength1 * 10, 
            2, jam_strength2 * 10,
            3, jam_strength3 * 10,
@@ -340,7 +428,7 @@ void parse_anti_status(const uint8_t anti_status[6]) {
 void parse_and_print_0x35(T_AJRSatellitePositionInfo_Telemetry *frame) {
     // 基础信息验证
     if (frame->header1 != 0x55 || frame->header2 != 0xAA || frame->info_flag != 0x35) {
-        printf("无效帧头或协议标识: %02X %02X %02X\n", 
+        frame_printf("无效帧头或协议标识: %02X %02X %02X\n", 
                frame->header1, frame->header2, frame->info_flag);
         return;
     }
@@ -368,7 +456,7 @@ void parse_and_print_0x35(T_AJRSatellitePositionInfo_Telemetry *frame) {
     
     // 修正卫星数量错误
     if (sat_count > 16) {
-        printf("警告: 可视卫星数(%d)超过最大值(16)，已修正为16\n", sat_count);
+        frame_printf("警告: 可视卫星数(%d)超过最大值(16)，已修正为16\n", sat_count);
         sat_count = 16;
     }
     
@@ -377,63 +465,63 @@ void parse_and_print_0x35(T_AJRSatellitePositionInfo_Telemetry *frame) {
     uint8_t *frame_ptr = (uint8_t*)&frame->data_length;
     uint16_t frame_crc = (*(uint16_t*)((uint8_t*)frame + total_size - 2));
     
-    printf("total_size %d\r\n",total_size);
-    printf("fixed_size %d\r\n",fixed_size);
+    frame_printf("total_size %d\r\n",total_size);
+    frame_printf("fixed_size %d\r\n",fixed_size);
     // 计算CRC校验 (从帧头到RAIM之前)
     uint16_t calc_crc = crc_ccitt("Hello", 5);
 
-    printf("HelloCrc 0x%x\r\n",calc_crc);
+    frame_printf("HelloCrc 0x%x\r\n",calc_crc);
     calc_crc = crc_ccitt(frame_ptr, total_size - 4);
     
     if (calc_crc != frame_crc) {
-        printf("CRC校验失败: 计算值 %04X vs 帧值 %04X\n", calc_crc, frame_crc);
+        frame_printf("CRC校验失败: 计算值 %04X vs 帧值 %04X\n", calc_crc, frame_crc);
         return;
     }
     
-    printf("\n============ 0x35协议 - 卫星定位信息 ============\n");
+    frame_printf("\n============ 0x35协议 - 卫星定位信息 ============\n");
     
     // 基础定位信息
-    printf("时间: 北斗周数 %u, 周秒 %.3fs\n", 
+    frame_printf("时间: 北斗周数 %u, 周秒 %.3fs\n", 
            frame->weeknum, frame->secondofweek / 1000.0);
-    printf("定位状态: %s\n", frame->pos_flag ? "已定位" : "未定位");
+    frame_printf("定位状态: %s\n", frame->pos_flag ? "已定位" : "未定位");
     
     // 经纬度转换 (原始单位为弧度, LSB=1e-8)
     double lon_deg = (double)frame->longitude * (180.0 / (M_PI * 1e8));
     double lat_deg = (double)frame->latitude * (180.0 / (M_PI * 1e8));
     
-    printf("位置: 经度 %.8f°, 纬度 %.8f°, 高度 %.2fm\n", 
+    frame_printf("位置: 经度 %.8f°, 纬度 %.8f°, 高度 %.2fm\n", 
            lon_deg, lat_deg, (double)frame->height * 0.01);
-    printf("速度: 东向 %.2fm/s, 北向 %.2fm/s, 天向 %.2fm/s\n",
+    frame_printf("速度: 东向 %.2fm/s, 北向 %.2fm/s, 天向 %.2fm/s\n",
            (double)frame->velocity_e * 0.01,
            (double)frame->velocity_n * 0.01,
            (double)frame->velocity_u * 0.01);
     
     // 精度信息
-    printf("精度指标: PDOP: %.2f, 位置残差: %.1f, 速度残差: %.1f\n", 
+    frame_printf("精度指标: PDOP: %.2f, 位置残差: %.1f, 速度残差: %.1f\n", 
            frame->pdop * 0.01, 
            (double)frame->posiResidual, 
            (double)frame->veloResidual);
     
     // 时钟信息
-    printf("时钟: 钟差 %.1fns, 钟漂 %.1fns/s\n",
+    frame_printf("时钟: 钟差 %.1fns, 钟漂 %.1fns/s\n",
            (double)frame->clockCorrection * 0.1,
            (double)frame->clockBias * 0.1);
     
     // 卫星状态
-    printf("卫星: 可视%d颗, 可用%d颗\n", frame->vin, frame->van);
+    frame_printf("卫星: 可视%d颗, 可用%d颗\n", frame->vin, frame->van);
     
     // 状态信息
-    printf("状态信息:\n");
-    printf("  工作模式: %s\n", frame->civiliFlag ? "军码" : "民码");
-    printf("  自检状态: %s\n", 
+    frame_printf("状态信息:\n");
+    frame_printf("  工作模式: %s\n", frame->civiliFlag ? "军码" : "民码");
+    frame_printf("  自检状态: %s\n", 
            frame->status.self_test_status == 1 ? "成功" : 
            frame->status.self_test_status == 3 ? "失败" : "默认");
-    printf("  定位模式: %d (0=B3I,1=B1I,2=GPS)\n", frame->status.pos_mode);
-    printf("  定位情况: %s\n", frame->status.pos_status == 0 ? "定位" : "未定位");
-    printf("  天线状态: %s\n", 
+    frame_printf("  定位模式: %d (0=B3I,1=B1I,2=GPS)\n", frame->status.pos_mode);
+    frame_printf("  定位情况: %s\n", frame->status.pos_status == 0 ? "定位" : "未定位");
+    frame_printf("  天线状态: %s\n", 
            frame->status.ant_status == 1 ? "机载天线" : 
            frame->status.ant_status == 2 ? "弹载天线" : "默认");
-    printf("  天线模式: %s\n", frame->ant_mode ? "直通模式" : "抗干扰模式");
+    frame_printf("  天线模式: %s\n", frame->ant_mode ? "直通模式" : "抗干扰模式");
     
     // 抗干扰状态
     parse_anti_status(frame->anti_status);
@@ -449,7 +537,7 @@ void parse_and_print_0x35(T_AJRSatellitePositionInfo_Telemetry *frame) {
         }
 
     }
-    printf("\n卫星详细信息(%d颗):\n", sat_valid);
+    frame_printf("\n卫星详细信息(%d颗):\n", sat_valid);
     for (int i = 0; i < sat_valid; i++) {
         T_AJRSatelliteInfo_Telemetry *sat = &frame->sats[i];
         
@@ -458,152 +546,965 @@ void parse_and_print_0x35(T_AJRSatellitePositionInfo_Telemetry *frame) {
         // sat->pseudorange = ntohl(sat->pseudorange);
         // sat->pseudorange_rate = ntohl(sat->pseudorange_rate);
         
-        printf("卫星 %d: PRN=%d, 参与定位=%s\n", 
+        frame_printf("卫星 %d: PRN=%d, 参与定位=%s\n", 
                i + 1, sat->prn, sat->participate ? "是" : "否");
-        printf("  信噪比: %ddB, 仰角: %d°, 方位角: %d°\n", 
+        frame_printf("  信噪比: %ddB, 仰角: %d°, 方位角: %d°\n", 
                sat->snr, sat->elevation, sat->azimuth);
-        printf("  伪距: %.1fm, 伪距率: %.4fm/s\n", 
+        frame_printf("  伪距: %.1fm, 伪距率: %.4fm/s\n", 
                sat->pseudorange * 0.1, sat->pseudorange_rate * 0.01);
     }
     
     // 解析RAIM故障卫星
-    printf("\nRAIM故障卫星: ");
+    frame_printf("\nRAIM故障卫星: ");
     for (int i = 0; i < 6; i++) {
         if (frame->raim_fault_stalite[i] != 0) {
-            printf("%d ", frame->raim_fault_stalite[i]);
+            frame_printf("%d ", frame->raim_fault_stalite[i]);
         }
     }
-    printf("\n");
+    frame_printf("\n");
     
-    printf("=================================================\n");
+    frame_printf("=================================================\n");
 }
 
 
-int main(int argc, char *argv[]) {
-    if (argc != 3) {
-        printf("用法: %s <二进制文件> 0x36\n", argv[0]);
-        printf("示例: %s data.bin 0x36\n", argv[0]);
-        return 1;
+// ==========================================
+// 流式解码: 分段映射文件 + memchr 搜索帧头
+// 单遍解码所有已注册的帧类型, 内存占用与文件大小无关
+// 通用帧格式: 55 AA | data_length(2) | info_flag | ... | CRC(2)
+//            帧长 = 4 + data_length + 2, CRC 覆盖 data_length 起的 data_length + 2 字节
+// ==========================================
+#define FRAME_SYNC1         0x55
+#define FRAME_SYNC2         0xAA
+#define FRAME_HEAD_LEN      5                   // 帧头(2) + data_length(2) + info_flag(1)
+#define FRAME_MAX_LEN       (4 + 0xFFFF + 2)
+#define MAP_WINDOW_SIZE     (16UL << 20)        // 每次映射 16MB (+ 一帧最大长度的重叠区)
+
+typedef void (*FrameHandler)(const uint8_t *frame, size_t frame_len);
+
+typedef struct {
+    uint8_t info_flag;          // 帧类型
+    size_t min_len;             // 解析函数按结构体访问的最大范围, 短帧补零后再交给解析函数
+    FrameHandler handler;
+    const char *name;
+} FrameDecoder;
+
+typedef struct {
+    uint64_t frames;            // 校验通过并输出的帧
+    uint64_t skipped;           // 校验通过但被类型过滤的帧
+    uint64_t crc_errors;        // 帧头匹配但 CRC 错误 (按伪帧头处理, 前进 1 字节重新同步)
+    uint64_t per_type[256];
+} DecodeStats;
+
+static const FrameDecoder *g_frame_decoders[256];
+
+// 注册帧解码器, 同一 info_flag 重复注册时后者覆盖前者
+int register_frame_decoder(const FrameDecoder *dec) {
+    if (dec == NULL || dec->handler == NULL) {
+        return -1;
     }
-    
-    // 打开二进制文件
-    FILE *file = fopen(argv[1], "rb");
-    if (!file) {
-        perror("打开文件失败");
-        return 1;
+    g_frame_decoders[dec->info_flag] = dec;
+    return 0;
+}
+
+static void handle_frame_0x36(const uint8_t *frame, size_t frame_len) {
+    (void)frame_len;
+    parse_and_print((SatellitePositionInfo *)frame);
+}
+
+static void handle_frame_0x35(const uint8_t *frame, size_t frame_len) {
+    (void)frame_len;
+    parse_and_print_0x35((T_AJRSatellitePositionInfo_Telemetry *)frame);
+}
+
+static const FrameDecoder g_decoder_0x36 = {
+    0x36, offsetof(SatellitePositionInfo, sats) + 16 * sizeof(SatelliteInfo),
+    handle_frame_0x36, "卫星定位信息"
+};
+static const FrameDecoder g_decoder_0x35 = {
+    0x35, sizeof(T_AJRSatellitePositionInfo_Telemetry),
+    handle_frame_0x35, "遥测信息"
+};
+
+// ---------- 文件分段映射 ----------
+typedef struct {
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+    uint64_t file_size;
+    uint64_t granularity;       // 映射起点对齐粒度
+} MappedFile;
+
+typedef struct {
+    void *addr;
+    size_t len;
+} MappedView;
+
+static int mapped_open(MappedFile *mf, const char *path) {
+    memset(mf, 0, sizeof(*mf));
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    LARGE_INTEGER size;
+
+    mf->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (mf->file == INVALID_HANDLE_VALUE) {
+        return -1;
     }
-    
-    // 获取文件大小
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    
-    if (file_size <= 0) {
-        printf("文件为空\n");
-        fclose(file);
-        return 1;
+    if (!GetFileSizeEx(mf->file, &size)) {
+        CloseHandle(mf->file);
+        return -1;
     }
-    
-    // 读取文件内容
-    uint8_t *buffer = (uint8_t*)malloc(file_size);
-    if (!buffer) {
-        perror("内存分配失败");
-        fclose(file);
-        return 1;
+    mf->file_size = (uint64_t)size.QuadPart;
+    if (mf->file_size > 0) {
+        mf->mapping = CreateFileMappingA(mf->file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mf->mapping == NULL) {
+            CloseHandle(mf->file);
+            return -1;
+        }
     }
-    
-    size_t bytes_read = fread(buffer, 1, file_size, file);
-    fclose(file);
-    
-    if (bytes_read != (size_t)file_size) {
-        printf("文件读取不完整\n");
-        free(buffer);
-        return 1;
+    GetSystemInfo(&si);
+    mf->granularity = si.dwAllocationGranularity;
+#else
+    struct stat st;
+
+    mf->fd = open(path, O_RDONLY);
+    if (mf->fd < 0) {
+        return -1;
     }
+    if (fstat(mf->fd, &st) != 0) {
+        close(mf->fd);
+        return -1;
+    }
+    mf->file_size = (uint64_t)st.st_size;
+    mf->granularity = (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+    return 0;
+}
 
-    printf(" cmd type 0x%x\r\n",atoi(argv[2]));
-    
-    uint16_t crc16 = crc_ccitt("Hello",strlen("Hello"));
+static void mapped_unmap(MappedView *view) {
+    if (view->addr == NULL) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(view->addr);
+#else
+    munmap(view->addr, view->len);
+#endif
+    view->addr = NULL;
+    view->len = 0;
+}
 
-    printf("HelloCrc : 0x%x\r\n",crc16);
-    uint8_t hex_cmd = atoi(argv[2]);
-    // 处理数据帧
-    long offset = 0;
-    int frame_count = 0;
-    const size_t min_frame_size = sizeof(SatellitePositionInfo);
-    
-    while (offset < file_size - min_frame_size) {
-        switch (hex_cmd)
-        {
-        case 0x36:
-            // 搜索帧头
-            if (buffer[offset] == 0x55 && buffer[offset + 1] == 0xAA && buffer[offset+4] == 0x36) {
-                SatellitePositionInfo *frame = (SatellitePositionInfo*)(buffer + offset);
-                
-                // 获取数据长度
-                uint16_t data_length = frame->data_length;
-                
-                // 计算完整帧大小 (帧头2字节 + 数据长度2字节 + 有效数据长度 + CRC2字节)
-                size_t frame_size = 4 + data_length + 2;
-                
-                printf("data_length 0x%x frame_size 0x%x\n",data_length,frame_size);
-                printf("visual_sat %d\r\n",frame->vin);
-                printf("used_sat %d\r\n",frame->van);
-                // 检查帧完整性
-                if (offset + frame_size > file_size) {
-                    printf("文件结尾，数据不完整\n");
-                    break;
-                }
-                
-                // 解析并打印帧
-                parse_and_print(frame);
-                
-                // 更新位置指针
-                offset += frame_size;
-                frame_count++;
-            }
-            else {
-                offset++;
+// 映射 [offset, offset + len), offset 必须按 granularity 对齐; view 中的旧映射自动解除
+// 同一个 MappedFile 可以在多个线程中各自持有视图
+static const uint8_t *mapped_view(MappedFile *mf, MappedView *view, uint64_t offset, size_t len) {
+    mapped_unmap(view);
+#ifdef _WIN32
+    view->addr = MapViewOfFile(mf->mapping, FILE_MAP_READ,
+                               (DWORD)(offset >> 32), (DWORD)(offset & 0xFFFFFFFFu), len);
+    if (view->addr == NULL) {
+        return NULL;
+    }
+#else
+    view->addr = mmap(NULL, len, PROT_READ, MAP_PRIVATE, mf->fd, (off_t)offset);
+    if (view->addr == MAP_FAILED) {
+        view->addr = NULL;
+        return NULL;
+    }
+    posix_madvise(view->addr, len, POSIX_MADV_SEQUENTIAL);
+#endif
+    view->len = len;
+    return (const uint8_t *)view->addr;
+}
+
+static void mapped_close(MappedFile *mf) {
+#ifdef _WIN32
+    if (mf->mapping != NULL) {
+        CloseHandle(mf->mapping);
+    }
+    CloseHandle(mf->file);
+#else
+    close(mf->fd);
+#endif
+}
+
+// ---------- 帧扫描 ----------
+#define NO_FRAME UINT64_MAX
+
+typedef struct {
+    int type_filter;            // < 0 表示输出所有已注册类型
+    DecodeStats *stats;
+    uint8_t *pad_frame;         // 短帧补零缓冲, 每个线程一份
+    uint64_t first_frame;       // 本次扫描第一个校验通过帧的绝对偏移, 用于块边界核对
+} ScanCtx;
+
+// 在 buf[pos, scan_end) 内查找帧起点, 帧体可延伸到 buf_len; 返回停止扫描的位置
+// base 为 buf[0] 在文件中的绝对偏移
+static size_t scan_frames(ScanCtx *ctx, const uint8_t *buf, uint64_t base,
+                          size_t pos, size_t scan_end, size_t buf_len) {
+    DecodeStats *stats = ctx->stats;
+
+    while (pos < scan_end) {
+        const uint8_t *p = (const uint8_t *)memchr(buf + pos, FRAME_SYNC1, scan_end - pos);
+        if (p == NULL) {
+            return scan_end;
+        }
+        pos = (size_t)(p - buf);
+        if (pos + FRAME_HEAD_LEN > buf_len) {
+            return scan_end;    // 文件末尾残帧
+        }
+        if (p[1] != FRAME_SYNC2) {
+            pos++;
+            continue;
+        }
+
+        const FrameDecoder *dec = g_frame_decoders[p[4]];
+        size_t data_length = (size_t)p[2] | ((size_t)p[3] << 8);
+        size_t frame_len = 4 + data_length + 2;
+        if (dec == NULL || pos + frame_len > buf_len) {
+            pos++;
+            continue;
+        }
+
+        uint16_t frame_crc = (uint16_t)(p[frame_len - 2] | (p[frame_len - 1] << 8));
+        if (crc_ccitt(p + 2, data_length + 2) != frame_crc) {
+            stats->crc_errors++;
+            pos++;
+            continue;
+        }
+
+        if (ctx->first_frame == NO_FRAME) {
+            ctx->first_frame = base + pos;
+        }
+        if (ctx->type_filter >= 0 && p[4] != ctx->type_filter) {
+            stats->skipped++;
+        } else if (frame_len >= dec->min_len) {
+            dec->handler(p, frame_len);     // 直接使用映射区数据, 无拷贝
+            stats->frames++;
+            stats->per_type[p[4]]++;
+        } else {
+            memcpy(ctx->pad_frame, p, frame_len);
+            memset(ctx->pad_frame + frame_len, 0, dec->min_len - frame_len);
+            dec->handler(ctx->pad_frame, frame_len);
+            stats->frames++;
+            stats->per_type[p[4]]++;
+        }
+        pos += frame_len;
+    }
+    return pos;
+}
+
+#define PAD_FRAME_SIZE (FRAME_MAX_LEN + sizeof(T_AJRSatellitePositionInfo_Telemetry))
+
+// 顺序扫描 [start, end) 内起始的帧, 返回停止位置 (可能越过 end, 最后一帧完整处理)
+static uint64_t decode_range(MappedFile *mf, ScanCtx *ctx, uint64_t start, uint64_t end) {
+    MappedView view = {NULL, 0};
+    uint64_t next = start;     // 下一次扫描的绝对起点
+
+    while (next < end) {
+        uint64_t base = next - next % mf->granularity;
+        uint64_t body = (end - base > MAP_WINDOW_SIZE) ? MAP_WINDOW_SIZE : end - base;
+        uint64_t remain = mf->file_size - base;
+        // 帧起点只在窗口主体内搜索, 重叠区保证窗口末尾的帧完整可见
+        size_t view_len = (remain > body + FRAME_MAX_LEN) ?
+                          (size_t)(body + FRAME_MAX_LEN) : (size_t)remain;
+        size_t scan_end = (body < view_len) ? (size_t)body : view_len;
+
+        const uint8_t *buf = mapped_view(mf, &view, base, view_len);
+        if (buf == NULL) {
+            return NO_FRAME;
+        }
+        next = base + scan_frames(ctx, buf, base, (size_t)(next - base), scan_end, view_len);
+    }
+
+    mapped_unmap(&view);
+    return next;
+}
+
+// 逐窗口映射整个文件并解码, 输出直接写 stdout
+int decode_capture_file(const char *path, int type_filter, DecodeStats *stats) {
+    MappedFile mf;
+    ScanCtx ctx;
+    uint64_t stop;
+
+    memset(stats, 0, sizeof(*stats));
+    if (mapped_open(&mf, path) != 0) {
+        return -1;
+    }
+
+    ctx.type_filter = type_filter;
+    ctx.stats = stats;
+    ctx.first_frame = NO_FRAME;
+    ctx.pad_frame = (uint8_t *)malloc(PAD_FRAME_SIZE);
+    if (ctx.pad_frame == NULL) {
+        mapped_close(&mf);
+        return -1;
+    }
+
+    stop = decode_range(&mf, &ctx, 0, mf.file_size);
+
+    free(ctx.pad_frame);
+    mapped_close(&mf);
+    return (stop == NO_FRAME) ? -1 : 0;
+}
+
+// ==========================================
+// 多线程分块解码
+// 文件按 PARALLEL_CHUNK_SIZE 切块, 工作线程各自从块起点重新同步到第一个 CRC 通过的帧,
+// 解码输出写入本块的内存缓冲; 主线程按文件顺序核对块边界并输出.
+// 若上一块最后一帧越过边界, 而本块在该帧内部同步到了伪帧 (first_frame < 上一块停止位置),
+// 主线程从上一块停止位置重新顺序解码本块, 保证结果与单线程完全一致.
+// 块边界附近的伪帧头 CRC 错误可能被重复计数, 仅影响统计.
+// ==========================================
+#define PARALLEL_CHUNK_SIZE (4UL << 20)
+#define MAX_DECODE_THREADS  64
+
+typedef struct {
+    int state;                  // 0-空闲 1-解码中 2-完成
+    uint64_t index;             // 块序号
+    uint64_t first_frame;
+    uint64_t stop;
+    DecodeStats stats;
+    OutBuf out;
+} ChunkResult;
+
+typedef struct {
+    MappedFile *mf;
+    int type_filter;
+    uint64_t chunk_count;
+    uint64_t next_chunk;        // 下一个待领取的块
+    uint64_t emitted;           // 已输出的块数, 限制工作线程领先的距离
+    int slot_count;
+    ChunkResult *slots;         // 环形结果槽, 块 i 使用 slots[i % slot_count]
+    int failed;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} ParallelDecoder;
+
+static void decode_stats_merge(DecodeStats *dst, const DecodeStats *src) {
+    dst->frames += src->frames;
+    dst->skipped += src->skipped;
+    dst->crc_errors += src->crc_errors;
+    for (int t = 0; t < 256; t++) {
+        dst->per_type[t] += src->per_type[t];
+    }
+}
+
+static void *parallel_worker(void *arg) {
+    ParallelDecoder *pd = (ParallelDecoder *)arg;
+    uint8_t *pad_frame = (uint8_t *)malloc(PAD_FRAME_SIZE);
+
+    for (;;) {
+        pthread_mutex_lock(&pd->lock);
+        while (pd->next_chunk < pd->chunk_count &&
+               pd->next_chunk >= pd->emitted + (uint64_t)pd->slot_count) {
+            pthread_cond_wait(&pd->cond, &pd->lock);
+        }
+        if (pd->next_chunk >= pd->chunk_count || pad_frame == NULL) {
+            if (pad_frame == NULL) {
+                pd->failed = 1;
+                pthread_cond_broadcast(&pd->cond);
             }
+            pthread_mutex_unlock(&pd->lock);
             break;
-        case 0x35:
-            if (buffer[offset] == 0x55 && buffer[offset + 1] == 0xAA && buffer[offset+4] == 0x35) {
-                T_AJRSatellitePositionInfo_Telemetry *frame = 
-                    (T_AJRSatellitePositionInfo_Telemetry*)(buffer + offset);
-                
-                // 计算最小帧大小
-                size_t frame_size = sizeof(T_AJRSatellitePositionInfo_Telemetry);
-                
-                // // 检查帧完整性
-                // if (offset + frame_size > file_size) {
-                //     printf("文件结尾，数据不完整\n");
-                //     break;
-                // }
-                
-                // 解析并打印帧
-                parse_and_print_0x35(frame);
-                
-                // 更新位置指针 (按最大帧大小前进)
-                offset += sizeof(T_AJRSatellitePositionInfo_Telemetry);
-                frame_count++;
-            } else {
-                offset++;
-            }
+        }
+        uint64_t index = pd->next_chunk++;
+        ChunkResult *res = &pd->slots[index % pd->slot_count];
+        res->state = 1;
+        res->index = index;
+        pthread_mutex_unlock(&pd->lock);
+
+        uint64_t start = index * PARALLEL_CHUNK_SIZE;
+        uint64_t end = start + PARALLEL_CHUNK_SIZE;
+        ScanCtx ctx;
+
+        if (end > pd->mf->file_size) {
+            end = pd->mf->file_size;
+        }
+        memset(&res->stats, 0, sizeof(res->stats));
+        res->out.len = 0;
+        ctx.type_filter = pd->type_filter;
+        ctx.stats = &res->stats;
+        ctx.pad_frame = pad_frame;
+        ctx.first_frame = NO_FRAME;
+
+        g_frame_out = &res->out;
+        res->stop = decode_range(pd->mf, &ctx, start, end);
+        g_frame_out = NULL;
+        res->first_frame = ctx.first_frame;
+
+        pthread_mutex_lock(&pd->lock);
+        if (res->stop == NO_FRAME || res->out.failed) {
+            pd->failed = 1;
+        }
+        res->state = 2;
+        pthread_cond_broadcast(&pd->cond);
+        pthread_mutex_unlock(&pd->lock);
+    }
+
+    free(pad_frame);
+    return NULL;
+}
+
+// 多线程解码整个文件, 输出按文件顺序写入 out (NULL 表示丢弃, 用于测速)
+int decode_capture_parallel(const char *path, int type_filter, int threads,
+                            FILE *out, DecodeStats *stats) {
+    MappedFile mf;
+    ParallelDecoder pd;
+    pthread_t tids[MAX_DECODE_THREADS];
+    uint64_t prev_stop = 0;
+    int started = 0;
+
+    memset(stats, 0, sizeof(*stats));
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (threads > MAX_DECODE_THREADS) {
+        threads = MAX_DECODE_THREADS;
+    }
+    if (mapped_open(&mf, path) != 0) {
+        return -1;
+    }
+    if (!crc_ccitt_table_ready) {
+        crc_ccitt_build_table();    // 查询表在启动线程前构造, 避免竞争
+    }
+
+    memset(&pd, 0, sizeof(pd));
+    pd.mf = &mf;
+    pd.type_filter = type_filter;
+    pd.chunk_count = (mf.file_size + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+    pd.slot_count = threads * 2;
+    pd.slots = (ChunkResult *)calloc(pd.slot_count, sizeof(ChunkResult));
+    if (pd.slots == NULL) {
+        mapped_close(&mf);
+        return -1;
+    }
+    pthread_mutex_init(&pd.lock, NULL);
+    pthread_cond_init(&pd.cond, NULL);
+
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&tids[i], NULL, parallel_worker, &pd) != 0) {
             break;
-        default:
-            goto TAG_R;
+        }
+        started++;
+    }
+
+    for (uint64_t index = 0; index < pd.chunk_count && started > 0; index++) {
+        ChunkResult *res = &pd.slots[index % pd.slot_count];
+
+        pthread_mutex_lock(&pd.lock);
+        while (!pd.failed && !(res->state == 2 && res->index == index)) {
+            pthread_cond_wait(&pd.cond, &pd.lock);
+        }
+        pthread_mutex_unlock(&pd.lock);
+        if (pd.failed) {
             break;
         }
+
+        if (res->first_frame != NO_FRAME && res->first_frame < prev_stop) {
+            // 本块在上一块最后一帧内部同步到了伪帧: 从上一块停止位置顺序重解本块
+            uint64_t end = (index + 1) * PARALLEL_CHUNK_SIZE;
+            ScanCtx ctx;
+
+            if (end > mf.file_size) {
+                end = mf.file_size;
+            }
+            memset(&res->stats, 0, sizeof(res->stats));
+            res->out.len = 0;
+            ctx.type_filter = type_filter;
+            ctx.stats = &res->stats;
+            ctx.pad_frame = (uint8_t *)malloc(PAD_FRAME_SIZE);
+            ctx.first_frame = NO_FRAME;
+            if (ctx.pad_frame == NULL) {
+                pd.failed = 1;
+                break;
+            }
+            g_frame_out = &res->out;
+            res->stop = decode_range(&mf, &ctx, prev_stop, end);
+            g_frame_out = NULL;
+            free(ctx.pad_frame);
+            if (res->stop == NO_FRAME || res->out.failed) {
+                pd.failed = 1;
+                break;
+            }
+        }
+        if (res->stop > prev_stop) {
+            prev_stop = res->stop;
+        }
+
+        if (out != NULL && res->out.len > 0) {
+            fwrite(res->out.data, 1, res->out.len, out);
+        }
+        decode_stats_merge(stats, &res->stats);
+
+        pthread_mutex_lock(&pd.lock);
+        res->state = 0;
+        pd.emitted = index + 1;
+        pthread_cond_broadcast(&pd.cond);
+        pthread_mutex_unlock(&pd.lock);
+    }
+
+    pthread_mutex_lock(&pd.lock);
+    if (pd.emitted < pd.chunk_count) {
+        pd.failed = 1;
+        pd.next_chunk = pd.chunk_count;     // 出错时让工作线程尽快退出
+    }
+    pthread_cond_broadcast(&pd.cond);
+    pthread_mutex_unlock(&pd.lock);
+    for (int i = 0; i < started; i++) {
+        pthread_join(tids[i], NULL);
+    }
+
+    int ret = (pd.failed || started == 0) ? -1 : 0;
+    for (int i = 0; i < pd.slot_count; i++) {
+        free(pd.slots[i].out.data);
+    }
+    free(pd.slots);
+    pthread_cond_destroy(&pd.cond);
+    pthread_mutex_destroy(&pd.lock);
+    mapped_close(&mf);
+    return ret;
+}
+
+// ==========================================
+// 列式导出: 解码字段按列写入独立的二进制文件, 分析工具可单独 mmap 任一列
+// <前缀>.<表>.<列>.bin : 小端定长数组, 无文件头, 第 i 个元素即第 i 行
+// <前缀>.schema.csv    : 表名,列名,类型,字节宽度,行数,单位,文件名
+// frame 表每个有效帧一行; sat 表每颗卫星一行, frame_index 指向 frame 表的行号
+// 每列带 256KB 写缓冲, 写满后一次 fwrite
+// ==========================================
+#define EXPORT_COL_BUF_SIZE (256 << 10)
+
+typedef struct {
+    const char *table;
+    const char *name;
+    const char *type;           // u8/u16/u32/i32/f64
+    size_t width;
+    const char *unit;
+    FILE *fp;
+    uint8_t *buf;
+    size_t len;
+    uint64_t rows;
+} ExportColumn;
+
+enum {
+    FCOL_FRAME_TYPE, FCOL_POS_FLAG, FCOL_WEEK, FCOL_TOW_MS,
+    FCOL_LON, FCOL_LAT, FCOL_HEIGHT, FCOL_VEL_E, FCOL_VEL_N, FCOL_VEL_U,
+    FCOL_VIN, FCOL_VAN, FCOL_PDOP,
+    SCOL_FRAME_INDEX, SCOL_PRN, SCOL_PARTICIPATE, SCOL_SNR, SCOL_ELEVATION,
+    SCOL_AZIMUTH, SCOL_PSEUDORANGE, SCOL_PSEUDORANGE_RATE,
+    EXPORT_COL_COUNT
+};
+
+static ExportColumn g_export_cols[EXPORT_COL_COUNT] = {
+    {"frame", "frame_type",       "u8",  1, "",      NULL, NULL, 0, 0},
+    {"frame", "pos_flag",         "u8",  1, "",      NULL, NULL, 0, 0},
+    {"frame", "week",             "u16", 2, "week",  NULL, NULL, 0, 0},
+    {"frame", "tow_ms",           "u32", 4, "ms",    NULL, NULL, 0, 0},
+    {"frame", "longitude",        "f64", 8, "deg",   NULL, NULL, 0, 0},
+    {"frame", "latitude",         "f64", 8, "deg",   NULL, NULL, 0, 0},
+    {"frame", "height",           "f64", 8, "m",     NULL, NULL, 0, 0},
+    {"frame", "velocity_e",       "f64", 8, "m/s",   NULL, NULL, 0, 0},
+    {"frame", "velocity_n",       "f64", 8, "m/s",   NULL, NULL, 0, 0},
+    {"frame", "velocity_u",       "f64", 8, "m/s",   NULL, NULL, 0, 0},
+    {"frame", "vin",              "u8",  1, "",      NULL, NULL, 0, 0},
+    {"frame", "van",              "u8",  1, "",      NULL, NULL, 0, 0},
+    {"frame", "pdop",             "f64", 8, "",      NULL, NULL, 0, 0},
+    {"sat",   "frame_index",      "u32", 4, "",      NULL, NULL, 0, 0},
+    {"sat",   "prn",              "u8",  1, "",      NULL, NULL, 0, 0},
+    {"sat",   "participate",      "u8",  1, "",      NULL, NULL, 0, 0},
+    {"sat",   "snr",              "u8",  1, "dB",    NULL, NULL, 0, 0},
+    {"sat",   "elevation",        "u8",  1, "deg",   NULL, NULL, 0, 0},
+    {"sat",   "azimuth",          "u16", 2, "deg",   NULL, NULL, 0, 0},
+    {"sat",   "pseudorange",      "f64", 8, "m",     NULL, NULL, 0, 0},
+    {"sat",   "pseudorange_rate", "f64", 8, "m/s",   NULL, NULL, 0, 0},
+};
+
+static const char *g_export_prefix;
+static uint32_t g_export_frame_rows;
+static int g_export_failed;
+
+static void export_column_path(char *path, size_t size, const ExportColumn *col) {
+    snprintf(path, size, "%s.%s.%s.bin", g_export_prefix, col->table, col->name);
+}
+
+static void export_flush(ExportColumn *col) {
+    if (col->len > 0 && fwrite(col->buf, 1, col->len, col->fp) != col->len) {
+        g_export_failed = 1;
+    }
+    col->len = 0;
+}
+
+static void export_put(int index, const void *value) {
+    ExportColumn *col = &g_export_cols[index];
+    if (col->len + col->width > EXPORT_COL_BUF_SIZE) {
+        export_flush(col);
+    }
+    memcpy(col->buf + col->len, value, col->width);     // 主机为小端, 与帧内字节序一致
+    col->len += col->width;
+    col->rows++;
+}
+
+static void export_put_u8(int index, uint8_t v)   { export_put(index, &v); }
+static void export_put_u16(int index, uint16_t v) { export_put(index, &v); }
+static void export_put_u32(int index, uint32_t v) { export_put(index, &v); }
+static void export_put_f64(int index, double v)   { export_put(index, &v); }
+
+int export_open(const char *prefix) {
+    char path[1024];
+
+    g_export_prefix = prefix;
+    g_export_frame_rows = 0;
+    g_export_failed = 0;
+    for (int i = 0; i < EXPORT_COL_COUNT; i++) {
+        ExportColumn *col = &g_export_cols[i];
+        export_column_path(path, sizeof(path), col);
+        col->fp = fopen(path, "wb");
+        col->buf = (uint8_t *)malloc(EXPORT_COL_BUF_SIZE);
+        col->len = 0;
+        col->rows = 0;
+        if (col->fp == NULL || col->buf == NULL) {
+            return -1;
+        }
+        setvbuf(col->fp, NULL, _IONBF, 0);     // 已有列缓冲, 不再经过 stdio 缓冲
     }
-TAG_R:
+    return 0;
+}
+
+// 写出剩余缓冲并生成 schema, 返回 0 表示全部写入成功
+int export_close(void) {
+    char path[1024];
+    FILE *schema;
+
+    for (int i = 0; i < EXPORT_COL_COUNT; i++) {
+        ExportColumn *col = &g_export_cols[i];
+        if (col->fp != NULL) {
+            export_flush(col);
+            if (fclose(col->fp) != 0) {
+                g_export_failed = 1;
+            }
+        }
+        free(col->buf);
+        col->fp = NULL;
+        col->buf = NULL;
+    }
+
+    snprintf(path, sizeof(path), "%s.schema.csv", g_export_prefix);
+    schema = fopen(path, "w");
+    if (schema == NULL) {
+        return -1;
+    }
+    fprintf(schema, "table,column,type,width,rows,unit,file\n");
+    for (int i = 0; i < EXPORT_COL_COUNT; i++) {
+        const ExportColumn *col = &g_export_cols[i];
+        export_column_path(path, sizeof(path), col);
+        fprintf(schema, "%s,%s,%s,%u,%llu,%s,%s\n", col->table, col->name, col->type,
+                (unsigned)col->width, (unsigned long long)col->rows, col->unit, path);
+    }
+    if (fclose(schema) != 0) {
+        g_export_failed = 1;
+    }
+    return g_export_failed ? -1 : 0;
+}
+
+static void export_sat(uint32_t frame_index, const T_AJRSatelliteInfo_Telemetry *sat) {
+    export_put_u32(SCOL_FRAME_INDEX, frame_index);
+    export_put_u8(SCOL_PRN, sat->prn);
+    export_put_u8(SCOL_PARTICIPATE, sat->participate);
+    export_put_u8(SCOL_SNR, sat->snr);
+    export_put_u8(SCOL_ELEVATION, sat->elevation);
+    export_put_u16(SCOL_AZIMUTH, sat->azimuth);
+    export_put_f64(SCOL_PSEUDORANGE, sat->pseudorange * 0.1);
+    export_put_f64(SCOL_PSEUDORANGE_RATE, sat->pseudorange_rate * 0.01);
+}
+
+static void export_frame_common(uint8_t type, uint8_t pos_flag, uint16_t week, uint32_t tow_ms,
+                                int32_t lon, int32_t lat, int32_t height,
+                                int32_t ve, int32_t vn, int32_t vu,
+                                uint8_t vin, uint8_t van, uint16_t pdop) {
+    export_put_u8(FCOL_FRAME_TYPE, type);
+    export_put_u8(FCOL_POS_FLAG, pos_flag);
+    export_put_u16(FCOL_WEEK, week);
+    export_put_u32(FCOL_TOW_MS, tow_ms);
+    export_put_f64(FCOL_LON, (double)lon * (180.0 / (M_PI * 1e8)));
+    export_put_f64(FCOL_LAT, (double)lat * (180.0 / (M_PI * 1e8)));
+    export_put_f64(FCOL_HEIGHT, (double)height * 0.01);
+    export_put_f64(FCOL_VEL_E, (double)ve * 0.01);
+    export_put_f64(FCOL_VEL_N, (double)vn * 0.01);
+    export_put_f64(FCOL_VEL_U, (double)vu * 0.01);
+    export_put_u8(FCOL_VIN, vin);
+    export_put_u8(FCOL_VAN, van);
+    export_put_f64(FCOL_PDOP, pdop * 0.01);
+}
+
+static void export_frame_0x36(const uint8_t *frame, size_t frame_len) {
+    const SatellitePositionInfo *f = (const SatellitePositionInfo *)frame;
+    size_t fixed_size = offsetof(SatellitePositionInfo, sats);
+    size_t sat_slots = (frame_len > fixed_size + 2) ? (frame_len - fixed_size - 2) / sizeof(SatelliteInfo) : 0;
+
+    export_frame_common(0x36, f->pos_flag, f->bd_week, f->bd_week_ms,
+                        f->longitude, f->latitude, f->height,
+                        f->velocity_e, f->velocity_n, f->velocity_u, f->vin, f->van, f->pdop);
+    for (size_t i = 0; i < sat_slots && i < 16; i++) {
+        if (f->sats[i].prn != 0) {
+            // 0x36 卫星信息前 12 字节与 0x35 相同
+            export_sat(g_export_frame_rows, (const T_AJRSatelliteInfo_Telemetry *)&f->sats[i]);
+        }
+    }
+    g_export_frame_rows++;
+}
+
+static void export_frame_0x35(const uint8_t *frame, size_t frame_len) {
+    const T_AJRSatellitePositionInfo_Telemetry *f = (const T_AJRSatellitePositionInfo_Telemetry *)frame;
+    (void)frame_len;
+
+    export_frame_common(0x35, f->pos_flag, f->weeknum, f->secondofweek,
+                        f->longitude, f->latitude, f->height,
+                        f->velocity_e, f->velocity_n, f->velocity_u, f->vin, f->van, f->pdop);
+    for (int i = 0; i < 16 && f->sats[i].prn != 0; i++) {
+        export_sat(g_export_frame_rows, &f->sats[i]);
+    }
+    g_export_frame_rows++;
+}
+
+static const FrameDecoder g_exporter_0x36 = {
+    0x36, offsetof(SatellitePositionInfo, sats) + 16 * sizeof(SatelliteInfo),
+    export_frame_0x36, "卫星定位信息"
+};
+static const FrameDecoder g_exporter_0x35 = {
+    0x35, sizeof(T_AJRSatellitePositionInfo_Telemetry),
+    export_frame_0x35, "遥测信息"
+};
+
+// ==========================================
+// 测速: 生成合成采集文件, 分别用单线程和多线程解码 (输出丢弃)
+// ==========================================
+static double now_seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, cnt;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&cnt);
+    return (double)cnt.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+// 在 frame 中填充 CRC 并返回帧长, frame 的 data_length 已设置
+static size_t synth_finish_frame(uint8_t *frame) {
+    size_t data_length = (size_t)frame[2] | ((size_t)frame[3] << 8);
+    uint16_t crc = crc_ccitt(frame + 2, data_length + 2);
+    frame[4 + data_length] = (uint8_t)(crc & 0xFF);
+    frame[5 + data_length] = (uint8_t)(crc >> 8);
+    return 4 + data_length + 2;
+}
+
+// 生成约 size_mb MB 的合成采集: 0x35/0x36 帧交替, 帧间夹杂随机字节和伪帧头
+int generate_synthetic_capture(const char *path, uint64_t size_mb) {
+    FILE *fp = fopen(path, "wb");
+    uint64_t target = size_mb << 20, written = 0;
+    uint32_t seed = 12345;
+    uint8_t frame[FRAME_MAX_LEN];
+
+    if (fp == NULL) {
+        return -1;
+    }
+    setvbuf(fp, NULL, _IOFBF, 1 << 20);
+
+    while (written < target) {
+        seed = seed * 1103515245u + 12345u;
+        int junk = (seed >> 16) % 8;
+        for (int i = 0; i < junk; i++) {
+            fputc((i == 0) ? FRAME_SYNC1 : (int)((seed >> (i * 3)) & 0xFF), fp);
+        }
+        written += junk;
+
+        memset(frame, 0, sizeof(frame));
+        if (seed & 0x100) {
+            T_AJRSatellitePositionInfo_Telemetry *f = (T_AJRSatellitePositionInfo_Telemetry *)frame;
+            f->header1 = FRAME_SYNC1;
+            f->header2 = FRAME_SYNC2;
+            f->data_length = (uint16_t)(sizeof(*f) - 6);
+            f->info_flag = 0x35;
+            f->pos_flag = 1;
+            f->weeknum = 1000;
+            f->secondofweek = seed % 604800000u;
+            f->longitude = 203000000 + (int32_t)(seed & 0xFFFF);
+            f->latitude = 69000000 + (int32_t)(seed >> 16);
+            f->height = 5000;
+            f->vin = f->van = 12;
+            f->pdop = 150;
+            for (int i = 0; i < 12; i++) {
+                f->sats[i].prn = (uint8_t)(i + 1);
+                f->sats[i].participate = 1;
+                f->sats[i].snr = (uint8_t)(40 + i);
+                f->sats[i].elevation = (uint8_t)(10 + i * 5);
+                f->sats[i].azimuth = (uint16_t)(i * 30);
+                f->sats[i].pseudorange = 210000000 + i * 1000;
+            }
+        } else {
+            SatellitePositionInfo *f = (SatellitePositionInfo *)frame;
+            f->header1 = FRAME_SYNC1;
+            f->header2 = FRAME_SYNC2;
+            f->data_length = (uint16_t)(offsetof(SatellitePositionInfo, sats) + 16 * sizeof(SatelliteInfo) - 4);
+            f->info_flag = 0x36;
+            f->pos_flag = 1;
+            f->date_ymd = (uint16_t)((25 << 9) | (6 << 5) | 18);
+            f->time_24h = seed % 2160000000u;
+            f->bd_week = 1000;
+            f->longitude = 203000000 + (int32_t)(seed & 0xFFFF);
+            f->latitude = 69000000 + (int32_t)(seed >> 16);
+            f->vin = f->van = 16;
+            f->pdop = 120;
+            for (int i = 0; i < 16; i++) {
+                f->sats[i].prn = (uint8_t)(i + 1);
+                f->sats[i].snr = (uint8_t)(35 + i);
+                f->sats[i].pseudorange = 210000000 + i * 1000;
+            }
+        }
+        size_t frame_len = synth_finish_frame(frame);
+        fwrite(frame, 1, frame_len, fp);
+        written += frame_len;
+    }
+
+    fclose(fp);
+    return 0;
+}
+
+static int run_benchmark(const char *path, int threads) {
+    DecodeStats stats;
+    MappedFile mf;
+    double t0, t1, single, multi;
+
+    if (mapped_open(&mf, path) != 0) {
+        return -1;
+    }
+    double mb = (double)mf.file_size / (1 << 20);
+    mapped_close(&mf);
+
+    t0 = now_seconds();
+    if (decode_capture_parallel(path, -1, 1, NULL, &stats) != 0) {
+        return -1;
+    }
+    t1 = now_seconds();
+    single = t1 - t0;
+    fprintf(stderr, "1 线程: %.2fs, %.1f MB/s, %llu 帧\n",
+            single, mb / single, (unsigned long long)stats.frames);
+
+    t0 = now_seconds();
+    if (decode_capture_parallel(path, -1, threads, NULL, &stats) != 0) {
+        return -1;
+    }
+    t1 = now_seconds();
+    multi = t1 - t0;
+    fprintf(stderr, "%d 线程: %.2fs, %.1f MB/s, %llu 帧, 加速比 %.2f\n",
+            threads, multi, mb / multi, (unsigned long long)stats.frames, single / multi);
+    return 0;
+}
+
+
+static void print_usage(const char *prog) {
+    printf("用法: %s [--threads N] <二进制文件> [帧类型, 默认全部]\n", prog);
+    printf("      %s --gen <输出文件> <大小MB>       生成合成采集文件\n", prog);
+    printf("      %s [--threads N] --bench <文件>    单线程/多线程解码测速\n", prog);
+    printf("      %s --export <输出前缀> <二进制文件> [帧类型]  列式导出, 不打印文本, 单线程\n", prog);
+    printf("示例: %s --threads 8 data.bin 0x36\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    int threads = 1;
+    int argi = 1;
+
+    if (argc >= 3 && strcmp(argv[1], "--threads") == 0) {
+        threads = atoi(argv[2]);
+        argi = 3;
+    }
+    const char *export_prefix = NULL;
+    if (argc - argi >= 2 && strcmp(argv[argi], "--export") == 0) {
+        export_prefix = argv[argi + 1];
+        argi += 2;
+        // 导出列按帧顺序追加, 只支持单线程
+        if (threads > 1) {
+            printf("--export 不支持 --threads, 请去掉 --threads 参数\n");
+            return 1;
+        }
+    }
+    if (argc - argi == 3 && strcmp(argv[argi], "--gen") == 0) {
+        if (generate_synthetic_capture(argv[argi + 1], strtoull(argv[argi + 2], NULL, 0)) != 0) {
+            perror("生成文件失败");
+            return 1;
+        }
+        return 0;
+    }
+
+    register_frame_decoder(&g_decoder_0x36);
+    register_frame_decoder(&g_decoder_0x35);
+
+    if (argc - argi == 2 && strcmp(argv[argi], "--bench") == 0) {
+        if (run_benchmark(argv[argi + 1], threads > 1 ? threads : 4) != 0) {
+            perror("测速失败");
+            return 1;
+        }
+        return 0;
+    }
+    if (argc - argi != 1 && argc - argi != 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    int type_filter = -1;
+    if (argc - argi == 2 && strcmp(argv[argi + 1], "all") != 0) {
+        type_filter = (int)(strtol(argv[argi + 1], NULL, 0) & 0xFF);
+    }
+    if (type_filter >= 0 && g_frame_decoders[type_filter] == NULL) {
+        printf("不支持的帧类型: 0x%02X\n", type_filter);
+        return 1;
+    }
+
+    DecodeStats stats;
+    int ret;
+    if (export_prefix != NULL) {
+        register_frame_decoder(&g_exporter_0x36);
+        register_frame_decoder(&g_exporter_0x35);
+        if (export_open(export_prefix) != 0) {
+            perror("创建导出文件失败");
+            export_close();
+            return 1;
+        }
+        ret = decode_capture_file(argv[argi], type_filter, &stats);
+        if (export_close() != 0) {
+            perror("写导出文件失败");
+            return 1;
+        }
+    } else if (threads > 1) {
+        ret = decode_capture_parallel(argv[argi], type_filter, threads, stdout, &stats);
+    } else {
+        ret = decode_capture_file(argv[argi], type_filter, &stats);
+    }
+    if (ret != 0) {
+        perror("打开或映射文件失败");
+        return 1;
+    }
+
     // 统计结果
-    if (frame_count == 0) {
+    if (stats.frames == 0) {
         printf("未找到有效数据帧\n");
     } else {
-        printf("\n处理完成! 共发现 %d 个有效数据帧\n", frame_count);
+        printf("\n处理完成! 共发现 %llu 个有效数据帧\n", (unsigned long long)stats.frames);
+        for (int t = 0; t < 256; t++) {
+            if (stats.per_type[t] != 0) {
+                printf("  0x%02X %s: %llu\n", t, g_frame_decoders[t]->name,
+                       (unsigned long long)stats.per_type[t]);
+            }
+        }
+    }
+    if (stats.crc_errors != 0 || stats.skipped != 0) {
+        printf("CRC错误 %llu 个, 类型过滤 %llu 个\n",
+               (unsigned long long)stats.crc_errors, (unsigned long long)stats.skipped);
     }
-    
-    // 清理资源
-    free(buffer);
     return 0;
-}
\ No newline at end of file
+}
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <stddef.h>
 #include <string.h>
 #include <math.h>
 #include <windows.h> // For Windows specific functions like ntohs, ntohl if needed
@@ -548,32 +549,127 @@ void parse_and_print_0x35(T_AJRSatellitePositionInfo_Telemetry *frame) {
     printf("=================================================\n");
 }
 
-// 将ASCII码表示的十六进制字符串转换为字节数组
-// "55AA36..." -> {0x55, 0xAA, 0x36, ...}
-long hex_to_bytes(const char *hex_str, uint8_t *byte_array, long max_len) {
-    long byte_count = 0;
-    long hex_len = strlen(hex_str);
-    if (hex_len % 2 != 0) {
-        fprintf(stderr, "错误: 十六进制字符串长度为奇数，无法解析。\n");
-        return -1;
-    }
-
-    for (long i = 0; i < hex_len && byte_count < max_len; i += 2) {
-        char hex_byte_str[3];
-        hex_byte_str[0] = hex_str[i];
-        hex_byte_str[1] = hex_str[i+1];
-        hex_byte_str[2] = '\0';
-        
-        // 使用sscanf将两个字符的十六进制字符串转换为一个字节
-        if (sscanf(hex_byte_str, "%hhx", &byte_array[byte_count]) != 1) {
-            fprintf(stderr, "错误: 无效的十六进制字符 '%s' 在位置 %ld。\n", hex_byte_str, i);
-            return -1;
+// ==========================================
+// 十六进制文本解码: 查表代替 sscanf, 跳过空白/换行等非十六进制字符
+// 支持分块输入, 块边界上落单的半个字节由 HexStream 保存
+// ==========================================
+static int8_t hex_lut[256];
+static int hex_lut_ready = 0;
+
+static void hex_lut_init(void) {
+    memset(hex_lut, -1, sizeof(hex_lut));
+    for (int i = 0; i < 10; i++) {
+        hex_lut['0' + i] = (int8_t)i;
+    }
+    for (int i = 0; i < 6; i++) {
+        hex_lut['a' + i] = (int8_t)(10 + i);
+        hex_lut['A' + i] = (int8_t)(10 + i);
+    }
+    hex_lut_ready = 1;
+}
+
+typedef struct {
+    int high;           // 已读入的高半字节, -1 表示无
+} HexStream;
+
+// 解码 text[0, len) 追加到 out, 返回输出字节数; out 至少需要 len / 2 + 1 字节
+static size_t hex_stream_decode(HexStream *hs, const char *text, size_t len, uint8_t *out) {
+    const uint8_t *p = (const uint8_t *)text;
+    const uint8_t *end = p + len;
+    uint8_t *o = out;
+    int high = hs->high;
+
+    if (!hex_lut_ready) {
+        hex_lut_init();
+    }
+    // 先补齐上一块留下的半个字节
+    while (high >= 0 && p < end) {
+        int v = hex_lut[*p++];
+        if (v >= 0) {
+            *o++ = (uint8_t)((high << 4) | v);
+            high = -1;
         }
-        byte_count++;
     }
-    return byte_count;
+    // 快速路径: 连续两个都是十六进制字符, 一次输出一个字节
+    while (p + 1 < end) {
+        int h = hex_lut[p[0]];
+        int l = hex_lut[p[1]];
+        if ((h | l) >= 0) {
+            *o++ = (uint8_t)((h << 4) | l);
+            p += 2;
+        } else if (h < 0) {
+            p++;
+        } else {
+            // 高半字节后夹着分隔符, 向后找低半字节
+            p += 2;
+            while (p < end && hex_lut[*p] < 0) {
+                p++;
+            }
+            if (p == end) {
+                high = h;
+                break;
+            }
+            *o++ = (uint8_t)((h << 4) | hex_lut[*p++]);
+        }
+    }
+    if (p < end && hex_lut[*p] >= 0) {
+        high = hex_lut[*p];
+    }
+    hs->high = high;
+    return (size_t)(o - out);
 }
 
+// 在 buf[0, len) 中查找并解析 hex_cmd 类型的帧, 返回已处理的字节数
+// at_eof 为 0 时, 末尾不完整的帧保留到下一块数据到达后再解析
+static long scan_frames(uint8_t *buf, long len, uint8_t hex_cmd, int at_eof, int *frame_count) {
+    long offset = 0;
+
+    while (offset < len) {
+        // 确保有足够的字节来读取帧头和数据长度字段
+        if (offset + 5 > len) { // 2(header) + 2(data_length) + 1(info_flag)
+            if (!at_eof) {
+                return offset;
+            }
+            printf("数据末尾，剩余字节不足以构成完整帧头。\n");
+            return len;
+        }
+
+        // 查找帧头 0x55 0xAA
+        uint8_t *p = (uint8_t *)memchr(buf + offset, 0x55, len - offset - 1);
+        if (p == NULL) {
+            return len - 1;     // 最后一个字节可能是下一块帧头的前半部分
+        }
+        offset = p - buf;
+        if (offset + 5 > len) {
+            continue;
+        }
+        if (p[1] != 0xAA || p[4] != hex_cmd) {
+            offset++; // 协议类型不匹配，移动一个字节继续搜索
+            continue;
+        }
+
+        // 完整帧大小 = 帧头(2) + data_length(2) + data_length + CRC(2)
+        uint16_t current_data_length = (uint16_t)(p[2] | (p[3] << 8));
+        long frame_size = 4 + current_data_length + 2;
+        if (offset + frame_size > len) {
+            if (!at_eof) {
+                return offset;
+            }
+            printf("0x%02X协议帧数据不完整，跳过此帧。\n", hex_cmd);
+            offset++; // 移动一个字节继续搜索
+            continue;
+        }
+
+        if (hex_cmd == 0x36) {
+            parse_and_print_0x36((SatellitePositionInfo *)p);
+        } else {
+            parse_and_print_0x35((T_AJRSatellitePositionInfo_Telemetry *)p);
+        }
+        offset += frame_size;
+        (*frame_count)++;
+    }
+    return offset;
+}
 
 int main(int argc, char *argv[]) {
     if (argc != 3) {
@@ -589,17 +685,6 @@ int main(int argc, char *argv[]) {
         return 1;
     }
     
-    // 读取文件内容到字符串
-    fseek(file, 0, SEEK_END);
-    long file_char_len = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    if (file_char_len <= 0) {
-        printf("文件为空\n");
-        fclose(file);
-        return 1;
-    }
-
     buildTableCRC_CCITT();
 
     uint16_t calc_crc = calcCRC16("1234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890", 1000);
@@ -610,131 +695,71 @@ int main(int argc, char *argv[]) {
     calc_crc = calcCRC16((char*)&hex, 2);
     printf("hex0x18e 2 crc :0x%x\r\n",calc_crc);
 
-    // 分配足够的空间来存储ASCII十六进制字符串
-    char *hex_string_buffer = (char*)malloc(file_char_len + 1);
-    if (!hex_string_buffer) {
-        perror("内存分配失败");
+    uint8_t hex_cmd = (uint8_t)strtol(argv[2], NULL, 16); // 将协议类型字符串转换为十六进制数值
+    if (hex_cmd != 0x36 && hex_cmd != 0x35) {
+        printf("不支持的协议类型: 0x%02X\n", hex_cmd);
         fclose(file);
         return 1;
     }
-    hex_string_buffer[file_char_len] = '\0'; // 确保字符串以null结尾
-    
-    size_t chars_read = fread(hex_string_buffer, 1, file_char_len, file);
-    fclose(file);
-    
-    if (chars_read != (size_t)file_char_len) {
-        printf("文件读取不完整\n");
-        free(hex_string_buffer);
-        return 1;
-    }
 
-    // 移除可能的换行符、空格等非十六进制字符，仅保留十六进制字符
-    char *clean_hex_string = (char*)malloc(file_char_len + 1); // 额外空间以防万一
-    if (!clean_hex_string) {
+    // 按固定大小分块读取文本, 解码后直接送入帧扫描; 字节缓冲只保留一帧的未处理尾部
+    const size_t text_block = 1 << 20;
+    const long max_frame = 4 + 0xFFFF + 2;
+    char *text = (char *)malloc(text_block);
+    long byte_cap = (long)(text_block / 2 + 1) + max_frame;
+    uint8_t *byte_buffer = (uint8_t *)malloc(byte_cap + sizeof(T_AJRSatellitePositionInfo_Telemetry));
+    if (!text || !byte_buffer) {
         perror("内存分配失败");
-        free(hex_string_buffer);
+        free(text);
+        free(byte_buffer);
+        fclose(file);
         return 1;
     }
-    long clean_len = 0;
-    for (long i = 0; i < file_char_len; ++i) {
-        if (isxdigit(hex_string_buffer[i])) { // 检查是否是十六进制数字
-            clean_hex_string[clean_len++] = hex_string_buffer[i];
+
+    HexStream hs = { -1 };
+    long byte_len = 0;
+    long bytes_converted = 0;
+    int frame_count = 0;
+    size_t chars_read;
+    int at_eof = 0;
+
+    while (!at_eof) {
+        chars_read = fread(text, 1, text_block, file);
+        at_eof = (chars_read < text_block);
+        size_t n = hex_stream_decode(&hs, text, chars_read, byte_buffer + byte_len);
+        byte_len += (long)n;
+        bytes_converted += (long)n;
+
+        long used = scan_frames(byte_buffer, byte_len, hex_cmd, at_eof, &frame_count);
+        if (!at_eof && byte_len - used > max_frame) {
+            used = byte_len - max_frame;    // 不可能属于同一帧的旧数据直接丢弃
         }
+        memmove(byte_buffer, byte_buffer + used, byte_len - used);
+        byte_len -= used;
     }
-    clean_hex_string[clean_len] = '\0';
-    free(hex_string_buffer); // 释放原始读取的缓冲区
-    hex_string_buffer = clean_hex_string; // 现在 hex_string_buffer 指向清理后的字符串
-    file_char_len = clean_len;
-
-    // 将十六进制字符串转换为字节数组
-    // 一个字节由两个十六进制字符表示，所以字节数组长度是字符串长度的一半
-    long buffer_size_bytes = file_char_len / 2;
-    uint8_t *byte_buffer = (uint8_t*)malloc(buffer_size_bytes);
-    if (!byte_buffer) {
-        perror("内存分配失败");
-        free(hex_string_buffer);
-        return 1;
+    if (ferror(file)) {
+        printf("文件读取不完整\n");
     }
-    
-    long bytes_converted = hex_to_bytes(hex_string_buffer, byte_buffer, buffer_size_bytes);
-    free(hex_string_buffer); // 释放十六进制字符串缓冲区
-
-    if (bytes_converted == -1 || bytes_converted == 0) {
+    fclose(file);
+    if (hs.high >= 0) {
+        printf("警告: 十六进制字符数为奇数，最后半个字节被忽略。\n");
+    }
+    if (bytes_converted == 0) {
         printf("十六进制数据转换失败或为空。\n");
+        free(text);
         free(byte_buffer);
         return 1;
     }
-    
-    uint8_t hex_cmd = (uint8_t)strtol(argv[2], NULL, 16); // 将协议类型字符串转换为十六进制数值
-
-    // 处理数据帧
-    long offset = 0;
-    int frame_count = 0;
-    
-    // 最小帧大小的假设，用于跳过无效数据
-    const size_t min_frame_size_0x36 = sizeof(SatellitePositionInfo) - sizeof(SatelliteInfo) + sizeof(SatelliteInfo); // 假设至少一颗卫星
-    const size_t min_frame_size_0x35 = offsetof(T_AJRSatellitePositionInfo_Telemetry, sats); // 0x35协议的固定部分
-
-    while (offset < bytes_converted) {
-        // 确保有足够的字节来读取帧头和数据长度字段
-        if (offset + 5 > bytes_converted) { // 2(header) + 2(data_length) + 1(info_flag)
-            printf("数据末尾，剩余字节不足以构成完整帧头。\n");
-            break;
-        }
 
-        // 查找帧头 0x55 0xAA
-        if (byte_buffer[offset] == 0x55 && byte_buffer[offset + 1] == 0xAA) {
-            uint8_t current_info_flag = byte_buffer[offset + 4]; // info_flag 位于第5个字节 (索引4)
-            uint16_t current_data_length = *(uint16_t*)(byte_buffer + offset + 2); // data_length 位于第3-4字节 (索引2-3)
-
-            // 根据协议类型进行解析
-            if (current_info_flag == hex_cmd) {
-                if (hex_cmd == 0x36) {
-                    // 0x36协议的完整帧大小 = 帧头(2) + data_length(2) + data_length + CRC(2)
-                    size_t frame_size_0x36 = 4 + current_data_length + 2;
-
-                    if (offset + frame_size_0x36 > bytes_converted) {
-                        printf("0x36协议帧数据不完整，跳过此帧。\n");
-                        offset++; // 移动一个字节继续搜索
-                        continue;
-                    }
-                    SatellitePositionInfo *frame = (SatellitePositionInfo*)(byte_buffer + offset);
-                    parse_and_print_0x36(frame);
-                    offset += frame_size_0x36;
-                    frame_count++;
-                } else if (hex_cmd == 0x35) {
-                    // 0x35协议的完整帧大小 = 帧头(2) + data_length(2) + data_length + CRC(2)
-                    size_t frame_size_0x35 = 4 + current_data_length + 2;
-
-                    if (offset + frame_size_0x35 > bytes_converted) {
-                        printf("0x35协议帧数据不完整，跳过此帧。\n");
-                        offset++; // 移动一个字节继续搜索
-                        continue;
-                    }
-                    T_AJRSatellitePositionInfo_Telemetry *frame = (T_AJRSatellitePositionInfo_Telemetry*)(byte_buffer + offset);
-                    parse_and_print_0x35(frame);
-                    offset += frame_size_0x35;
-                    frame_count++;
-                } else {
-                    printf("不支持的协议类型: 0x%02X\n", hex_cmd);
-                    offset++;
-                }
-            } else {
-                offset++; // 协议类型不匹配，移动一个字节继续搜索
-            }
-        } else {
-            offset++; // 未找到帧头，移动一个字节继续搜索
-        }
-    }
-    
     // 统计结果
     if (frame_count == 0) {
         printf("未找到有效数据帧。\n");
     } else {
         printf("\n处理完成! 共发现 %d 个有效数据帧。\n", frame_count);
     }
-    
+
     // 清理资源
+    free(text);
     free(byte_buffer);
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,213 @@
+#include "inet_csum.h"
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// 按内存原样读取, 不要求对齐
+static uint16_t load16(const uint8_t *p) {
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t load32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static void store16(uint8_t *p, uint16_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+// 64 位和折叠为 32 位, 保持一补数加法语义 (高位进位回卷)
+static uint32_t fold64(uint64_t sum) {
+    sum = (sum & 0xFFFFFFFFu) + (sum >> 32);
+    sum = (sum & 0xFFFFFFFFu) + (sum >> 32);
+    return (uint32_t)sum;
+}
+
+static uint16_t fold32(uint32_t sum) {
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t)sum;
+}
+
+/*
+ * 一补数和与字节序无关 (RFC 1071 2.(B)): 以 32 位为单位累加到 64 位累加器,
+ * 最后折叠为 16 位, 与逐个 16 位字相加结果相同, 但循环次数和进位处理都少得多
+ */
+uint32_t inet_csum_partial(const void *data, size_t len, uint32_t sum) {
+    const uint8_t *p = (const uint8_t *)data;
+    uint64_t acc = sum;
+
+#if defined(__SSE2__)
+    if (len >= 64) {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc0 = _mm_setzero_si128();
+        __m128i acc1 = _mm_setzero_si128();
+
+        // 每个 32 位字零扩展到 64 位通道, 单次调用最多累加 2^32 个字, 不会溢出
+        while (len >= 64) {
+            __m128i v0 = _mm_loadu_si128((const __m128i *)(p +  0));
+            __m128i v1 = _mm_loadu_si128((const __m128i *)(p + 16));
+            __m128i v2 = _mm_loadu_si128((const __m128i *)(p + 32));
+            __m128i v3 = _mm_loadu_si128((const __m128i *)(p + 48));
+            acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v0, zero));
+            acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v0, zero));
+            acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v1, zero));
+            acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v1, zero));
+            acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v2, zero));
+            acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v2, zero));
+            acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v3, zero));
+            acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v3, zero));
+            p += 64;
+            len -= 64;
+        }
+
+        uint64_t lanes[2];
+        _mm_storeu_si128((__m128i *)lanes, _mm_add_epi64(acc0, acc1));
+        acc += fold64(lanes[0]);
+        acc += fold64(lanes[1]);
+    }
+#endif
+
+    while (len >= 32) {
+        acc += load32(p +  0);
+        acc += load32(p +  4);
+        acc += load32(p +  8);
+        acc += load32(p + 12);
+        acc += load32(p + 16);
+        acc += load32(p + 20);
+        acc += load32(p + 24);
+        acc += load32(p + 28);
+        p += 32;
+        len -= 32;
+    }
+    while (len >= 4) {
+        acc += load32(p);
+        p += 4;
+        len -= 4;
+    }
+    if (len >= 2) {
+        acc += load16(p);
+        p += 2;
+        len -= 2;
+    }
+    if (len) {
+        // 奇数长度: 最后一个字节作为高位字节, 低位补 0 (按内存顺序)
+        uint8_t tail[2] = { *p, 0 };
+        acc += load16(tail);
+    }
+    return fold64(acc);
+}
+
+uint32_t inet_csum_add(uint32_t a, uint32_t b) {
+    return fold64((uint64_t)a + b);
+}
+
+uint16_t inet_csum_fold(uint32_t sum) {
+    return (uint16_t)~fold32(sum);
+}
+
+uint16_t inet_csum(const void *data, size_t len) {
+    return inet_csum_fold(inet_csum_partial(data, len, 0));
+}
+
+uint32_t inet_csum_iov_partial(const csum_iov_t *iov, int count, uint32_t sum) {
+    uint64_t acc = sum;
+    size_t offset = 0;
+
+    for (int i = 0; i < count; i++) {
+        uint32_t part = fold32(inet_csum_partial(iov[i].base, iov[i].len, 0));
+        // 段起点位于奇数偏移时, 该段的每个字节都在 16 位字的另一半, 交换部分和的两个字节即可
+        if (offset & 1) {
+            part = ((part & 0xFF) << 8) | (part >> 8);
+        }
+        acc += part;
+        offset += iov[i].len;
+    }
+    return fold64(acc);
+}
+
+uint16_t inet_csum_iov(const csum_iov_t *iov, int count, uint32_t sum) {
+    return inet_csum_fold(inet_csum_iov_partial(iov, count, sum));
+}
+
+uint32_t inet_csum_pseudo_ipv4(uint32_t src_ip, uint32_t dst_ip, uint8_t protocol, uint16_t l4_len) {
+    uint8_t tail[4] = { 0, protocol, (uint8_t)(l4_len >> 8), (uint8_t)l4_len };
+    uint64_t acc = 0;
+
+    acc += src_ip;
+    acc += dst_ip;
+    acc += load32(tail);
+    return fold64(acc);
+}
+
+uint16_t inet_csum_update16(uint16_t csum, uint16_t old_val, uint16_t new_val) {
+    uint32_t sum = (uint16_t)~csum;
+    sum += (uint16_t)~old_val;
+    sum += new_val;
+    return (uint16_t)~fold32(sum);
+}
+
+uint16_t inet_csum_update32(uint16_t csum, uint32_t old_val, uint32_t new_val) {
+    uint64_t sum = (uint16_t)~csum;
+    sum += (uint32_t)~old_val;
+    sum += new_val;
+    return (uint16_t)~fold32(fold64(sum));
+}
+
+#define IPV4_TTL_OFFSET     8
+#define IPV4_PROTO_OFFSET   9
+#define IPV4_CSUM_OFFSET    10
+#define IPV4_SRC_OFFSET     12
+#define INET_PROTO_UDP      17
+
+// 增量更新传输层校验和. UDP 校验和 0 表示未启用, 保持为 0;
+// 更新结果为 0 时写 0xFFFF (与 0 在一补数中等价), 避免被接收方当成未启用
+static void l4_csum_store(uint8_t *l4_csum, uint16_t csum, uint8_t protocol) {
+    if (protocol == INET_PROTO_UDP && csum == 0) {
+        csum = 0xFFFF;
+    }
+    store16(l4_csum, csum);
+}
+
+uint8_t ipv4_decrement_ttl(uint8_t *ip_hdr) {
+    // TTL 与协议号同在一个 16 位字中
+    uint16_t old_word = load16(ip_hdr + IPV4_TTL_OFFSET);
+    uint16_t csum = load16(ip_hdr + IPV4_CSUM_OFFSET);
+
+    ip_hdr[IPV4_TTL_OFFSET]--;
+    store16(ip_hdr + IPV4_CSUM_OFFSET,
+            inet_csum_update16(csum, old_word, load16(ip_hdr + IPV4_TTL_OFFSET)));
+    return ip_hdr[IPV4_TTL_OFFSET];
+}
+
+void ipv4_rewrite_addr(uint8_t *ip_hdr, int which, uint32_t new_ip, uint8_t *l4_csum) {
+    uint8_t *field = ip_hdr + IPV4_SRC_OFFSET + (which ? 4 : 0);
+    uint32_t old_ip = load32(field);
+    uint8_t protocol = ip_hdr[IPV4_PROTO_OFFSET];
+
+    memcpy(field, &new_ip, sizeof(new_ip));
+    store16(ip_hdr + IPV4_CSUM_OFFSET,
+            inet_csum_update32(load16(ip_hdr + IPV4_CSUM_OFFSET), old_ip, new_ip));
+    // 地址属于伪头部, 传输层校验和同样需要更新
+    if (l4_csum == NULL || (protocol == INET_PROTO_UDP && load16(l4_csum) == 0)) {
+        return;
+    }
+    l4_csum_store(l4_csum, inet_csum_update32(load16(l4_csum), old_ip, new_ip), protocol);
+}
+
+void l4_rewrite_port(uint8_t *port, uint16_t new_port, uint8_t *l4_csum, uint8_t protocol) {
+    uint16_t old_val = load16(port);
+
+    port[0] = (uint8_t)(new_port >> 8);
+    port[1] = (uint8_t)new_port;
+    if (l4_csum == NULL || (protocol == INET_PROTO_UDP && load16(l4_csum) == 0)) {
+        return;
+    }
+    l4_csum_store(l4_csum, inet_csum_update16(load16(l4_csum), old_val, load16(port)), protocol);
+}
@@ -0,0 +1,67 @@
+#ifndef __INET_CSUM_H__
+#define __INET_CSUM_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Internet 校验和 (RFC 1071 一补数和)
+ *
+ * 所有数据按内存中的网络字节序直接求和, 结果同样是网络字节序:
+ * 返回的 16 位校验和用 memcpy 原样写入报文头即可, 不需要 htons.
+ * 部分和 (inet_csum_partial 等返回的 uint32_t) 未取反, 可继续累加, 最后用 inet_csum_fold 收尾.
+ */
+
+// 分散/聚集段: 报文各部分可以位于不同缓冲区, 求和时不拷贝
+typedef struct {
+    const void *base;
+    size_t len;
+} csum_iov_t;
+
+// 累加 data 的一补数部分和, 64 位累加器, 主机支持 SSE2 时每次处理 64 字节
+uint32_t inet_csum_partial(const void *data, size_t len, uint32_t sum);
+
+// 合并两个部分和 (两段数据在报文中的偏移均为偶数时)
+uint32_t inet_csum_add(uint32_t a, uint32_t b);
+
+// 折叠为 16 位并取反, 得到最终校验和
+uint16_t inet_csum_fold(uint32_t sum);
+
+// 连续缓冲区的校验和 (如 IPv4 头部, 校验和字段需先置 0)
+uint16_t inet_csum(const void *data, size_t len);
+
+// 多段数据的部分和, 段长度为奇数时后续段自动按字节交换对齐
+uint32_t inet_csum_iov_partial(const csum_iov_t *iov, int count, uint32_t sum);
+uint16_t inet_csum_iov(const csum_iov_t *iov, int count, uint32_t sum);
+
+// IPv4 伪头部部分和; src/dst 为网络字节序, l4_len 为主机字节序的 TCP/UDP 长度
+uint32_t inet_csum_pseudo_ipv4(uint32_t src_ip, uint32_t dst_ip, uint8_t protocol, uint16_t l4_len);
+
+/*
+ * RFC 1624 增量更新: HC' = ~(~HC + ~m + m')
+ * csum 为报文中现有校验和, old/new 为被改写字段的旧值/新值, 均为内存中的原样取值
+ */
+uint16_t inet_csum_update16(uint16_t csum, uint16_t old_val, uint16_t new_val);
+uint16_t inet_csum_update32(uint16_t csum, uint32_t old_val, uint32_t new_val);
+
+// 转发路径常用改写: 报文内字段和校验和一起更新, 不重算整包
+// TTL 减 1 并更新 IPv4 头部校验和, 返回新的 TTL
+uint8_t ipv4_decrement_ttl(uint8_t *ip_hdr);
+// 改写 IPv4 源/目的地址 (which: 0 源, 1 目的; new_ip 为网络字节序, 如 inet_addr 的返回值)
+// 同时更新 IP 头部和 l4_csum 指向的 TCP/UDP 校验和, 协议取自 IP 头部
+void ipv4_rewrite_addr(uint8_t *ip_hdr, int which, uint32_t new_ip, uint8_t *l4_csum);
+// 改写 TCP/UDP 端口 (port 指向报文中的端口字段, new_port 为主机字节序), 同时更新 l4_csum
+// protocol 为 IP 头部中的协议号 (6 TCP, 17 UDP)
+void l4_rewrite_port(uint8_t *port, uint16_t new_port, uint8_t *l4_csum, uint8_t protocol);
+// 以上 l4_csum 为 NULL 时不更新传输层校验和; UDP 校验和为 0 (未启用) 时保持为 0,
+// UDP 更新结果为 0 时写 0xFFFF
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
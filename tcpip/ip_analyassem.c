@@ -3,6 +3,8 @@
 #include <string.h>
 // #include <arpa/inet.h> // 在Windows中使用<winsock2.h>
 #include <winsock2.h>
+#include <time.h>
+#include "pkt_build.h"
 
 #define MAC_ADDR_LEN 6
 #define IP_ADDR_LEN  4
@@ -72,45 +74,148 @@ void assemble_ethernet_frame(struct ethernet_frame *frame, const uint8_t *dest_m
     memcpy(frame->dest_mac, dest_mac, MAC_ADDR_LEN);
     memcpy(frame->src_mac, src_mac, MAC_ADDR_LEN);
     frame->type = htons(type);
-    memcpy(frame->payload, payload, payload_size);
+    if (frame->payload != payload) {
+        memcpy(frame->payload, payload, payload_size);
+    }
 }
 
 
-
-
-int main() {
-    int i;
-    struct ethernet_frame eth_frame;
-    uint8_t dest_mac[MAC_ADDR_LEN] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
-    uint8_t src_mac[MAC_ADDR_LEN] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
-
-    // 构建IP头部和TCP头部
+// 原有组装方式: 头部结构体和负载逐个拷贝进 ethernet_frame, 不计算校验和 (作为基准)
+static size_t legacy_build(struct ethernet_frame *eth_frame, const uint8_t *dest_mac, const uint8_t *src_mac,
+                           const uint8_t *tcp_data, size_t data_len) {
     struct ip_header ip_hdr;
     struct tcp_header tcp_hdr;
-    uint8_t tcp_data[] = {0x12, 0x34, 0x56, 0x78}; // TCP数据
+    size_t ip_total_length = sizeof(struct ip_header) + sizeof(struct tcp_header) + data_len;
 
-    size_t ip_total_length = sizeof(struct ip_header) + sizeof(struct tcp_header) + sizeof(tcp_data);
     assemble_ip_header(&ip_hdr, inet_addr("192.168.1.2"), inet_addr("192.168.1.3"), ip_total_length, IPPROTO_TCP);
     assemble_tcp_header(&tcp_hdr, 12345, 80, 0, 0, 8192);
 
-    // 将IP头部、TCP头部和TCP数据放入以太网帧的有效载荷中
-    memcpy(eth_frame.payload, &ip_hdr, sizeof(ip_hdr));
-    memcpy(eth_frame.payload + sizeof(ip_hdr), &tcp_hdr, sizeof(tcp_hdr));
-    memcpy(eth_frame.payload + sizeof(ip_hdr) + sizeof(tcp_hdr), tcp_data, sizeof(tcp_data));
+    memcpy(eth_frame->payload, &ip_hdr, sizeof(ip_hdr));
+    memcpy(eth_frame->payload + sizeof(ip_hdr), &tcp_hdr, sizeof(tcp_hdr));
+    memcpy(eth_frame->payload + sizeof(ip_hdr) + sizeof(tcp_hdr), tcp_data, data_len);
 
+    assemble_ethernet_frame(eth_frame, dest_mac, src_mac, ETHERNET_TYPE_IPv4, eth_frame->payload, ip_total_length);
+    return 14 + ip_total_length;
+}
 
-    // 组装以太网帧
-    assemble_ethernet_frame(&eth_frame, dest_mac, src_mac, ETHERNET_TYPE_IPv4, eth_frame.payload, ip_total_length);
+static void print_frame(const uint8_t *frame, size_t len) {
+    size_t i;
 
-    for (i = 0; i < 14 + ip_total_length; i++)
+    for (i = 0; i < len; i++)
     {
         if(i%16 == 0)
             printf("\r\n");
-        printf("0x%02x ", *((char*)&eth_frame + i) & 0xff);
+        printf("0x%02x ", frame[i]);
     }
-    
-    // ... 在此处可以发送eth_frame或进一步处理 ...
+    printf("\r\n");
+}
 
-    return 0;
+#define BENCH_POOL_SIZE     64
+
+static double bench_seconds(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// 每秒组帧数: 原有 memcpy 方式 / 缓冲池 + headroom / 分散段 (负载不拷贝)
+static void bench(const uint8_t *dest_mac, const uint8_t *src_mac, size_t data_len, long rounds) {
+    static struct ethernet_frame eth_frame;
+    static uint8_t data[MAX_PAYLOAD_SIZE];
+    static pkt_buf_t descs[BENCH_POOL_SIZE];
+    static uint8_t storage[BENCH_POOL_SIZE * PKT_BUF_SIZE];
+    pkt_pool_t pool;
+    pkt_flow_t flow;
+    uint8_t hdr[PKT_HDR_MAX];
+    csum_iov_t payload = { data, data_len };
+    csum_iov_t chain[2];
+    volatile uint32_t sink = 0;
+    clock_t start;
+    double t_legacy, t_pool, t_iov;
+    long n;
+
+    memset(data, 0x5A, sizeof(data));
+    pkt_pool_init(&pool, descs, storage, BENCH_POOL_SIZE);
+    pkt_flow_init(&flow, dest_mac, src_mac, inet_addr("192.168.1.2"), inet_addr("192.168.1.3"),
+                  PKT_PROTO_TCP, 12345, 80);
+
+    start = clock();
+    for (n = 0; n < rounds; n++) {
+        data[0] = (uint8_t)n;
+        sink += (uint32_t)legacy_build(&eth_frame, dest_mac, src_mac, data, data_len);
+        sink += eth_frame.payload[0];
+    }
+    t_legacy = bench_seconds(start);
+
+    start = clock();
+    for (n = 0; n < rounds; n++) {
+        pkt_buf_t *pkt = pkt_alloc(&pool);
+
+        data[0] = (uint8_t)n;
+        // 应用把负载直接写进池缓冲区, 这是整条路径上唯一一次拷贝
+        memcpy(pkt_put(pkt, data_len), data, data_len);
+        pkt_build(&flow, pkt);
+        sink += pkt->len + pkt->data[0];
+        pkt_free(&pool, pkt);
+    }
+    t_pool = bench_seconds(start);
+
+    start = clock();
+    for (n = 0; n < rounds; n++) {
+        data[0] = (uint8_t)n;
+        sink += (uint32_t)pkt_build_iov(&flow, hdr, &payload, 1, chain);
+        sink += hdr[PKT_HDR_MAX - 4];
+    }
+    t_iov = bench_seconds(start);
+
+    printf("payload %4u: legacy %8.2f Mpps, pool+headroom %8.2f Mpps, iov %8.2f Mpps (%u)\r\n",
+           (unsigned)data_len, rounds / t_legacy / 1e6, rounds / t_pool / 1e6, rounds / t_iov / 1e6,
+           (unsigned)(sink & 1));
 }
 
+int main(int argc, char *argv[]) {
+    int i;
+    struct ethernet_frame eth_frame;
+    uint8_t dest_mac[MAC_ADDR_LEN] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+    uint8_t src_mac[MAC_ADDR_LEN] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+    uint8_t tcp_data[] = {0x12, 0x34, 0x56, 0x78}; // TCP数据
+    size_t frame_len;
+
+    static pkt_buf_t descs[4];
+    static uint8_t storage[4 * PKT_BUF_SIZE];
+    pkt_pool_t pool;
+    pkt_flow_t flow;
+    pkt_buf_t *pkt;
+
+    if (argc > 1 && strcmp(argv[1], "-b") == 0) {
+        static const size_t sizes[] = { 4, 64, 512, 1460 };
+        for (i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++) {
+            bench(dest_mac, src_mac, sizes[i], 2000000);
+        }
+        return 0;
+    }
+
+    // 原有方式: 校验和为 0
+    frame_len = legacy_build(&eth_frame, dest_mac, src_mac, tcp_data, sizeof(tcp_data));
+    print_frame((const uint8_t *)&eth_frame, frame_len);
+
+    // 组帧器: 负载写入池缓冲区, 头部填入其前方预留空间, 校验和同时算好
+    pkt_pool_init(&pool, descs, storage, 4);
+    pkt_flow_init(&flow, dest_mac, src_mac, inet_addr("192.168.1.2"), inet_addr("192.168.1.3"),
+                  PKT_PROTO_TCP, 12345, 80);
+    pkt_flow_set_tcp(&flow, PKT_TCP_PSH | PKT_TCP_ACK, 8192);
+    pkt = pkt_alloc(&pool);
+    memcpy(pkt_put(pkt, sizeof(tcp_data)), tcp_data, sizeof(tcp_data));
+    if (pkt_build(&flow, pkt) == 0) {
+        print_frame(pkt->data, pkt->len);
+        // 含校验和字段一起求和, 结果为 0 说明校验和正确
+        printf("ip verify 0x%x, tcp verify 0x%x\r\n",
+               inet_csum(pkt->data + PKT_ETH_HLEN, PKT_IPV4_HLEN),
+               inet_csum_fold(inet_csum_partial(pkt->data + PKT_ETH_HLEN + PKT_IPV4_HLEN, pkt->len - PKT_ETH_HLEN - PKT_IPV4_HLEN,
+                              inet_csum_pseudo_ipv4(inet_addr("192.168.1.2"), inet_addr("192.168.1.3"), PKT_PROTO_TCP,
+                                                    (uint16_t)(pkt->len - PKT_ETH_HLEN - PKT_IPV4_HLEN)))));
+    }
+    pkt_free(&pool, pkt);
+
+    // ... 在此处可以发送帧或进一步处理; 运行 -b 对比各方式的组帧速率 ...
+
+    return 0;
+}
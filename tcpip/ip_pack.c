@@ -3,6 +3,7 @@
 #include <string.h>
 // #include <arpa/inet.h> // ֽת
 #include <winsock2.h>
+#include "inet_csum.h"
 
 
 #define MAC_ADDR_LEN 6
@@ -43,14 +44,6 @@ struct tcp_header {
     uint16_t urgent_pointer;     // ָ
 };
 
-struct pseudo_header {
-    uint32_t src_addr;
-    uint32_t dst_addr;
-    uint8_t reserved;
-    uint8_t protocol;
-    uint16_t tcp_length;
-};
-
 
 
 uint8_t packet[] = {
@@ -105,72 +98,29 @@ void parse_ip_header(const uint8_t *buffer, struct ip_header *header) {
 }
 
 uint16_t compute_ip_checksum(uint8_t *header, size_t len) {
-    uint32_t sum = 0;
-    uint16_t *ptr = (uint16_t *)header;
-
-    for (sum = 0; len > 1; len -= 2) {
-        sum += *ptr++;
-    }
-
-    if (len > 0) {
-        sum += *(uint8_t *)ptr;
-    }
-
-    while (sum >> 16) {
-        sum = (sum & 0xFFFF) + (sum >> 16);
-    }
-
-    return (uint16_t)~sum;
+    return inet_csum(header, len);
 }
 
 uint16_t compute_tcp_checksum(uint16_t *addr, int len) {
-    uint32_t sum = 0;
-    while (len > 1) {
-        sum += *addr++;
-        len -= sizeof(uint16_t);
-    }
-    if (len > 0) {
-        sum += *(uint8_t *)addr;
-    }
-    while (sum >> 16) {
-        sum = (sum & 0xffff) + (sum >> 16);
-    }
-    return (uint16_t)~sum;
+    return inet_csum(addr, (size_t)len);
 }
 
+// tcp_seg ָе TCP  (ͷ + ), αͷУֶ 0 
+// γ TCP Сͷ 20 ֽʱ 0,  iov
+uint16_t tcp_checksum(struct ip_header *ip_hdr, const uint8_t *tcp_seg, int tcp_len) {
+    static const uint8_t zero_csum[2] = { 0, 0 };
+    if (tcp_len < 20) {
+        return 0;
+    }
+
+    csum_iov_t iov[3] = {
+        { tcp_seg,      16 },
+        { zero_csum,    2 },
+        { tcp_seg + 18, (size_t)tcp_len - 18 },
+    };
+    uint32_t sum = inet_csum_pseudo_ipv4(ip_hdr->src_ip, ip_hdr->dest_ip, ip_hdr->protocol, (uint16_t)tcp_len);
 
-uint16_t tcp_checksum(struct ip_header *ip_hdr, struct tcp_header *tcp_hdr, uint8_t *data, int data_len) {
-    // αͷ
-    struct pseudo_header psh;
-    psh.src_addr = ip_hdr->src_ip;
-    psh.dst_addr = ip_hdr->dest_ip;
-    psh.reserved = 0;
-    psh.protocol = ip_hdr->protocol;
-    psh.tcp_length = htons(sizeof(struct tcp_header) + data_len);
-
-    int psh_size = sizeof(struct pseudo_header);
-    int tcp_header_size = sizeof(struct tcp_header);
-
-    // ĻС
-    int total_len = psh_size + tcp_header_size + data_len;
-    uint8_t *buffer = (uint8_t *)malloc(total_len);
-    printf("tcp psh_size %d\r\n",psh_size);
-    printf("tcp tcp_header_size %d\r\n",tcp_header_size);
-    printf("tcp total_len %d\r\n",total_len);
-    printf("psh.src_addr   0x%x\r\n",psh.src_addr  ); 
-    printf("psh.dst_addr   0x%x\r\n",psh.dst_addr  ); 
-    printf("psh.reserved   0x%x\r\n",psh.reserved  ); 
-    printf("psh.protocol   0x%x\r\n",psh.protocol  ); 
-    printf("psh.tcp_length 0x%x\r\n",psh.tcp_length);
-    // װαͷTCPͷݵ
-    memcpy(buffer, &psh, psh_size);
-    memcpy(buffer + psh_size, tcp_hdr, tcp_header_size);
-    memcpy(buffer + psh_size + tcp_header_size, data, data_len);
-
-    // У
-    uint16_t checksum = compute_tcp_checksum((uint16_t *)buffer, total_len);
-    free(buffer);
-    return checksum;
+    return inet_csum_iov(iov, 3, sum);
 }
 
 
@@ -245,13 +195,32 @@ int main() {
             // ֶ...
             printf("check sum1 0x%x\r\n",ip_hdr.header_checksum);
             // ip_hdrֶ
-            tcpChecksum = tcp_checksum( &ip_hdr, &tcp_hdr, (uint8_t *)eth_frame.payload+40 , eth_frame.payload_size - 40 );
-            printf("tcpChecksum 0x%x\r\n", tcpChecksum);
+            tcpChecksum = tcp_checksum(&ip_hdr, eth_frame.payload + ip_header_length, total_length - ip_header_length);
+            printf("tcpChecksum 0x%x (in packet 0x%x)\r\n", ntohs(tcpChecksum), tcp_hdr.checksum);
 
             printf("sizeof(ip_hdr) %d\r\n",sizeof(ip_hdr));
             // packet_ipheadע УλҪ0 IPУ
             ip_hdr.header_checksum = compute_ip_checksum((uint8_t *)&packet_iphead, sizeof(packet_iphead));
             printf("check sum2 0x%x\r\n",ip_hdr.header_checksum);
+
+            // ת·: ԭظдֶ, УͰ RFC 1624 , Ӧһ
+            {
+                uint8_t *ip = eth_frame.payload;
+                uint8_t *tcp = ip + ip_header_length;
+                uint16_t ip_csum, tcp_csum;
+
+                ipv4_decrement_ttl(ip);
+                ipv4_rewrite_addr(ip, 1, inet_addr("10.0.0.2"), tcp + 16);
+                l4_rewrite_port(tcp + 2, 8080, tcp + 16, ip[9]);
+                parse_ip_header(ip, &ip_hdr);
+
+                memcpy(&ip_csum, ip + 10, 2);
+                memcpy(&tcp_csum, tcp + 16, 2);
+                // Уֶһ, ͷȷʱΪ 0
+                printf("forward ip csum 0x%x verify 0x%x\r\n", ntohs(ip_csum), compute_ip_checksum(ip, ip_header_length));
+                printf("forward tcp csum 0x%x full 0x%x\r\n", ntohs(tcp_csum),
+                       ntohs(tcp_checksum(&ip_hdr, tcp, total_length - ip_header_length)));
+            }
         }
     }
 
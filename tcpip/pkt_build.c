@@ -0,0 +1,192 @@
+#include "pkt_build.h"
+#include <string.h>
+
+#define ETH_TYPE_IPV4       0x0800
+
+// 以太网帧内各头部的偏移
+#define OFF_IP              PKT_ETH_HLEN
+#define OFF_L4              (PKT_ETH_HLEN + PKT_IPV4_HLEN)
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+void pkt_buf_init(pkt_buf_t *pkt, uint8_t *mem, size_t size, size_t headroom) {
+    pkt->next = NULL;
+    pkt->head = mem;
+    pkt->data = mem + headroom;
+    pkt->end = mem + size;
+    pkt->len = 0;
+}
+
+uint8_t *pkt_put(pkt_buf_t *pkt, size_t len) {
+    uint8_t *tail = pkt->data + pkt->len;
+
+    if (len > (size_t)(pkt->end - tail)) {
+        return NULL;
+    }
+    pkt->len += (uint16_t)len;
+    return tail;
+}
+
+uint8_t *pkt_push(pkt_buf_t *pkt, size_t len) {
+    if (len > (size_t)(pkt->data - pkt->head)) {
+        return NULL;
+    }
+    pkt->data -= len;
+    pkt->len += (uint16_t)len;
+    return pkt->data;
+}
+
+void pkt_pool_init(pkt_pool_t *pool, pkt_buf_t *descs, uint8_t *storage, uint32_t count) {
+    uint32_t i;
+
+    pool->free = NULL;
+    pool->count = count;
+    pool->in_use = 0;
+    // 倒序入链, 使首次分配按地址顺序进行
+    for (i = count; i > 0; i--) {
+        pkt_buf_t *pkt = &descs[i - 1];
+        pkt->head = storage + (size_t)(i - 1) * PKT_BUF_SIZE;
+        pkt->end = pkt->head + PKT_BUF_SIZE;
+        pkt->next = pool->free;
+        pool->free = pkt;
+    }
+}
+
+pkt_buf_t *pkt_alloc(pkt_pool_t *pool) {
+    pkt_buf_t *pkt = pool->free;
+
+    if (pkt == NULL) {
+        return NULL;
+    }
+    pool->free = pkt->next;
+    pool->in_use++;
+    pkt->next = NULL;
+    pkt->data = pkt->head + PKT_HEADROOM;
+    pkt->len = 0;
+    return pkt;
+}
+
+void pkt_free(pkt_pool_t *pool, pkt_buf_t *pkt) {
+    pkt->next = pool->free;
+    pool->free = pkt;
+    pool->in_use--;
+}
+
+void pkt_flow_init(pkt_flow_t *flow, const uint8_t *dst_mac, const uint8_t *src_mac,
+                   uint32_t src_ip, uint32_t dst_ip, uint8_t protocol,
+                   uint16_t src_port, uint16_t dst_port) {
+    uint8_t *t = flow->tmpl;
+    uint8_t *ip = t + OFF_IP;
+    uint8_t *l4 = t + OFF_L4;
+
+    memset(flow, 0, sizeof(*flow));
+    flow->protocol = protocol;
+    flow->hdr_len = OFF_L4 + (protocol == PKT_PROTO_TCP ? PKT_TCP_HLEN : PKT_UDP_HLEN);
+
+    memcpy(t, dst_mac, 6);
+    memcpy(t + 6, src_mac, 6);
+    put16(t + 12, ETH_TYPE_IPV4);
+
+    ip[0] = 0x45;               // IPv4, 头部 20 字节
+    ip[6] = 0x40;               // DF
+    ip[8] = 64;                 // TTL
+    ip[9] = protocol;
+    memcpy(ip + 12, &src_ip, 4);
+    memcpy(ip + 16, &dst_ip, 4);
+
+    put16(l4, src_port);
+    put16(l4 + 2, dst_port);
+    if (protocol == PKT_PROTO_TCP) {
+        l4[12] = (PKT_TCP_HLEN / 4) << 4;
+        l4[13] = PKT_TCP_PSH | PKT_TCP_ACK;
+        put16(l4 + 14, 8192);
+    }
+}
+
+void pkt_flow_set_tcp(pkt_flow_t *flow, uint8_t flags, uint16_t window) {
+    flow->tmpl[OFF_L4 + 13] = flags;
+    put16(flow->tmpl + OFF_L4 + 14, window);
+}
+
+size_t pkt_build_hdr(pkt_flow_t *flow, uint8_t *hdr, uint32_t payload_sum, size_t payload_len) {
+    uint8_t *ip = hdr + OFF_IP;
+    uint8_t *l4 = hdr + OFF_L4;
+    size_t l4_len = flow->hdr_len - OFF_L4 + payload_len;
+    uint32_t src_ip, dst_ip, sum;
+    uint16_t csum;
+
+    if (PKT_IPV4_HLEN + l4_len > PKT_MTU) {
+        return 0;
+    }
+
+    memcpy(hdr, flow->tmpl, flow->hdr_len);
+
+    put16(ip + 2, (uint16_t)(PKT_IPV4_HLEN + l4_len));
+    put16(ip + 4, flow->ip_id++);
+    csum = inet_csum(ip, PKT_IPV4_HLEN);
+    memcpy(ip + 10, &csum, 2);
+
+    if (flow->protocol == PKT_PROTO_TCP) {
+        put32(l4 + 4, flow->seq);
+        put32(l4 + 8, flow->ack);
+        flow->seq += (uint32_t)payload_len;
+    } else {
+        put16(l4 + 4, (uint16_t)l4_len);
+    }
+
+    // 头部长度为偶数, 负载部分和可以直接累加, 不需要字节交换
+    memcpy(&src_ip, ip + 12, 4);
+    memcpy(&dst_ip, ip + 16, 4);
+    sum = inet_csum_pseudo_ipv4(src_ip, dst_ip, flow->protocol, (uint16_t)l4_len);
+    sum = inet_csum_partial(l4, flow->hdr_len - OFF_L4, sum);
+    csum = inet_csum_fold(inet_csum_add(sum, payload_sum));
+    // UDP 中 0 表示未计算校验和, 按 RFC 768 发送全 1
+    if (flow->protocol == PKT_PROTO_UDP && csum == 0) {
+        csum = 0xFFFF;
+    }
+    memcpy(l4 + (flow->protocol == PKT_PROTO_TCP ? 16 : 6), &csum, 2);
+
+    return flow->hdr_len;
+}
+
+int pkt_build(pkt_flow_t *flow, pkt_buf_t *pkt) {
+    size_t payload_len = pkt->len;
+    uint32_t sum = inet_csum_partial(pkt->data, payload_len, 0);
+    uint8_t *hdr = pkt_push(pkt, flow->hdr_len);
+
+    if (hdr == NULL) {
+        return -1;
+    }
+    if (pkt_build_hdr(flow, hdr, sum, payload_len) == 0) {
+        pkt->data += flow->hdr_len;
+        pkt->len -= flow->hdr_len;
+        return -1;
+    }
+    return 0;
+}
+
+int pkt_build_iov(pkt_flow_t *flow, uint8_t *hdr, const csum_iov_t *payload, int count, csum_iov_t *chain) {
+    size_t payload_len = 0;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        payload_len += payload[i].len;
+        chain[i + 1] = payload[i];
+    }
+    if (pkt_build_hdr(flow, hdr, inet_csum_iov_partial(payload, count, 0), payload_len) == 0) {
+        return -1;
+    }
+    chain[0].base = hdr;
+    chain[0].len = flow->hdr_len;
+    return count + 1;
+}
@@ -0,0 +1,108 @@
+#ifndef __PKT_BUILD_H__
+#define __PKT_BUILD_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "inet_csum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 零拷贝报文组装
+ *
+ * 负载由调用者写入报文缓冲区 (或以分散段给出), 以太网/IPv4/TCP/UDP 头部
+ * 从流模板拷贝到负载前方的预留空间 (headroom) 中并就地填写长度, 序号和校验和,
+ * 负载本身始终不移动.
+ */
+
+#define PKT_ETH_HLEN        14
+#define PKT_IPV4_HLEN       20
+#define PKT_TCP_HLEN        20
+#define PKT_UDP_HLEN        8
+#define PKT_HDR_MAX         (PKT_ETH_HLEN + PKT_IPV4_HLEN + PKT_TCP_HLEN)
+#define PKT_MTU             1500
+
+// 池中缓冲区的预留头部空间, 大于 PKT_HDR_MAX 并保持负载起点对齐
+#define PKT_HEADROOM        64
+#define PKT_BUF_SIZE        (PKT_HEADROOM + PKT_ETH_HLEN + PKT_MTU)
+
+#define PKT_PROTO_TCP       6
+#define PKT_PROTO_UDP       17
+
+#define PKT_TCP_FIN         0x01
+#define PKT_TCP_SYN         0x02
+#define PKT_TCP_RST         0x04
+#define PKT_TCP_PSH         0x08
+#define PKT_TCP_ACK         0x10
+
+// 报文缓冲区: [head .. data) 为预留空间, [data .. data+len) 为已有内容
+typedef struct pkt_buf {
+    struct pkt_buf *next;       // 空闲链表
+    uint8_t *head;
+    uint8_t *data;
+    uint8_t *end;
+    uint16_t len;
+} pkt_buf_t;
+
+// 固定大小缓冲区池, 空闲链表 LIFO 分配, 最近释放的缓冲区仍在缓存中; 非线程安全
+typedef struct {
+    pkt_buf_t *free;
+    uint32_t count;
+    uint32_t in_use;
+} pkt_pool_t;
+
+// 流模板: 同一条流的报文头部只有长度, IP 标识, 序号和校验和不同
+typedef struct {
+    uint8_t  tmpl[PKT_HDR_MAX];     // 预先填好的头部 (网络字节序)
+    uint16_t hdr_len;               // 以太网 + IPv4 + TCP/UDP 头部长度
+    uint8_t  protocol;
+    uint16_t ip_id;                 // 每个报文递增
+    uint32_t seq;                   // TCP 下一个发送序号, 每个报文按负载长度推进
+    uint32_t ack;
+} pkt_flow_t;
+
+// 用调用者自己的内存初始化报文缓冲区, 预留 headroom 字节给头部
+void pkt_buf_init(pkt_buf_t *pkt, uint8_t *mem, size_t size, size_t headroom);
+// 在尾部追加 len 字节 (写负载), 返回写入位置; 空间不足返回 NULL
+uint8_t *pkt_put(pkt_buf_t *pkt, size_t len);
+// 在头部前插 len 字节 (写头部), 返回新的起点; 预留空间不足返回 NULL
+uint8_t *pkt_push(pkt_buf_t *pkt, size_t len);
+
+// storage 至少为 count * PKT_BUF_SIZE 字节, descs 为 count 个描述符
+void pkt_pool_init(pkt_pool_t *pool, pkt_buf_t *descs, uint8_t *storage, uint32_t count);
+// 取出一个空缓冲区, 已预留 PKT_HEADROOM; 池空返回 NULL
+pkt_buf_t *pkt_alloc(pkt_pool_t *pool);
+void pkt_free(pkt_pool_t *pool, pkt_buf_t *pkt);
+
+/*
+ * 初始化流模板; MAC 为 6 字节数组, IP 为网络字节序 (inet_addr 的返回值), 端口为主机字节序.
+ * protocol 为 PKT_PROTO_TCP 或 PKT_PROTO_UDP; TCP 默认标志 PSH|ACK, 窗口 8192, TTL 64
+ */
+void pkt_flow_init(pkt_flow_t *flow, const uint8_t *dst_mac, const uint8_t *src_mac,
+                   uint32_t src_ip, uint32_t dst_ip, uint8_t protocol,
+                   uint16_t src_port, uint16_t dst_port);
+void pkt_flow_set_tcp(pkt_flow_t *flow, uint8_t flags, uint16_t window);
+
+/*
+ * 把头部写入 hdr (至少 flow->hdr_len 字节), 负载紧跟其后.
+ * payload_sum 为负载的一补数部分和 (inet_csum_partial/inet_csum_iov_partial), 两个校验和都在这里填好.
+ * 返回头部长度; 负载过长返回 0
+ */
+size_t pkt_build_hdr(pkt_flow_t *flow, uint8_t *hdr, uint32_t payload_sum, size_t payload_len);
+
+// 负载已在 pkt 中, 头部写入其前方预留空间; 成功后 pkt->data 指向以太网帧起点. 返回 0 成功, -1 失败
+int pkt_build(pkt_flow_t *flow, pkt_buf_t *pkt);
+
+/*
+ * 分散/聚集形式: 头部写入调用者提供的 hdr, chain 输出 { hdr, payload[0], ..., payload[count-1] },
+ * 交给支持 gather 的发送接口 (writev/sendmsg/DMA 描述符链). 返回 chain 段数, 失败返回 -1
+ */
+int pkt_build_iov(pkt_flow_t *flow, uint8_t *hdr, const csum_iov_t *payload, int count, csum_iov_t *chain);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
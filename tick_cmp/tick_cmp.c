@@ -14,6 +14,30 @@ uint32_t tick_diff(uint32_t new_time_ms, uint32_t old_time_ms) {
     return new_time_ms - old_time_ms;
 }
 
+/**
+ * @brief 判断时刻 a 是否早于时刻 b，能正确处理u32溢出。
+ *
+ * 差值按有符号数解释，因此要求两个时刻相差小于 2^31 ms (约 24.8 天)。
+ * 直接比较 a < b 在回卷附近会出错：0xFFFFFFF0 实际早于 0x10。
+ */
+int tick_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+int tick_after(uint32_t a, uint32_t b) {
+    return tick_before(b, a);
+}
+
+/**
+ * @brief 判断截止时刻是否已到 (now >= deadline)。
+ *
+ * 超时只需记录一次 deadline = now + timeout，之后与当前时刻比较，
+ * 不必保存起点再每次求差。
+ */
+int tick_expired(uint32_t now, uint32_t deadline) {
+    return !tick_before(now, deadline);
+}
+
 
 
 int main(void)
@@ -22,5 +46,9 @@ int main(void)
     time = tick_diff(1,2);
 
     printf("diff time %d\r\n",time);
+
+    // 跨越回卷: 0xFFFFFFF0 + 0x20 = 0x10
+    printf("before %d after %d\r\n", tick_before(0xFFFFFFF0u, 0x10u), tick_after(0xFFFFFFF0u, 0x10u));
+    printf("expired %d %d\r\n", tick_expired(0x0Fu, 0xFFFFFFF0u + 0x20u), tick_expired(0x10u, 0xFFFFFFF0u + 0x20u));
     return 0;
 }
\ No newline at end of file
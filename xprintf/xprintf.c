@@ -1,112 +1,492 @@
 #include "xprintf.h"
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#ifndef XPRINTF_USE_STDOUT
 #include "usart.h"
-void my_putchar(char c) {
-    // putchar(c);
-    HAL_UART_Transmit( &huart1, (uint8_t*)&c, 1, HAL_MAX_DELAY);
+#endif
+
+/* ------------------------------------------------------------
+ * 输出目标
+ * 缓冲区模式 (write == NULL): 写入 buf, 超出 size-1 的部分只计数不写
+ * 分块模式: buf 为分块缓冲, 写满即交给 write
+ * ------------------------------------------------------------ */
+typedef struct {
+    xprintf_write_t write;
+    void *arg;
+    char *buf;
+    size_t size;
+    size_t pos;
+    int total;          // 完整输出的字符数
+} xout_t;
+
+static void out_flush(xout_t *o) {
+    if (o->write != NULL && o->pos > 0) {
+        o->write(o->arg, o->buf, o->pos);
+        o->pos = 0;
+    }
 }
 
-void my_puts(const char *str) {
-    while (*str) {
-        my_putchar(*str);
-        str++;
+static void out_put(xout_t *o, const char *s, size_t n) {
+    o->total += (int)n;
+    while (n > 0) {
+        size_t room = o->size - o->pos;
+        if (o->write == NULL) {
+            // 缓冲区模式保留结尾 '\0' 的位置
+            room = (o->size > o->pos + 1) ? o->size - o->pos - 1 : 0;
+            if (n < room) room = n;
+            memcpy(o->buf + o->pos, s, room);
+            o->pos += room;
+            return;
+        }
+        if (room > n) room = n;
+        memcpy(o->buf + o->pos, s, room);
+        o->pos += room;
+        s += room;
+        n -= room;
+        if (o->pos == o->size) out_flush(o);
     }
 }
 
-void my_putint(int num) {
-    if (num == 0) {
-        my_putchar('0');
-        return;
+static void out_fill(xout_t *o, char c, size_t n) {
+    char block[16];
+    memset(block, c, sizeof(block));
+    while (n > 0) {
+        size_t step = (n > sizeof(block)) ? sizeof(block) : n;
+        out_put(o, block, step);
+        n -= step;
     }
+}
+
+/* ------------------------------------------------------------
+ * 数字转换: 从缓冲区末尾向前写, 返回首字符位置
+ * ------------------------------------------------------------ */
+static const char digit_pairs[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
 
-    if (num < 0) {
-        my_putchar('-');
-        num = -num;
+static const uint32_t pow10_u32[10] = {
+    1u, 10u, 100u, 1000u, 10000u, 100000u,
+    1000000u, 10000000u, 100000000u, 1000000000u
+};
+
+// 每次除以 100 产出两位, 除法次数减半
+static char *fmt_u32(char *end, uint32_t v) {
+    while (v >= 100) {
+        uint32_t q = v / 100;
+        const char *d = &digit_pairs[(v - q * 100) * 2];
+        *--end = d[1];
+        *--end = d[0];
+        v = q;
+    }
+    if (v >= 10) {
+        *--end = digit_pairs[v * 2 + 1];
+        *--end = digit_pairs[v * 2];
+    } else {
+        *--end = (char)('0' + v);
     }
+    return end;
+}
 
-    char buffer[20];
-    int i = 0;
+// 64 位值先按 1e8 切段, 64 位除法最多两次, 其余都是 32 位运算
+static char *fmt_u64(char *end, uint64_t v) {
+    while (v > 0xFFFFFFFFu) {
+        uint64_t q = v / 100000000u;
+        char *stop = end - 8;
+        end = fmt_u32(end, (uint32_t)(v - q * 100000000u));
+        while (end > stop) *--end = '0';
+        v = q;
+    }
+    return fmt_u32(end, (uint32_t)v);
+}
 
-    while (num > 0) {
-        buffer[i++] = '0' + (num % 10);
-        num /= 10;
+static char *fmt_hex(char *end, uint64_t v, int uppercase) {
+    const char *digits = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+    do {
+        *--end = digits[v & 0xF];
+        v >>= 4;
+    } while (v != 0);
+    return end;
+}
+
+/* ------------------------------------------------------------
+ * 格式解析
+ * ------------------------------------------------------------ */
+typedef struct {
+    size_t width;       // 字段宽度
+    int precision;      // 精度, -1 表示未指定
+    int left_align;     // 左对齐标志
+    char pad_char;      // 填充字符
+    char sign_char;     // 正数前缀: 0 / '+' / ' '
+    int alt_form;       // '#' 标志
+    int length;         // 长度修饰, 见下
+} format_info;
+
+enum { LEN_INT, LEN_CHAR, LEN_SHORT, LEN_LONG, LEN_LLONG, LEN_SIZE };
+
+static const char *parse_format(const char *format, format_info *info, va_list *args) {
+    info->width = 0;
+    info->precision = -1;
+    info->left_align = 0;
+    info->pad_char = ' ';
+    info->sign_char = 0;
+    info->alt_form = 0;
+    info->length = LEN_INT;
+
+    for (;; format++) {
+        if (*format == '-')      info->left_align = 1;
+        else if (*format == '0') info->pad_char = '0';
+        else if (*format == '+') info->sign_char = '+';
+        else if (*format == ' ') { if (info->sign_char == 0) info->sign_char = ' '; }
+        else if (*format == '#') info->alt_form = 1;
+        else break;
     }
 
-    while (i > 0) {
-        my_putchar(buffer[--i]);
+    if (*format == '*') {
+        int w = va_arg(*args, int);
+        if (w < 0) {
+            info->left_align = 1;
+            w = -w;
+        }
+        info->width = (size_t)w;
+        format++;
+    } else {
+        while (*format >= '0' && *format <= '9') {
+            info->width = info->width * 10 + (size_t)(*format++ - '0');
+        }
     }
+
+    if (*format == '.') {
+        format++;
+        if (*format == '*') {
+            info->precision = va_arg(*args, int);
+            if (info->precision < 0) info->precision = -1;
+            format++;
+        } else {
+            info->precision = 0;
+            while (*format >= '0' && *format <= '9') {
+                info->precision = info->precision * 10 + (*format++ - '0');
+            }
+        }
+    }
+
+    switch (*format) {
+        case 'h':
+            format++;
+            info->length = LEN_SHORT;
+            if (*format == 'h') { format++; info->length = LEN_CHAR; }
+            break;
+        case 'l':
+            format++;
+            info->length = LEN_LONG;
+            if (*format == 'l') { format++; info->length = LEN_LLONG; }
+            break;
+        case 'z':
+            format++;
+            info->length = LEN_SIZE;
+            break;
+        default:
+            break;
+    }
+    if (info->left_align) info->pad_char = ' ';
+    return format;
 }
 
-void my_puthex(int num) {
-    if (num == 0) {
-        my_putchar('0');
-        return;
+// 输出一个字段: [空格][前缀][0 填充][正文][空格]
+static void out_field(xout_t *o, const format_info *info, const char *prefix, size_t prefix_len,
+                      size_t zeros, const char *body, size_t body_len) {
+    size_t len = prefix_len + zeros + body_len;
+    size_t pad = (info->width > len) ? info->width - len : 0;
+
+    if (!info->left_align) {
+        if (info->pad_char == '0') {
+            zeros += pad;
+        } else {
+            out_fill(o, ' ', pad);
+        }
+        pad = 0;
+    }
+    out_put(o, prefix, prefix_len);
+    out_fill(o, '0', zeros);
+    out_put(o, body, body_len);
+    out_fill(o, ' ', pad);
+}
+
+static uint64_t arg_unsigned(const format_info *info, va_list *args) {
+    switch (info->length) {
+        case LEN_CHAR:  return (unsigned char)va_arg(*args, unsigned int);
+        case LEN_SHORT: return (unsigned short)va_arg(*args, unsigned int);
+        case LEN_LONG:  return va_arg(*args, unsigned long);
+        case LEN_LLONG: return va_arg(*args, unsigned long long);
+        case LEN_SIZE:  return va_arg(*args, size_t);
+        default:        return va_arg(*args, unsigned int);
+    }
+}
+
+static int64_t arg_signed(const format_info *info, va_list *args) {
+    switch (info->length) {
+        case LEN_CHAR:  return (signed char)va_arg(*args, int);
+        case LEN_SHORT: return (short)va_arg(*args, int);
+        case LEN_LONG:  return va_arg(*args, long);
+        case LEN_LLONG: return va_arg(*args, long long);
+        case LEN_SIZE:  return (int64_t)va_arg(*args, size_t);
+        default:        return va_arg(*args, int);
     }
+}
+
+static void out_integer(xout_t *o, format_info *info, uint64_t v, int negative, char conv) {
+    char tmp[24];
+    char *end = tmp + sizeof(tmp);
+    char *body;
+    char prefix[2];
+    size_t prefix_len = 0;
+    size_t body_len, zeros = 0;
 
-    char buffer[20];
-    int i = 0;
-    unsigned char ch;
-    while (num > 0) {
-        ch = num & 0xf;
-        if(ch < 10)
-        {
-            buffer[i++] = '0' + (ch % 10);
+    if (conv == 'x' || conv == 'X') {
+        body = fmt_hex(end, v, conv == 'X');
+        if (info->alt_form && v != 0) {
+            prefix[prefix_len++] = '0';
+            prefix[prefix_len++] = conv;
         }
-        else
-        {
-            buffer[i++] = 'A' + (ch - 10);
+    } else {
+        body = fmt_u64(end, v);
+        if (negative) {
+            prefix[prefix_len++] = '-';
+        } else if (info->sign_char != 0 && conv != 'u') {
+            prefix[prefix_len++] = info->sign_char;
         }
-        num >>= 4;
     }
+    body_len = (size_t)(end - body);
 
-    while (i > 0) {
-        my_putchar(buffer[--i]);
+    // 整数的精度表示最少位数, 指定精度时忽略 0 标志
+    if (info->precision >= 0) {
+        info->pad_char = ' ';
+        if (info->precision == 0 && v == 0) body_len = 0;
+        if ((size_t)info->precision > body_len) zeros = (size_t)info->precision - body_len;
     }
+    out_field(o, info, prefix, prefix_len, zeros, body, body_len);
 }
 
-void my_putfloat(double num) {
-    // 实现浮点数的输出需要更复杂的逻辑
-    // 这里简化为输出小数点后两位
-    int integerPart = (int)num;
-    double fractionalPart = num - integerPart;
+// 整数部分与按精度放大后的小数部分各转一次整数, 不逐位做浮点乘除
+static void out_float(xout_t *o, format_info *info, double v) {
+    char tmp[64];
+    char *end = tmp + sizeof(tmp);
+    char *body = end;
+    char prefix[1];
+    size_t prefix_len = 0;
+    int prec = (info->precision < 0) ? 6 : info->precision;
+    int calc_prec;
 
-    my_putint(integerPart);
-    my_putchar('.');
-    my_putint((int)(fractionalPart * 100));
+    if (prec > 30) prec = 30;
+    calc_prec = (prec > 9) ? 9 : prec;
+
+    if (v < 0) {
+        prefix[prefix_len++] = '-';
+        v = -v;
+    } else if (info->sign_char != 0) {
+        prefix[prefix_len++] = info->sign_char;
+    }
+
+    if (v != v || v >= 18446744073709551616.0) {
+        info->pad_char = ' ';
+        out_field(o, info, prefix, prefix_len, 0, (v != v) ? "nan" : "inf", 3);
+        return;
+    }
+
+    uint64_t int_part = (uint64_t)v;
+    uint32_t scale = pow10_u32[calc_prec];
+    double fraction = v - (double)int_part;
+    double scaled = fraction * scale;
+    uint32_t frac = (uint32_t)scaled;
+    double rem = scaled - (double)frac;
+    // 舍入规则与 C 库一致: 恰好一半时取偶
+    // 乘法结果为 0.5 时用 fma 求精确余量, 区分真正的一半和乘法舍入出来的一半
+    if (rem == 0.5) {
+        double exact = fma(fraction, (double)scale, -((double)frac + 0.5));
+        if (exact > 0 || (exact == 0 && ((calc_prec > 0 ? frac : (uint32_t)int_part) & 1))) {
+            frac++;
+        }
+    } else if (rem > 0.5) {
+        frac++;
+    }
+    if (frac >= scale) {       // 进位到整数部分
+        frac -= scale;
+        int_part++;
+    }
+
+    // 超出 9 位的精度补 0
+    while (prec > calc_prec) {
+        *--body = '0';
+        prec--;
+    }
+    if (calc_prec > 0) {
+        char *stop = body - calc_prec;
+        body = fmt_u32(body, frac);
+        while (body > stop) *--body = '0';
+    }
+    if (prec > 0 || info->alt_form) *--body = '.';
+    body = fmt_u64(body, int_part);
+    out_field(o, info, prefix, prefix_len, 0, body, (size_t)(end - body));
 }
 
-void xprintf(const char *format, ...) {
+static void format_to(xout_t *o, const char *format, va_list args_in) {
     va_list args;
-    va_start(args, format);
+    va_copy(args, args_in);
 
     while (*format) {
-        if (*format == '%') {
-            format++; // Move past '%'
-            switch (*format) {
-                case 'd':
-                    my_putint(va_arg(args, int));
-                    break;
-                case 's':
-                    my_puts(va_arg(args, char *));
-                    break;
-                case 'f':
-                    my_putfloat(va_arg(args, double));
-                    break;
-                case 'x':
-                    my_puthex(va_arg(args, unsigned int));
-                    break;
-                case 'c':
-                    my_putchar(va_arg(args, int));
-                    break;
-                default:
-                    my_putchar('%');
-                    my_putchar(*format);
-                    break;
+        // 普通字符整段拷贝
+        const char *p = format;
+        while (*p && *p != '%') p++;
+        if (p != format) {
+            out_put(o, format, (size_t)(p - format));
+            format = p;
+            if (*format == '\0') break;
+        }
+
+        format_info info;
+        format = parse_format(format + 1, &info, &args);
+
+        switch (*format) {
+            case 'd':
+            case 'i': {
+                int64_t v = arg_signed(&info, &args);
+                uint64_t mag = (v < 0) ? (uint64_t)0 - (uint64_t)v : (uint64_t)v;
+                out_integer(o, &info, mag, v < 0, 'd');
+                break;
             }
-        } else {
-            my_putchar(*format);
+
+            case 'u':
+            case 'x':
+            case 'X':
+                out_integer(o, &info, arg_unsigned(&info, &args), 0, *format);
+                break;
+
+            case 'p': {
+                // 固定输出 0x + 满宽大写十六进制, 与原 memdisplay 的地址列一致
+                char tmp[16];
+                char *end = tmp + sizeof(tmp);
+                char *body = fmt_hex(end, (uint64_t)(uintptr_t)va_arg(args, void *), 1);
+                size_t body_len = (size_t)(end - body);
+                info.pad_char = ' ';
+                out_field(o, &info, "0x", 2, sizeof(void *) * 2 - body_len, body, body_len);
+                break;
+            }
+
+            case 's': {
+                const char *s = va_arg(args, const char *);
+                size_t len = 0;
+                if (s == NULL) s = "(null)";
+                // 有精度时最多读 precision 个字符, 字符串可以不以 '\0' 结尾
+                while ((info.precision < 0 || len < (size_t)info.precision) && s[len] != '\0') len++;
+                out_field(o, &info, NULL, 0, 0, s, len);
+                break;
+            }
+
+            case 'c': {
+                char c = (char)va_arg(args, int);
+                out_field(o, &info, NULL, 0, 0, &c, 1);
+                break;
+            }
+
+            case 'f':
+            case 'F':
+                out_float(o, &info, va_arg(args, double));
+                break;
+
+            case '%':
+                out_put(o, "%", 1);
+                break;
+
+            case '\0':
+                out_put(o, "%", 1);
+                va_end(args);
+                return;
+
+            default:
+                out_put(o, "%", 1);
+                out_put(o, format, 1);
+                break;
         }
         format++;
     }
+    va_end(args);
+}
+
+/* ------------------------------------------------------------
+ * 接口
+ * ------------------------------------------------------------ */
+int xvformat(xprintf_write_t write, void *arg, const char *format, va_list args) {
+    char chunk[XPRINTF_CHUNK_SIZE];
+    xout_t o = { write, arg, chunk, sizeof(chunk), 0, 0 };
+
+    if (write == NULL) return -1;
+    format_to(&o, format, args);
+    out_flush(&o);
+    return o.total;
+}
+
+int xformat(xprintf_write_t write, void *arg, const char *format, ...) {
+    va_list args;
+    int ret;
+    va_start(args, format);
+    ret = xvformat(write, arg, format, args);
+    va_end(args);
+    return ret;
+}
+
+int xvsnprintf(char *buf, size_t size, const char *format, va_list args) {
+    xout_t o = { NULL, NULL, buf, size, 0, 0 };
+
+    format_to(&o, format, args);
+    if (size > 0) buf[o.pos] = '\0';
+    return o.total;
+}
+
+int xsnprintf(char *buf, size_t size, const char *format, ...) {
+    va_list args;
+    int ret;
+    va_start(args, format);
+    ret = xvsnprintf(buf, size, format, args);
+    va_end(args);
+    return ret;
+}
+
+// 默认输出: 每块调用一次驱动
+static void uart_write(void *arg, const char *buf, size_t len) {
+    (void)arg;
+#ifdef XPRINTF_USE_STDOUT
+    fwrite(buf, 1, len, stdout);
+#else
+    HAL_UART_Transmit(&huart1, (uint8_t *)buf, (uint16_t)len, HAL_MAX_DELAY);
+#endif
+}
+
+static xprintf_write_t xprintf_out = uart_write;
+static void *xprintf_arg;
 
+void xprintf_set_output(xprintf_write_t write, void *arg) {
+    xprintf_out = (write != NULL) ? write : uart_write;
+    xprintf_arg = arg;
+}
+
+void xprintf_write(const char *buf, size_t len) {
+    xprintf_out(xprintf_arg, buf, len);
+}
+
+void my_putchar(char c) {
+    xprintf_out(xprintf_arg, &c, 1);
+}
+
+void my_puts(const char *str) {
+    xprintf_out(xprintf_arg, str, strlen(str));
+}
+
+void xprintf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    xvformat(xprintf_out, xprintf_arg, format, args);
     va_end(args);
 }
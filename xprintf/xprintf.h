@@ -3,13 +3,39 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// 输出先攒在栈上的分块缓冲中, 满一块或格式化结束时调用一次 write
+// 按 UART DMA 单次搬运长度设置
+#ifndef XPRINTF_CHUNK_SIZE
+#define XPRINTF_CHUNK_SIZE  64
+#endif
+
+// 分块输出回调: 一次交出 len 个字符 (不含结尾 '\0')
+typedef void (*xprintf_write_t)(void *arg, const char *buf, size_t len);
+
+// 支持: %d %i %u %x %X %p %s %c %f %%
+// 标志 - 0 + 空格 #, 宽度/精度 (可用 *), 长度修饰 hh h l ll z
+// %f 小数部分最多计算 9 位, 更多位补 0; 超出 uint64 范围的值输出 inf
+int xvformat(xprintf_write_t write, void *arg, const char *format, va_list args);
+int xformat(xprintf_write_t write, void *arg, const char *format, ...);
+
+// 格式化到调用者缓冲区, 语义同 snprintf: 返回完整输出所需长度, 超出部分截断
+int xvsnprintf(char *buf, size_t size, const char *format, va_list args);
+int xsnprintf(char *buf, size_t size, const char *format, ...);
+
+// 替换 xprintf 的输出 (默认为 UART1 阻塞发送), write 为 NULL 时恢复默认
+void xprintf_set_output(xprintf_write_t write, void *arg);
+
 void xprintf(const char *format, ...);
 
+// 不经格式化, 直接交给 xprintf 当前输出
+void xprintf_write(const char *buf, size_t len);
+
 #ifdef __cplusplus
 }
 #endif